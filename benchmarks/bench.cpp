@@ -0,0 +1,481 @@
+// author: cyberchriz(Christian Suer)
+// benchmark harness for NGrid operations (CMake target 'toolbox_bench', see docs/bench.md):
+// sweeps grid sizes and workgroup sizes over the benchmarked operations and reports latency, throughput
+// and achieved memory bandwidth; the results are written as CSV and JSON for trend tracking
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <log.h>
+#include <map>
+#include <memory>
+#include <ngrid.h>
+#include <sstream>
+#include <string>
+#include <timelog.h>
+#include <vector>
+
+
+// command line options (--name=value)
+struct Options {
+	uint64_t min_elements = 100;
+	uint64_t max_elements = 100000000;
+	uint32_t repetitions = 5;                   // timed runs per measurement (after one warm-up run)
+	double max_seconds = 2.0;                   // stops the repetitions of a measurement early once exceeded
+	double peak_gbps = 0.0;                     // theoretical device bandwidth; 0 = measured copy bandwidth as reference
+	uint32_t device = 0;
+	std::string output = "toolbox_bench";       // writes <output>.csv and <output>.json
+	bool tune_host = false;                     // measures the size thresholds of the host backend
+	std::vector<std::string> ops;               // empty = all operations
+	std::vector<uint32_t> workgroup_sizes_1d = { 64, 128, 256, 512, 1024 };
+	std::vector<uint32_t> workgroup_sizes_2d = { 8, 16, 32 };
+};
+
+// a benchmarked operation; 'prepare' creates the operands for a shape and returns a single run of the operation
+struct Case {
+	std::string name;
+	bool dispatch_2d = false;                   // true: swept over the 2d workgroup sizes, false: 1d workgroup sizes
+	bool square = false;                        // true: operands are square matrices {n, n}, false: 1d grids {elements}
+	uint64_t max_elements = UINT64_MAX;         // size limit of the sweep (e.g. for O(n^3) operations)
+	std::function<std::function<void()>(const std::vector<uint32_t>&)> prepare;
+	std::function<double(double n)> bytes;      // estimated memory traffic of one run (n = elements or matrix order)
+	std::function<double(double n)> flops;      // arithmetic operations of one run (nullptr = not reported)
+};
+
+struct Result {
+	std::string op;
+	std::string shape;
+	uint64_t elements = 0;
+	uint32_t workgroup_size = 0;
+	uint32_t repetitions = 0;
+	double min_us = 0, median_us = 0, mean_us = 0;
+	double elements_per_sec = 0;
+	double bytes = 0;
+	double gbps = 0;
+	double peak_fraction = 0;
+	double gflops = 0;
+};
+
+
+static std::vector<std::string> split(const std::string& text) {
+	std::vector<std::string> items;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		if (!item.empty()) { items.push_back(item); }
+	}
+	return items;
+}
+
+static Options parse_options(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		size_t separator = arg.find('=');
+		std::string key = arg.substr(0, separator);
+		std::string value = separator == std::string::npos ? "" : arg.substr(separator + 1);
+		if (key == "--min-elements") { options.min_elements = std::stoull(value); }
+		else if (key == "--max-elements") { options.max_elements = std::stoull(value); }
+		else if (key == "--repetitions") { options.repetitions = std::max(1u, uint32_t(std::stoul(value))); }
+		else if (key == "--max-seconds") { options.max_seconds = std::stod(value); }
+		else if (key == "--peak-gbps") { options.peak_gbps = std::stod(value); }
+		else if (key == "--device") { options.device = uint32_t(std::stoul(value)); }
+		else if (key == "--output") { options.output = value; }
+		else if (key == "--tune-host") { options.tune_host = true; }
+		else if (key == "--ops") { options.ops = split(value); }
+		else if (key == "--wg1d" || key == "--wg2d") {
+			std::vector<uint32_t> sizes;
+			for (const std::string& item : split(value)) { sizes.push_back(uint32_t(std::stoul(item))); }
+			(key == "--wg1d" ? options.workgroup_sizes_1d : options.workgroup_sizes_2d) = sizes;
+		}
+		else if (key == "--help") {
+			std::cout << "usage: toolbox_bench [--min-elements=N] [--max-elements=N] [--repetitions=N] [--max-seconds=S]\n"
+				<< "  [--peak-gbps=G] [--device=I] [--output=PREFIX] [--ops=a,b,...] [--wg1d=64,128,...] [--wg2d=8,16,...] [--tune-host]\n";
+			std::exit(0);
+		}
+		else {
+			Log::warning("toolbox_bench: unknown option '", arg, "' (see --help)");
+		}
+	}
+	return options;
+}
+
+// creates a grid of the given shape, filled with uniform random values in [min, max]
+static std::shared_ptr<NGrid> random_grid(const std::vector<uint32_t>& shape, float_t min = 0.0f, float_t max = 1.0f) {
+	auto grid = std::make_shared<NGrid>(shape);
+	grid->fill_random_uniform(min, max);
+	return grid;
+}
+
+static std::vector<Case> benchmark_cases() {
+	std::vector<Case> cases;
+	auto stream_bytes = [](double factor) { return [factor](double n) { return factor * n * sizeof(float_t); }; };
+
+	// fills (write only)
+	cases.push_back({ "fill", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = std::make_shared<NGrid>(shape);
+		return std::function<void()>([a]() { a->fill(1.0f); });
+	}, stream_bytes(1), nullptr });
+	cases.push_back({ "fill_random_uniform", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = std::make_shared<NGrid>(shape);
+		return std::function<void()>([a]() { a->fill_random_uniform(); });
+	}, stream_bytes(1), nullptr });
+	cases.push_back({ "fill_random_gaussian", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = std::make_shared<NGrid>(shape);
+		return std::function<void()>([a]() { a->fill_random_gaussian(); });
+	}, stream_bytes(1), nullptr });
+
+	// copy into an existing grid (also the reference for the achieved bandwidth if no --peak-gbps is given)
+	cases.push_back({ "copy", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		auto b = std::make_shared<NGrid>(shape);
+		return std::function<void()>([a, b]() { b->set(*a); });
+	}, stream_bytes(2), nullptr });
+
+	// elementwise operations
+	cases.push_back({ "add", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		auto b = random_grid(shape);
+		return std::function<void()>([a, b]() { NGrid c = *a + *b; });
+	}, stream_bytes(3), [](double n) { return n; } });
+	cases.push_back({ "add_scalar", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { *a += 1.0f; });
+	}, stream_bytes(2), [](double n) { return n; } });
+	cases.push_back({ "exp", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { NGrid c = a->exp(); });
+	}, stream_bytes(2), nullptr });
+	cases.push_back({ "pow", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { NGrid c = a->pow(2.0f); });
+	}, stream_bytes(2), nullptr });
+
+	// activation functions
+	cases.push_back({ "sigmoid", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape, -4.0f, 4.0f);
+		return std::function<void()>([a]() { NGrid c = a->sigmoid(); });
+	}, stream_bytes(2), nullptr });
+	cases.push_back({ "tanh", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape, -4.0f, 4.0f);
+		return std::function<void()>([a]() { NGrid c = a->tanh(); });
+	}, stream_bytes(2), nullptr });
+
+	// reductions (read only)
+	cases.push_back({ "sum", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { a->sum(); });
+	}, stream_bytes(1), [](double n) { return n; } });
+	cases.push_back({ "max", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { a->max(); });
+	}, stream_bytes(1), [](double n) { return n; } });
+	cases.push_back({ "var", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { a->var(); });
+	}, stream_bytes(1), nullptr });
+
+	// sort (one read and one write as the lower bound of the memory traffic)
+	cases.push_back({ "sort", false, false, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape);
+		return std::function<void()>([a]() { NGrid c = a->sort(); });
+	}, stream_bytes(2), nullptr });
+
+	// matrix operations on square matrices of order n
+	cases.push_back({ "matrix_product", true, true, uint64_t(1) << 24, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape, -1.0f, 1.0f);
+		auto b = random_grid(shape, -1.0f, 1.0f);
+		return std::function<void()>([a, b]() { NGrid c = a->matrix_product(*b); });
+	}, [](double n) { return 3 * n * n * sizeof(float_t); }, [](double n) { return 2 * n * n * n; } });
+	cases.push_back({ "convolution", true, true, UINT64_MAX, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape, -1.0f, 1.0f);
+		auto kernel = random_grid({ 3, 3 }, -1.0f, 1.0f);
+		return std::function<void()>([a, kernel]() { NGrid c = a->convolution(*kernel, 1); });
+	}, [](double n) { return 2 * n * n * sizeof(float_t); }, [](double n) { return 2 * 9 * n * n; } });
+	cases.push_back({ "lu_decomp", true, true, uint64_t(1) << 22, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape, -1.0f, 1.0f);
+		auto factors = std::make_shared<std::vector<NGrid>>(3);
+		return std::function<void()>([a, factors]() { a->lu_decomp((*factors)[0], (*factors)[1], (*factors)[2]); });
+	}, [](double n) { return 4 * n * n * sizeof(float_t); }, [](double n) { return 2.0 / 3.0 * n * n * n; } });
+	cases.push_back({ "inverse", true, true, uint64_t(1) << 22, [](const std::vector<uint32_t>& shape) {
+		auto a = random_grid(shape, -1.0f, 1.0f);
+		return std::function<void()>([a]() { NGrid c = a->inverse(); });
+	}, [](double n) { return 2 * n * n * sizeof(float_t); }, [](double n) { return 2 * n * n * n; } });
+
+	return cases;
+}
+
+// times the given run (one warm-up run for pipeline creation, then up to 'repetitions' timed runs)
+static std::vector<double> measure(const std::function<void()>& run, const Options& options) {
+	run();
+	std::vector<double> times_us;
+	double total_us = 0;
+	for (uint32_t i = 0; i < options.repetitions; i++) {
+		auto start = std::chrono::steady_clock::now();
+		run();
+		double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		times_us.push_back(elapsed_us);
+		total_us += elapsed_us;
+		if (total_us > options.max_seconds * 1e6) { break; }
+	}
+	return times_us;
+}
+
+// operand shape of a case for a requested element count (square matrices use the nearest order n)
+static std::vector<uint32_t> case_shape(const Case& c, uint64_t elements) {
+	if (c.square) {
+		uint32_t n = std::max(2u, uint32_t(std::lround(std::sqrt(double(elements)))));
+		return { n, n };
+	}
+	return { uint32_t(elements) };
+}
+
+static std::string shapestring(const std::vector<uint32_t>& shape) {
+	std::string text;
+	for (size_t i = 0; i < shape.size(); i++) {
+		text += (i == 0 ? "" : "x") + std::to_string(shape[i]);
+	}
+	return text;
+}
+
+static std::string json_escape(const std::string& text) {
+	std::string escaped;
+	for (char c : text) {
+		if (c == '"' || c == '\\') { escaped += '\\'; }
+		escaped += c;
+	}
+	return escaped;
+}
+
+static void write_csv(const std::string& filepath, const std::vector<Result>& results) {
+	std::ofstream file(filepath);
+	if (!file.is_open()) {
+		Log::warning("toolbox_bench: failed to open ", filepath, " for writing");
+		return;
+	}
+	file << "op,shape,elements,workgroup_size,repetitions,min_us,median_us,mean_us,elements_per_sec,bytes,gbps,peak_fraction,gflops\n";
+	for (const Result& r : results) {
+		file << r.op << "," << r.shape << "," << r.elements << "," << r.workgroup_size << "," << r.repetitions << ","
+			<< r.min_us << "," << r.median_us << "," << r.mean_us << "," << r.elements_per_sec << "," << r.bytes << ","
+			<< r.gbps << "," << r.peak_fraction << "," << r.gflops << "\n";
+	}
+}
+
+// measures the crossover sizes of the host backend (NGrid::set_host_threshold()) with one representative op per class:
+// the threshold is the largest size of the doubling sequence up to which the host path is faster than the GPU path
+static std::map<std::string, uint32_t> tune_host(const std::vector<Case>& cases, const Options& options) {
+	struct HostClass { std::string name; NGrid::HostOp host_op; std::string label; };
+	const std::vector<HostClass> classes = {
+		{ "add", NGrid::HOST_ELEMENTWISE, "HOST_ELEMENTWISE" },
+		{ "sigmoid", NGrid::HOST_ACTIVATION, "HOST_ACTIVATION" },
+		{ "sum", NGrid::HOST_REDUCTION, "HOST_REDUCTION" }
+	};
+	std::map<std::string, uint32_t> thresholds;
+	std::cout << "\nhost backend thresholds:\n";
+	for (const auto& [name, host_op, label] : classes) {
+		auto c = std::find_if(cases.begin(), cases.end(), [&](const Case& candidate) { return candidate.name == name; });
+		if (c == cases.end()) {
+			continue;
+		}
+		uint32_t threshold = 0;
+		bool device_local = false;
+		for (uint64_t size = 64; size <= std::min<uint64_t>(options.max_elements, uint64_t(1) << 24); size *= 2) {
+			std::vector<uint32_t> shape = { uint32_t(size) };
+			device_local = NGrid(shape).is_device_local();
+			if (device_local) {
+				break; // device-local grids always stay on the GPU
+			}
+			std::function<void()> run = c->prepare(shape);
+			NGrid::set_host_threshold(host_op, 0);
+			std::vector<double> gpu_us = measure(run, options);
+			NGrid::set_host_threshold(host_op, UINT32_MAX);
+			std::vector<double> host_us = measure(run, options);
+			if (*std::min_element(host_us.begin(), host_us.end()) >= *std::min_element(gpu_us.begin(), gpu_us.end())) {
+				break;
+			}
+			threshold = uint32_t(size);
+		}
+		NGrid::set_host_threshold(host_op, threshold);
+		thresholds[label] = threshold;
+		std::cout << "  NGrid::set_host_threshold(NGrid::" << label << ", " << threshold << ");"
+			<< (device_local ? " (grids are device-local, the host path doesn't apply)" : "") << "\n";
+	}
+	return thresholds;
+}
+
+static void write_json_map(std::ofstream& file, const std::map<std::string, uint32_t>& values) {
+	file << "{";
+	bool first = true;
+	for (const auto& [key, value] : values) {
+		file << (first ? "" : ", ") << "\"" << key << "\": " << value;
+		first = false;
+	}
+	file << "}";
+}
+
+static void write_json(const std::string& filepath, const std::vector<Result>& results, const std::map<std::string, uint32_t>& defaults,
+	const std::map<std::string, uint32_t>& host_thresholds, double peak_gbps, bool measured_peak) {
+	std::ofstream file(filepath);
+	if (!file.is_open()) {
+		Log::warning("toolbox_bench: failed to open ", filepath, " for writing");
+		return;
+	}
+	const VkPhysicalDeviceProperties& properties = NGrid::get_device_properties();
+	file << "{\n  \"device\": {\"name\": \"" << json_escape(properties.deviceName) << "\", \"vendor_id\": " << properties.vendorID
+		<< ", \"device_id\": " << properties.deviceID << ", \"driver_version\": " << properties.driverVersion
+		<< ", \"api_version\": " << properties.apiVersion << "},\n";
+	file << "  \"peak_gbps\": " << peak_gbps << ",\n  \"peak_measured\": " << (measured_peak ? "true" : "false") << ",\n";
+	file << "  \"best_workgroup_size\": ";
+	write_json_map(file, defaults);
+	file << ",\n  \"host_thresholds\": ";
+	write_json_map(file, host_thresholds);
+	file << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result& r = results[i];
+		file << "    {\"op\": \"" << r.op << "\", \"shape\": \"" << r.shape << "\", \"elements\": " << r.elements
+			<< ", \"workgroup_size\": " << r.workgroup_size << ", \"repetitions\": " << r.repetitions
+			<< ", \"min_us\": " << r.min_us << ", \"median_us\": " << r.median_us << ", \"mean_us\": " << r.mean_us
+			<< ", \"elements_per_sec\": " << r.elements_per_sec << ", \"bytes\": " << r.bytes << ", \"gbps\": " << r.gbps
+			<< ", \"peak_fraction\": " << r.peak_fraction << ", \"gflops\": " << r.gflops << "}"
+			<< (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	file << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+	Log::set_level(LEVEL_WARNING);
+	Options options = parse_options(argc, argv);
+	if (options.device >= NGrid::get_device_count()) {
+		Log::error("toolbox_bench: invalid device index ", options.device, " (", NGrid::get_device_count(), " devices available)");
+	}
+	NGrid::set_current_device(options.device);
+	const VkPhysicalDeviceProperties& properties = NGrid::get_device_properties();
+	uint32_t max_invocations = properties.limits.maxComputeWorkGroupInvocations;
+	uint64_t max_buffer_elements = properties.limits.maxStorageBufferRange / sizeof(float_t);
+	std::cout << "device: " << properties.deviceName << "\n";
+
+	std::vector<Case> cases;
+	for (Case& c : benchmark_cases()) {
+		if (options.ops.empty() || std::find(options.ops.begin(), options.ops.end(), c.name) != options.ops.end()) {
+			cases.push_back(std::move(c));
+		}
+	}
+
+	// sizes: decades from min_elements to max_elements
+	std::vector<uint64_t> sizes;
+	for (uint64_t size = std::max<uint64_t>(1, options.min_elements); size <= options.max_elements; size *= 10) {
+		sizes.push_back(size);
+	}
+
+	// reference bandwidth: the peak of a device-local copy at the largest size (if not given on the command line)
+	bool measured_peak = options.peak_gbps <= 0;
+	double peak_gbps = options.peak_gbps;
+	if (measured_peak) {
+		uint64_t elements = std::min({ options.max_elements, max_buffer_elements, uint64_t(1) << 26 });
+		try {
+			std::vector<Case> all_cases = benchmark_cases();
+			const Case& copy_case = *std::find_if(all_cases.begin(), all_cases.end(), [](const Case& c) { return c.name == "copy"; });
+			std::vector<double> times_us = measure(copy_case.prepare({ uint32_t(elements) }), options);
+			peak_gbps = copy_case.bytes(double(elements)) / (*std::min_element(times_us.begin(), times_us.end()) * 1e3);
+		}
+		catch (const std::exception& e) {
+			Log::warning("toolbox_bench: failed to measure the reference bandwidth (", e.what(), ")");
+			peak_gbps = 0;
+		}
+	}
+	std::cout << "reference bandwidth: " << peak_gbps << " GB/s" << (measured_peak ? " (measured copy)" : "") << "\n\n";
+	std::cout << std::left << std::setw(22) << "op" << std::setw(14) << "shape" << std::setw(8) << "wg" << std::right
+		<< std::setw(14) << "median_us" << std::setw(14) << "Melem/s" << std::setw(10) << "GB/s" << std::setw(8) << "peak%"
+		<< std::setw(10) << "GFLOP/s" << "\n";
+
+	// the sweep measures the GPU kernels, so the host backend is disabled meanwhile
+	uint32_t host_thresholds[NGrid::HOST_OP_COUNT];
+	for (uint32_t op = 0; op < NGrid::HOST_OP_COUNT; op++) {
+		host_thresholds[op] = NGrid::get_host_threshold(NGrid::HostOp(op));
+		NGrid::set_host_threshold(NGrid::HostOp(op), 0);
+	}
+
+	std::vector<Result> results;
+	for (const Case& c : cases) {
+		const std::vector<uint32_t>& workgroup_sizes = c.dispatch_2d ? options.workgroup_sizes_2d : options.workgroup_sizes_1d;
+		for (uint64_t size : sizes) {
+			if (size > c.max_elements) { continue; }
+			std::vector<uint32_t> shape = case_shape(c, size);
+			uint64_t elements = c.square ? uint64_t(shape[0]) * shape[1] : size;
+			if (elements > max_buffer_elements) { continue; }
+			double n = c.square ? double(shape[0]) : double(elements);
+			try {
+				std::function<void()> run = c.prepare(shape);
+				for (uint32_t workgroup_size : workgroup_sizes) {
+					uint64_t invocations = c.dispatch_2d ? uint64_t(workgroup_size) * workgroup_size : workgroup_size;
+					if (workgroup_size == 0 || invocations > max_invocations) { continue; }
+					if (c.dispatch_2d) { NGrid::set_workgroup_size_2d(workgroup_size); }
+					else { NGrid::set_workgroup_size_1d(workgroup_size); }
+
+					std::vector<double> times_us = measure(run, options);
+					std::vector<double> sorted = times_us;
+					std::sort(sorted.begin(), sorted.end());
+					Result r;
+					r.op = c.name;
+					r.shape = shapestring(shape);
+					r.elements = elements;
+					r.workgroup_size = workgroup_size;
+					r.repetitions = uint32_t(times_us.size());
+					r.min_us = sorted.front();
+					r.median_us = sorted[sorted.size() / 2];
+					for (double t : times_us) { r.mean_us += t / double(times_us.size()); }
+					r.elements_per_sec = double(elements) / (r.median_us * 1e-6);
+					r.bytes = c.bytes(n);
+					r.gbps = r.bytes / (r.median_us * 1e3);
+					r.peak_fraction = peak_gbps > 0 ? r.gbps / peak_gbps : 0;
+					r.gflops = c.flops ? c.flops(n) / (r.median_us * 1e3) : 0;
+					results.push_back(r);
+
+					std::cout << std::left << std::setw(22) << r.op << std::setw(14) << r.shape << std::setw(8) << r.workgroup_size
+						<< std::right << std::fixed << std::setprecision(1) << std::setw(14) << r.median_us << std::setw(14)
+						<< r.elements_per_sec * 1e-6 << std::setw(10) << r.gbps << std::setw(8) << r.peak_fraction * 100
+						<< std::setw(10) << r.gflops << std::defaultfloat << std::setprecision(6) << "\n";
+				}
+			}
+			catch (const std::exception& e) {
+				Log::warning("toolbox_bench: ", c.name, " with shape ", shapestring(shape), " failed (", e.what(), ")");
+			}
+		}
+	}
+	NGrid::set_workgroup_size_1d(DEFAULT_WORKGROUP_SIZE_1D);
+	NGrid::set_workgroup_size_2d(DEFAULT_WORKGROUP_SIZE_2D);
+	for (uint32_t op = 0; op < NGrid::HOST_OP_COUNT; op++) {
+		NGrid::set_host_threshold(NGrid::HostOp(op), host_thresholds[op]);
+	}
+
+	// per-device defaults: the workgroup size with the lowest total median latency over the sizes of an op
+	std::map<std::string, std::map<uint32_t, double>> total_latency;
+	for (const Result& r : results) {
+		total_latency[r.op][r.workgroup_size] += r.median_us;
+	}
+	std::map<std::string, uint32_t> defaults;
+	std::cout << "\nbest workgroup sizes:\n";
+	for (const auto& [op, totals] : total_latency) {
+		auto best = std::min_element(totals.begin(), totals.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+		defaults[op] = best->first;
+		std::cout << "  " << op << ": " << best->first << "\n";
+	}
+
+	std::map<std::string, uint32_t> tuned_thresholds;
+	if (options.tune_host) {
+		tuned_thresholds = tune_host(benchmark_cases(), options);
+	}
+
+	write_csv(options.output + ".csv", results);
+	write_json(options.output + ".json", results, defaults, tuned_thresholds, peak_gbps, measured_peak);
+#ifdef PROFILING
+	Profiler::write_csv(options.output + "_profile.csv");
+#endif
+	std::cout << "\nresults written to " << options.output << ".csv and " << options.output << ".json\n";
+	return 0;
+}
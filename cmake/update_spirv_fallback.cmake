@@ -0,0 +1,30 @@
+# update_spirv_fallback.cmake
+#
+# Copies the generated SPIR-V header into the source tree as the fallback header that is
+# used when the shaders aren't compiled (COMPILE_GLSL_SHADERS=OFF or no glslangValidator).
+#
+# Input variables (set via cmake -D... -P):
+#   GENERATED_HEADER  - Full path to the generated spirv_bin.h (in build dir).
+#   FALLBACK_HEADER   - Full path to the fallback header (include/spirv_bin_precompiled.h).
+#
+
+if(NOT DEFINED GENERATED_HEADER OR NOT DEFINED FALLBACK_HEADER)
+    message(FATAL_ERROR "update_spirv_fallback.cmake requires GENERATED_HEADER and FALLBACK_HEADER to be defined.")
+endif()
+if(NOT EXISTS "${GENERATED_HEADER}")
+    message(FATAL_ERROR "Generated SPIR-V header not found: ${GENERATED_HEADER}")
+endif()
+
+file(READ "${GENERATED_HEADER}" HEADER_CONTENT)
+
+# replace the "do not edit" note of the generated header with the comment of the fallback header
+string(REPLACE "// Generated by CMake. Do not edit.\n"
+"// The following definitions are used as a fallback in case the SPIR-V binary is not available,
+// for example in case of stand-alone builds where the SPIR-V binary is not precompiled
+// (e.g. when the original CMakeLists.txt is not used)
+// This file should be updated with the latest definitions in case of any changes made to the original shader code
+// (build the target 'update_spirv_fallback' with COMPILE_GLSL_SHADERS=ON)\n"
+    HEADER_CONTENT "${HEADER_CONTENT}")
+
+file(WRITE "${FALLBACK_HEADER}" "${HEADER_CONTENT}")
+message(STATUS "Updated fallback SPIR-V header: ${FALLBACK_HEADER}")
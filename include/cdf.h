@@ -11,6 +11,11 @@
 #define CUMULATIVE_DISTRIBUTION_FUNCTIONS_H
 
 #include <cmath>
+#include <hostkernels.h>        // SIMD kernels and thread pool for the batch evaluation over spans
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 
 
 
@@ -26,6 +31,19 @@ namespace cdf {
     template<typename T> static T pareto(T x_val, T alpha = 1, T tail_index = 1);
     template<typename T> static T lomax(T x_val, T alpha = 1, T tail_index = 1);
     template<typename T> static T F_distribution(T x_val, T d1, T d2);
+    template<typename T> static T poisson(T k, T lambda);
+    template<typename T> T beta_inc(T a, T b, T x);
+    template<typename T> T regularized_beta(T a, T b, T x);
+
+    // batch evaluation: out[i] = F(x[i]) ('out' needs at least x.size() elements), e.g. cdf::gaussian<float>(x, out);
+    // gaussian and laplace are vectorized for <float>, large spans are split over the thread pool
+    template<typename T> static void gaussian(std::span<const T> x, std::span<T> out, T mu = 0, T sigma = 1);
+    template<typename T> static void cauchy(std::span<const T> x, std::span<T> out, T x_peak = 0, T gamma = 1);
+    template<typename T> static void laplace(std::span<const T> x, std::span<T> out, T mu = 0, T sigma = 1);
+    template<typename T> static void pareto(std::span<const T> x, std::span<T> out, T alpha = 1, T tail_index = 1);
+    template<typename T> static void lomax(std::span<const T> x, std::span<T> out, T alpha = 1, T tail_index = 1);
+    template<typename T> static void F_distribution(std::span<const T> x, std::span<T> out, T d1, T d2);
+    template<typename T> static void poisson(std::span<const T> k, std::span<T> out, T lambda);
 
 
     // +------------------------------------------------------------------+
@@ -55,8 +73,7 @@ namespace cdf {
     // the scale_factor is sigma/sqrt(2)=0.707106781 by default
     template<typename T>
     T laplace(T x_val, T mu, T sigma) {
-        static double scale_factor = 0.707106781;
-        scale_factor = sigma / SQRT_2;
+        T scale_factor = sigma / SQRT_2;
         if (x_val < mu) {
             return 0.5 * exp((x_val - mu) / scale_factor);
         }
@@ -101,40 +118,82 @@ namespace cdf {
         return regularized_beta(d1 / 2, d2 / 2, d1 * x_val / (d1 * x_val + d2));
     }
 
+    // returns the probability of a random value
+    // as part of a Poisson distribution (with the given mean 'lambda')
+    // being less or equal than the given 'k';
+    // the terms lambda^i * exp(-lambda) / i! are summed up in log space (running log-sum-exp),
+    // so that exp(-lambda) doesn't underflow for large lambda; one iteration per term, up to floor(k)
+    template<typename T>
+    T poisson(T k, T lambda) {
+        if (k < 0) {
+            return 0;
+        }
+        const T log_lambda = log(lambda);
+        const T log_epsilon = log(std::numeric_limits<T>::epsilon());
+        T log_sum = -lambda;
+        for (T i = 1; i <= std::floor(k); i++) {
+            // (every term is evaluated directly instead of as a product of ratios, which would accumulate rounding errors)
+            T log_term = i * log_lambda - lambda - std::lgamma(i + 1);
+            if (log_term > log_sum) {
+                log_sum = log_term + std::log1p(exp(log_sum - log_term));
+            }
+            else {
+                log_sum += std::log1p(exp(log_term - log_sum));
+            }
+            if (i > lambda && log_term - log_sum < log_epsilon) {
+                break; // (the remaining terms are negligible)
+            }
+        }
+        return std::fmin(exp(log_sum), T(1));
+    }
 
 
-    // Helper function for the regularized incomplete beta function
+
+    // Helper function for the regularized incomplete beta function:
+    // continued fraction, evaluated with the modified Lentz method
     template <typename T>
     T beta_inc(T a, T b, T x) {
-        const int MAXIT = 100;
+        const int MAXIT = 200;
         const T EPS = std::numeric_limits<T>::epsilon();
         const T FPMIN = std::numeric_limits<T>::min() / EPS;
-        const T fpmin = static_cast<T>(FPMIN);
-        const T xk = 1 - x;
-        T ap = a, bp = b, am = 1, bm = 1, az = 1, qab = a + b, qap = a + 1, qam = a - 1, bz = 1 - qab * x / qap;
-        T aold, em, tem, d = 0;
-
+        const T qab = a + b, qap = a + 1, qam = a - 1;
+        T c = 1;
+        T d = 1 - qab * x / qap;
+        if (std::abs(d) < FPMIN) {
+            d = FPMIN;
+        }
+        d = 1 / d;
+        T h = d;
         for (int m = 1; m <= MAXIT; ++m) {
-            em = static_cast<T>(m);
-            tem = em + em;
-            d = em * (b - em) * x / ((ap + tem) * (a + tem));
-            const T apb = ap + bp;
-            const T app = ap + em;
-            const T apm = ap - em;
-            const T bpp = bp + em;
-            const T bpm = bp - em;
-            az = bz + d * az;
-            const T bpz = bz + d / bm * az;
-            am = az / ap;
-            bm = bz / bp;
-            const T aaz = -(ap + em) * (qam + em) * x / ((a + tem) * (qap + em));
-            const T bbz = bpz + d * bpz / bm;
-            const T abz = am * bbz + bm * aaz;
-            const T aold = az;
-            az = bbz / abz;
-            bz = bpz / abz;
-            if (std::abs(az - aold) < EPS * std::abs(az)) {
-                return az;
+            const T em = static_cast<T>(m);
+            const T m2 = em + em;
+            // even step
+            T aa = em * (b - em) * x / ((qam + m2) * (a + m2));
+            d = 1 + aa * d;
+            if (std::abs(d) < FPMIN) {
+                d = FPMIN;
+            }
+            c = 1 + aa / c;
+            if (std::abs(c) < FPMIN) {
+                c = FPMIN;
+            }
+            d = 1 / d;
+            h *= d * c;
+            // odd step
+            aa = -(a + em) * (qab + em) * x / ((a + m2) * (qap + m2));
+            d = 1 + aa * d;
+            if (std::abs(d) < FPMIN) {
+                d = FPMIN;
+            }
+            c = 1 + aa / c;
+            if (std::abs(c) < FPMIN) {
+                c = FPMIN;
+            }
+            d = 1 / d;
+            const T del = d * c;
+            h *= del;
+            if (std::abs(del - 1) < EPS) {
+                return h;
             }
         }
         throw std::runtime_error("beta_inc failed to converge");
@@ -161,5 +220,65 @@ namespace cdf {
         }
     }
 
+    // helper for the batch evaluation: out[i] = op(x[i])
+    template<typename T, typename Op>
+    void transform(std::span<const T> x, std::span<T> out, Op op) {
+        if (out.size() < x.size()) {
+            throw std::invalid_argument("cdf: the output span has fewer elements than the input span");
+        }
+        hostkernels::transform_scalar(x.data(), out.data(), x.size(), op);
+    }
+
+    template<typename T>
+    void gaussian(std::span<const T> x, std::span<T> out, T mu, T sigma) {
+        if constexpr (std::is_same<T, float>::value) {
+            if (out.size() < x.size()) {
+                throw std::invalid_argument("cdf: the output span has fewer elements than the input span");
+            }
+            hostkernels::gaussian_cdf(x.data(), mu, sigma, out.data(), x.size());
+        }
+        else {
+            transform(x, out, [mu, sigma](T x_val) { return gaussian(x_val, mu, sigma); });
+        }
+    }
+
+    template<typename T>
+    void cauchy(std::span<const T> x, std::span<T> out, T x_peak, T gamma) {
+        transform(x, out, [x_peak, gamma](T x_val) { return cauchy(x_val, x_peak, gamma); });
+    }
+
+    template<typename T>
+    void laplace(std::span<const T> x, std::span<T> out, T mu, T sigma) {
+        if constexpr (std::is_same<T, float>::value) {
+            if (out.size() < x.size()) {
+                throw std::invalid_argument("cdf: the output span has fewer elements than the input span");
+            }
+            hostkernels::laplace_cdf(x.data(), mu, sigma, out.data(), x.size());
+        }
+        else {
+            transform(x, out, [mu, sigma](T x_val) { return laplace(x_val, mu, sigma); });
+        }
+    }
+
+    template<typename T>
+    void pareto(std::span<const T> x, std::span<T> out, T alpha, T tail_index) {
+        transform(x, out, [alpha, tail_index](T x_val) { return pareto(x_val, alpha, tail_index); });
+    }
+
+    template<typename T>
+    void lomax(std::span<const T> x, std::span<T> out, T alpha, T tail_index) {
+        transform(x, out, [alpha, tail_index](T x_val) { return lomax(x_val, alpha, tail_index); });
+    }
+
+    template<typename T>
+    void F_distribution(std::span<const T> x, std::span<T> out, T d1, T d2) {
+        transform(x, out, [d1, d2](T x_val) { return F_distribution(x_val, d1, d2); });
+    }
+
+    template<typename T>
+    void poisson(std::span<const T> k, std::span<T> out, T lambda) {
+        transform(k, out, [lambda](T k_val) { return poisson(k_val, lambda); });
+    }
+
 };
 #endif
\ No newline at end of file
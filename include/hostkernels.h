@@ -0,0 +1,428 @@
+// author: cyberchriz(Christian Suer)
+// description: SIMD kernels for elementwise math, activation functions, probability distributions and reductions on the host
+// (AVX-512, AVX2 or NEON, depending on the target architecture of the compiler, e.g. -march=native;
+// otherwise scalar code); large arrays are split over the shared work-stealing ThreadPool
+
+
+
+#ifndef HOSTKERNELS_H
+#define HOSTKERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <threadpool.h>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+
+namespace hostkernels {
+
+    constexpr size_t parallel_min_elements = 1 << 17;   // smaller arrays are processed by the calling thread only
+    constexpr size_t parallel_grain = 1 << 15;          // elements per chunk of the thread pool
+
+    // vector type and operations of the target architecture
+#if defined(__AVX512F__)
+    struct simd {
+        using type = __m512;
+        static constexpr size_t width = 16;
+        static type load(const float* p) { return _mm512_loadu_ps(p); }
+        static void store(float* p, type v) { _mm512_storeu_ps(p, v); }
+        static type set(float x) { return _mm512_set1_ps(x); }
+        static type add(type a, type b) { return _mm512_add_ps(a, b); }
+        static type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+        static type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+        static type div(type a, type b) { return _mm512_div_ps(a, b); }
+        static type min(type a, type b) { return _mm512_min_ps(a, b); }
+        static type max(type a, type b) { return _mm512_max_ps(a, b); }
+        static type abs(type a) { return _mm512_abs_ps(a); }
+        static type round(type a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static type select_positive(type x, type a, type b) { // x > 0 ? a : b
+            return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GT_OQ), b, a);
+        }
+        static type pow2(type n) { // 2^n for integral n in [-126, 127]
+            return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23));
+        }
+    };
+#elif defined(__AVX2__)
+    struct simd {
+        using type = __m256;
+        static constexpr size_t width = 8;
+        static type load(const float* p) { return _mm256_loadu_ps(p); }
+        static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+        static type set(float x) { return _mm256_set1_ps(x); }
+        static type add(type a, type b) { return _mm256_add_ps(a, b); }
+        static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+        static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+        static type div(type a, type b) { return _mm256_div_ps(a, b); }
+        static type min(type a, type b) { return _mm256_min_ps(a, b); }
+        static type max(type a, type b) { return _mm256_max_ps(a, b); }
+        static type abs(type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static type round(type a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static type select_positive(type x, type a, type b) { // x > 0 ? a : b
+            return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ));
+        }
+        static type pow2(type n) { // 2^n for integral n in [-126, 127]
+            return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23));
+        }
+    };
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    struct simd {
+        using type = float32x4_t;
+        static constexpr size_t width = 4;
+        static type load(const float* p) { return vld1q_f32(p); }
+        static void store(float* p, type v) { vst1q_f32(p, v); }
+        static type set(float x) { return vdupq_n_f32(x); }
+        static type add(type a, type b) { return vaddq_f32(a, b); }
+        static type sub(type a, type b) { return vsubq_f32(a, b); }
+        static type mul(type a, type b) { return vmulq_f32(a, b); }
+        static type div(type a, type b) { return vdivq_f32(a, b); }
+        static type min(type a, type b) { return vminq_f32(a, b); }
+        static type max(type a, type b) { return vmaxq_f32(a, b); }
+        static type abs(type a) { return vabsq_f32(a); }
+        static type round(type a) { return vrndnq_f32(a); }
+        static type select_positive(type x, type a, type b) { // x > 0 ? a : b
+            return vbslq_f32(vcgtq_f32(x, vdupq_n_f32(0.0f)), a, b);
+        }
+        static type pow2(type n) { // 2^n for integral n in [-126, 127]
+            return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtnq_s32_f32(n), vdupq_n_s32(127)), 23));
+        }
+    };
+#else
+    struct simd {
+        using type = float;
+        static constexpr size_t width = 1;
+        static type load(const float* p) { return *p; }
+        static void store(float* p, type v) { *p = v; }
+        static type set(float x) { return x; }
+        static type add(type a, type b) { return a + b; }
+        static type sub(type a, type b) { return a - b; }
+        static type mul(type a, type b) { return a * b; }
+        static type div(type a, type b) { return a / b; }
+        static type min(type a, type b) { return std::min(a, b); }
+        static type max(type a, type b) { return std::max(a, b); }
+        static type abs(type a) { return std::fabs(a); }
+        static type round(type a) { return std::nearbyint(a); }
+        static type select_positive(type x, type a, type b) { return x > 0 ? a : b; }
+        static type pow2(type n) { return std::ldexp(1.0f, int(n)); }
+    };
+#endif
+
+    // exp(x) with range reduction to [-ln2/2, ln2/2] and a polynomial of degree 6 (max. rel. error ~2e-7);
+    // the argument is clamped to the range of normal float results
+    inline simd::type exp(simd::type x) {
+        x = simd::min(simd::max(x, simd::set(-87.3f)), simd::set(88.3f));
+        simd::type n = simd::round(simd::mul(x, simd::set(1.44269504088896341f)));
+        simd::type r = simd::sub(x, simd::mul(n, simd::set(0.693359375f)));
+        r = simd::sub(r, simd::mul(n, simd::set(-2.12194440e-4f)));
+        simd::type p = simd::set(1.9875691500e-4f);
+        p = simd::add(simd::mul(p, r), simd::set(1.3981999507e-3f));
+        p = simd::add(simd::mul(p, r), simd::set(8.3334519073e-3f));
+        p = simd::add(simd::mul(p, r), simd::set(4.1665795894e-2f));
+        p = simd::add(simd::mul(p, r), simd::set(1.6666665459e-1f));
+        p = simd::add(simd::mul(p, r), simd::set(5.0000001201e-1f));
+        simd::type y = simd::add(simd::add(simd::mul(simd::mul(p, r), r), r), simd::set(1.0f));
+        return simd::mul(y, simd::pow2(n));
+    }
+
+    // runs body(begin, end) over [0, n), split over the thread pool for large arrays
+    template<typename Body>
+    inline void parallel(size_t n, Body body) {
+        if (n < parallel_min_elements) {
+            body(size_t(0), n);
+            return;
+        }
+        ThreadPool::shared().parallel_for(n, parallel_grain, body);
+    }
+
+    // out[i] = op(a[i]) for n elements; the remaining elements after the last full vector go through a padded vector
+    template<typename Op>
+    inline void transform(const float* a, float* out, size_t n, Op op) {
+        parallel(n, [&](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + simd::width <= end; i += simd::width) {
+                simd::store(out + i, op(simd::load(a + i)));
+            }
+            if (i < end) {
+                float tail[simd::width] = {};
+                std::copy(a + i, a + end, tail);
+                simd::store(tail, op(simd::load(tail)));
+                std::copy(tail, tail + (end - i), out + i);
+            }
+        });
+    }
+
+    // out[i] = op(a[i], b[i]) for n elements
+    template<typename Op>
+    inline void transform(const float* a, const float* b, float* out, size_t n, Op op) {
+        parallel(n, [&](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + simd::width <= end; i += simd::width) {
+                simd::store(out + i, op(simd::load(a + i), simd::load(b + i)));
+            }
+            if (i < end) {
+                float tail_a[simd::width] = {};
+                float tail_b[simd::width] = {};
+                std::copy(a + i, a + end, tail_a);
+                std::copy(b + i, b + end, tail_b);
+                simd::store(tail_a, op(simd::load(tail_a), simd::load(tail_b)));
+                std::copy(tail_a, tail_a + (end - i), out + i);
+            }
+        });
+    }
+
+    // +=================================+
+    // | Elementwise Arithmetic          |
+    // +=================================+
+
+    inline void add(const float* a, float value, float* out, size_t n) {
+        simd::type v = simd::set(value);
+        transform(a, out, n, [v](simd::type x) { return simd::add(x, v); });
+    }
+
+    inline void multiply(const float* a, float factor, float* out, size_t n) {
+        simd::type f = simd::set(factor);
+        transform(a, out, n, [f](simd::type x) { return simd::mul(x, f); });
+    }
+
+    inline void add(const float* a, const float* b, float* out, size_t n) {
+        transform(a, b, out, n, [](simd::type x, simd::type y) { return simd::add(x, y); });
+    }
+
+    inline void subtract(const float* a, const float* b, float* out, size_t n) {
+        transform(a, b, out, n, [](simd::type x, simd::type y) { return simd::sub(x, y); });
+    }
+
+    inline void multiply(const float* a, const float* b, float* out, size_t n) {
+        transform(a, b, out, n, [](simd::type x, simd::type y) { return simd::mul(x, y); });
+    }
+
+    inline void divide(const float* a, const float* b, float* out, size_t n) {
+        transform(a, b, out, n, [](simd::type x, simd::type y) { return simd::div(x, y); });
+    }
+
+    // +=================================+
+    // | Activation Functions            |
+    // +=================================+
+
+    // x > 0 ? x : alpha * x
+    inline void relu(const float* a, float alpha, float* out, size_t n) {
+        simd::type al = simd::set(alpha);
+        transform(a, out, n, [al](simd::type x) { return simd::select_positive(x, x, simd::mul(al, x)); });
+    }
+
+    // x > 0 ? 1 : alpha
+    inline void relu_drv(const float* a, float alpha, float* out, size_t n) {
+        simd::type one = simd::set(1.0f);
+        simd::type al = simd::set(alpha);
+        transform(a, out, n, [one, al](simd::type x) { return simd::select_positive(x, one, al); });
+    }
+
+    // 1 / (1 + exp(-x))
+    inline void sigmoid(const float* a, float* out, size_t n) {
+        simd::type one = simd::set(1.0f);
+        transform(a, out, n, [one](simd::type x) { return simd::div(one, simd::add(one, exp(simd::sub(simd::set(0.0f), x)))); });
+    }
+
+    // exp(x) / (exp(x) + 1)^2 = sigmoid(x) * (1 - sigmoid(x))
+    inline void sigmoid_drv(const float* a, float* out, size_t n) {
+        simd::type one = simd::set(1.0f);
+        transform(a, out, n, [one](simd::type x) {
+            simd::type s = simd::div(one, simd::add(one, exp(simd::sub(simd::set(0.0f), x))));
+            return simd::mul(s, simd::sub(one, s));
+        });
+    }
+
+    // tanh(x) = 1 - 2 / (exp(2x) + 1)
+    inline simd::type tanh(simd::type x) {
+        simd::type one = simd::set(1.0f);
+        return simd::sub(one, simd::div(simd::set(2.0f), simd::add(exp(simd::add(x, x)), one)));
+    }
+
+    inline void tanh(const float* a, float* out, size_t n) {
+        transform(a, out, n, [](simd::type x) { return tanh(x); });
+    }
+
+    // 1 - tanh(x)^2
+    inline void tanh_drv(const float* a, float* out, size_t n) {
+        simd::type one = simd::set(1.0f);
+        transform(a, out, n, [one](simd::type x) {
+            simd::type t = tanh(x);
+            return simd::sub(one, simd::mul(t, t));
+        });
+    }
+
+    // +=================================+
+    // | Probability Distributions       |
+    // +=================================+
+
+    // erf(x) via Abramowitz & Stegun 7.1.26 (max. abs. error ~1.5e-7)
+    inline simd::type erf(simd::type x) {
+        simd::type one = simd::set(1.0f);
+        simd::type a = simd::abs(x);
+        simd::type t = simd::div(one, simd::add(one, simd::mul(simd::set(0.3275911f), a)));
+        simd::type p = simd::set(1.061405429f);
+        p = simd::add(simd::mul(p, t), simd::set(-1.453152027f));
+        p = simd::add(simd::mul(p, t), simd::set(1.421413741f));
+        p = simd::add(simd::mul(p, t), simd::set(-0.284496736f));
+        p = simd::add(simd::mul(p, t), simd::set(0.254829592f));
+        simd::type y = simd::sub(one, simd::mul(simd::mul(p, t), exp(simd::sub(simd::set(0.0f), simd::mul(a, a)))));
+        return simd::select_positive(x, y, simd::sub(simd::set(0.0f), y));
+    }
+
+    // out[i] = op(a[i]) for n elements with a scalar function (for distributions without a vectorized kernel)
+    template<typename T, typename Op>
+    inline void transform_scalar(const T* a, T* out, size_t n, Op op) {
+        parallel(n, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                out[i] = op(a[i]);
+            }
+        });
+    }
+
+    // exp(-(x - mu)^2 / (2 sigma^2)) / (sigma * sqrt(2 pi))
+    inline void gaussian_pdf(const float* a, float mu, float sigma, float* out, size_t n) {
+        simd::type m = simd::set(mu);
+        simd::type k = simd::set(-0.5f / (sigma * sigma));
+        simd::type c = simd::set(1.0f / (sigma * 2.50662827463100050f));
+        transform(a, out, n, [m, k, c](simd::type x) {
+            simd::type d = simd::sub(x, m);
+            return simd::mul(c, exp(simd::mul(k, simd::mul(d, d))));
+        });
+    }
+
+    // 1 / (pi * gamma * (1 + ((x - x_peak) / gamma)^2))
+    inline void cauchy_pdf(const float* a, float x_peak, float gamma, float* out, size_t n) {
+        simd::type one = simd::set(1.0f);
+        simd::type p = simd::set(x_peak);
+        simd::type g = simd::set(1.0f / gamma);
+        simd::type c = simd::set(1.0f / (3.14159265358979324f * gamma));
+        transform(a, out, n, [one, p, g, c](simd::type x) {
+            simd::type z = simd::mul(simd::sub(x, p), g);
+            return simd::div(c, simd::add(one, simd::mul(z, z)));
+        });
+    }
+
+    // exp(-|x - mu| / b) / (2b) with b = sigma / sqrt(2)
+    inline void laplace_pdf(const float* a, float mu, float sigma, float* out, size_t n) {
+        float b = sigma / 1.41421356237309505f;
+        simd::type m = simd::set(mu);
+        simd::type k = simd::set(-1.0f / b);
+        simd::type c = simd::set(0.5f / b);
+        transform(a, out, n, [m, k, c](simd::type x) {
+            return simd::mul(c, exp(simd::mul(k, simd::abs(simd::sub(x, m)))));
+        });
+    }
+
+    // 0.5 * (1 + erf((x - mu) / (sigma * sqrt(2))))
+    inline void gaussian_cdf(const float* a, float mu, float sigma, float* out, size_t n) {
+        simd::type half = simd::set(0.5f);
+        simd::type m = simd::set(mu);
+        simd::type k = simd::set(1.0f / (sigma * 1.41421356237309505f));
+        transform(a, out, n, [half, m, k](simd::type x) {
+            return simd::add(half, simd::mul(half, erf(simd::mul(simd::sub(x, m), k))));
+        });
+    }
+
+    // x < mu ? 0.5 * exp((x - mu) / b) : 1 - 0.5 * exp(-(x - mu) / b) with b = sigma / sqrt(2)
+    inline void laplace_cdf(const float* a, float mu, float sigma, float* out, size_t n) {
+        simd::type one = simd::set(1.0f);
+        simd::type half = simd::set(0.5f);
+        simd::type m = simd::set(mu);
+        simd::type k = simd::set(-1.41421356237309505f / sigma);
+        transform(a, out, n, [one, half, m, k](simd::type x) {
+            simd::type d = simd::sub(x, m);
+            simd::type h = simd::mul(half, exp(simd::mul(k, simd::abs(d))));
+            return simd::select_positive(d, simd::sub(one, h), h);
+        });
+    }
+
+    // +=================================+
+    // | Reductions                      |
+    // +=================================+
+
+    // reduces the lanes of a vector with 'op'
+    template<typename Op>
+    inline float horizontal(simd::type v, Op op) {
+        float lanes[simd::width];
+        simd::store(lanes, v);
+        float result = lanes[0];
+        for (size_t i = 1; i < simd::width; i++) {
+            result = op(result, lanes[i]);
+        }
+        return result;
+    }
+
+    // sum of n elements; vector partial sums of blocks of 1024 elements are accumulated in double precision
+    inline double sum(const float* a, size_t n) {
+        std::vector<double> partials((n + parallel_grain - 1) / parallel_grain + 1, 0.0);
+        parallel(n, [&](size_t begin, size_t end) {
+            double total = 0;
+            size_t i = begin;
+            while (i + simd::width <= end) {
+                size_t block_end = std::min(end, i + 1024);
+                simd::type acc = simd::set(0.0f);
+                for (; i + simd::width <= block_end; i += simd::width) {
+                    acc = simd::add(acc, simd::load(a + i));
+                }
+                total += horizontal(acc, [](float x, float y) { return x + y; });
+            }
+            for (; i < end; i++) {
+                total += a[i];
+            }
+            partials[begin / parallel_grain] += total;
+        });
+        double result = 0;
+        for (double p : partials) {
+            result += p;
+        }
+        return result;
+    }
+
+    // min, max or max(abs) of n > 0 elements (selected by 'absolute' and 'op')
+    template<typename VecOp, typename ScalarOp>
+    inline float extremum(const float* a, size_t n, bool absolute, VecOp vec_op, ScalarOp scalar_op) {
+        std::vector<float> partials((n + parallel_grain - 1) / parallel_grain + 1, absolute ? std::fabs(a[0]) : a[0]);
+        parallel(n, [&](size_t begin, size_t end) {
+            float result = absolute ? std::fabs(a[begin]) : a[begin];
+            size_t i = begin;
+            simd::type acc = simd::set(result);
+            for (; i + simd::width <= end; i += simd::width) {
+                simd::type x = simd::load(a + i);
+                acc = vec_op(acc, absolute ? simd::abs(x) : x);
+            }
+            result = horizontal(acc, scalar_op);
+            for (; i < end; i++) {
+                result = scalar_op(result, absolute ? std::fabs(a[i]) : a[i]);
+            }
+            partials[begin / parallel_grain] = result;
+        });
+        float result = partials[0];
+        for (float p : partials) {
+            result = scalar_op(result, p); // (unused partials hold the first element)
+        }
+        return result;
+    }
+
+    inline float min(const float* a, size_t n) {
+        return extremum(a, n, false, [](simd::type x, simd::type y) { return simd::min(x, y); }, [](float x, float y) { return std::min(x, y); });
+    }
+
+    inline float max(const float* a, size_t n) {
+        return extremum(a, n, false, [](simd::type x, simd::type y) { return simd::max(x, y); }, [](float x, float y) { return std::max(x, y); });
+    }
+
+    inline float maxabs(const float* a, size_t n) {
+        return extremum(a, n, true, [](simd::type x, simd::type y) { return simd::max(x, y); }, [](float x, float y) { return std::max(x, y); });
+    }
+
+}
+
+#endif
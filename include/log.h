@@ -7,15 +7,38 @@
 #define DEFAULT_LEVEL LogLevel::LEVEL_WARNING
 #endif
 
+// most verbose level that is compiled in: warning(), info() and debug() calls above this level
+// compile to nothing (errors are always compiled, because they throw); can be set before including <log.h>
+// or via the CMake option LOG_COMPILE_LEVEL
+#ifndef LOG_COMPILE_LEVEL
+#ifdef _RELEASE
+#define LOG_COMPILE_LEVEL LogLevel::LEVEL_WARNING
+#else
+#define LOG_COMPILE_LEVEL LogLevel::LEVEL_DEBUG
+#endif
+#endif
+
+// logging macros for hot paths: unlike the Log methods, the arguments aren't evaluated
+// if the level is filtered, either at compile time (LOG_COMPILE_LEVEL) or at runtime (Log::set_level())
+#define LOG_WARNING(...) do { if constexpr (LOG_COMPILE_LEVEL >= LogLevel::LEVEL_WARNING) { if (Log::enabled(LogLevel::LEVEL_WARNING)) { Log::warning(__VA_ARGS__); } } } while (0)
+#define LOG_INFO(...) do { if constexpr (LOG_COMPILE_LEVEL >= LogLevel::LEVEL_INFO) { if (Log::enabled(LogLevel::LEVEL_INFO)) { Log::info(__VA_ARGS__); } } } while (0)
+#define LOG_DEBUG(...) do { if constexpr (LOG_COMPILE_LEVEL >= LogLevel::LEVEL_DEBUG) { if (Log::enabled(LogLevel::LEVEL_DEBUG)) { Log::debug(__VA_ARGS__); } } } while (0)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <ios>
 #include <iosfwd>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 enum LogLevel {
     LEVEL_ERROR,
@@ -38,32 +61,143 @@ public:
     static void to_console(bool active = true);
     static void to_file(bool active = true);
     static LogLevel get_level();
+    static bool enabled(LogLevel level);
     static void enable_exit_on_error(bool active = true);
+    static void set_async(bool active = true, uint32_t capacity = 4096); // must not be called while other threads are logging
+    static void flush();
 private:
     Log() {}
     ~Log() {}
+    class AsyncSink;
     static void write_log(std::string log_message);
+    static void write_direct(const std::string& log_message);
     static LogLevel log_level;
     static bool log_to_console;
     static bool log_to_file;
     static bool exit_on_error;
     static std::string log_filepath;
+    static std::unique_ptr<AsyncSink> async_sink;
     template <typename Arg> static void concatArgs(std::stringstream& stream, Arg&& arg);
     template <typename First, typename... Args> static void concatArgs(std::stringstream& stream, First&& first, Args&&... args);
 };
 
 
+// asynchronous sink: the logging threads push their messages into a bounded lock-free ring buffer
+// (multi-producer, single-consumer; Vyukov's sequence numbers per slot), a background thread writes them
+// to the console / log file; if the buffer is full, messages are dropped instead of blocking the caller
+class Log::AsyncSink {
+public:
+    explicit AsyncSink(uint32_t capacity) {
+        size_t size = 1;
+        while (size < std::max<uint32_t>(capacity, 2)) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        slots = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread(&AsyncSink::loop, this);
+    }
+
+    ~AsyncSink() {
+        stopping.store(true, std::memory_order_release);
+        writer.join(); // (the remaining messages are written first)
+    }
+
+    // returns false if the buffer is full
+    bool push(std::string& message) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->message = std::move(message);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // blocks until all messages that have been pushed before the call are written
+    void flush() {
+        size_t target = tail.load(std::memory_order_acquire);
+        while (written.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence = 0;
+        std::string message;
+    };
+
+    bool pop(std::string& message) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        message = std::move(slot.message);
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    void loop() {
+        std::string message;
+        while (true) {
+            if (pop(message)) {
+                write_direct(message);
+                written.fetch_add(1, std::memory_order_release);
+                continue;
+            }
+            size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+            if (lost > 0) {
+                write_direct("[WARNING]: \033[33m" + std::to_string(lost) + " log message(s) dropped (asynchronous log buffer full)\033[0m");
+            }
+            if (stopping.load(std::memory_order_acquire) && head == tail.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> tail = 0;   // next slot for the producers
+    alignas(64) size_t head = 0;                // next slot for the writer thread
+    std::atomic<size_t> written = 0;
+    std::atomic<size_t> dropped = 0;
+    std::atomic<bool> stopping = false;
+    std::thread writer;
+};
+
+
 // +-----------------------------------+
 // |  Definitions of member functions  |
 // +-----------------------------------+
 
 template <typename... Args>
-static void Log::error(Args&&... args) {
+void Log::error(Args&&... args) {
     if (log_level == LogLevel::LEVEL_SILENT) { return; }
     std::stringstream stream;
     concatArgs(stream, std::forward<Args>(args)...);
     std::string log_message = "[ERROR]:   \033[31m" + stream.str() + "\033[0m"; // red
     write_log(log_message);
+    flush(); // (errors are written before the program continues with the exception or exits)
     if (exit_on_error) {
         exit(EXIT_FAILURE);
     }
@@ -73,40 +207,43 @@ static void Log::error(Args&&... args) {
 }
 
 template <typename... Args>
-static void Log::warning(Args&&... args) {
-    if (log_level == LogLevel::LEVEL_SILENT) { return; }
-    else if (log_level >= LogLevel::LEVEL_WARNING) {
-        std::stringstream stream;
-        concatArgs(stream, std::forward<Args>(args)...);
-        std::string log_message = "[WARNING]: \033[33m" + stream.str() + "\033[0m"; // yellow
-        write_log(log_message);
+void Log::warning(Args&&... args) {
+    if constexpr (LOG_COMPILE_LEVEL >= LogLevel::LEVEL_WARNING) {
+        if (enabled(LogLevel::LEVEL_WARNING)) {
+            std::stringstream stream;
+            concatArgs(stream, std::forward<Args>(args)...);
+            std::string log_message = "[WARNING]: \033[33m" + stream.str() + "\033[0m"; // yellow
+            write_log(log_message);
+        }
     }
 }
 
 template <typename... Args>
-static void Log::info(Args&&... args) {
-    if (log_level == LogLevel::LEVEL_SILENT) { return; }
-    else if (log_level >= LogLevel::LEVEL_INFO) {
-        std::stringstream stream;
-        concatArgs(stream, std::forward<Args>(args)...);
-        std::string log_message = "[INFO]:    \033[32m" + stream.str() + "\033[0m"; // green
-        write_log(log_message);
+void Log::info(Args&&... args) {
+    if constexpr (LOG_COMPILE_LEVEL >= LogLevel::LEVEL_INFO) {
+        if (enabled(LogLevel::LEVEL_INFO)) {
+            std::stringstream stream;
+            concatArgs(stream, std::forward<Args>(args)...);
+            std::string log_message = "[INFO]:    \033[32m" + stream.str() + "\033[0m"; // green
+            write_log(log_message);
+        }
     }
 }
 
 template <typename... Args>
-static void Log::debug(Args&&... args) {
-    if (log_level == LogLevel::LEVEL_SILENT) { return; }
-    else if (log_level >= LogLevel::LEVEL_DEBUG) {
-        std::stringstream stream;
-        concatArgs(stream, std::forward<Args>(args)...);
-        std::string log_message = "[DEBUG]:   \033[34m" + stream.str() + "\033[0m"; // blue
-        write_log(log_message);
+void Log::debug(Args&&... args) {
+    if constexpr (LOG_COMPILE_LEVEL >= LogLevel::LEVEL_DEBUG) {
+        if (enabled(LogLevel::LEVEL_DEBUG)) {
+            std::stringstream stream;
+            concatArgs(stream, std::forward<Args>(args)...);
+            std::string log_message = "[DEBUG]:   \033[34m" + stream.str() + "\033[0m"; // blue
+            write_log(log_message);
+        }
     }
 }
 
 template <typename... Args>
-static void Log::force(Args&&... args) {
+void Log::force(Args&&... args) {
     std::stringstream stream;
     concatArgs(stream, std::forward<Args>(args)...);
     std::string log_message = stream.str();
@@ -133,7 +270,38 @@ void Log::to_file(bool active) {
     log_to_file = active;
 }
 
+void Log::enable_exit_on_error(bool active) {
+    exit_on_error = active;
+}
+
+// switches between synchronous writes (default) and the asynchronous sink with a ring buffer
+// of the given capacity (rounded up to a power of two); disabling the sink writes the pending messages
+void Log::set_async(bool active, uint32_t capacity) {
+    async_sink.reset();
+    if (active) {
+        async_sink = std::make_unique<AsyncSink>(capacity);
+    }
+}
+
+// blocks until the pending messages of the asynchronous sink are written
+void Log::flush() {
+    if (async_sink) {
+        async_sink->flush();
+    }
+}
+
 void Log::write_log(std::string log_message) {
+    if (!log_to_file && !log_to_console) {
+        return;
+    }
+    if (async_sink) {
+        async_sink->push(log_message); // (a message that doesn't fit is dropped and reported by the writer thread)
+        return;
+    }
+    write_direct(log_message);
+}
+
+void Log::write_direct(const std::string& log_message) {
     if (log_to_file) {
         std::ofstream file_stream(log_filepath, std::ios_base::app);
         if (file_stream.good()) {
@@ -156,6 +324,11 @@ LogLevel Log::get_level() {
     return log_level;
 }
 
+// returns true if messages of the given level are written with the current runtime level
+bool Log::enabled(LogLevel level) {
+    return log_level != LogLevel::LEVEL_SILENT && log_level >= level;
+}
+
 template <typename Arg>
 void Log::concatArgs(std::stringstream& stream, Arg&& arg) {
     stream << std::forward<Arg>(arg);
@@ -173,5 +346,6 @@ bool Log::log_to_console = true;
 bool Log::log_to_file = false;
 bool Log::exit_on_error = false;
 std::string Log::log_filepath = "../logs/";
+std::unique_ptr<Log::AsyncSink> Log::async_sink;
 
-#endif
\ No newline at end of file
+#endif
@@ -8,19 +8,40 @@
 #define NOMINMAX
 #define DEFAULT_WORKGROUP_SIZE_1D 256	// default workgroup_size_x for 1d dispatch; can be changed via set_workgroup_size_1d() method
 #define DEFAULT_WORKGROUP_SIZE_2D 16	// default workgroup_size_x for 2d dispatch; can be changed via set_workgroup_size_2d() method
-#define MAX_DESCRIPTOR_SET_COUNT 10 // max number of descriptor sets within the shared singleton descriptor pool
+#define MAX_DESCRIPTOR_SET_COUNT 64 // max number of descriptor sets within the descriptor pool of each thread (= max number of batched dispatches per submit without push descriptors)
+#define MAX_DESCRIPTOR_SET_BINDINGS 12 // max number of buffer bindings per descriptor set (used for sizing the descriptor pools)
+#define DEFAULT_HOST_THRESHOLD_ELEMENTWISE 16384 // grids up to this size run elementwise arithmetic on the host; can be changed via set_host_threshold()
+#define DEFAULT_HOST_THRESHOLD_ACTIVATION 8192 // same for activation functions and derivatives
+#define DEFAULT_HOST_THRESHOLD_REDUCTION 32768 // same for full reductions
 
 #include <algorithm>
 #include <angular.h>            // custom class for angular units
+#include <atomic>
+#include <cdf.h>                // cumulative distribution functions (host versions of the cdf_* methods)
+#include <chrono>
+#include <concepts>
 #include <cmath>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
 #include <functional>
+#include <future>
+#include <hostkernels.h>        // SIMD kernels of the host backend (with <threadpool.h>)
 #include <initializer_list>
 #include <iostream>
 #include <log.h>                // custom logging class
+#include <map>
+#include <memory>
+#include <mutex>
+#include <pdf.h>                // probability density functions (host versions of the pdf_* methods)
 #include <rnd.h>                // custom random number generator
 #include <set>
+#include <source_location>
+#include <span>
 #include <string>
+#include <thread>
 #include <utility>              // for std::swap and std::move
 #include <vector>
 #include <vkcontext.h>          // custom high-level wrapper library for Vulkan context
@@ -31,7 +52,14 @@
 #include <spirv_bin_precompiled.h> // fallback include for spirv_bin.h if not found in the include path
 #endif
 
-#include <Windows.h>
+#ifdef _WIN32
+#include <Windows.h>            // also used for memory-mapped grid files
+#else
+#include <fcntl.h>              // open() and mmap() for memory-mapped grid files
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include <bit>
 #include <cstdlib>
 #include <limits>
@@ -45,7 +73,7 @@ public:
 	// | Constructors & Destructors      |
 	// +=================================+
 	NGrid();                                        // default constructor (initilizes an empty array)
-	template<typename... Args> NGrid(Args... args); // parametric default constructor for multi-dimensional array, overload for variadic template
+	template<typename... Args> requires (std::integral<Args> && ...) NGrid(Args... args); // parametric default constructor for multi-dimensional array, overload for variadic template (integral sizes only)
 	NGrid(const std::vector<uint32_t>& shape);      // parametric default constructor for multi-dimensional array, overload for std::vector
 	NGrid(std::initializer_list<uint32_t> shape);   // parametric default constructor for multi-dimensional array, overload for std::initializer_list
 	NGrid(std::vector<float_t> source_vector);      // construct 1d array and directly fill it with the contents of a std::vector<float_t>
@@ -76,6 +104,9 @@ public:
 	std::vector<float_t> get(const uint32_t read_elements, const uint32_t source_offset_elements) const;
 	Buffer<float_t>* get_buffer() const;
 	Buffer<uint32_t>* get_shape_buffer() const;
+	std::span<float_t> map();                   // zero-copy host access to the grid data (call unmap() after writing)
+	void unmap();
+	std::span<const float_t> view() const;      // zero-copy read-only host access to the grid data
 	uint32_t get_dimensions() const;
 	uint32_t get_size(uint32_t dimension = 0) const;
 	uint32_t get_elements() const;
@@ -98,6 +129,9 @@ public:
 	void fill_range(const float_t start = 0.0f, const float_t step = 1.0f);
 	void fill_dropout(float_t ratio = 0.2f);
 	void fill_index();
+	static void set_random_seed(uint64_t seed);  // makes the random fills reproducible (also resets the stream offset)
+	static uint64_t get_random_offset();         // stream offset of the next random fill
+	static void set_random_offset(uint64_t offset); // e.g. to regenerate a dropout mask instead of storing it
 
 	// +=================================+   
 	// | Neural Net Weight Initialization|
@@ -115,22 +149,29 @@ public:
 	float_t max() const;
 	float_t maxabs() const;
 	float_t mean() const;
+	NGrid mean(const uint32_t axis) const; // mean values along the given axis
 	float_t median() const;
+	float_t quantile(const float_t q) const;
 	float_t var(bool sample_var = true) const;
 	float_t stdev() const;
 	float_t kurt() const;
 	float_t skew() const;
+	struct Moments { float_t count = 0, mean = 0, M2 = 0, M3 = 0, M4 = 0; }; // M2..M4 = sums of the powers of deviations from the mean
+	Moments moments() const; // count, mean and central moment sums of all elements with a single reduction
 
 	// +=================================+   
 	// | Addition                        |
 	// +=================================+
 	float_t sum() const; // returns the sum of all array elements
+	NGrid sum(const uint32_t axis) const; // returns the sums along the given axis
 	NGrid operator+(const float_t value) const;
 	NGrid operator+(const NGrid& other) const;
 	NGrid& operator++(); // prefix increment
 	NGrid operator++(int); // postfix increment
 	void operator+=(const float_t value);
 	void operator+=(const NGrid& other);
+	void add_into(NGrid& out, const float_t value) const; // out = this + value (out may be *this)
+	void add_into(NGrid& out, const NGrid& other) const;
 
 	// +=================================+   
 	// | Substraction                    |
@@ -141,6 +182,8 @@ public:
 	NGrid operator--(int); // postfix decrement
 	void operator-=(const float_t value);
 	void operator-=(const NGrid& other);
+	void subtract_into(NGrid& out, const float_t value) const;
+	void subtract_into(NGrid& out, const NGrid& other) const;
 
 	// +=================================+   
 	// | Multiplication                  |
@@ -151,8 +194,10 @@ public:
 	NGrid operator*(const NGrid& other) const;  // alias for matrix product
 	void operator*=(const NGrid& other);        // "equals matrix product"
 	float_t scalar_product(const NGrid& other) const;
-	NGrid matrix_product(const NGrid& other) const;
+	NGrid matrix_product(const NGrid& other) const; // 2d or batched 3d {batch, m, n}
 	NGrid Hadamard_product(const NGrid& other) const;
+	void multiply_into(NGrid& out, const float_t factor) const;
+	void Hadamard_product_into(NGrid& out, const NGrid& other) const;
 
 	// +=================================+   
 	// | Division                        |
@@ -161,12 +206,15 @@ public:
 	void operator/=(const float_t quotient);
 	NGrid Hadamard_division(const NGrid& other);
 	NGrid operator/(const NGrid& other) const; // alias for the matrix product with the inverse of 'other'
+	void divide_into(NGrid& out, const float_t quotient) const;
+	void Hadamard_division_into(NGrid& out, const NGrid& other) const;
 
 	// +=================================+   
 	// | Modulo                          |
 	// +=================================+
 	void operator%=(const float_t value);
 	NGrid operator%(const float_t num) const;
+	void modulo_into(NGrid& out, const float_t value) const;
 
 	// +=================================+   
 	// | Exponentiation & Logarithm      |
@@ -176,6 +224,8 @@ public:
 	void operator^=(const float_t exponent);
 	NGrid pow(const NGrid& other) const;
 	NGrid operator^(const NGrid& other) const;
+	void pow_into(NGrid& out, const float_t exponent) const;
+	void pow_into(NGrid& out, const NGrid& other) const;
 	NGrid sqrt() const;
 	NGrid log(float_t base = 2.718282) const;
 	NGrid exp() const;
@@ -208,6 +258,7 @@ public:
 	NGrid cosh() const;
 	NGrid sinh() const;
 	NGrid tanh() const;
+	void tanh_into(NGrid& out) const;
 	NGrid acosh() const;
 	NGrid asinh() const;
 	NGrid atanh() const;
@@ -221,6 +272,16 @@ public:
 	uint32_t find(const float_t& value) const;
 	NGrid sign() const;
 
+	// +=================================+   
+	// | Scan, Stream Compaction         |
+	// +=================================+
+	NGrid cumsum() const;                       // inclusive prefix sums of all elements (in memory order), same shape as the source
+	NGrid cumprod() const;                      // inclusive prefix products of all elements (in memory order)
+	uint32_t count_nonzero() const;
+	NGrid where(const NGrid& mask, bool return_indices = false) const; // 1d grid with the values (or flat indices) where mask != 0
+	std::vector<uint32_t> histogram(uint32_t bins, float_t lower, float_t upper) const; // equal-width bins over [lower, upper]
+	std::vector<uint32_t> histogram(uint32_t bins) const; // range = [min(), max()]
+
 	// +=================================+   
 	// | Scaling                         |
 	// +=================================+
@@ -252,6 +313,15 @@ public:
 	NGrid relu(float_t alpha = 0.01) const;             NGrid relu_drv(float_t alpha = 0.01) const;
 	NGrid tanh_drv() const;
 
+	// variants with a preallocated result grid of the same shape (may be *this for in-place updates)
+	void activation_into(NGrid& out, ActFunc activation_function) const;
+	void derivative_into(NGrid& out, ActFunc activation_function) const;
+	void ident_into(NGrid& out) const;                  void ident_drv_into(NGrid& out) const;
+	void sigmoid_into(NGrid& out) const;                void sigmoid_drv_into(NGrid& out) const;
+	void elu_into(NGrid& out, float_t alpha = 0.01) const; void elu_drv_into(NGrid& out, float_t alpha = 0.01) const;
+	void relu_into(NGrid& out, float_t alpha = 0.01) const; void relu_drv_into(NGrid& out, float_t alpha = 0.01) const;
+	void tanh_drv_into(NGrid& out) const;
+
 	// +=================================+   
 	// | Outlier Treatment               |
 	// +=================================+
@@ -296,7 +366,9 @@ public:
 	NGrid padding(const uint32_t amount, const float_t init_value = 0.0f) const;
 	NGrid stationary(const uint32_t degree = 1) const;
 	NGrid stationary_log(const float_t log_base = 10, const uint32_t degree = 1) const;
+	NGrid stationary_batched(const uint32_t degree = 1) const;
 	NGrid sort(const bool ascending = true) const;
+	NGrid argsort(const bool ascending = true) const;
 	NGrid pool_max(const std::vector<uint32_t>& window_shape, const std::vector<uint32_t>& stride_shape = {}) const;
 	NGrid pool_max(const std::initializer_list<uint32_t>& window_shape, const std::initializer_list<uint32_t>& stride_shape = {}) const;
 	NGrid pool_maxabs(const std::vector<uint32_t>& window_shape, const std::vector<uint32_t>& stride_shape = {}) const;
@@ -324,6 +396,30 @@ public:
 	float_t Dickey_Fuller() const;
 	float_t Engle_Granger(const NGrid& other) const;
 	float_t covariance(const NGrid& other) const;
+	NGrid regression_batched(const NGrid& other, const bool sample = true) const;
+	NGrid Dickey_Fuller_batched() const;
+	NGrid Engle_Granger_batched(const NGrid& other) const;
+	NGrid rolling_mean(const uint32_t window, const uint32_t step = 1) const;
+	NGrid rolling_var(const uint32_t window, const uint32_t step = 1, const bool sample = true) const;
+	NGrid rolling_regression(const NGrid& other, const uint32_t window, const uint32_t step = 1) const;
+
+	// +=================================+   
+	// | Probability Distributions       |
+	// +=================================+
+	NGrid pdf_gaussian(const float_t mu = 0, const float_t sigma = 1) const;
+	NGrid pdf_cauchy(const float_t x_peak = 0, const float_t gamma = 1) const;
+	NGrid pdf_laplace(const float_t mu = 0, const float_t sigma = 1) const;
+	NGrid pdf_pareto(const float_t alpha = 1, const float_t tail_index = 1) const;
+	NGrid pdf_lomax(const float_t alpha = 1, const float_t tail_index = 1) const;
+	NGrid pdf_F_distribution(const float_t d1, const float_t d2) const;
+	NGrid pdf_poisson(const float_t lambda) const;
+	NGrid cdf_gaussian(const float_t mu = 0, const float_t sigma = 1) const;
+	NGrid cdf_cauchy(const float_t x_peak = 0, const float_t gamma = 1) const;
+	NGrid cdf_laplace(const float_t mu = 0, const float_t sigma = 1) const;
+	NGrid cdf_pareto(const float_t alpha = 1, const float_t tail_index = 1) const;
+	NGrid cdf_lomax(const float_t alpha = 1, const float_t tail_index = 1) const;
+	NGrid cdf_F_distribution(const float_t d1, const float_t d2) const;
+	NGrid cdf_poisson(const float_t lambda) const;
 
 	// +=================================+   
 	// | Miscellaneous                   |
@@ -332,40 +428,912 @@ public:
 	static void set_workgroup_size_1d(uint32_t size);
 	static void set_workgroup_size_2d(uint32_t size);
 	static void set_fence_timeout_nanosec(uint64_t timeout);
+	static uint32_t get_thread_queue_index();
+
+	// +=================================+   
+	// | Devices                         |
+	// +=================================+
+	static void set_current_device(uint32_t device_index);
+	static uint32_t get_current_device();
+	static uint32_t get_device_count();
+	static const VkPhysicalDeviceProperties& get_device_properties(); // properties of the current device (name, limits, ...)
+	uint32_t get_device_index() const;
+	class Sharded;                              // grid that is split along axis 0 across several devices (forward declaration)
+
+	// memory residency policy for the data buffers of newly created grids
+	enum Residency {
+		AUTO_RESIDENCY,         // host-visible device memory if available on a large heap (ReBAR/UMA), otherwise device-local
+		HOST_VISIBLE_RESIDENCY, // device-local + host-visible memory, accessed directly by the host
+		DEVICE_LOCAL_RESIDENCY  // pure device-local memory, host access via staging buffers on the transfer queue
+	};
+	static void set_default_residency(Residency residency);
+	bool is_device_local() const;
+	static NGrid sparse_resident(const std::vector<uint32_t>& shape); // device memory only for the pages that are made resident
+	bool is_sparse_resident() const;
+	uint32_t make_resident(uint32_t first_element, uint32_t count); // binds memory to the pages of the range (returns the new pages)
+	uint32_t make_resident(const std::vector<uint32_t>& tile_offset, const std::vector<uint32_t>& tile_shape);
+	uint32_t evict(uint32_t first_element, uint32_t count);         // releases the pages within the range (returns the released pages)
+	uint32_t evict(const std::vector<uint32_t>& tile_offset, const std::vector<uint32_t>& tile_shape);
+	uint32_t get_resident_pages() const;
+	uint32_t get_page_elements() const;
+
+	// +=================================+   
+	// | Host Backend                    |
+	// +=================================+
+	enum HostOp : uint32_t {                    // operation classes of the host backend, with a size threshold each
+		HOST_ELEMENTWISE,                       // arithmetic with scalars and grids of the same shape, cumsum, cumprod, where
+		HOST_ACTIVATION,                        // relu, sigmoid, tanh and their derivatives, pdf_* and cdf_*
+		HOST_REDUCTION,                         // sum, min, max, maxabs (and the methods that are based on them), count_nonzero
+		HOST_OP_COUNT
+	};
+	static void set_host_threshold(HostOp op, uint32_t max_elements); // ops on host-visible grids up to this size run on the host (0 = never)
+	static uint32_t get_host_threshold(HostOp op);
+	static void set_host_threads(uint32_t threads); // threads of the host backend (0 = hardware concurrency)
+
+	// +=================================+   
+	// | Batched Execution               |
+	// +=================================+
+	class Batch;                                // RAII scope for batched execution (forward declaration)
+	static void begin_batch();
+	static void end_batch();
+	static void flush();
+	static bool is_batching();
+
+	// +=================================+   
+	// | Compute Graphs                  |
+	// +=================================+
+	class Graph;                                // reusable recording of a sequence of operations (forward declaration)
+	static Graph capture(const std::function<void()>& operations);
+	static bool is_capturing();
+	static uint32_t get_captured_dispatches();  // dispatches recorded so far by the active capture (= index of the next one)
+
+	// +=================================+   
+	// | Lazy Elementwise Expressions    |
+	// +=================================+
+	class Expr;                                 // lazy elementwise expression with kernel fusion (forward declaration)
+	Expr lazy() const;
+
+	// +=================================+   
+	// | Asynchronous Results            |
+	// +=================================+
+	class Async;                                // future-like handle for asynchronously computed scalar results (forward declaration)
+	Async sum_async() const;
+	Async mean_async() const;
+	Async var_async(bool sample_var = true) const;
+	Async scalar_product_async(const NGrid& other) const;
+	Async Dickey_Fuller_async() const;
+	static void wait_async();
+
+	// +=================================+   
+	// | Packed Storage Types            |
+	// +=================================+
+	enum ElementType : uint32_t {               // storage element types of packed grids (must match element_types.inc)
+		FP32, FP16, BF16, INT32, INT8, UINT8
+	};
+	class Packed;                               // grid data in a compact storage element type (forward declaration)
+	Packed pack(ElementType type) const;
+
+	// +=================================+   
+	// | Sparse Matrices                 |
+	// +=================================+
+	class Sparse;                               // sparse matrix in compressed sparse row format (forward declaration)
+	Sparse to_sparse(float_t threshold = 0.0f) const;
+	Sparse to_sparse(const NGrid& mask) const;
+
+	// +=================================+   
+	// | Convolution                     |
+	// +=================================+
+	enum ConvAlgorithm : uint32_t {             // algorithms of the convolution engine
+		CONV_AUTO,                              // chosen from the shapes (heuristic or autotuning table)
+		CONV_DIRECT,                            // shared memory tiles; kernels up to 9x9, strides up to 2
+		CONV_WINOGRAD,                          // Winograd F(2x2, 3x3); 3x3 kernels with stride 1
+		CONV_IM2COL,                            // im2col + tiled matrix product
+		CONV_FFT                                // FFT-based; large kernels
+	};
+	NGrid conv2d(const NGrid& weights, uint32_t stride = 1, uint32_t padding = 0, ConvAlgorithm algorithm = CONV_AUTO) const;
+	ConvAlgorithm conv2d_algorithm(const NGrid& weights, uint32_t stride = 1, uint32_t padding = 0) const;
+	static void set_conv_autotuning(bool enabled);
+
+	// +=================================+   
+	// | Strided Views                   |
+	// +=================================+
+	class View;                                 // zero-copy strided view of the grid data (forward declaration)
+	View as_view() const;
+	View subgrid_view(const std::vector<uint32_t>& source_offset, const std::vector<uint32_t>& subgrid_shape) const;
+	View transpose_view(const std::vector<uint32_t>& target_axis_order = { 1,0 }) const;
+	View reshape_view(const std::vector<uint32_t>& new_shape) const;
+	View flatten_view() const;
+	View mirror_view(const std::vector<bool>& mirror_axes) const;
+
+	// +=================================+   
+	// | Binary Files                    |
+	// +=================================+
+	class File;                                 // memory-mapped grid file for (partial) loading (forward declaration)
+	void save(const std::string& filepath, ElementType type = FP32, uint32_t chunk_rows = 0) const;
+	static NGrid load(const std::string& filepath);
+
+	// +=================================+   
+	// | Out-of-Core Streaming           |
+	// +=================================+
+	class Streaming;                            // chunked execution over host arrays larger than device memory (forward declaration)
 
 protected:
 
 	// +=================================+   
 	// | Protected Class Members         |
 	// +=================================+
+	struct GemmVariant {                        // kernel variant and dispatch size of the tiled matrix product
+		uint32_t wg_x = 16, wg_y = 16, thread_m = 1, thread_n = 1, tile_k = 16, vec4_loads = 0;
+		uint32_t groups_x = 1, groups_y = 1;
+	};
+	enum ReductionOp { REDUCE_SUM, REDUCE_MIN, REDUCE_MAX, REDUCE_MAXABS, REDUCE_MOMENTS }; // must match reduce.comp
+	enum ScanOp { SCAN_SUM, SCAN_PRODUCT, SCAN_COUNT }; // SCAN_COUNT: counts of the elements != 0 (COUNT variant of scan.comp)
+	enum SeriesMode { SERIES_DIFFERENCE, SERIES_REGRESSION, SERIES_DICKEY_FULLER, SERIES_ENGLE_GRANGER }; // must match series_stats.comp
+	enum RollingMode { ROLLING_MEAN, ROLLING_VAR, ROLLING_REGRESSION }; // must match rolling.comp
+	enum Distribution { DIST_GAUSSIAN, DIST_CAUCHY, DIST_LAPLACE, DIST_PARETO, DIST_LOMAX, DIST_F, DIST_POISSON }; // must match distribution.comp
+	struct ReductionResources {                 // temporary objects of recorded reduction levels or passes (kept until completion)
+		std::vector<std::unique_ptr<DescriptorSet>> sets;
+		std::vector<std::unique_ptr<PushConstants>> constants;
+		std::vector<std::unique_ptr<ComputePipeline>> pipelines;
+		std::vector<std::unique_ptr<Buffer<float_t>>> buffers;
+	};
+	struct ConvShape {                          // geometry of a (batched, multi-channel) 2D cross-correlation
+		uint32_t batches = 1, in_channels = 1, out_channels = 1;
+		uint32_t height = 1, width = 1, kernel_h = 1, kernel_w = 1, out_h = 1, out_w = 1;
+		uint32_t stride = 1, padding_y = 0, padding_x = 0;
+		uint32_t batch_planes = 1, channel_planes = 1, plane_offset = 0, total_planes = 1; // addressing of the input planes
+	};
+	struct Context;                             // per-thread execution state (forward declaration)
+	struct RandomStream {                       // seed and offset of a random fill as push constant words
+		uint32_t seed_lo = 0, seed_hi = 0, offset_lo = 0, offset_hi = 0;
+	};
 	static VulkanManager* manager;              // shared singleton manager for instance, device and command pool
-	static DescriptorPool* descriptor_pool;	    // shared singleton descriptor pool for command buffer
 	static uint32_t workgroup_size_1d;          // default workgroup size for 1d dispatch
 	static uint32_t workgroup_size_2d;          // default workgroup size for 2d dispatch
 	static uint64_t fence_timeout_nanosec;      // timeout for waiting for the fence to be signaled
+	static Residency default_residency;         // memory residency policy for new data buffers
+	static std::atomic<uint32_t> host_thresholds[HOST_OP_COUNT]; // max. elements per op class that run on the host (see set_host_threshold())
+	static bool conv_autotuning;                // true if CONV_AUTO times the supported algorithms on first use of a shape
+	static std::map<std::vector<uint32_t>, ConvAlgorithm> conv_tuning_table; // fastest algorithm per device and convolution shape
+	static std::mutex conv_tuning_mutex;
+	static std::atomic<uint64_t> random_seed;   // key of the counter-based generator of the random fills (see philox.inc)
+	static std::atomic<uint64_t> random_offset; // stream offset of the next random fill (every fill uses its own stream)
 	std::vector<uint32_t> shape = {};           // shape of the array
 	uint32_t dimensions = 0;                    // number of dimensions
 	uint32_t elements = 0;                      // total number of elements
-	CommandBuffer* command_buffer = nullptr;
-	Buffer<float_t>* data_buffer = nullptr;
+	uint32_t device_index = 0;                  // physical device index of the device that holds the buffers
+	std::shared_ptr<Buffer<float_t>> data_buffer; // shared with strided views of the grid (see NGrid::View)
 	Buffer<uint32_t>* shape_buffer = nullptr;
+	bool device_local = false;                  // true if the data buffer isn't host-visible
+	mutable uint64_t async_read_value = 0;      // timeline value of the last asynchronous operation that reads this grid
+	mutable std::shared_ptr<Semaphore> async_read_timeline; // timeline that async_read_value refers to
+	mutable std::vector<float_t> host_shadow;   // host copy of device-local data for map() / view()
+	bool host_shadow_mapped = false;            // true between map() and unmap() of a device-local grid
 
 	// helper methods
-	void create(const std::vector<uint32_t>& shape); // instance creation helper method, shared among constructors
-	static void release_descriptor_pool();      // static method for cleanup of the shared descriptor pool
+	void create(const std::vector<uint32_t>& shape, bool sparse = false); // instance creation helper method, shared among constructors
+	static void init_manager();                 // creates the shared manager on first use (thread-safe)
+	static Context& context();                  // returns the execution context of the calling thread for its current device
+	static Context& context(uint32_t device_index); // returns the execution context of the calling thread for the given device
+	static Device& current_device();
+	static const ShaderModule& shader_module(const unsigned char* binary, size_t size_bytes);
+	static StagingTransfer& get_staging(uint32_t device_index);
+	static Buffer<float_t> scratch_buffer(uint32_t elements);
+	static GemmVariant gemm_variant(uint32_t rows, uint32_t cols, bool aligned);
+	void lu_batched(NGrid& first, NGrid& second, NGrid& third, const bool inverse) const;
+	void check_output(const NGrid& out, const char* method) const;
+	bool on_host(HostOp op, const NGrid& out, const NGrid* other = nullptr) const;
+	const float_t* host_read() const;
+	float_t* host_write();
+	void host_written();
+	void record_reduction(CommandBuffer& command_buffer, DescriptorPool& pool, ReductionResources& resources, ReductionOp op,
+		Buffer<float_t>& output, uint32_t axis = UINT32_MAX, float_t scale = 1.0f) const;
+	static void record_buffer_reduction(CommandBuffer& command_buffer, DescriptorPool& pool, ReductionResources& resources, ReductionOp op,
+		const Buffer<float_t>& input, ElementType input_type, const std::vector<uint32_t>& shape, Buffer<float_t>& output, uint32_t axis, float_t scale);
+	static void submit_reduction(ReductionResources& resources);
+	std::vector<float_t> reduce(ReductionOp op) const;
+	NGrid reduce_axis(ReductionOp op, uint32_t axis, float_t scale = 1.0f) const;
+	NGrid sort_network(const bool ascending, const bool return_indices) const;
+	float_t select_rank(uint32_t rank) const;
+	static void record_scan(ReductionResources& resources, ScanOp op, const Buffer<float_t>& input, Buffer<float_t>& output, uint32_t elements);
+	NGrid scan(ScanOp op) const;
+	NGrid series_stats(SeriesMode mode, const NGrid* other, uint32_t degree, bool sample, const char* method) const;
+	NGrid rolling(RollingMode mode, const NGrid* other, uint32_t window, uint32_t step, bool sample, const char* method) const;
+	NGrid distribution(Distribution dist, bool cumulative, float_t p1, float_t p2) const;
+	static void record_pass(ReductionResources& resources, const ShaderModule& shader, DescriptorSet& set, PushConstants* constants,
+		uint32_t global_size_x, uint32_t global_size_y, uint32_t global_size_z, uint32_t workgroup_size_x, uint32_t workgroup_size_y,
+		const std::vector<uint32_t>& specialization_constants = {}, std::source_location location = std::source_location::current());
+	static DescriptorSet& record_set(ReductionResources& resources, const std::vector<const Buffer<float_t>*>& buffers);
+	ConvShape conv2d_shape(const NGrid& weights, uint32_t stride, uint32_t padding) const;
+	static bool conv_supported(const ConvShape& conv, ConvAlgorithm algorithm);
+	static ConvAlgorithm conv_heuristic(const ConvShape& conv);
+	static ConvAlgorithm select_conv_algorithm(const ConvShape& conv);
+	static std::vector<uint32_t> conv_tuning_key(const ConvShape& conv);
+	static void run_conv2d(const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result, ConvAlgorithm algorithm);
+	static void run_conv2d_auto(const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result);
+	static void record_conv_direct(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result);
+	static void record_conv_winograd(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result);
+	static void record_conv_im2col(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result);
+	static void record_conv_fft(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result);
+	std::vector<std::pair<VkDeviceSize, VkDeviceSize>> tile_ranges(const std::vector<uint32_t>& tile_offset, const std::vector<uint32_t>& tile_shape, const char* method) const;
+	uint32_t change_residency(std::vector<std::pair<VkDeviceSize, VkDeviceSize>> ranges, bool resident, const char* method);
+	void upload(const float_t* source, uint32_t copied_elements, uint32_t target_offset_elements);
+	void download(float_t* target, uint32_t copied_elements, uint32_t source_offset_elements) const;
+	static void release_buffer(Buffer<float_t>*& buffer);
+	static void release_buffer(Buffer<uint32_t>*& buffer);
+	static void release_buffer(std::shared_ptr<Buffer<float_t>>& buffer);
+	static std::shared_ptr<Buffer<float_t>> shared_buffer(Buffer<float_t>* buffer);
+	static bool async_supported();
+	static RandomStream next_random_stream(uint32_t word);
+	static void add_async_dependency(CommandBuffer& command_buffer);
+	static void add_async_dependency(Context& ctx, CommandBuffer& command_buffer);
+	static void flush(Context& ctx);
+	void wait_async_reads() const;
+	static Async begin_async();
+	void record_async_reduction(Async& handle, ReductionOp op) const;
+	static void submit_async(Async& handle, std::function<float_t(const std::vector<float_t>&)> finish);
+	void execute(ComputePipeline& pipeline, DescriptorSet& set, uint32_t global_size_x, uint32_t global_size_y = 1, uint32_t global_size_z = 1, bool host_sync = false,
+		std::source_location location = std::source_location::current()) const;
+	static void dispatch(uint32_t device_index, ComputePipeline& pipeline, DescriptorSet& set, uint32_t global_size_x, uint32_t global_size_y = 1, uint32_t global_size_z = 1, bool host_sync = false,
+		std::source_location location = std::source_location::current());
 	uint32_t flat_index(std::initializer_list<uint32_t> multi_index) const;
 	uint32_t flat_index(const std::vector<uint32_t>& multi_index) const;
 };
 
+// scope guard for batched execution: all NGrid operations within the lifetime
+// of a Batch object are recorded into a single command buffer and submitted at once
+// when the scope ends (or earlier, if a host access requires the results);
+// batch scopes are per thread, i.e. they only collect the operations of the calling thread
+// usage:	{ NGrid::Batch batch; result = (A * 2 + C).relu(); } // single submit here
+class NGrid::Batch {
+public:
+	Batch() { NGrid::begin_batch(); }
+	~Batch() { NGrid::end_batch(); }
+
+	// deleted copy constructor and assignment
+	Batch(const Batch&) = delete;
+	Batch& operator=(const Batch&) = delete;
+};
+
+// lazy elementwise expression: instead of allocating an intermediate grid (and running a separate shader)
+// for every step, an expression only records the operations as a small stack program;
+// on evaluation, the whole expression gets fused into a single pass over memory
+// (interpreted by the 'elementwise_program' compute shader);
+// note: grids referenced by an expression must outlive the expression; multiplication and division
+// of two grids are elementwise (Hadamard) operations in this context, not matrix operations;
+// usage:	NGrid out = (A.lazy() * w + b).relu().eval();
+class NGrid::Expr {
+public:
+	// instruction set of the interpreter shader (must match elementwise_program.comp)
+	enum OpCode : uint32_t {
+		OP_INPUT, OP_CONST, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_POW, OP_MIN, OP_MAX,
+		OP_NEG, OP_ABS, OP_SQRT, OP_EXP, OP_LOG, OP_SIN, OP_COS, OP_TAN, OP_TANH, OP_SIGMOID,
+		OP_RELU, OP_ELU, OP_SIGN, OP_ROUND, OP_FLOOR, OP_CEIL, OP_GREATER, OP_SMALLER, OP_EQUAL
+	};
+	static constexpr uint32_t max_inputs = 8;       // max number of distinct grids per expression
+	static constexpr uint32_t max_stack_depth = 16; // max evaluation stack depth of the interpreter shader
+
+	// constructors
+	Expr() = delete;
+	Expr(const NGrid& grid);
+	Expr(const Packed& packed);
+	Expr(const View& view);
+	Expr(const float_t value);
+
+	// arithmetic
+	friend Expr operator+(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_ADD); }
+	friend Expr operator-(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_SUB); }
+	friend Expr operator*(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_MUL); }
+	friend Expr operator/(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_DIV); }
+	friend Expr operator%(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_MOD); }
+	friend Expr operator>(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_GREATER); }
+	friend Expr operator<(const Expr& a, const Expr& b) { return Expr::combine(a, b, OP_SMALLER); }
+	Expr operator-() const { return this->unary(OP_NEG); }
+
+	// elementwise functions
+	Expr pow(const Expr& exponent) const { return Expr::combine(*this, exponent, OP_POW); }
+	Expr min(const Expr& other) const { return Expr::combine(*this, other, OP_MIN); }
+	Expr max(const Expr& other) const { return Expr::combine(*this, other, OP_MAX); }
+	Expr clamp(const float_t min_value, const float_t max_value) const { return this->max(min_value).min(max_value); }
+	Expr abs() const { return this->unary(OP_ABS); }
+	Expr sqrt() const { return this->unary(OP_SQRT); }
+	Expr exp() const { return this->unary(OP_EXP); }
+	Expr log(float_t base = 2.718282) const;
+	Expr sin() const { return this->unary(OP_SIN); }
+	Expr cos() const { return this->unary(OP_COS); }
+	Expr tan() const { return this->unary(OP_TAN); }
+	Expr tanh() const { return this->unary(OP_TANH); }
+	Expr sigmoid() const { return this->unary(OP_SIGMOID); }
+	Expr relu(float_t alpha = 0.01) const { return Expr::combine(*this, alpha, OP_RELU); }
+	Expr elu(float_t alpha = 0.01) const { return Expr::combine(*this, alpha, OP_ELU); }
+	Expr sign() const { return this->unary(OP_SIGN); }
+	Expr round() const { return this->unary(OP_ROUND); }
+	Expr floor() const { return this->unary(OP_FLOOR); }
+	Expr ceil() const { return this->unary(OP_CEIL); }
+
+	// evaluates the expression with a single dispatch and returns the result as a new grid
+	NGrid eval() const;
+	Packed eval_packed(ElementType type) const; // returns the result in a packed storage element type
+
+	// getters
+	uint32_t get_program_length() const { return static_cast<uint32_t>(program.size()); }
+	uint32_t get_input_count() const { return static_cast<uint32_t>(inputs.size()); }
+
+private:
+	friend class NGrid::View;
+	struct Input {                      // referenced grid (a regular grid, a packed grid or a strided view)
+		const NGrid* grid = nullptr;
+		const Packed* packed = nullptr;
+		const View* view = nullptr;
+		bool operator==(const Input& other) const { return grid == other.grid && packed == other.packed && view == other.view; }
+		const Buffer<float_t>& buffer() const;
+		ElementType type() const;
+		uint32_t elements() const;
+		std::vector<uint32_t> shape() const;
+		bool strided() const;           // true for views that aren't a plain contiguous range from the start of the buffer
+	};
+	static Expr combine(const Expr& a, const Expr& b, OpCode opcode);
+	Expr unary(OpCode opcode) const;
+	uint32_t add_input(const Input& input);
+	void run(const Buffer<float_t>& result, uint32_t device_index, ElementType result_type, const View* result_view = nullptr) const;
+
+	std::vector<uint32_t> program;      // instructions, encoded as (operand << 8) | opcode
+	std::vector<float_t> constants;     // constant pool referenced by OP_CONST instructions
+	std::vector<Input> inputs;          // grids referenced by OP_INPUT instructions
+	uint32_t stack_depth = 0;           // max evaluation stack depth of the program
+};
+
+// grid data in a compact storage element type (fp16, bf16, int32, int8 or uint8), packed into 32-bit words;
+// halves (fp16, bf16) or quarters (int8, uint8) the memory footprint and the bandwidth of memory-bound passes;
+// reductions and fused expressions (see NGrid::Expr) read the packed data directly and compute in fp32,
+// all other operations require the conversion back into a regular grid with unpack();
+// integer types are rounded to nearest and saturated when packed (e.g. uint8 masks of comparison results);
+// packed grids are move-only
+// usage:	NGrid::Packed mask = (A.lazy() > B).eval_packed(NGrid::UINT8); float_t count = mask.sum();
+class NGrid::Packed {
+public:
+	Packed() = default;
+	Packed(const NGrid& source, ElementType type);
+	~Packed();
+	Packed(Packed&& other) noexcept;
+	Packed& operator=(Packed&& other) noexcept;
+
+	// deleted copy constructor and assignment
+	Packed(const Packed&) = delete;
+	Packed& operator=(const Packed&) = delete;
+
+	// conversion and host access
+	NGrid unpack() const;                       // converts the data back into a regular (fp32) grid
+	std::vector<float_t> get() const;           // returns the decoded elements
+	Expr lazy() const;                          // returns a lazy expression that references this grid
+
+	// getters
+	ElementType get_type() const { return type; }
+	std::vector<uint32_t> get_shape() const { return shape; }
+	uint32_t get_elements() const { return elements; }
+	uint32_t get_words() const;                 // number of 32-bit words of the storage buffer
+	uint64_t get_bytes() const { return uint64_t(get_words()) * 4; }
+	uint32_t get_device_index() const { return device_index; }
+	Buffer<float_t>* get_buffer() const { return words; } // storage buffer (the float type only serves as a 32-bit container)
+	static uint32_t elements_per_word(ElementType type);
+
+	// reductions (accumulated in fp32)
+	float_t sum() const;
+	float_t mean() const;
+	float_t min() const;
+	float_t max() const;
+	float_t maxabs() const;
+	Moments moments() const;
+
+private:
+	friend class NGrid;
+	friend class NGrid::Expr;
+	friend class NGrid::File;
+	Packed(const std::vector<uint32_t>& shape, ElementType type); // allocates the storage buffer (uninitialized)
+	std::vector<float_t> reduce(ReductionOp op) const;
+
+	std::vector<uint32_t> shape;
+	uint32_t elements = 0;
+	ElementType type = FP32;
+	uint32_t device_index = 0;
+	Buffer<float_t>* words = nullptr;
+};
+
+// sparse matrix in compressed sparse row (CSR) format: the values of the stored elements (row by row), their column indices
+// and the index of the first stored value of every row (rows + 1 offsets); dense grids are converted by a threshold or a mask
+// (e.g. of fill_dropout() or of a comparison) with a stream compaction on the GPU, COO triplets are converted on the host;
+// products with dense matrices run without expanding the sparse operand, elementwise operations and reductions work on the
+// stored values, i.e. they keep the sparsity pattern; the index buffers are shared by matrices with the same pattern;
+// 1d grids are treated as a single row
+// usage:	NGrid::Sparse S = A.to_sparse(1e-3f); NGrid C = S.matrix_product(B); float_t total = (S * 2.0f).sum();
+class NGrid::Sparse {
+public:
+	Sparse() = default;
+	Sparse(const NGrid& dense, float_t threshold = 0.0f); // keeps the elements with |value| > threshold
+	Sparse(const NGrid& dense, const NGrid& mask);        // keeps the elements with mask value != 0
+	static Sparse from_coo(uint32_t rows, uint32_t cols, const std::vector<uint32_t>& row_indices, const std::vector<uint32_t>& column_indices,
+		const std::vector<float_t>& values);             // (duplicate positions are summed up)
+
+	// conversion and host access
+	NGrid to_dense() const;
+	NGrid row_indices() const;                  // COO row index of every stored value
+	NGrid column_indices() const;               // column index of every stored value
+	std::vector<uint32_t> get_row_offsets() const;
+	std::vector<uint32_t> get_columns() const;
+
+	// getters
+	std::vector<uint32_t> get_shape() const { return { rows, cols }; }
+	uint32_t get_rows() const { return rows; }
+	uint32_t get_cols() const { return cols; }
+	uint32_t get_nonzeros() const { return nonzeros; }
+	float_t get_density() const { return rows * cols == 0 ? 0.0f : float_t(nonzeros) / (float_t(rows) * cols); }
+	const NGrid& get_values() const { return values; } // stored values (shape {nonzeros})
+	uint32_t get_device_index() const { return device_index; }
+
+	// elementwise operations on the stored values (op(0) is assumed to be 0, i.e. the sparsity pattern is kept)
+	Sparse map(std::function<NGrid(const NGrid&)> op) const;
+	Sparse operator*(const float_t factor) const { return map([factor](const NGrid& v) { return v * factor; }); }
+	Sparse operator/(const float_t quotient) const { return map([quotient](const NGrid& v) { return v / quotient; }); }
+	Sparse operator+(const Sparse& other) const; // (same sparsity pattern required)
+	Sparse operator-(const Sparse& other) const;
+	Sparse Hadamard_product(const Sparse& other) const;
+	Sparse Hadamard_product(const NGrid& dense) const; // multiplies every stored value with the dense element at its position
+
+	// reductions over all rows x cols elements (including the elements that aren't stored)
+	float_t sum() const;
+	float_t mean() const;
+	float_t min() const;
+	float_t max() const;
+	float_t maxabs() const;
+
+	// sparse (m x k) x dense (k x n or 1d with k elements) -> dense (m x n)
+	NGrid matrix_product(const NGrid& dense) const;
+
+private:
+	enum ConvertMode : uint32_t { MASK, COMPRESS, DENSE, ROWS, COLUMNS, SAMPLE }; // must match sparse.comp
+	void compress(const NGrid& dense, const NGrid* mask, float_t threshold);
+	void convert(ConvertMode mode, const std::vector<const Buffer<float_t>*>& buffers, uint32_t invocations, float_t threshold = 0.0f, bool host_sync = false) const;
+	Sparse with_values(NGrid new_values) const;   // same pattern, other values
+	void check_pattern(const Sparse& other, const char* method) const;
+
+	uint32_t rows = 0;
+	uint32_t cols = 0;
+	uint32_t nonzeros = 0;
+	uint32_t device_index = 0;
+	NGrid values;
+	std::shared_ptr<const NGrid> columns;       // column index per stored value (uint32_t bits; the grid only serves as a 32-bit container)
+	std::shared_ptr<const NGrid> offsets;       // first stored value per row (rows + 1 entries, uint32_t bits)
+};
+
+// zero-copy strided view of grid data: offset, shape and strides over the reference-counted data buffer of a grid,
+// so that subgrid, select, transpose, reshape, flatten and mirror only change the metadata;
+// a view keeps the buffer alive (also if the grid is destroyed or gets a new buffer) and aliases the grid data,
+// i.e. in-place operations on the grid are visible through the view and assign() writes into the grid;
+// fused expressions (see NGrid::Expr) read views with strided indexing, the data is only copied by contiguous()
+// usage:	NGrid At = A.transpose_view().contiguous(); NGrid B = (A.subgrid_view({ 2, 0 }, { 4, 8 }).lazy() * 2).eval();
+class NGrid::View {
+public:
+	View() = default;
+	View(const NGrid& grid);                    // view of the whole grid
+
+	// zero-copy transformations (metadata only)
+	View subgrid(const std::vector<uint32_t>& source_offset, const std::vector<uint32_t>& subgrid_shape) const;
+	View select(uint32_t axis, uint32_t index) const; // removes an axis, e.g. one matrix of a batch
+	View transpose(const std::vector<uint32_t>& target_axis_order = { 1,0 }) const;
+	View reshape(const std::vector<uint32_t>& new_shape) const; // requires a contiguous view
+	View flatten() const;                       // requires a contiguous view
+	View mirror(const std::vector<bool>& mirror_axes) const;
+	View mirror() const;                        // mirrors all axes
+
+	// data access
+	NGrid contiguous() const;                   // copies the viewed elements into a new grid
+	std::vector<float_t> get() const;           // returns the viewed elements in row-major order
+	Expr lazy() const;                          // returns a lazy expression that references this view
+	void assign(const Expr& expr);              // evaluates an expression into the viewed elements
+	void assign(const NGrid& source);           // copies the elements of a grid into the viewed elements
+
+	// getters
+	std::vector<uint32_t> get_shape() const { return shape; }
+	std::vector<int32_t> get_strides() const { return strides; }
+	uint32_t get_offset() const { return offset; }
+	uint32_t get_dimensions() const { return static_cast<uint32_t>(shape.size()); }
+	uint32_t get_elements() const { return elements; }
+	uint32_t get_device_index() const { return device_index; }
+	Buffer<float_t>* get_buffer() const { return storage.get(); }
+	bool is_contiguous() const;                 // true if the viewed elements are consecutive in row-major order
+	static constexpr uint32_t max_dimensions = 10; // max number of dimensions (must match elementwise_program.comp)
+
+private:
+	friend class NGrid;
+	friend class NGrid::Expr;
+
+	std::shared_ptr<Buffer<float_t>> storage;   // data buffer of the viewed grid
+	std::vector<uint32_t> shape;
+	std::vector<int32_t> strides;               // distance between consecutive elements of each axis (negative if mirrored)
+	uint32_t offset = 0;                        // buffer index of the first viewed element
+	uint32_t elements = 0;
+	uint32_t device_index = 0;
+};
+
+// read access to a binary grid file written by NGrid::save(), via a read-only memory mapping of the file;
+// file layout: header (shape, storage element type, chunking), followed by the payload at an aligned offset;
+// the payload consists of chunks of 'chunk_rows' slices along axis 0, each starting at an aligned offset
+// and stored in the element type of the file (packed words for types other than FP32, see NGrid::Packed);
+// the mapped pages are copied straight into the (staging) buffers of the loaded grids without an intermediate copy,
+// and only the pages of loaded chunks are read from disk, which allows partial reads of huge files;
+// files are move-only; the header is stored in the byte order of the host (little-endian on all supported platforms)
+// usage:	NGrid::File file("weights.ngrid"); NGrid first = file.load_chunk(0); NGrid rows = file.load_rows(100, 20);
+class NGrid::File {
+public:
+	File() = default;
+	File(const std::string& filepath);          // opens and maps the file
+	~File();
+	File(File&& other) noexcept;
+	File& operator=(File&& other) noexcept;
+
+	// deleted copy constructor and assignment
+	File(const File&) = delete;
+	File& operator=(const File&) = delete;
+
+	// loading (decoded into regular fp32 grids on the current device of the calling thread)
+	NGrid load() const;                                  // whole grid
+	NGrid load_chunk(uint32_t chunk) const;              // one chunk of slices along axis 0
+	NGrid load_rows(uint32_t first_row, uint32_t rows) const; // slices [first_row, first_row + rows) along axis 0
+	void close();                                        // unmaps and closes the file
+
+	// getters
+	bool is_open() const { return mapped != nullptr; }
+	std::string get_path() const { return path; }
+	std::vector<uint32_t> get_shape() const { return shape; }
+	ElementType get_type() const { return type; }
+	uint32_t get_elements() const { return elements; }
+	uint32_t get_chunk_rows() const { return chunk_rows; }
+	uint32_t get_chunks() const { return chunks; }
+
+	static constexpr uint32_t max_dimensions = 10;
+	static constexpr uint64_t alignment = 4096; // file offsets of the payload and of the chunks (page size)
+
+private:
+	friend class NGrid;
+
+	struct Header {
+		char magic[4];                          // "NGRD"
+		uint32_t version;
+		uint32_t type;                          // storage element type of the payload
+		uint32_t dimensions;
+		uint32_t shape[max_dimensions];
+		uint32_t elements;
+		uint32_t chunk_rows;                    // slices along axis 0 per chunk
+		uint32_t chunks;
+		uint32_t reserved;
+		uint64_t chunk_bytes;                   // distance between the starts of two chunks
+		uint64_t payload_offset;                // file offset of the first chunk
+	};
+	static constexpr uint32_t version = 1;
+	static uint64_t aligned(uint64_t bytes) { return (bytes + alignment - 1) / alignment * alignment; }
+	uint32_t rows_of_chunk(uint32_t chunk) const;
+	const float_t* chunk_data(uint32_t chunk) const;
+
+	std::string path;
+	std::vector<uint32_t> shape;
+	ElementType type = FP32;
+	uint32_t elements = 0;
+	uint32_t row_elements = 0;                  // elements per slice along axis 0
+	uint32_t chunk_rows = 0;
+	uint32_t chunks = 0;
+	uint64_t chunk_bytes = 0;
+	uint64_t payload_offset = 0;
+	uint64_t file_bytes = 0;
+	const uint8_t* mapped = nullptr;
+#ifdef _WIN32
+	HANDLE file_handle = INVALID_HANDLE_VALUE;
+	HANDLE mapping_handle = nullptr;
+#else
+	int file_descriptor = -1;
+#endif
+};
+
+// future-like handle for the scalar result of an asynchronously submitted operation
+// (see NGrid::sum_async(), NGrid::var_async() etc.);
+// the work gets submitted to the compute queue right away and signals the timeline semaphore of the calling thread on completion,
+// so that the host can continue with other work in the meantime;
+// get() blocks until the result is available, ready() can be used for polling;
+// the semaphore and its value can be passed to CommandBuffer::wait_semaphore() as a dependency for later submits;
+// copies of a handle share the same result; a handle may be waited for from any thread
+// usage:	NGrid::Async total = A.sum_async(); /* ... host work ... */ float_t value = total.get();
+class NGrid::Async {
+public:
+	Async() = default;
+
+	bool valid() const;                         // returns true if the handle refers to a result
+	bool ready() const;                         // returns true if the result is available (non-blocking)
+	void wait() const;                          // blocks until the GPU work has completed
+	float_t get() const;                        // blocks until the result is available and returns it
+	const Semaphore* get_semaphore() const;     // timeline semaphore of the submission (nullptr if computed synchronously)
+	uint64_t get_value() const;                 // timeline value that signals completion
+
+private:
+	friend class NGrid;
+	struct State;                               // GPU resources that need to stay alive until completion
+	static constexpr uint32_t max_dispatches = 16;
+
+	explicit Async(float_t result);             // handle for a result that has already been computed synchronously
+
+	std::shared_ptr<State> state;
+	bool immediate = false;
+	float_t immediate_result = 0;
+};
+
+// resources of an asynchronous submission
+struct NGrid::Async::State {
+	State();
+	~State();
+
+	CommandPool command_pool;                               // own pool, so that the handle can outlive the submitting thread
+	CommandBuffer command_buffer;
+	DescriptorPool pool;
+	std::shared_ptr<Semaphore> timeline;                    // timeline semaphore of the submitting thread
+	ReductionResources resources;                           // objects of the recorded reduction levels
+	std::vector<std::unique_ptr<Buffer<float_t>>> results;  // results of the recorded reductions
+	std::vector<NGrid> keep_alive;                          // temporary grids that are read by the recorded dispatches
+	std::vector<const NGrid*> readers;                      // grids that are read by the recorded dispatches (until submission)
+	std::function<float_t(const std::vector<float_t>&)> finish; // combines the reduction results into the final value
+	uint64_t value = 0;
+	bool submitted = false;
+	bool done = false;
+	float_t result = 0;
+};
+
+// sequence of dispatches that has been recorded once by NGrid::capture() into a reusable command buffer,
+// with resolved pipelines and descriptor sets (similar to CUDA graphs); replay() submits the recording again
+// and waits for completion, without the host cost of running the operations once more;
+// random fills get a new random stream with every replay, other push constants (e.g. scalar operands) can be changed
+// with set_constant(); changed constants only re-record the command buffer (no pipelines or descriptor sets are created);
+// the dispatches refer to the buffers that the grids had during the capture, so these grids must stay alive and keep their shape
+// (temporary grids of the captured expressions are kept alive by the graph); a graph belongs to the thread that captured it
+// usage:	NGrid::Graph step = NGrid::capture([&]() { Y = (X.matrix_product(W) + B).relu(); });
+//			for (...) { X.set(input); step.replay(); }
+class NGrid::Graph {
+public:
+	Graph() = default;
+	Graph(Graph&& other) noexcept;
+	Graph& operator=(Graph&& other) noexcept;
+	~Graph();
+
+	// deleted copy constructor and assignment
+	Graph(const Graph&) = delete;
+	Graph& operator=(const Graph&) = delete;
+
+	void replay();                              // submits the recorded dispatches and waits for completion
+	uint32_t get_dispatch_count() const;
+	bool empty() const { return get_dispatch_count() == 0; }
+
+	// changes a (4-byte) push constant word of a dispatch, e.g. the scalar of 'A + 2.0f' (word 1, after the element count);
+	// the index of a dispatch can be queried with NGrid::get_captured_dispatches() inside the capture
+	template<typename T>
+	void set_constant(uint32_t dispatch, uint32_t word, T value) {
+		static_assert(sizeof(T) == 4, "push constant words have 4 bytes");
+		set_word(dispatch, word, std::bit_cast<uint32_t>(value));
+	}
+
+private:
+	friend class NGrid;
+	struct Node;
+	struct State;
+
+	void set_word(uint32_t dispatch, uint32_t word, uint32_t bits);
+	void record();
+
+	std::unique_ptr<State> state;
+};
+
+// recorded dispatch of a graph; pipeline and layout are owned by the pipeline cache
+struct NGrid::Graph::Node {
+	VkPipeline pipeline = nullptr;
+	VkPipelineLayout layout = nullptr;
+	uint32_t workgroups_x = 1, workgroups_y = 1, workgroups_z = 1;
+	std::unique_ptr<DescriptorSet> set;
+	VkPushConstantRange range = {};
+	std::vector<uint32_t> constants;            // push constant words
+	uint32_t random_word = UINT32_MAX;          // position of the random stream of a random fill (4 words, see RandomStream)
+};
+
+// resources of a graph (also the state of an active capture, see NGrid::Context::capture)
+struct NGrid::Graph::State {
+	State(Context& ctx);
+	~State();
+	void add(ComputePipeline& pipeline, DescriptorSet& set, uint32_t global_size_x, uint32_t global_size_y, uint32_t global_size_z);
+
+	Context* ctx = nullptr;                     // execution context of the capturing thread (owns the pools)
+	CommandBuffer command_buffer;               // reusable recording of all nodes
+	std::vector<Node> nodes;
+	std::vector<Buffer<float_t>*> data_buffers; // buffers that have been released during the capture (still referenced by the nodes)
+	std::vector<Buffer<uint32_t>*> shape_buffers;
+	struct PendingStream {
+		RandomStream stream;
+		uint32_t word;                          // position of the stream within the push constants of the fill
+	};
+	std::vector<PendingStream> pending_streams; // random streams that have been drawn since the last captured dispatch
+	bool dirty = false;                         // push constants have changed since the last recording
+};
+
+// per-thread and per-device execution state (see NGrid::context());
+// command pools, descriptor pools and queues are externally synchronized Vulkan objects, so every thread that runs
+// NGrid operations gets its own pools, batch scope and timeline semaphore for each device it uses; the threads are assigned round-robin
+// to the queues of the compute queue family, so that independent grids on different threads run concurrently;
+// a grid may be used by any thread, but not by two threads at the same time
+struct NGrid::Context {
+	Context(uint32_t device_index);
+	~Context();
+
+	uint32_t device_index = 0;                  // physical device index (see VulkanManager::get_device())
+	Device* device = nullptr;
+	uint32_t queue_index = 0;                   // index of the compute queue that this thread submits to
+	CommandPool command_pool;
+	CommandBuffer command_buffer;               // command buffer for direct submission
+	CommandBuffer batch_command_buffer;         // command buffer for batched execution
+	DescriptorPool descriptor_pool;
+	uint32_t batch_depth = 0;                   // nesting depth of active batch scopes (0 = direct submission)
+	uint32_t batch_recorded_dispatches = 0;     // number of dispatches recorded since the last flush
+	std::vector<DescriptorSet> batch_pending_sets;              // descriptor sets in use by recorded dispatches
+	std::vector<Buffer<float_t>*> batch_pending_data_buffers;   // data buffers with deferred deletion
+	std::vector<Buffer<uint32_t>*> batch_pending_shape_buffers; // shape buffers with deferred deletion
+	Graph::State* capture = nullptr;            // active capture of the calling thread (see NGrid::capture())
+	std::shared_ptr<Semaphore> async_timeline;  // timeline semaphore that is signaled by asynchronous submissions
+	uint64_t async_timeline_value = 0;          // last value that has been scheduled for signaling the timeline
+	std::unique_ptr<CommandPool> transfer_pool; // command pool of the transfer queue family for the staging helper (created on first use)
+	std::unique_ptr<StagingTransfer> staging;   // staging helper for transfers to and from device-local memory (created on first use)
+
+	static uint32_t assign_queue(Device& device);
+	static std::atomic<uint32_t> next_queue;    // counter for the round-robin queue assignment
+	static thread_local Context* current;       // context of the current device of the calling thread (nullptr if not selected yet or already destroyed)
+};
+
+
+// grid that is split along axis 0 into contiguous shards on several physical devices (one NGrid per shard);
+// elementwise operations and reductions run shard-locally on all devices concurrently (on one worker thread per device),
+// the partial results of reductions, matrix products and concatenations are combined via host memory;
+// binary operations on two sharded grids require the same partitioning (same shape and devices);
+// note: the functions that are passed to map() and for_each() run on the worker threads and must not use Sharded methods themselves
+// usage:	NGrid::Sharded X = NGrid::Sharded::scatter(A, { 0, 1 }); float_t total = (X * 2.0f).sum();
+class NGrid::Sharded {
+public:
+	// constructors
+	Sharded() = default;
+	Sharded(const std::vector<uint32_t>& shape, const std::vector<uint32_t>& device_indices);
+	Sharded(const Sharded& other);
+	Sharded(Sharded&& other) noexcept = default;
+	Sharded& operator=(const Sharded& other);
+	Sharded& operator=(Sharded&& other) noexcept = default;
+	static Sharded scatter(const NGrid& source, const std::vector<uint32_t>& device_indices);
+
+	// host access
+	NGrid gather() const;                       // combines the shards into a single grid on the current device of the calling thread
+	std::vector<float_t> get() const;
+	void set(const std::vector<float_t>& data);
+
+	// getters
+	std::vector<uint32_t> get_shape() const { return shape; }
+	uint32_t get_elements() const;
+	uint32_t get_shard_count() const { return static_cast<uint32_t>(shards.size()); }
+	NGrid& shard(uint32_t index);
+	const NGrid& shard(uint32_t index) const;
+	uint32_t get_shard_device(uint32_t index) const;
+	uint32_t get_shard_offset(uint32_t index) const; // index (along axis 0) of the first row of the shard
+
+	// shard-local operations
+	Sharded map(std::function<NGrid(const NGrid&)> op) const;
+	void for_each(std::function<void(NGrid&)> op);
+	Sharded operator+(const float_t value) const { return map([value](const NGrid& s) { return s + value; }); }
+	Sharded operator-(const float_t value) const { return map([value](const NGrid& s) { return s - value; }); }
+	Sharded operator*(const float_t factor) const { return map([factor](const NGrid& s) { return s * factor; }); }
+	Sharded operator/(const float_t quotient) const { return map([quotient](const NGrid& s) { return s / quotient; }); }
+	Sharded operator+(const Sharded& other) const;
+	Sharded operator-(const Sharded& other) const;
+	Sharded Hadamard_product(const Sharded& other) const;
+
+	// reductions (partial results are combined on the host)
+	float_t sum() const;
+	float_t mean() const;
+	float_t min() const;
+	float_t max() const;
+
+	// operations that combine shards or replicate operands
+	Sharded matrix_product(const NGrid& other) const; // 2d product, the rows of the result keep the partitioning of this grid
+	Sharded concatenate(const Sharded& other, const uint32_t axis = 0) const;
+
+private:
+	class Worker;
+	static Worker& worker(uint32_t device_index);
+	void run(const std::function<void(uint32_t)>& task) const; // runs the task for every shard on the worker of its device
+	Sharded zip(const Sharded& other, const char* method, std::function<NGrid(const NGrid&, const NGrid&)> op) const;
+	void check_partitioning(const Sharded& other, const char* method) const;
+	void update_shape();                        // derives the shape from the shards (after shard-local operations)
+	uint32_t row_elements() const;              // elements per index of axis 0
+
+	std::vector<uint32_t> shape;
+	std::vector<NGrid> shards;
+	std::vector<uint32_t> devices;              // physical device index per shard
+	std::vector<uint32_t> offsets;              // first row per shard
+};
+
+// persistent thread with the current device set to one physical device; executes the tasks of its queue in order
+class NGrid::Sharded::Worker {
+public:
+	Worker(uint32_t device_index);
+	~Worker();
+	std::future<void> submit(std::function<void()> task); // exceptions of the task are rethrown by std::future::get()
+
+private:
+	void loop();
+
+	uint32_t device_index;
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::deque<std::packaged_task<void()>> tasks;
+	bool stopping = false;
+	std::thread thread;
+};
+
+// out-of-core execution over a host-resident array (e.g. a std::vector or the mapping of a raw file) that doesn't fit
+// into device memory or exceeds the uint32_t element count of a grid: the data is processed in chunks of 'chunk_elements';
+// the chunks rotate through 'buffers' device grids (2 = double buffering, 3 = triple buffering), so that the uploads of the next
+// chunks run on the transfer queue while the compute queue works on the current one; a timeline semaphore that is signaled
+// by the transfer submissions tells when a chunk has arrived; devices without timeline semaphores and host-visible grids
+// fall back to synchronous uploads; elementwise results are written back to a host target,
+// reductions are combined across the chunks on the host (in double precision);
+// the source must stay valid while the stream is used
+// usage:	NGrid::Streaming S(history); float_t total = S.sum();
+//			S.map(returns, [](const NGrid& chunk) { return chunk.log(); });
+class NGrid::Streaming {
+public:
+	Streaming(std::span<const float_t> source, uint32_t chunk_elements = default_chunk_elements, uint32_t buffers = 2);
+
+	// elementwise operations (the operation has to return a grid with the same number of elements as the chunk)
+	void map(std::span<float_t> target, std::function<NGrid(const NGrid&)> op) const;
+	void scale_minmax(std::span<float_t> target, float_t range_from = 0.0f, float_t range_to = 1.0f) const;
+
+	// reductions
+	float_t sum() const;
+	float_t mean() const;
+	float_t var(bool sample_var = true) const;
+	float_t stdev(bool sample_var = true) const;
+	float_t min() const;
+	float_t max() const;
+
+	// runs a custom operation on every chunk (offset = index of the first element of the chunk in the source)
+	void for_each(std::function<void(const NGrid& chunk, uint64_t offset)> op) const;
+
+	// getters
+	uint64_t get_elements() const { return source.size(); }
+	uint64_t get_chunks() const { return (source.size() + chunk_elements - 1) / chunk_elements; }
+	uint32_t get_chunk_elements() const { return chunk_elements; }
+	uint32_t get_buffers() const { return buffers; }
+
+	static constexpr uint32_t default_chunk_elements = 1u << 24; // 64 MiB of fp32 data per chunk
+
+private:
+	std::span<const float_t> source;
+	uint32_t chunk_elements = default_chunk_elements;
+	uint32_t buffers = 2;
+};
 
 // +=================================+   
 // | Static Member Initializations   |
 // +=================================+
 VulkanManager* NGrid::manager = nullptr;
-DescriptorPool* NGrid::descriptor_pool = nullptr;
 uint32_t NGrid::workgroup_size_1d = DEFAULT_WORKGROUP_SIZE_1D;
 uint32_t NGrid::workgroup_size_2d = DEFAULT_WORKGROUP_SIZE_2D;
 UINT64 NGrid::fence_timeout_nanosec = 1000000000; // default: 1 second timeout for waiting for the fence to be signaled
+NGrid::Residency NGrid::default_residency = NGrid::AUTO_RESIDENCY;
+std::atomic<uint32_t> NGrid::host_thresholds[NGrid::HOST_OP_COUNT] = { DEFAULT_HOST_THRESHOLD_ELEMENTWISE, DEFAULT_HOST_THRESHOLD_ACTIVATION, DEFAULT_HOST_THRESHOLD_REDUCTION };
+bool NGrid::conv_autotuning = false;
+std::map<std::vector<uint32_t>, NGrid::ConvAlgorithm> NGrid::conv_tuning_table;
+std::mutex NGrid::conv_tuning_mutex;
+std::atomic<uint64_t> NGrid::random_seed = rnd::seed32();
+std::atomic<uint64_t> NGrid::random_offset = 0;
+std::atomic<uint32_t> NGrid::Context::next_queue = 0;
+thread_local NGrid::Context* NGrid::Context::current = nullptr;
 
 
 
@@ -385,7 +1353,7 @@ NGrid::NGrid() {
 }
 
 // parametric default constructor for multi-dimensional array, overloaded for variadic template
-template<typename... Args> NGrid::NGrid(Args... args) {
+template<typename... Args> requires (std::integral<Args> && ...) NGrid::NGrid(Args... args) {
 	std::vector<uint32_t> shape_vec = { static_cast<uint32_t>(args)... };
 	this->create(shape_vec);
 }
@@ -417,7 +1385,10 @@ NGrid::NGrid(const float_t* source_array, const uint32_t copied_elements, const
 }
 
 // shared protected helper method for constructors
-void NGrid::create(const std::vector<uint32_t>& shape) {
+// (sparse = true creates the data buffer with sparse residency, see NGrid::sparse_resident())
+void NGrid::create(const std::vector<uint32_t>& shape, bool sparse) {
+	wait_async_reads(); // the previous buffers might get released
+	host_shadow_mapped = false; // spans returned by map() / view() become invalid
 	this->shape = shape;
 	this->dimensions = static_cast<uint32_t>(shape.size());
 
@@ -433,78 +1404,89 @@ void NGrid::create(const std::vector<uint32_t>& shape) {
 	}
 
 	// create a shared manager for instance, device and commandpool
-	if (VulkanManager::get_singleton() == nullptr) {
-		manager = VulkanManager::make_singleton_for_compute(1, 3, 0);
-	}
-	else {
-		manager = VulkanManager::get_singleton();
-	}
-
-	// create a descriptor pool for the command buffer
-	if (descriptor_pool == nullptr) {
-		std::vector<VkDescriptorPoolSize> max_buffers = {
-			{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 20},
-			{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 20}
-		};
-		descriptor_pool = new DescriptorPool(manager->get_device(), MAX_DESCRIPTOR_SET_COUNT, max_buffers);
+	init_manager();
 
-		// register static destructor for cleanup at program termination;
-		// note: this is necessary because descriptor_pool is a static object shared across multiple instances of NGrid,
-		// therefore it shouldn't be destroyed by any object destructors which are meant for single instances
-		std::atexit(&NGrid::release_descriptor_pool);
-	}
-
-	// create a command buffer
-	if (this->command_buffer == nullptr) {
-		command_buffer = new CommandBuffer(manager->get_device(), manager->get_command_pool_compute());
+	// the buffers are always created on the current device of the calling thread;
+	// buffers of a previous device can't be reused
+	uint32_t target_device = context().device_index;
+	if (target_device != this->device_index) {
+		release_buffer(data_buffer);
+		release_buffer(shape_buffer);
+		this->device_index = target_device;
 	}
 
 	if (this->elements != 0) {
 		// allocate as a 'flat' buffer -> this is required because GLSL shaders only support dynamic sizing in a single (=the last) dimension
 		VkMemoryPropertyFlags memory_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		// apply the residency policy to the data buffer; device-local buffers are shared between
+		// the compute and the transfer queue family (for staging transfers)
+		const bool host_visible_device_memory = current_device().supports_host_visible_device_memory();
+		bool use_device_local = sparse || default_residency == DEVICE_LOCAL_RESIDENCY
+			|| (default_residency == AUTO_RESIDENCY && !host_visible_device_memory);
+		MemoryAllocationMode data_allocation_mode = sparse ? MemoryAllocationMode::SPARSE_RESIDENCY : MemoryAllocationMode::ARENA_ALLOCATION;
+		VkMemoryPropertyFlags data_memory_properties = use_device_local ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : memory_properties;
+		std::vector<uint32_t> data_queue_families = {};
+		if (use_device_local && current_device().get_compute_queue_family_index() != current_device().get_transfer_queue_family_index()) {
+			data_queue_families = { current_device().get_compute_queue_family_index(), current_device().get_transfer_queue_family_index() };
+		}
+
 		if (this->data_buffer == nullptr) {
-			data_buffer = new Buffer<float_t>(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->elements, memory_properties);
+			data_buffer = shared_buffer(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, this->elements, data_memory_properties, data_queue_families, data_allocation_mode));
 		}
 		else {
-			// keep the previous buffer only if it already has sufficient capacity
-			if (data_buffer->get_elements() < this->elements) {
-				delete data_buffer;
-				data_buffer = new Buffer<float_t>(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->elements, memory_properties);
+			// keep the previous buffer only if it already has sufficient capacity and the requested residency
+			// and if it isn't shared with views (which keep referring to the previous data);
+			// sparse buffers are kept with their resident pages
+			bool residency_mismatch = !data_buffer->is_sparse() && (sparse || data_buffer->host_visible() == use_device_local);
+			if (data_buffer->get_elements() < this->elements || residency_mismatch || data_buffer.use_count() > 1) {
+				release_buffer(data_buffer);
+				data_buffer = shared_buffer(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, this->elements, data_memory_properties, data_queue_families, data_allocation_mode));
 			}
 		}
+		this->device_local = !data_buffer->host_visible();
 
-		// allocate a storage buffer for the shape of the array
+		// allocate a storage buffer for the shape of the array (with the same residency as the data buffer,
+		// so that device-local grids don't take up the small host-visible device memory heap)
+		VkMemoryPropertyFlags shape_memory_properties = use_device_local ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : memory_properties;
 		if (this->shape_buffer == nullptr) {
-			shape_buffer = new Buffer<uint32_t>(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions, memory_properties);
+			shape_buffer = new Buffer<uint32_t>(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions, shape_memory_properties, data_queue_families);
 		}
 		else {
-			// if it already exists: create a new one in case the number of dimensions is wrong
-			if (shape_buffer->get_elements() != this->dimensions) {
-				delete shape_buffer;
-				shape_buffer = new Buffer<uint32_t>(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions, memory_properties);
+			// if it already exists: create a new one in case the number of dimensions or the residency is wrong
+			// (inside a capture, the old shape buffer may be referenced by a recorded dispatch and must not be overwritten)
+			if (shape_buffer->get_elements() != this->dimensions || shape_buffer->host_visible() == use_device_local || is_capturing()) {
+				release_buffer(shape_buffer);
+				shape_buffer = new Buffer<uint32_t>(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions, shape_memory_properties, data_queue_families);
+			}
+			else {
+				flush(); // the reused shape buffer may still be referenced by a recorded dispatch
 			}
 		}
-		shape_buffer->write(this->shape, this->dimensions, 0, 0);
+		// (device-local shape buffers are written via the staging path, like the data)
+		get_staging(this->device_index).upload(*shape_buffer, this->shape.data(), this->dimensions);
 	}
 }
 
 // move constructor
 NGrid::NGrid(NGrid&& other) noexcept {
-	Log::debug("NGrid move constructor invoked");
+	LOG_DEBUG("NGrid move constructor invoked");
 	this->elements = other.elements;                            other.elements = 0;
 	this->dimensions = other.dimensions;                        other.dimensions = 0;
 	this->shape = std::move(other.shape);                       other.shape.clear();
-	if (this->data_buffer != nullptr) {
-		delete[] this->data_buffer;
-	}
 	this->data_buffer = std::move(other.data_buffer);           other.data_buffer = nullptr;
 	this->shape_buffer = std::move(other.shape_buffer);         other.shape_buffer = nullptr;
-	this->command_buffer = std::move(other.command_buffer);		other.command_buffer = nullptr;
+	this->device_local = other.device_local;
+	this->device_index = other.device_index;
+	this->async_read_value = other.async_read_value;            other.async_read_value = 0;
+	this->async_read_timeline = std::move(other.async_read_timeline);
+	this->host_shadow = std::move(other.host_shadow);
+	this->host_shadow_mapped = other.host_shadow_mapped;        other.host_shadow_mapped = false;
 }
 
 // copy constructor
 NGrid::NGrid(const NGrid& other) {
-	Log::debug("NGrid copy constructor invoked");
+	LOG_DEBUG("NGrid copy constructor invoked");
 	this->create(other.get_shape());
 	this->set(other);
 }
@@ -512,21 +1494,12 @@ NGrid::NGrid(const NGrid& other) {
 // destructor
 NGrid::~NGrid() {
 	// destroy in reverse order of creation
-	Log::debug("NGrid destructor invoked");
-	if (this->shape_buffer != nullptr) {
-		delete this->shape_buffer;
-		this->shape_buffer = nullptr;
-	}
-	if (this->data_buffer != nullptr) {
-		delete this->data_buffer;
-		this->data_buffer = nullptr;
-	}
-	if (this->command_buffer != nullptr) {
-		delete this->command_buffer;
-		this->command_buffer = nullptr;
-	}
-	// Note: 'manager' and 'descriptor_pool' are static objects, shared across multiple instances of NGrid,
-	// therefore they shouldn't be destroyed by any object destructors which are meant for single instances
+	LOG_DEBUG("NGrid destructor invoked");
+	wait_async_reads();
+	release_buffer(this->shape_buffer);
+	release_buffer(this->data_buffer);
+	// Note: 'manager' is a static object, shared across multiple instances of NGrid, and the command buffers and
+	// descriptor pools belong to the per-thread execution context, therefore they aren't destroyed by this destructor
 }
 
 // +=================================+   
@@ -535,11 +1508,15 @@ NGrid::~NGrid() {
 
 // copy assignment operator
 NGrid& NGrid::operator=(const NGrid& other) {
-	Log::debug("NGrid copy assignment invoked, copying from other (handle: ", other.data_buffer, ") to this (handle: ", this->data_buffer, ")");
+	LOG_DEBUG("NGrid copy assignment invoked, copying from other (handle: ", other.data_buffer, ") to this (handle: ", this->data_buffer, ")");
 	if (this != &other) {
-		delete this->data_buffer;
-		delete this->shape_buffer;
-		this->create(other.get_shape());
+		// the existing buffers are reused if the shapes match
+		if (this->shape != other.get_shape() || this->data_buffer == nullptr) {
+			wait_async_reads();
+			release_buffer(this->data_buffer);
+			release_buffer(this->shape_buffer);
+			this->create(other.get_shape());
+		}
 		this->set(other);
 	}
 	return *this;
@@ -547,17 +1524,22 @@ NGrid& NGrid::operator=(const NGrid& other) {
 
 // move assignment operator
 NGrid& NGrid::operator=(NGrid&& other) noexcept {
-	Log::debug("NGrid move assignment invoked, moving from other (handle: ", other.data_buffer, ") to this (handle: ", this->data_buffer, ")");
+	LOG_DEBUG("NGrid move assignment invoked, moving from other (handle: ", other.data_buffer, ") to this (handle: ", this->data_buffer, ")");
 	if (this != &other) {
 		this->elements = other.elements;                            other.elements = 0;
 		this->dimensions = other.dimensions;                        other.dimensions = 0;
 		this->shape = std::move(other.shape);                       other.shape.clear();
-		delete this->data_buffer;
-		delete this->shape_buffer;
-		delete this->command_buffer;
+		wait_async_reads();
+		release_buffer(this->data_buffer);
+		release_buffer(this->shape_buffer);
 		this->data_buffer = std::move(other.data_buffer);           other.data_buffer = nullptr;
 		this->shape_buffer = std::move(other.shape_buffer);         other.shape_buffer = nullptr;
-		this->command_buffer = std::move(other.command_buffer);		other.command_buffer = nullptr;
+		this->device_local = other.device_local;
+		this->device_index = other.device_index;
+		this->async_read_value = other.async_read_value;            other.async_read_value = 0;
+		this->async_read_timeline = std::move(other.async_read_timeline);
+		this->host_shadow = std::move(other.host_shadow);
+		this->host_shadow_mapped = other.host_shadow_mapped;        other.host_shadow_mapped = false;
 	}
 	return *this;
 }
@@ -569,13 +1551,15 @@ NGrid& NGrid::operator=(NGrid&& other) noexcept {
 // assigns a value to a data element via multi-dimensional index;
 // overload with index as std::initializer_list<uint32_t>
 void NGrid::set(std::initializer_list<uint32_t> index, const float_t value) {
-	this->data_buffer->write_element(flat_index(index), value);
+	flush();
+	this->upload(&value, 1, flat_index(index));
 }
 
 // assigns a value to a data element via multi-dimensional index;
 // overload with index as std::vector<uint32_t>
 void NGrid::set(const std::vector<uint32_t>& index, const float_t value) {
-	this->data_buffer->write_element(flat_index(index), value);
+	flush();
+	this->upload(&value, 1, flat_index(index));
 }
 
 // alias for set(const std::vector<float_t>& data)
@@ -592,13 +1576,18 @@ void NGrid::operator=(const float_t* data) {
 // of the underlying NGrid array;
 // copied_elements=0 means: copy ALL elements from the source buffer
 void NGrid::set(const std::vector<float_t>& data, uint32_t copied_elements, uint32_t source_offset_elements, uint32_t target_offset_elements) {
-	data_buffer->write(data, copied_elements, source_offset_elements, target_offset_elements);
+	flush();
+	if (copied_elements == 0) {
+		copied_elements = source_offset_elements < data.size() ? static_cast<uint32_t>(data.size()) - source_offset_elements : 0;
+	}
+	this->upload(data.data() + source_offset_elements, copied_elements, target_offset_elements);
 }
 
 // copies raw data from a float_t array to the data buffer
 // of the underlying NGrid array;
 void NGrid::set(const float_t* data, uint32_t copied_elements, uint32_t source_offset_elements, uint32_t target_offset_elements) {
-	data_buffer->write(data, copied_elements, source_offset_elements, target_offset_elements);
+	flush();
+	this->upload(data + source_offset_elements, copied_elements, target_offset_elements);
 }
 
 // copies raw data from another NGrid array to the data buffer
@@ -634,29 +1623,70 @@ void NGrid::set(const NGrid& other, uint32_t copied_elements, uint32_t source_of
 			}
 		}
 	}
-	data_buffer->write(*other.get_buffer(), copied_elements, source_offset_elements, target_offset_elements);
+	flush();
+	wait_async_reads();
+	if (this->device_index != other.device_index && (this->device_local || other.is_device_local())) {
+		// buffers of different devices can only be copied via host memory
+		if (copied_elements == 0) {
+			copied_elements = other.get_elements() > source_offset_elements ? other.get_elements() - source_offset_elements : 0;
+		}
+		if (target_offset_elements + copied_elements > this->elements) {
+			Log::warning("in method NGrid::set(const NGrid& other, ...): attempting to write past the end of the grid; clipping copy region size to fit");
+			copied_elements = this->elements > target_offset_elements ? this->elements - target_offset_elements : 0;
+		}
+		std::vector<float_t> values(copied_elements);
+		other.download(values.data(), copied_elements, source_offset_elements);
+		this->upload(values.data(), copied_elements, target_offset_elements);
+	}
+	else if (!this->device_local && !other.is_device_local()) {
+		data_buffer->write(*other.get_buffer(), copied_elements, source_offset_elements, target_offset_elements);
+	}
+	else {
+		// device-side copy on the transfer queue
+		if (copied_elements == 0) {
+			copied_elements = other.get_elements() > source_offset_elements ? other.get_elements() - source_offset_elements : 0;
+		}
+		if (target_offset_elements + copied_elements > this->elements) {
+			Log::warning("in method NGrid::set(const NGrid& other, ...): attempting to write past the end of the grid; clipping copy region size to fit");
+			copied_elements = this->elements > target_offset_elements ? this->elements - target_offset_elements : 0;
+		}
+		get_staging(this->device_index).copy(*other.get_buffer(), *this->data_buffer, copied_elements, source_offset_elements, target_offset_elements);
+	}
 }
 
 // returns the value of an array element via its flattened index
 float_t NGrid::get(const uint32_t flat_index) const {
 	// using flat index as 'row' index
-	return data_buffer->read_element(flat_index);
+	flush();
+	if (!this->device_local) {
+		return data_buffer->read_element(flat_index);
+	}
+	float_t value = 0.0f;
+	this->download(&value, 1, flat_index);
+	return value;
 }
 
 // returns a flat (= 1-dimensional) copy of ALL raw data of the underlying buffer as type std::vector<float_t>
 std::vector<float> NGrid::get() const {
-	return data_buffer->read();
+	return this->get(0, 0);
 }
 
 // returns a flat (= 1-dimensional) copy of the raw data of the underlying buffer as type std::vector<float_t>;
 // this overload uses parameters "read_elements" and "source_offset_elements" to allow copying only a subset of the data
 std::vector<float> NGrid::get(const uint32_t read_elements, const uint32_t source_offset_elements) const {
-	return data_buffer->read(read_elements, source_offset_elements);
+	flush();
+	if (!this->device_local) {
+		return data_buffer->read(read_elements, source_offset_elements);
+	}
+	uint32_t available_elements = this->elements > source_offset_elements ? this->elements - source_offset_elements : 0;
+	std::vector<float_t> result(read_elements == 0 ? available_elements : std::min(read_elements, available_elements));
+	this->download(result.data(), static_cast<uint32_t>(result.size()), source_offset_elements);
+	return result;
 }
 
 // returns the buffer containg the raw array data
 Buffer<float_t>* NGrid::get_buffer() const {
-	return this->data_buffer;
+	return this->data_buffer.get();
 }
 
 // returns the buffer containg the shape of the array
@@ -664,6 +1694,67 @@ Buffer<uint32_t>* NGrid::get_shape_buffer() const {
 	return this->shape_buffer;
 }
 
+// returns a span over the persistently mapped grid data for direct (zero-copy) host access;
+// writes must be followed by unmap() before the grid is used by the device again;
+// device-local grids fall back to a host copy, which is written back by unmap();
+// the span becomes invalid if the grid is resized or destroyed
+std::span<float_t> NGrid::map() {
+	flush();
+	wait_async_reads();
+	if (this->data_buffer == nullptr) {
+		return {};
+	}
+	if (this->device_local) {
+		if (!host_shadow_mapped) {
+			host_shadow = this->get();
+			host_shadow_mapped = true;
+		}
+		return std::span<float_t>(host_shadow);
+	}
+	if (!data_buffer->host_coherent()) {
+		data_buffer->invalidate();
+	}
+	return std::span<float_t>(data_buffer->data(), this->elements);
+}
+
+// makes host writes via map() visible to the device
+// (flushes non-coherent memory or uploads the host copy of device-local grids)
+void NGrid::unmap() {
+	if (this->data_buffer == nullptr) {
+		return;
+	}
+	if (this->device_local) {
+		if (host_shadow_mapped) {
+			this->upload(host_shadow.data(), static_cast<uint32_t>(std::min<size_t>(host_shadow.size(), this->elements)), 0);
+			host_shadow_mapped = false;
+		}
+		return;
+	}
+	if (!data_buffer->host_coherent()) {
+		data_buffer->flush();
+	}
+}
+
+// returns a read-only span over the grid data without copying
+// (device-local grids fall back to a host copy that stays valid until the next call of map() or view();
+// while the grid is mapped, the view shows the mapped host copy)
+std::span<const float_t> NGrid::view() const {
+	flush();
+	if (this->data_buffer == nullptr) {
+		return {};
+	}
+	if (this->device_local) {
+		if (!host_shadow_mapped) {
+			host_shadow = this->get();
+		}
+		return std::span<const float_t>(host_shadow);
+	}
+	if (!data_buffer->host_coherent()) {
+		data_buffer->invalidate();
+	}
+	return std::span<const float_t>(data_buffer->data(), this->elements);
+}
+
 // returns the number of dimensions of the underlying array
 uint32_t NGrid::get_dimensions() const {
 	return this->dimensions;
@@ -723,24 +1814,23 @@ NGrid NGrid::subgrid(std::initializer_list<uint32_t> source_offset, std::initial
 	}
 	NGrid subgrid(subgrid_shape);
 
-	Buffer<uint32_t> source_offset_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> source_offset_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	source_offset_buffer.write(source_offset);
 
-	static ShaderModule shader(manager->get_device(), SUBGRID_SPIRV_BIN, SUBGRID_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SUBGRID_SPIRV_BIN, SUBGRID_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*subgrid.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*subgrid.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(source_offset_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions);
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, subgrid.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, subgrid.get_elements(), 1, 1, true);
 	return subgrid;
 }
 
@@ -760,24 +1850,23 @@ NGrid NGrid::subgrid(std::vector<uint32_t> source_offset, std::vector<uint32_t>
 	}
 	NGrid subgrid(subgrid_shape);
 
-	Buffer<uint32_t> source_offset_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> source_offset_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	source_offset_buffer.write(source_offset);
 
-	static ShaderModule shader(manager->get_device(), SUBGRID_SPIRV_BIN, SUBGRID_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SUBGRID_SPIRV_BIN, SUBGRID_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*subgrid.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*subgrid.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(source_offset_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, subgrid.get_elements());
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, subgrid.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, subgrid.get_elements(), 1, 1, true);
 	return subgrid;
 }
 
@@ -787,105 +1876,102 @@ NGrid NGrid::subgrid(std::vector<uint32_t> source_offset, std::vector<uint32_t>
 
 // fill entire array with given floating point value
 void NGrid::fill(const float_t value) {
-	static ShaderModule shader(manager->get_device(), FILL_SPIRV_BIN, FILL_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_SPIRV_BIN, FILL_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // initialize the entire array with zeros
 void NGrid::fill_zero() {
-	static ShaderModule shader(manager->get_device(), FILL_ZERO_SPIRV_BIN, FILL_ZERO_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_ZERO_SPIRV_BIN, FILL_ZERO_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill entire array with identity matrix
 void NGrid::fill_identity() {
-	static ShaderModule shader(manager->get_device(), FILL_IDENTITY_SPIRV_BIN, FILL_IDENTITY_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_IDENTITY_SPIRV_BIN, FILL_IDENTITY_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, this->dimensions);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with values from a random normal (=gaussian) distribution
 void NGrid::fill_random_gaussian(const float_t mu, const float_t sigma) {
-	static ShaderModule shader(manager->get_device(), FILL_RANDOM_GAUSSIAN_SPIRV_BIN, FILL_RANDOM_GAUSSIAN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_RANDOM_GAUSSIAN_SPIRV_BIN, FILL_RANDOM_GAUSSIAN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, rnd::seed32(), mu, sigma);
+	RandomStream stream = next_random_stream(1);
+	PushConstants constants(this->elements, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi, mu, sigma);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with values from a random uniform distribution
 void NGrid::fill_random_uniform(const float_t min, const float_t max) {
-	static ShaderModule shader(manager->get_device(), FILL_RANDOM_UNIFORM_SPIRV_BIN, FILL_RANDOM_UNIFORM_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_RANDOM_UNIFORM_SPIRV_BIN, FILL_RANDOM_UNIFORM_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, rnd::seed32(), min, max);
+	RandomStream stream = next_random_stream(1);
+	PushConstants constants(this->elements, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi, min, max);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with values from a random uniform distribution
 void NGrid::fill_random_uniform_int(const int32_t min, const int32_t max) {
-	static ShaderModule shader(manager->get_device(), FILL_RANDOM_UNIFORM_INT_SPIRV_BIN, FILL_RANDOM_UNIFORM_INT_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_RANDOM_UNIFORM_INT_SPIRV_BIN, FILL_RANDOM_UNIFORM_INT_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, rnd::seed32(), min, max);
+	RandomStream stream = next_random_stream(1);
+	PushConstants constants(this->elements, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi, min, max);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // randomly sets the specified fraction of the values to zero and the rest to 1 (default: 0.5, i.e. 50%)
@@ -897,19 +1983,19 @@ void NGrid::fill_random_binary(float_t ratio) {
 	}
 	float_t valid_ratio = std::fmax(std::fmin(ratio, 1.0f), 0.0f);
 
-	static ShaderModule shader(manager->get_device(), FILL_RANDOM_BINARY_SPIRV_BIN, FILL_RANDOM_BINARY_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_RANDOM_BINARY_SPIRV_BIN, FILL_RANDOM_BINARY_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, rnd::seed32(), valid_ratio);
+	RandomStream stream = next_random_stream(1);
+	PushConstants constants(this->elements, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi, valid_ratio);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // randomly sets the specified fraction of the values to -1 and the rest to +1 (default: 0.5, i.e. 50%)
@@ -921,19 +2007,19 @@ void NGrid::fill_random_sign(float_t ratio) {
 	}
 	float_t valid_ratio = std::fmax(std::fmin(ratio, 1.0f), 0.0f);
 
-	static ShaderModule shader(manager->get_device(), FILL_RANDOM_SIGN_SPIRV_BIN, FILL_RANDOM_SIGN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_RANDOM_SIGN_SPIRV_BIN, FILL_RANDOM_SIGN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, rnd::seed32(), valid_ratio);
+	RandomStream stream = next_random_stream(1);
+	PushConstants constants(this->elements, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi, valid_ratio);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fills the array with a continuous
@@ -941,20 +2027,55 @@ void NGrid::fill_random_sign(float_t ratio) {
 // referring to the zero position and a step parameter)
 // in all dimensions
 void NGrid::fill_range(const float_t start, const float_t step) {
-	static ShaderModule shader(manager->get_device(), FILL_RANGE_SPIRV_BIN, FILL_RANGE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_RANGE_SPIRV_BIN, FILL_RANGE_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, this->dimensions, start, step);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
+}
+
+// sets the seed of the counter-based generator that is used by the random fills and weight initializations
+// and resets the stream offset, so that the following fills are reproducible
+// (the default seed is derived from the clock at program start)
+void NGrid::set_random_seed(uint64_t seed) {
+	random_seed = seed;
+	random_offset = 0;
+}
+
+// every random fill draws from its own stream (seed, offset) and increments the offset;
+// the values of a fill only depend on the stream and the element index, so a fill can be repeated exactly
+// by restoring the offset, e.g. to apply the same dropout mask to the gradients in the backward pass:
+// uint64_t offset = NGrid::get_random_offset(); A.fill_dropout(0.2f); ... NGrid::set_random_offset(offset); G.fill_dropout(0.2f);
+uint64_t NGrid::get_random_offset() {
+	return random_offset;
+}
+
+void NGrid::set_random_offset(uint64_t offset) {
+	random_offset = offset;
+}
+
+// returns the stream for the next random fill (thread-safe);
+// 'word' is the position of the stream within the push constants of the fill (renewed by every replay of a captured fill)
+NGrid::RandomStream NGrid::next_random_stream(uint32_t word) {
+	uint64_t seed = random_seed;
+	uint64_t offset = random_offset.fetch_add(1);
+	RandomStream stream;
+	stream.seed_lo = static_cast<uint32_t>(seed);
+	stream.seed_hi = static_cast<uint32_t>(seed >> 32);
+	stream.offset_lo = static_cast<uint32_t>(offset);
+	stream.offset_hi = static_cast<uint32_t>(offset >> 32);
+	if (Context::current != nullptr && Context::current->capture != nullptr) {
+		Context::current->capture->pending_streams.push_back({ stream, word });
+	}
+	return stream;
 }
 
 void NGrid::fill_dropout(float_t ratio) {
@@ -965,126 +2086,125 @@ void NGrid::fill_dropout(float_t ratio) {
 	}
 	float_t valid_ratio = std::fmax(std::fmin(ratio, 1.0f), 0.0f);
 
-	static ShaderModule shader(manager->get_device(), FILL_DROPOUT_SPIRV_BIN, FILL_DROPOUT_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_DROPOUT_SPIRV_BIN, FILL_DROPOUT_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, valid_ratio, rnd::seed32());
+	RandomStream stream = next_random_stream(2);
+	PushConstants constants(this->elements, valid_ratio, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with normal "Xavier" weight initialization
 // (by Xavier Glorot & Bengio) for tanh activation
 void NGrid::weightinit_tanh_normal(uint32_t fan_in, uint32_t fan_out) {
-	static ShaderModule shader(manager->get_device(), WEIGHTINIT_TANH_NORMAL_SPIRV_BIN, WEIGHTINIT_TANH_NORMAL_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(WEIGHTINIT_TANH_NORMAL_SPIRV_BIN, WEIGHTINIT_TANH_NORMAL_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, fan_in, fan_out, rnd::seed32());
+	RandomStream stream = next_random_stream(3);
+	PushConstants constants(this->elements, fan_in, fan_out, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with uniform "Xavier" weight initializiation
 // (by Xavier Glorot & Bengio), e.g. for tanh activation
 void NGrid::weightinit_tanh_uniform(uint32_t fan_in, uint32_t fan_out) {
-	static ShaderModule shader(manager->get_device(), WEIGHTINIT_TANH_UNIFORM_SPIRV_BIN, WEIGHTINIT_TANH_UNIFORM_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(WEIGHTINIT_TANH_UNIFORM_SPIRV_BIN, WEIGHTINIT_TANH_UNIFORM_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, fan_in, fan_out, rnd::seed32());
+	RandomStream stream = next_random_stream(3);
+	PushConstants constants(this->elements, fan_in, fan_out, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with uniform "Xavier" weight initialization
 // for sigmoid activation
 void NGrid::weightinit_sigmoid(uint32_t fan_in, uint32_t fan_out) {
-	static ShaderModule shader(manager->get_device(), WEIGHTINIT_SIGMOID_SPIRV_BIN, WEIGHTINIT_SIGMOID_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(WEIGHTINIT_SIGMOID_SPIRV_BIN, WEIGHTINIT_SIGMOID_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, fan_in, fan_out, rnd::seed32());
+	RandomStream stream = next_random_stream(3);
+	PushConstants constants(this->elements, fan_in, fan_out, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with "Kaiming He" normal weight initialization,
 // used for ReLU activation
 void NGrid::weightinit_relu(uint32_t fan_in) {
-	static ShaderModule shader(manager->get_device(), WEIGHTINIT_RELU_SPIRV_BIN, WEIGHTINIT_RELU_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(WEIGHTINIT_RELU_SPIRV_BIN, WEIGHTINIT_RELU_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, fan_in, rnd::seed32());
+	RandomStream stream = next_random_stream(2);
+	PushConstants constants(this->elements, fan_in, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fill with modified "Kaiming He" nornal weight initialization,
 // used for ELU activation
 void NGrid::weightinit_elu(uint32_t fan_in) {
-	static ShaderModule shader(manager->get_device(), WEIGHTINIT_ELU_SPIRV_BIN, WEIGHTINIT_ELU_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(WEIGHTINIT_ELU_SPIRV_BIN, WEIGHTINIT_ELU_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
-	PushConstants constants(this->elements, fan_in, rnd::seed32());
+	RandomStream stream = next_random_stream(2);
+	PushConstants constants(this->elements, fan_in, stream.seed_lo, stream.seed_hi, stream.offset_lo, stream.offset_hi);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // fills the array elements with their flat indices
 void NGrid::fill_index() {
-	static ShaderModule shader(manager->get_device(), FILL_INDEX_SPIRV_BIN, FILL_INDEX_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FILL_INDEX_SPIRV_BIN, FILL_INDEX_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // +=================================+
@@ -1094,70 +2214,19 @@ void NGrid::fill_index() {
 // returns the lowest value of the NGrid,
 // across all dimensions
 float_t NGrid::min() const {
-	static ShaderModule shader(manager->get_device(), MIN_SPIRV_BIN, MIN_SPIRV_BYTES);
-
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.finalize_layout();
-
-	descriptor_pool->allocate_set(set);
-
-	PushConstants constants(this->elements);
-
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return local_results.read_element(0);
+	return this->reduce(REDUCE_MIN)[0];
 }
 
 // returns the highest value of the NGrid,
 // across all dimensions
 float_t NGrid::max() const {
-	static ShaderModule shader(manager->get_device(), MAX_SPIRV_BIN, MAX_SPIRV_BYTES);
-
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.finalize_layout();
-
-	descriptor_pool->allocate_set(set);
-
-	PushConstants constants(this->elements);
-
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return local_results.read_element(0);
+	return this->reduce(REDUCE_MAX)[0];
 }
 
-// returns the value of the NGrid with the highest
-// deviation from zero, across all dimensions
+// returns the highest absolute value of the NGrid
+// (= deviation from zero), across all dimensions
 float_t NGrid::maxabs() const {
-	static ShaderModule shader(manager->get_device(), MAXABS_SPIRV_BIN, MAXABS_SPIRV_BYTES);
-
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.finalize_layout();
-
-	descriptor_pool->allocate_set(set);
-
-	PushConstants constants(this->elements);
-
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return local_results.read_element(0);
+	return this->reduce(REDUCE_MAXABS)[0];
 }
 
 // returns the arrithmetic mean of all values of the NGrid
@@ -1165,6 +2234,28 @@ float_t NGrid::mean() const {
 	return this->sum() / this->elements;
 }
 
+// returns the arithmetic means along the specified axis
+// (the result has the shape of the grid without this axis)
+NGrid NGrid::mean(const uint32_t axis) const {
+	if (axis >= this->dimensions) {
+		Log::error("invalid call of method NGrid::mean(axis): axis ", axis, " doesn't exist for an array with shape ", this->get_shapestring());
+	}
+	return this->reduce_axis(REDUCE_SUM, axis, 1.0f / this->shape[axis]);
+}
+
+// returns the count, mean and the sums of the 2nd, 3rd and 4th powers of the deviations from the mean
+// of all elements, obtained with a single pass over the data (pairwise Welford/Chan updates)
+NGrid::Moments NGrid::moments() const {
+	std::vector<float_t> values = this->reduce(REDUCE_MOMENTS);
+	Moments result;
+	result.count = values[0];
+	result.mean = values[1];
+	result.M2 = values[2];
+	result.M3 = values[3];
+	result.M4 = values[4];
+	return result;
+}
+
 // returns the median of all values the NGrid;
 // NGrid must be 1d
 float_t NGrid::median() const {
@@ -1174,43 +2265,79 @@ float_t NGrid::median() const {
 		Log::warning("invalid usage of method NGrid::median(), underlying array must be 1d but has ", this->dimensions, " dimensions");
 		return 0.0f;
 	}
+	return this->quantile(0.5f);
+}
 
-	NGrid sorted = this->sort();
-
-	// odd number of elements
-	if (this->elements % 2) {
-		return sorted.get(elements / 2);
-	}
-	// even number of elements
-	else {
-		return (sorted.get(elements / 2 - 1) + sorted.get(elements / 2)) / 2;
+// returns the q-quantile (0 <= q <= 1) of all values of the NGrid,
+// with linear interpolation between the two closest ranks;
+// the ranks are found via radix selection, i.e. without sorting
+float_t NGrid::quantile(const float_t q) const {
+	if (this->elements == 0) {
+		Log::warning("invalid usage of method NGrid::quantile(): the grid is empty");
+		return 0.0f;
+	}
+	if (q < 0.0f || q > 1.0f) {
+		Log::warning("invalid usage of method NGrid::quantile(): q must be within [0,1] but is ", q, "; value will be clipped");
 	}
+	double position = std::clamp(double(q), 0.0, 1.0) * (this->elements - 1);
+	uint32_t lower_rank = static_cast<uint32_t>(std::floor(position));
+	uint32_t upper_rank = static_cast<uint32_t>(std::ceil(position));
+	float_t lower = this->select_rank(lower_rank);
+	if (upper_rank == lower_rank) {
+		return lower;
+	}
+	float_t upper = this->select_rank(upper_rank);
+	return lower + float_t(position - lower_rank) * (upper - lower);
 }
 
-// returns the variance of all values of a vector, matrix or array
-// as a floating point number;
-// use 'true' for the sample_var parameter to query the sample variance;
-// if 'false' the population variance will be returned instead
-float_t NGrid::var(bool sample_var) const {
-	// std::cout << "expected variance result: " << (this->operator-((this->operator/(elements)).sum())).pow().operator/(elements - 1).sum() << std::endl;
-	static ShaderModule shader(manager->get_device(), VARIANCE_SPIRV_BIN, VARIANCE_SPIRV_BYTES);
+// returns the value with the given (0-based) rank in ascending order;
+// four passes over the data, each of which counts one 8-bit digit of the order-preserving integer keys
+// of the remaining candidates and narrows down the selected prefix
+float_t NGrid::select_rank(uint32_t rank) const {
+	const ShaderModule& shader = shader_module(RADIX_SELECT_HISTOGRAM_SPIRV_BIN, RADIX_SELECT_HISTOGRAM_SPIRV_BYTES);
 
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
+	Buffer<uint32_t> histogram(current_device(), BufferUsage::STORAGE_BUFFER, 256,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
 
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.finalize_layout();
+	uint32_t prefix = 0;
+	uint32_t prefix_mask = 0;
+	for (int32_t shift = 24; shift >= 0; shift -= 8) {
+		histogram.set_all(0);
 
-	descriptor_pool->allocate_set(set);
+		DescriptorSet set(current_device());
+		set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+		set.bind_buffer(histogram, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+		set.finalize_layout();
 
-	PushConstants constants(this->elements, static_cast<uint32_t>(sample_var));
+		context().descriptor_pool.allocate_set(set);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+		PushConstants constants(this->elements, static_cast<uint32_t>(shift), prefix, prefix_mask);
+		ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+		execute(pipeline, set, this->elements, 1, 1, true);
 
-	return local_results.read_element(0);
+		// find the digit bin that contains the requested rank
+		std::vector<uint32_t> counts = histogram.read();
+		uint32_t bin = 0;
+		while (bin < 255 && rank >= counts[bin]) {
+			rank -= counts[bin];
+			bin++;
+		}
+		prefix |= bin << shift;
+		prefix_mask |= 0xFFu << shift;
+	}
+
+	// invert the order-preserving key transformation
+	uint32_t bits = (prefix & 0x80000000u) ? prefix & 0x7FFFFFFFu : ~prefix;
+	return std::bit_cast<float_t>(bits);
+}
+
+// returns the variance of all values of a vector, matrix or array
+// as a floating point number;
+// use 'true' for the sample_var parameter to query the sample variance;
+// if 'false' the population variance will be returned instead
+float_t NGrid::var(bool sample_var) const {
+	Moments m = this->moments();
+	return m.M2 / (sample_var ? m.count - 1 : m.count);
 }
 
 // returns the standard deviation of all values a the vector, matrix or array
@@ -1220,51 +2347,15 @@ float_t NGrid::stdev() const {
 
 // returns the sample skewness of all data of the NGrid
 float_t NGrid::skew() const {
-	static ShaderModule shader(manager->get_device(), SKEW_SPIRV_BIN, SKEW_SPIRV_BYTES);
-
-	Buffer<float> local_results1(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-	Buffer<float> local_results2(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results1, DescriptorType::STORAGE_BUFFER_DESCRIPTOR); // local_result1[0] will store the mean mdev2
-	set.bind_buffer(local_results2, DescriptorType::STORAGE_BUFFER_DESCRIPTOR); // local_result1[0] will store the mean mdev3
-	set.finalize_layout();
-
-	descriptor_pool->allocate_set(set);
-
-	PushConstants constants(this->elements);
-
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return static_cast<float_t>(local_results1.read_element(0) / std::pow(local_results2.read_element(0), 1.5));
+	Moments m = this->moments();
+	return static_cast<float_t>((m.M3 / m.count) / std::pow(m.M2 / m.count, 1.5));
 }
 
-// returns the sample kurtosis of all elements of the NGrid
+// returns the sample kurtosis (excess kurtosis) of all elements of the NGrid
 float_t NGrid::kurt() const {
-	static ShaderModule shader(manager->get_device(), SKEW_SPIRV_BIN, SKEW_SPIRV_BYTES);
-
-	Buffer<float> local_results1(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-	Buffer<float> local_results2(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results1, DescriptorType::STORAGE_BUFFER_DESCRIPTOR); // local_result1[0] will store the mean mdev2
-	set.bind_buffer(local_results2, DescriptorType::STORAGE_BUFFER_DESCRIPTOR); // local_result2[0] will store the mean mdev4
-	set.finalize_layout();
-
-	descriptor_pool->allocate_set(set);
-
-	PushConstants constants(this->elements);
-
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	float_t mean_mdev2 = local_results1.read_element(0);
-	float_t mean_mdev4 = local_results2.read_element(0);
+	Moments m = this->moments();
+	float_t mean_mdev2 = m.M2 / m.count;
+	float_t mean_mdev4 = m.M4 / m.count;
 	return mean_mdev4 / (mean_mdev2 * mean_mdev2) - 3;
 }
 
@@ -1274,72 +2365,80 @@ float_t NGrid::kurt() const {
 
 // returns the sum of all array elements;
 float_t NGrid::sum() const {
-	static ShaderModule shader(manager->get_device(), SUM_SPIRV_BIN, SUM_SPIRV_BYTES);
-
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.finalize_layout();
-
-	descriptor_pool->allocate_set(set);
-
-	PushConstants constants(this->elements);
-
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	return this->reduce(REDUCE_SUM)[0];
+}
 
-	return local_results.read_element(0);
+// returns the sums along the specified axis
+// (the result has the shape of the grid without this axis)
+NGrid NGrid::sum(const uint32_t axis) const {
+	return this->reduce_axis(REDUCE_SUM, axis);
 }
 
 // elementwise addition of the specified value to all elements of the array
 NGrid NGrid::operator+(const float_t value) const {
-
 	NGrid result(this->shape);
+	this->add_into(result, value);
+	return result;
+}
+
+// operator+(value) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::add_into(NGrid& out, const float_t value) const {
+	this->check_output(out, "add_into");
+	if (this->on_host(HOST_ELEMENTWISE, out)) {
+		hostkernels::add(this->host_read(), value, out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	static ShaderModule shader(manager->get_device(), OPERATOR_PLUS_SPIRV_BIN, OPERATOR_PLUS_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_PLUS_SPIRV_BIN, OPERATOR_PLUS_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // returns the resulting array of the elementwise addition of two arrays
 NGrid NGrid::operator+(const NGrid& other) const {
 	NGrid result(this->shape);
+	this->add_into(result, other);
+	return result;
+}
+
+// operator+(other) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::add_into(NGrid& out, const NGrid& other) const {
+	this->check_output(out, "add_into");
+	if (this->on_host(HOST_ELEMENTWISE, out, &other)) {
+		hostkernels::add(this->host_read(), other.host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	static ShaderModule shader(manager->get_device(), OPERATOR_PLUS_OTHER_SPIRV_BIN, OPERATOR_PLUS_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_PLUS_OTHER_SPIRV_BIN, OPERATOR_PLUS_OTHER_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // prefix increment operator;
@@ -1365,13 +2464,13 @@ NGrid NGrid::operator++(int) {
 // elementwise addition of the specified
 // value to the elements of the array
 void NGrid::operator+=(const float_t value) {
-	*this = this->operator+(value);
+	this->add_into(*this, value);
 }
 
 // elementwise addition of the values of 'other'
 // to the values of the corresponding elements of 'this'
 void NGrid::operator+=(const NGrid& other) {
-	*this = this->operator+(other);
+	this->add_into(*this, other);
 }
 
 
@@ -1385,36 +2484,52 @@ NGrid NGrid::operator-(const float_t value) const {
 	return this->operator+(value * -1);
 }
 
+// operator-(value) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::subtract_into(NGrid& out, const float_t value) const {
+	this->add_into(out, value * -1);
+}
+
 // returns the resulting array of the elementwise substraction of
 // two array of equal dimensions
 NGrid NGrid::operator-(const NGrid& other) const {
 	NGrid result(this->shape);
+	this->subtract_into(result, other);
+	return result;
+}
 
-	static ShaderModule shader(manager->get_device(), OPERATOR_MINUS_OTHER_SPIRV_BIN, OPERATOR_MINUS_OTHER_SPIRV_BYTES);
+// operator-(other) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::subtract_into(NGrid& out, const NGrid& other) const {
+	this->check_output(out, "subtract_into");
+	if (this->on_host(HOST_ELEMENTWISE, out, &other)) {
+		hostkernels::subtract(this->host_read(), other.host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(OPERATOR_MINUS_OTHER_SPIRV_BIN, OPERATOR_MINUS_OTHER_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // prefix decrement operator;
 // decrements the values of the array by -1
 NGrid& NGrid::operator--() {
-	*this = *this + (-1.0f);
+	*this -= 1.0f;
 	return *this;
 }
 
@@ -1433,13 +2548,13 @@ NGrid NGrid::operator--(int) {
 // elementwise substraction of the specified
 // value from the elements of the array
 void NGrid::operator-=(const float_t value) {
-	*this = *this + (value * -1);
+	this->subtract_into(*this, value);
 }
 
 // elementwise substraction of the values of 'other'
 // from the values of the corresponding elements of 'this'
 void NGrid::operator-=(const NGrid& other) {
-	*this = this->operator-(other);
+	this->subtract_into(*this, other);
 }
 
 // +=================================+   
@@ -1449,52 +2564,60 @@ void NGrid::operator-=(const NGrid& other) {
 // returns the product reduction, i.e. the result
 // of multiplication all individual elements of the array
 float_t NGrid::product() const {
-	static ShaderModule shader(manager->get_device(), PRODUCT_SPIRV_BIN, PRODUCT_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(PRODUCT_SPIRV_BIN, PRODUCT_SPIRV_BYTES);
 
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
+	Buffer<float> local_results = scratch_buffer(static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return local_results.read_element(0);
 }
 
 // elementwise multiplication with a scalar
 NGrid NGrid::operator*(const float_t factor) const {
-
 	NGrid result(this->shape);
+	this->multiply_into(result, factor);
+	return result;
+}
+
+// operator*(factor) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::multiply_into(NGrid& out, const float_t factor) const {
+	this->check_output(out, "multiply_into");
+	if (this->on_host(HOST_ELEMENTWISE, out)) {
+		hostkernels::multiply(this->host_read(), factor, out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	static ShaderModule shader(manager->get_device(), OPERATOR_MULTIPLY_SPIRV_BIN, OPERATOR_MULTIPLY_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_MULTIPLY_SPIRV_BIN, OPERATOR_MULTIPLY_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // elementwise multiplication (*=) with a scalar
 void NGrid::operator*=(const float_t factor) {
-	*this = this->operator*(factor);
+	this->multiply_into(*this, factor);
 }
 
 // Alias for 2D or 3D matrix multiplication
@@ -1513,18 +2636,32 @@ float_t NGrid::scalar_product(const NGrid& other) const {
 	return this->Hadamard_product(other).sum();
 }
 
-// 2D matrix product
+// 2D matrix product (or batched matrix product for 3D arrays of shape {batch, m, n});
+// 1d arrays are treated as column vector (first operand) or row vector (second operand);
+// a 2d operand of a batched product is broadcast across the batch
 NGrid NGrid::matrix_product(const NGrid& other) const {
-	if (this->dimensions > 2 || this->dimensions == 0 || other.get_dimensions() > 2 || other.get_dimensions() == 0) {
+	if (this->dimensions > 3 || this->dimensions == 0 || other.get_dimensions() > 3 || other.get_dimensions() == 0) {
 		Log::error("invalid call of NGrid::matrix_product; first array has shape ", this->get_shapestring(), ", second array has shape ",
-			other.get_shapestring(), "; both arrays must be 1d or 2d");
-	}
-	static ShaderModule shader(manager->get_device(), MATRIX_PRODUCT_OTHER_SPIRV_BIN, MATRIX_PRODUCT_OTHER_SPIRV_BYTES);
-
-	uint32_t first_rows = this->shape[0];
-	uint32_t first_cols = this->dimensions == 1 ? 1 : this->shape[1];
-	uint32_t second_rows = other.get_dimensions() == 1 ? 1 : other.get_shape()[0];
-	uint32_t second_cols = other.get_dimensions() == 1 ? other.get_shape()[0] : other.get_shape()[1];
+			other.get_shapestring(), "; both arrays must be 1d, 2d or 3d");
+	}
+	const ShaderModule& shader = shader_module(MATRIX_PRODUCT_TILED_SPIRV_BIN, MATRIX_PRODUCT_TILED_SPIRV_BYTES);
+
+	// batch dimension
+	std::vector<uint32_t> other_shape = other.get_shape();
+	bool batched = this->dimensions == 3 || other.get_dimensions() == 3;
+	uint32_t first_batch = this->dimensions == 3 ? this->shape[0] : 1;
+	uint32_t second_batch = other.get_dimensions() == 3 ? other_shape[0] : 1;
+	if (first_batch != second_batch && first_batch != 1 && second_batch != 1) {
+		Log::error("invalid call of NGrid::matrix_product; the batch sizes of the arrays with shapes ", this->get_shapestring(), " and ",
+			other.get_shapestring(), " don't match");
+	}
+	uint32_t batch = std::max(first_batch, second_batch);
+
+	// matrix dimensions (without the batch dimension)
+	uint32_t first_rows = this->dimensions == 3 ? this->shape[1] : this->shape[0];
+	uint32_t first_cols = this->dimensions == 3 ? this->shape[2] : (this->dimensions == 1 ? 1 : this->shape[1]);
+	uint32_t second_rows = other.get_dimensions() == 3 ? other_shape[1] : (other.get_dimensions() == 1 ? 1 : other_shape[0]);
+	uint32_t second_cols = other.get_dimensions() == 3 ? other_shape[2] : (other.get_dimensions() == 1 ? other_shape[0] : other_shape[1]);
 	uint32_t result_rows = first_rows;
 	uint32_t result_cols = second_cols;
 
@@ -1535,31 +2672,39 @@ NGrid NGrid::matrix_product(const NGrid& other) const {
 
 	// set result array with correct dimensions
 	// the matrix product of A{m,n} and B{n,p} has shape AxB=C{m,p}
-	NGrid result({ result_rows, result_cols });
+	NGrid result = batched ? NGrid({ batch, result_rows, result_cols }) : NGrid({ result_rows, result_cols });
+
+	// kernel variant (passed as specialization constants); vec4 loads if rows of A and B are 16-byte aligned
+	GemmVariant variant = gemm_variant(result_rows, result_cols, first_cols % 4 == 0 && second_cols % 4 == 0);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(
-		this->elements,
-		first_rows,
+		result_rows,
+		result_cols,
 		first_cols,
-		other.get_elements(),
-		second_rows,
+		first_batch == 1 ? 0 : first_rows * first_cols,
+		second_batch == 1 ? 0 : second_rows * second_cols,
+		result_rows * result_cols,
+		first_cols,			// row strides
 		second_cols,
-		result.get_elements(),
-		result_rows,
-		result_cols
+		result_cols,
+		uint32_t(0),		// offsets
+		uint32_t(0),
+		uint32_t(0),
+		1.0f,				// alpha
+		0.0f				// beta
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, variant.wg_x, variant.wg_y, 1, true,
+		{ variant.thread_m, variant.thread_n, variant.tile_k, variant.vec4_loads });
+	execute(pipeline, set, variant.groups_x * variant.wg_x, variant.groups_y * variant.wg_y, batch);
 
 	return result;
 }
@@ -1571,26 +2716,36 @@ NGrid NGrid::matrix_product(const NGrid& other) const {
 // if they don't: only the common elements will be part of the result array
 NGrid NGrid::Hadamard_product(const NGrid& other) const {
 	NGrid result(this->shape);
+	this->Hadamard_product_into(result, other);
+	return result;
+}
 
-	static ShaderModule shader(manager->get_device(), HADAMARD_PRODUCT_OTHER_SPIRV_BIN, HADAMARD_PRODUCT_OTHER_SPIRV_BYTES);
+// Hadamard_product(other) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::Hadamard_product_into(NGrid& out, const NGrid& other) const {
+	this->check_output(out, "Hadamard_product_into");
+	if (this->on_host(HOST_ELEMENTWISE, out, &other)) {
+		hostkernels::multiply(this->host_read(), other.host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(HADAMARD_PRODUCT_OTHER_SPIRV_BIN, HADAMARD_PRODUCT_OTHER_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // +=================================+   
@@ -1605,9 +2760,18 @@ NGrid NGrid::operator/(const float_t quotient) const {
 	return (*this) * (1.0f / quotient);
 }
 
+// operator/(quotient) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::divide_into(NGrid& out, const float_t quotient) const {
+	if (quotient == 0) {
+		Log::error("invalid call of method 'NGrid::divide_into(NGrid& out, const T quotient)' with quotient=0 (zero division is undefined)");
+	}
+	this->multiply_into(out, 1.0f / quotient);
+}
+
 // elementwise division (/=) by a scalar
 void NGrid::operator/=(const float_t quotient) {
-	(*this) *= (1.0f / quotient);
+	this->divide_into(*this, quotient);
 }
 
 // elementwise division of the values of the current
@@ -1616,26 +2780,36 @@ void NGrid::operator/=(const float_t quotient) {
 // the dimensions of the two arrays must match!
 NGrid NGrid::Hadamard_division(const NGrid& other) {
 	NGrid result(this->shape);
+	this->Hadamard_division_into(result, other);
+	return result;
+}
 
-	static ShaderModule shader(manager->get_device(), HADAMARD_DIVISION_OTHER_SPIRV_BIN, HADAMARD_DIVISION_OTHER_SPIRV_BYTES);
+// Hadamard_division(other) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::Hadamard_division_into(NGrid& out, const NGrid& other) const {
+	this->check_output(out, "Hadamard_division_into");
+	if (this->on_host(HOST_ELEMENTWISE, out, &other)) {
+		hostkernels::divide(this->host_read(), other.host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(HADAMARD_DIVISION_OTHER_SPIRV_BIN, HADAMARD_DIVISION_OTHER_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // matrix division of the NGrids;
@@ -1651,32 +2825,36 @@ NGrid NGrid::operator/(const NGrid& other) const {
 // elementwise modulo operation, converting the NGrid values
 // to the remainders of their division by the specified number
 void NGrid::operator%=(const float_t value) {
-	*this = this->operator%(value);
+	this->modulo_into(*this, value);
 }
 
 // elementwise modulo operation, resulting in an NGrid array that
 // contains the remainders of the division of the values of
 // the original array by the specified number
 NGrid NGrid::operator%(const float_t value) const {
-
 	NGrid result(this->shape);
+	this->modulo_into(result, value);
+	return result;
+}
+
+// operator%(value) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::modulo_into(NGrid& out, const float_t value) const {
+	this->check_output(out, "modulo_into");
 
-	static ShaderModule shader(manager->get_device(), OPERATOR_MODULO_SPIRV_BIN, OPERATOR_MODULO_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_MODULO_SPIRV_BIN, OPERATOR_MODULO_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // +=================================+   
@@ -1686,25 +2864,29 @@ NGrid NGrid::operator%(const float_t value) const {
 // elementwise exponentiation to the power of
 // the specified exponent
 NGrid NGrid::pow(const float_t exponent) const {
-
 	NGrid result(this->shape);
+	this->pow_into(result, exponent);
+	return result;
+}
 
-	static ShaderModule shader(manager->get_device(), POW_SPIRV_BIN, POW_SPIRV_BYTES);
+// pow(exponent) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::pow_into(NGrid& out, const float_t exponent) const {
+	this->check_output(out, "pow_into");
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(POW_SPIRV_BIN, POW_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, exponent);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // alias for pow(exponent):
@@ -1724,7 +2906,7 @@ NGrid NGrid::operator^(const NGrid& other) const {
 // elementwise exponentiation of the values of 'this'
 // to the power of the specified exponent
 void NGrid::operator^=(const float_t exponent) {
-	*this = this->pow(exponent);
+	this->pow_into(*this, exponent);
 }
 
 // elementwise exponentiation to the power of
@@ -1732,26 +2914,31 @@ void NGrid::operator^=(const float_t exponent) {
 // the dimensions of the two array must match!
 NGrid NGrid::pow(const NGrid& other) const {
 	NGrid result(this->shape);
+	this->pow_into(result, other);
+	return result;
+}
 
-	static ShaderModule shader(manager->get_device(), POW_OTHER_SPIRV_BIN, POW_OTHER_SPIRV_BYTES);
+// pow(other) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::pow_into(NGrid& out, const NGrid& other) const {
+	this->check_output(out, "pow_into");
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(POW_OTHER_SPIRV_BIN, POW_OTHER_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // converts the individual values of the array
@@ -1766,20 +2953,19 @@ NGrid NGrid::log(float_t base) const {
 	}
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), LOG_SPIRV_BIN, LOG_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(LOG_SPIRV_BIN, LOG_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, base);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1787,20 +2973,19 @@ NGrid NGrid::log(float_t base) const {
 NGrid NGrid::exp() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), EXP_SPIRV_BIN, EXP_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(EXP_SPIRV_BIN, EXP_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1814,20 +2999,19 @@ NGrid NGrid::exp() const {
 NGrid NGrid::round() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ROUND_SPIRV_BIN, ROUND_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ROUND_SPIRV_BIN, ROUND_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1837,20 +3021,19 @@ NGrid NGrid::round() const {
 NGrid NGrid::floor() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), FLOOR_SPIRV_BIN, FLOOR_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FLOOR_SPIRV_BIN, FLOOR_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1860,20 +3043,19 @@ NGrid NGrid::floor() const {
 NGrid NGrid::ceil() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), CEIL_SPIRV_BIN, CEIL_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(CEIL_SPIRV_BIN, CEIL_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1883,20 +3065,19 @@ NGrid NGrid::ceil() const {
 NGrid NGrid::abs() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ABS_SPIRV_BIN, ABS_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ABS_SPIRV_BIN, ABS_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1906,20 +3087,19 @@ NGrid NGrid::abs() const {
 NGrid NGrid::clamp(const float_t min_value, const float_t max_value) const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), CLAMP_SPIRV_BIN, CLAMP_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(CLAMP_SPIRV_BIN, CLAMP_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, min_value, max_value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1933,20 +3113,19 @@ NGrid NGrid::clamp(const float_t min_value, const float_t max_value) const {
 NGrid NGrid::min(const float_t value) const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), MIN_VALUE_SPIRV_BIN, MIN_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(MIN_VALUE_SPIRV_BIN, MIN_VALUE_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1956,20 +3135,19 @@ NGrid NGrid::min(const float_t value) const {
 NGrid NGrid::max(const float_t value) const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), MAX_VALUE_SPIRV_BIN, MAX_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(MAX_VALUE_SPIRV_BIN, MAX_VALUE_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -1979,9 +3157,9 @@ NGrid NGrid::max(const float_t value) const {
 NGrid NGrid::min(const NGrid& other) const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), MIN_OTHER_SPIRV_BIN, MIN_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(MIN_OTHER_SPIRV_BIN, MIN_OTHER_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -1989,13 +3167,12 @@ NGrid NGrid::min(const NGrid& other) const {
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2005,9 +3182,9 @@ NGrid NGrid::min(const NGrid& other) const {
 NGrid NGrid::max(const NGrid& other) const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), MAX_OTHER_SPIRV_BIN, MAX_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(MAX_OTHER_SPIRV_BIN, MAX_OTHER_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -2015,13 +3192,12 @@ NGrid NGrid::max(const NGrid& other) const {
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->dimensions, other.get_dimensions(), this->elements, other.get_elements());
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2036,20 +3212,19 @@ NGrid NGrid::cos(AngularMeasure source_angle_unit) const {
 	float_t factor = static_cast<float_t>(convert_angle(1.0f, source_angle_unit, RAD));
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), COS_SPIRV_BIN, COS_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(COS_SPIRV_BIN, COS_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2060,20 +3235,19 @@ NGrid NGrid::sin(AngularMeasure source_angle_unit) const {
 	float_t factor = static_cast<float_t>(convert_angle(1.0f, source_angle_unit, RAD));
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), SIN_SPIRV_BIN, SIN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SIN_SPIRV_BIN, SIN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2084,20 +3258,19 @@ NGrid NGrid::tan(AngularMeasure source_angle_unit) const {
 	float_t factor = static_cast<float_t>(convert_angle(1.0f, source_angle_unit, RAD));
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), TAN_SPIRV_BIN, TAN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(TAN_SPIRV_BIN, TAN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2109,20 +3282,19 @@ NGrid NGrid::acos(AngularMeasure result_angle_unit) const {
 	float_t factor = static_cast<float_t>(convert_angle(1.0f, RAD, result_angle_unit));
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ACOS_SPIRV_BIN, ACOS_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ACOS_SPIRV_BIN, ACOS_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2134,20 +3306,19 @@ NGrid NGrid::asin(AngularMeasure result_angle_unit) const {
 	float_t factor = static_cast<float_t>(convert_angle(1.0f, RAD, result_angle_unit));
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ASIN_SPIRV_BIN, ASIN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ASIN_SPIRV_BIN, ASIN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2159,20 +3330,19 @@ NGrid NGrid::atan(AngularMeasure result_angle_unit) const {
 	float_t factor = static_cast<float_t>(convert_angle(1.0f, RAD, result_angle_unit));
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ATAN_SPIRV_BIN, ATAN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ATAN_SPIRV_BIN, ATAN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, factor);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2181,20 +3351,19 @@ NGrid NGrid::atan(AngularMeasure result_angle_unit) const {
 NGrid NGrid::cosh() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), COSH_SPIRV_BIN, COSH_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(COSH_SPIRV_BIN, COSH_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2203,20 +3372,19 @@ NGrid NGrid::cosh() const {
 NGrid NGrid::sinh() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), SINH_SPIRV_BIN, SINH_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SINH_SPIRV_BIN, SINH_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2224,43 +3392,52 @@ NGrid NGrid::sinh() const {
 // elementwise application of the hyperbolic tangent function
 NGrid NGrid::tanh() const {
 	NGrid result(this->shape);
+	this->tanh_into(result);
+	return result;
+}
 
-	static ShaderModule shader(manager->get_device(), TANH_SPIRV_BIN, TANH_SPIRV_BYTES);
+// tanh() with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::tanh_into(NGrid& out) const {
+	this->check_output(out, "tanh_into");
+	if (this->on_host(HOST_ACTIVATION, out)) {
+		hostkernels::tanh(this->host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(TANH_SPIRV_BIN, TANH_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // elementwise application of the hyperbolic arc cosine function
 NGrid NGrid::acosh() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ACOSH_SPIRV_BIN, ACOSH_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ACOSH_SPIRV_BIN, ACOSH_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2269,20 +3446,19 @@ NGrid NGrid::acosh() const {
 NGrid NGrid::asinh() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ASINH_SPIRV_BIN, ASINH_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ASINH_SPIRV_BIN, ASINH_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2291,20 +3467,19 @@ NGrid NGrid::asinh() const {
 NGrid NGrid::atanh() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), ATANH_SPIRV_BIN, ATANH_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(ATANH_SPIRV_BIN, ATANH_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2318,20 +3493,19 @@ NGrid NGrid::atanh() const {
 NGrid NGrid::replace(const float_t old_value, const float_t new_value) const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), REPLACE_SPIRV_BIN, REPLACE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(REPLACE_SPIRV_BIN, REPLACE_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, old_value, new_value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2360,22 +3534,21 @@ NGrid NGrid::replace_if(const NGrid& condition_map, const NGrid& replacing_map)
 
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), REPLACE_MAP_IF_OTHER_SPIRV_BIN, REPLACE_MAP_IF_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(REPLACE_MAP_IF_OTHER_SPIRV_BIN, REPLACE_MAP_IF_OTHER_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*condition_map.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*replacing_map.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2402,43 +3575,41 @@ NGrid NGrid::replace_if(const NGrid& condition_map, const float_t replacing_valu
 
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), REPLACE_VALUE_IF_OTHER_SPIRV_BIN, REPLACE_VALUE_IF_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(REPLACE_VALUE_IF_OTHER_SPIRV_BIN, REPLACE_VALUE_IF_OTHER_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*condition_map.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, replacing_value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 // returns the number of occurrences of the specified value;
 uint32_t NGrid::find(const float_t& value) const {
-	static ShaderModule shader(manager->get_device(), FIND_SPIRV_BIN, FIND_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(FIND_SPIRV_BIN, FIND_SPIRV_BYTES);
 
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
+	Buffer<float> local_results = scratch_buffer(static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return static_cast<uint32_t>(local_results.read_element(0));
 }
@@ -2449,50 +3620,276 @@ uint32_t NGrid::find(const float_t& value) const {
 NGrid NGrid::sign() const {
 	NGrid result(this->shape);
 
-	static ShaderModule shader(manager->get_device(), SIGN_SPIRV_BIN, SIGN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SIGN_SPIRV_BIN, SIGN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(this->elements);
+
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
+
+	return result;
+}
+
+// +=================================+   
+// | Scan, Stream Compaction         |
+// +=================================+
+
+// returns the inclusive prefix sums of all elements in memory order (row-major, i.e. the last axis is the fastest)
+NGrid NGrid::cumsum() const {
+	return scan(SCAN_SUM);
+}
+
+// returns the inclusive prefix products of all elements in memory order
+NGrid NGrid::cumprod() const {
+	return scan(SCAN_PRODUCT);
+}
+
+// inclusive scan of all elements into a grid of the same shape;
+// small host-visible grids are scanned on the host (see NGrid::set_host_threshold())
+NGrid NGrid::scan(ScanOp op) const {
+	NGrid result(this->shape);
+	if (this->elements == 0) {
+		return result;
+	}
+	if (this->on_host(HOST_ELEMENTWISE, result)) {
+		const float_t* data = this->host_read();
+		float_t* out = result.host_write();
+		if (op == SCAN_PRODUCT) {
+			float_t running = 1.0f;
+			for (uint32_t i = 0; i < this->elements; i++) {
+				running *= data[i];
+				out[i] = running;
+			}
+		}
+		else {
+			double running = 0.0;
+			for (uint32_t i = 0; i < this->elements; i++) {
+				running += data[i];
+				out[i] = static_cast<float_t>(running);
+			}
+		}
+		result.host_written();
+		return result;
+	}
+	flush(); // the levels are submitted directly on the grid's own command buffer
+	ReductionResources resources;
+	record_scan(resources, op, *this->data_buffer, *result.data_buffer, this->elements);
+	submit_reduction(resources);
+	return result;
+}
+
+// records a multi-level inclusive scan of the first 'elements' values of the input buffer into the output buffer
+// (without submitting it); each level scans blocks of ITEMS * workgroup_size elements and writes one total per block,
+// the totals are scanned in place by the next level until a single block is left; on the way back down,
+// the scanned totals are combined with the elements of the following blocks (three dispatches for up to 1M elements
+// with 256 invocations per workgroup); this reduce-then-scan hierarchy is used instead of a single-pass decoupled look-back,
+// because Vulkan doesn't guarantee the forward progress between workgroups that the look-back relies on;
+// SCAN_COUNT scans the predicates (value != 0) of the input into unsigned integer counts (stored in the float buffer)
+void NGrid::record_scan(ReductionResources& resources, ScanOp op, const Buffer<float_t>& input, Buffer<float_t>& output, uint32_t elements) {
+	const uint32_t MODE_SCAN = 0, MODE_OFFSET = 1, ITEMS = 4; // must match scan.comp
+	const ShaderModule& shader = op == SCAN_COUNT
+		? shader_module(SCAN_COUNT_SPIRV_BIN, SCAN_COUNT_SPIRV_BYTES)
+		: shader_module(SCAN_SPIRV_BIN, SCAN_SPIRV_BYTES);
+	const std::vector<uint32_t> spec_constants = { op == SCAN_PRODUCT ? 1u : 0u };
+	const uint32_t workgroup_size = std::bit_floor(workgroup_size_1d);
+	const uint32_t block_size = ITEMS * workgroup_size;
+	const uint32_t max_groups_x = current_device().get_properties().limits.maxComputeWorkGroupCount[0];
+
+	// blocks beyond the max. workgroup count of the x axis continue along y
+	auto record_level = [&](DescriptorSet& set, uint32_t mode, uint32_t level_elements, uint32_t groups, uint32_t first_level) {
+		uint32_t groups_x = std::min(groups, max_groups_x);
+		uint32_t groups_y = (groups + groups_x - 1) / groups_x;
+		record_pass(resources, shader, set, new PushConstants(mode, level_elements, first_level),
+			groups_x * workgroup_size, groups_y, 1, workgroup_size, 1, spec_constants);
+	};
+
+	struct Level { DescriptorSet* set; uint32_t elements, groups; };
+	std::vector<Level> levels;
+	const Buffer<float_t>* level_input = &input;
+	Buffer<float_t>* level_output = &output;
+	while (true) {
+		uint32_t groups = (elements + block_size - 1) / block_size;
+		resources.buffers.emplace_back(new Buffer<float_t>(scratch_buffer(groups)));
+		Buffer<float_t>* totals = resources.buffers.back().get();
+		DescriptorSet& set = record_set(resources, { level_input, level_output, totals });
+		record_level(set, MODE_SCAN, elements, groups, levels.empty() ? 1 : 0);
+		levels.push_back({ &set, elements, groups });
+		if (groups == 1) {
+			break;
+		}
+		level_input = totals;
+		level_output = totals;
+		elements = groups;
+	}
+	for (size_t k = levels.size() - 1; k-- > 0;) {
+		record_level(*levels[k].set, MODE_OFFSET, levels[k].elements, levels[k].groups, k == 0 ? 1 : 0);
+	}
+}
+
+// returns the number of elements != 0 (e.g. the number of matches of a comparison), without reading the grid back
+uint32_t NGrid::count_nonzero() const {
+	if (this->elements == 0) {
+		return 0;
+	}
+	if (this->on_host(HOST_REDUCTION, *this)) {
+		const float_t* data = this->host_read();
+		return static_cast<uint32_t>(std::count_if(data, data + this->elements, [](float_t value) { return value != 0.0f; }));
+	}
+
+	const ShaderModule& shader = shader_module(COUNT_NONZERO_SPIRV_BIN, COUNT_NONZERO_SPIRV_BYTES);
+
+	Buffer<uint32_t> count(current_device(), BufferUsage::STORAGE_BUFFER, 1,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+	count.set_all(0);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(count, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
+
+	return count.read_element(0);
+}
+
+// stream compaction: returns a 1d grid with the values (or with return_indices=true the flat indices, as float values)
+// of all elements whose corresponding mask element is != 0, in memory order; e.g. grid.where(grid > 0.5f);
+// the mask predicates are scanned on the device, only their total count is read back before the compaction pass
+NGrid NGrid::where(const NGrid& mask, bool return_indices) const {
+	if (mask.get_elements() != this->elements) {
+		Log::warning("invalid usage of method NGrid::where(): the mask must have as many elements as the source; ",
+			"source has shape ", this->get_shapestring(), ", mask has shape ", mask.get_shapestring());
+		return NGrid(std::vector<uint32_t>{ 0 });
+	}
+	if (this->elements == 0) {
+		return NGrid(std::vector<uint32_t>{ 0 });
+	}
+	if (this->on_host(HOST_ELEMENTWISE, *this, &mask)) {
+		const float_t* data = this->host_read();
+		const float_t* mask_data = mask.host_read();
+		std::vector<float_t> values;
+		for (uint32_t i = 0; i < this->elements; i++) {
+			if (mask_data[i] != 0.0f) {
+				values.push_back(return_indices ? static_cast<float_t>(i) : data[i]);
+			}
+		}
+		return values.empty() ? NGrid(std::vector<uint32_t>{ 0 }) : NGrid(values);
+	}
+
+	// output positions = inclusive scan of the mask predicates
+	flush(); // the scan is submitted directly on the grid's own command buffer
+	ReductionResources resources;
+	resources.buffers.emplace_back(new Buffer<float_t>(scratch_buffer(this->elements)));
+	Buffer<float_t>& counts = *resources.buffers.back();
+	record_scan(resources, SCAN_COUNT, *mask.get_buffer(), counts, this->elements);
+	submit_reduction(resources);
+
+	uint32_t count = std::bit_cast<uint32_t>(counts.read_element(this->elements - 1));
+	NGrid result(std::vector<uint32_t>{ count });
+	if (count == 0) {
+		return result;
+	}
+
+	const ShaderModule& shader = shader_module(COMPACT_SPIRV_BIN, COMPACT_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*mask.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(counts, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(this->elements, static_cast<uint32_t>(return_indices));
+
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true); // ('counts' is local)
 
 	return result;
 }
 
+// counts the elements in 'bins' equal-width bins over [lower, upper] on the device; values outside of the range and NaN
+// are ignored, values equal to 'upper' are counted in the last bin; only the counts are read back
+std::vector<uint32_t> NGrid::histogram(uint32_t bins, float_t lower, float_t upper) const {
+	if (bins == 0 || !(upper > lower)) {
+		Log::warning("invalid usage of method NGrid::histogram(): requires bins > 0 and upper > lower, but bins = ", bins,
+			", lower = ", lower, ", upper = ", upper);
+		return std::vector<uint32_t>(bins, 0);
+	}
+	if (this->elements == 0) {
+		return std::vector<uint32_t>(bins, 0);
+	}
+
+	const ShaderModule& shader = shader_module(HISTOGRAM_SPIRV_BIN, HISTOGRAM_SPIRV_BYTES);
+
+	Buffer<uint32_t> counts(current_device(), BufferUsage::STORAGE_BUFFER, bins,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+	counts.set_all(0);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(counts, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(this->elements, bins, lower, upper, static_cast<float_t>(bins) / (upper - lower));
+
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
+
+	return counts.read();
+}
+
+// histogram over the range of the values (a grid with a single distinct value gets the range [value - 0.5, value + 0.5])
+std::vector<uint32_t> NGrid::histogram(uint32_t bins) const {
+	float_t lower = this->min();
+	float_t upper = this->max();
+	if (!(upper > lower)) {
+		lower -= 0.5f;
+		upper += 0.5f;
+	}
+	return histogram(bins, lower, upper);
+}
+
 // +=================================+   
 // | Scaling                         |
 // +=================================+
 
 // scale to specified range
 NGrid NGrid::scale_minmax(float_t range_from, float_t range_to) const {
-	static ShaderModule shader(manager->get_device(), SCALE_MINMAX_SPIRV_BIN, SCALE_MINMAX_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SCALE_MINMAX_SPIRV_BIN, SCALE_MINMAX_SPIRV_BYTES);
 
 	NGrid result(this->shape);
-	Buffer<float> local_min_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
-	Buffer<float> local_max_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
+	Buffer<float> local_min_results = scratch_buffer(static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
+	Buffer<float> local_max_results = scratch_buffer(static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d)));
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_min_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_max_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, range_from, range_to);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
@@ -2500,15 +3897,15 @@ NGrid NGrid::scale_minmax(float_t range_from, float_t range_to) const {
 // mean normalization scaling, i.e.
 // (x - mean) / (max - min)
 NGrid NGrid::scale_mean() const {
-	static ShaderModule shader(manager->get_device(), SCALE_MEAN_SPIRV_BIN, SCALE_MEAN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SCALE_MEAN_SPIRV_BIN, SCALE_MEAN_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 	uint32_t workgroups = static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d));
-	Buffer<float> local_mean_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
-	Buffer<float> local_min_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
-	Buffer<float> local_max_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
+	Buffer<float> local_mean_results = scratch_buffer(workgroups);
+	Buffer<float> local_min_results = scratch_buffer(workgroups);
+	Buffer<float> local_max_results = scratch_buffer(workgroups);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_mean_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -2516,13 +3913,12 @@ NGrid NGrid::scale_mean() const {
 	set.bind_buffer(local_max_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
@@ -2531,25 +3927,24 @@ NGrid NGrid::scale_mean() const {
 // scaling to zero mean and unit-variance, i.e.
 // (x - mean) / sigma
 NGrid NGrid::scale_std() const {
-	static ShaderModule shader(manager->get_device(), SCALE_STD_SPIRV_BIN, SCALE_STD_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(SCALE_STD_SPIRV_BIN, SCALE_STD_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 	uint32_t workgroups = static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d));
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
+	Buffer<float> local_results = scratch_buffer(workgroups);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
@@ -2616,87 +4011,185 @@ NGrid NGrid::derivative(ActFunc activation_function) const {
 	}
 }
 
-// identity activation function
-NGrid NGrid::ident() const {
-	NGrid result(this->shape);
-	result = *this; // copy constructor invocation
-	return result;
-}
-
-// identity activation function derivative
-NGrid NGrid::ident_drv() const {
-	NGrid result(this->shape);
-	result.fill(1.0f);
-	return result;
+// activation() with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::activation_into(NGrid& out, ActFunc activation_function) const {
+	switch (activation_function) {
+	case ActFunc::RELU:
+		this->relu_into(out, 0.0f);
+		break;
+	case ActFunc::LRELU:
+		this->relu_into(out, 0.01f);
+		break;
+	case ActFunc::ELU:
+		this->elu_into(out, 0.0f);
+		break;
+	case ActFunc::LELU:
+		this->elu_into(out, 0.01f);
+		break;
+	case ActFunc::SIGMOID:
+		this->sigmoid_into(out);
+		break;
+	case ActFunc::TANH:
+		this->tanh_into(out);
+		break;
+	default:
+		this->ident_into(out);
+		break;
+	}
 }
 
-// sigmoid activation function
+// derivative() with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::derivative_into(NGrid& out, ActFunc activation_function) const {
+	switch (activation_function) {
+	case ActFunc::RELU:
+		this->relu_drv_into(out, 0.0f);
+		break;
+	case ActFunc::LRELU:
+		this->relu_drv_into(out, 0.01f);
+		break;
+	case ActFunc::ELU:
+		this->elu_drv_into(out, 0.0f);
+		break;
+	case ActFunc::LELU:
+		this->elu_drv_into(out, 0.01f);
+		break;
+	case ActFunc::SIGMOID:
+		this->sigmoid_drv_into(out);
+		break;
+	case ActFunc::TANH:
+		this->tanh_drv_into(out);
+		break;
+	case ActFunc::IDENT:
+		this->ident_drv_into(out);
+		break;
+	default:
+		this->ident_into(out);
+		break;
+	}
+}
+
+// identity activation function
+NGrid NGrid::ident() const {
+	NGrid result(this->shape);
+	result = *this; // copy constructor invocation
+	return result;
+}
+
+// identity activation function derivative
+NGrid NGrid::ident_drv() const {
+	NGrid result(this->shape);
+	result.fill(1.0f);
+	return result;
+}
+
+// ident() with a preallocated result grid of the same shape
+void NGrid::ident_into(NGrid& out) const {
+	this->check_output(out, "ident_into");
+	if (&out != this) {
+		out.set(*this);
+	}
+}
+
+// ident_drv() with a preallocated result grid of the same shape
+void NGrid::ident_drv_into(NGrid& out) const {
+	this->check_output(out, "ident_drv_into");
+	out.fill(1.0f);
+}
+
+// sigmoid activation function
 // 1/(1+exp(-x))
 NGrid NGrid::sigmoid() const {
-	static ShaderModule shader(manager->get_device(), SIGMOID_SPIRV_BIN, SIGMOID_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->sigmoid_into(result);
+	return result;
+}
+
+// sigmoid() with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::sigmoid_into(NGrid& out) const {
+	this->check_output(out, "sigmoid_into");
+	if (this->on_host(HOST_ACTIVATION, out)) {
+		hostkernels::sigmoid(this->host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(SIGMOID_SPIRV_BIN, SIGMOID_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // sigmoid activation derivative
 // exp(x)/pow(exp(x)+1,2)
 NGrid NGrid::sigmoid_drv() const {
-	static ShaderModule shader(manager->get_device(), SIGMOID_DRV_SPIRV_BIN, SIGMOID_DRV_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->sigmoid_drv_into(result);
+	return result;
+}
+
+// sigmoid_drv() with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::sigmoid_drv_into(NGrid& out) const {
+	this->check_output(out, "sigmoid_drv_into");
+	if (this->on_host(HOST_ACTIVATION, out)) {
+		hostkernels::sigmoid_drv(this->host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(SIGMOID_DRV_SPIRV_BIN, SIGMOID_DRV_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // ELU activation function;
 // x>0 ? x : alpha*(exp(x)-1)
 NGrid NGrid::elu(float_t alpha) const {
-	static ShaderModule shader(manager->get_device(), ELU_SPIRV_BIN, ELU_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->elu_into(result, alpha);
+	return result;
+}
+
+// elu(alpha) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::elu_into(NGrid& out, float_t alpha) const {
+	this->check_output(out, "elu_into");
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(ELU_SPIRV_BIN, ELU_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, alpha);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // ELU activation derivative;
@@ -2704,24 +4197,29 @@ NGrid NGrid::elu(float_t alpha) const {
 // small alpha value like e.g. 0.01 for 'leaky' ELU
 // x>0 ? 1 : alpha*exp(x);
 NGrid NGrid::elu_drv(float_t alpha) const {
-	static ShaderModule shader(manager->get_device(), ELU_DRV_SPIRV_BIN, ELU_DRV_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->elu_drv_into(result, alpha);
+	return result;
+}
+
+// elu_drv(alpha) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::elu_drv_into(NGrid& out, float_t alpha) const {
+	this->check_output(out, "elu_drv_into");
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(ELU_DRV_SPIRV_BIN, ELU_DRV_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, alpha);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 
@@ -2729,70 +4227,100 @@ NGrid NGrid::elu_drv(float_t alpha) const {
 // chose alpha=0 for true ReLU function;
 // small alpha value like e.g. 0.01 for 'leaky' ReLU
 NGrid NGrid::relu(float_t alpha) const {
-	static ShaderModule shader(manager->get_device(), RELU_SPIRV_BIN, RELU_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->relu_into(result, alpha);
+	return result;
+}
+
+// relu(alpha) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::relu_into(NGrid& out, float_t alpha) const {
+	this->check_output(out, "relu_into");
+	if (this->on_host(HOST_ACTIVATION, out)) {
+		hostkernels::relu(this->host_read(), alpha, out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(RELU_SPIRV_BIN, RELU_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, alpha);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // ReLU activation derivative;
 // chose alpha=0 for true ReLU function;
 // small alpha value like e.g. 0.01 for 'leaky' ReLU
 NGrid NGrid::relu_drv(float_t alpha) const {
-	static ShaderModule shader(manager->get_device(), RELU_DRV_SPIRV_BIN, RELU_DRV_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->relu_drv_into(result, alpha);
+	return result;
+}
+
+// relu_drv(alpha) with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::relu_drv_into(NGrid& out, float_t alpha) const {
+	this->check_output(out, "relu_drv_into");
+	if (this->on_host(HOST_ACTIVATION, out)) {
+		hostkernels::relu_drv(this->host_read(), alpha, out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(RELU_DRV_SPIRV_BIN, RELU_DRV_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, alpha);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // tanh activation derivative
 NGrid NGrid::tanh_drv() const {
-	static ShaderModule shader(manager->get_device(), TANH_DRV_SPIRV_BIN, TANH_DRV_SPIRV_BYTES);
-
 	NGrid result(this->shape);
+	this->tanh_drv_into(result);
+	return result;
+}
+
+// tanh_drv() with a preallocated result grid of the same shape;
+// 'out' may also be this grid itself (in-place operation)
+void NGrid::tanh_drv_into(NGrid& out) const {
+	this->check_output(out, "tanh_drv_into");
+	if (this->on_host(HOST_ACTIVATION, out)) {
+		hostkernels::tanh_drv(this->host_read(), out.host_write(), this->elements);
+		out.host_written();
+		return;
+	}
 
-	DescriptorSet set(manager->get_device());
+	const ShaderModule& shader = shader_module(TANH_DRV_SPIRV_BIN, TANH_DRV_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*out.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
-
-	return result;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 }
 
 // +=================================+   
@@ -2801,75 +4329,72 @@ NGrid NGrid::tanh_drv() const {
 
 // truncate outliers by z-score mean deviation
 NGrid NGrid::outliers_truncate(float_t z_score) const {
-	static ShaderModule shader(manager->get_device(), OUTLIERS_TRUNCATE_SPIRV_BIN, OUTLIERS_TRUNCATE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OUTLIERS_TRUNCATE_SPIRV_BIN, OUTLIERS_TRUNCATE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 	uint32_t workgroups = static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d));
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
+	Buffer<float> local_results = scratch_buffer(workgroups);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, z_score);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
 
 // set outliers (by z-score) to mean
 NGrid NGrid::outliers_mean_imputation(float_t z_score) const {
-	static ShaderModule shader(manager->get_device(), OUTLIERS_MEAN_IMPUTATION_SPIRV_BIN, OUTLIERS_MEAN_IMPUTATION_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OUTLIERS_MEAN_IMPUTATION_SPIRV_BIN, OUTLIERS_MEAN_IMPUTATION_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 	uint32_t workgroups = static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d));
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
+	Buffer<float> local_results = scratch_buffer(workgroups);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, z_score);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
 
 // set outliers (by z-score) to value
 NGrid NGrid::outliers_value_imputation(float_t value, float_t z_score) const {
-	static ShaderModule shader(manager->get_device(), OUTLIERS_VALUE_IMPUTATION_SPIRV_BIN, OUTLIERS_VALUE_IMPUTATION_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OUTLIERS_VALUE_IMPUTATION_SPIRV_BIN, OUTLIERS_VALUE_IMPUTATION_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 	uint32_t workgroups = static_cast<uint32_t>(std::ceil(static_cast<float_t>(this->elements) / workgroup_size_1d));
-	Buffer<float> local_results(manager->get_device(), BufferUsage::STORAGE_BUFFER, workgroups);
+	Buffer<float> local_results = scratch_buffer(workgroups);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(local_results, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, z_score, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
@@ -2877,22 +4402,21 @@ NGrid NGrid::outliers_value_imputation(float_t value, float_t z_score) const {
 // recover -inf, +inf or nan values
 // (replace with -FLOAT_MAX, +FLOAT_MAX or 0)
 NGrid NGrid::recover() const {
-	static ShaderModule shader(manager->get_device(), RECOVER_SPIRV_BIN, RECOVER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(RECOVER_SPIRV_BIN, RECOVER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -2902,135 +4426,129 @@ NGrid NGrid::recover() const {
 // +=================================+
 
 NGrid NGrid::operator>(const float_t value) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_GREATER_VALUE_SPIRV_BIN, OPERATOR_GREATER_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_GREATER_VALUE_SPIRV_BIN, OPERATOR_GREATER_VALUE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 
 NGrid NGrid::operator>=(const float_t value) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_GREATER_EQUAL_VALUE_SPIRV_BIN, OPERATOR_GREATER_EQUAL_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_GREATER_EQUAL_VALUE_SPIRV_BIN, OPERATOR_GREATER_EQUAL_VALUE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator==(const float_t value) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_EQUAL_VALUE_SPIRV_BIN, OPERATOR_EQUAL_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_EQUAL_VALUE_SPIRV_BIN, OPERATOR_EQUAL_VALUE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator!=(const float_t value) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_NOT_EQUAL_VALUE_SPIRV_BIN, OPERATOR_NOT_EQUAL_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_NOT_EQUAL_VALUE_SPIRV_BIN, OPERATOR_NOT_EQUAL_VALUE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator<(const float_t value) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_SMALLER_VALUE_SPIRV_BIN, OPERATOR_SMALLER_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_SMALLER_VALUE_SPIRV_BIN, OPERATOR_SMALLER_VALUE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator<=(const float_t value) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_SMALLER_EQUAL_VALUE_SPIRV_BIN, OPERATOR_SMALLER_EQUAL_VALUE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_SMALLER_EQUAL_VALUE_SPIRV_BIN, OPERATOR_SMALLER_EQUAL_VALUE_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements, value);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 // elementwise comparison with second NGrid
 NGrid NGrid::operator>(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_GREATER_OTHER_SPIRV_BIN, OPERATOR_GREATER_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_GREATER_OTHER_SPIRV_BIN, OPERATOR_GREATER_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3048,25 +4566,24 @@ NGrid NGrid::operator>(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator>=(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_GREATER_EQUAL_OTHER_SPIRV_BIN, OPERATOR_GREATER_EQUAL_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_GREATER_EQUAL_OTHER_SPIRV_BIN, OPERATOR_GREATER_EQUAL_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3084,25 +4601,24 @@ NGrid NGrid::operator>=(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator==(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_EQUAL_OTHER_SPIRV_BIN, OPERATOR_EQUAL_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_EQUAL_OTHER_SPIRV_BIN, OPERATOR_EQUAL_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3120,25 +4636,24 @@ NGrid NGrid::operator==(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator!=(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_NOT_EQUAL_OTHER_SPIRV_BIN, OPERATOR_NOT_EQUAL_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_NOT_EQUAL_OTHER_SPIRV_BIN, OPERATOR_NOT_EQUAL_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3156,25 +4671,24 @@ NGrid NGrid::operator!=(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator<(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_SMALLER_OTHER_SPIRV_BIN, OPERATOR_SMALLER_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_SMALLER_OTHER_SPIRV_BIN, OPERATOR_SMALLER_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3192,25 +4706,24 @@ NGrid NGrid::operator<(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator<=(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_SMALLER_EQUAL_OTHER_SPIRV_BIN, OPERATOR_SMALLER_EQUAL_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_SMALLER_EQUAL_OTHER_SPIRV_BIN, OPERATOR_SMALLER_EQUAL_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3228,19 +4741,18 @@ NGrid NGrid::operator<=(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -3274,28 +4786,27 @@ NGrid NGrid::operator||(const bool value) const {
 }
 
 NGrid NGrid::operator!() const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_NOT_SPIRV_BIN, OPERATOR_NOT_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_NOT_SPIRV_BIN, OPERATOR_NOT_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator&&(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_AND_OTHER_SPIRV_BIN, OPERATOR_AND_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_AND_OTHER_SPIRV_BIN, OPERATOR_AND_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3313,25 +4824,24 @@ NGrid NGrid::operator&&(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
 
 NGrid NGrid::operator||(const NGrid& other) const {
-	static ShaderModule shader(manager->get_device(), OPERATOR_OR_OTHER_SPIRV_BIN, OPERATOR_OR_OTHER_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(OPERATOR_OR_OTHER_SPIRV_BIN, OPERATOR_OR_OTHER_SPIRV_BYTES);
 
 	NGrid result(this->shape);
 
@@ -3349,18 +4859,17 @@ NGrid NGrid::operator||(const NGrid& other) const {
 		}
 	}
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(this->elements);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -3372,7 +4881,7 @@ NGrid NGrid::operator||(const NGrid& other) const {
 // conversion to 1d array
 NGrid NGrid::flatten() const {
 	NGrid result(this->elements);
-	result.get_buffer()->write(*this->data_buffer);
+	result.set(*this);
 	return result;
 }
 
@@ -3388,16 +4897,16 @@ NGrid NGrid::reshape(const std::vector<uint32_t>& new_shape, float_t default_ini
 	}
 	else {
 		// load shader
-		static ShaderModule shader(manager->get_device(), RESIZE_SPIRV_BIN, RESIZE_SPIRV_BYTES);
+		const ShaderModule& shader = shader_module(RESIZE_SPIRV_BIN, RESIZE_SPIRV_BYTES);
 
 		// bind buffers to a descriptor set
-		DescriptorSet set(manager->get_device());
+		DescriptorSet set(current_device());
 		set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*result.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.finalize_layout();
-		descriptor_pool->allocate_set(set);
+		context().descriptor_pool.allocate_set(set);
 
 		// define push constants
 		PushConstants constants(
@@ -3409,9 +4918,8 @@ NGrid NGrid::reshape(const std::vector<uint32_t>& new_shape, float_t default_ini
 		);
 
 		// execute compute pipeline
-		ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-		command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-		descriptor_pool->release_set(set);
+		ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+		execute(pipeline, set, result.get_elements());
 	}
 	return result;
 }
@@ -3441,7 +4949,7 @@ NGrid NGrid::concatenate(const NGrid& other, const uint32_t axis) const {
 		}
 	}
 
-	static ShaderModule shader(manager->get_device(), CONCATENATE_SPIRV_BIN, CONCATENATE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(CONCATENATE_SPIRV_BIN, CONCATENATE_SPIRV_BYTES);
 
 	std::vector<uint32_t> result_shape = this->shape;
 	if (axis == this->dimensions + 1) {
@@ -3451,7 +4959,7 @@ NGrid NGrid::concatenate(const NGrid& other, const uint32_t axis) const {
 
 	NGrid result(result_shape);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*other.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -3460,7 +4968,7 @@ NGrid NGrid::concatenate(const NGrid& other, const uint32_t axis) const {
 	set.bind_buffer(*result.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(
 		this->dimensions,
@@ -3471,9 +4979,8 @@ NGrid NGrid::concatenate(const NGrid& other, const uint32_t axis) const {
 		axis
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements());
 
 	return result;
 }
@@ -3487,15 +4994,15 @@ NGrid NGrid::padding(const uint32_t amount, const float_t init_value) const {
 	}
 	NGrid result(result_shape);
 
-	static ShaderModule shader(manager->get_device(), PADDING_SPIRV_BIN, PADDING_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(PADDING_SPIRV_BIN, PADDING_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(
 		this->dimensions,
@@ -3505,9 +5012,8 @@ NGrid NGrid::padding(const uint32_t amount, const float_t init_value) const {
 		init_value
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements());
 
 	return result;
 }
@@ -3522,7 +5028,7 @@ NGrid NGrid::pool_max(const std::vector<uint32_t>& window_shape, const std::vect
 	}
 
 	// copy window shape to a storage buffer
-	Buffer<uint32_t> window_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
+	Buffer<uint32_t> window_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
 	window_shape_buffer.write(window_shape);
 
 	// calculate window elements
@@ -3533,7 +5039,7 @@ NGrid NGrid::pool_max(const std::vector<uint32_t>& window_shape, const std::vect
 
 	// copy stride shape to a storage buffer
 	// (if stride shape is empty, use window shape as default)
-	Buffer<uint32_t> stride_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> stride_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	stride_shape_buffer.write(stride_shape.size() == 0 ? window_shape : stride_shape);
 
 
@@ -3553,9 +5059,9 @@ NGrid NGrid::pool_max(const std::vector<uint32_t>& window_shape, const std::vect
 	}
 	NGrid result(result_shape);
 
-	static ShaderModule shader(manager->get_device(), POOL_MAX_SPIRV_BIN, POOL_MAX_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(POOL_MAX_SPIRV_BIN, POOL_MAX_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(window_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -3563,7 +5069,7 @@ NGrid NGrid::pool_max(const std::vector<uint32_t>& window_shape, const std::vect
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(stride_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(
 		this->dimensions,
@@ -3572,9 +5078,8 @@ NGrid NGrid::pool_max(const std::vector<uint32_t>& window_shape, const std::vect
 		window_N
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements(), 1, 1, true);
 	return result;
 }
 
@@ -3595,7 +5100,7 @@ NGrid NGrid::pool_maxabs(const std::vector<uint32_t>& window_shape, const std::v
 	}
 
 	// copy window shape to a storage buffer
-	Buffer<uint32_t> window_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
+	Buffer<uint32_t> window_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
 	window_shape_buffer.write(window_shape);
 
 	// calculate window elements
@@ -3606,7 +5111,7 @@ NGrid NGrid::pool_maxabs(const std::vector<uint32_t>& window_shape, const std::v
 
 	// copy stride shape to a storage buffer
 	// (if stride shape is empty, use window shape as default)
-	Buffer<uint32_t> stride_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> stride_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	stride_shape_buffer.write(stride_shape.size() == 0 ? window_shape : stride_shape);
 
 	// calculate result shape
@@ -3625,9 +5130,9 @@ NGrid NGrid::pool_maxabs(const std::vector<uint32_t>& window_shape, const std::v
 	}
 	NGrid result(result_shape);
 
-	static ShaderModule shader(manager->get_device(), POOL_MAXABS_SPIRV_BIN, POOL_MAXABS_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(POOL_MAXABS_SPIRV_BIN, POOL_MAXABS_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(window_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -3635,7 +5140,7 @@ NGrid NGrid::pool_maxabs(const std::vector<uint32_t>& window_shape, const std::v
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(stride_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(
 		this->dimensions,
@@ -3644,9 +5149,8 @@ NGrid NGrid::pool_maxabs(const std::vector<uint32_t>& window_shape, const std::v
 		window_N
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements(), 1, 1, true);
 	return result;
 }
 
@@ -3667,7 +5171,7 @@ NGrid NGrid::pool_min(const std::vector<uint32_t>& window_shape, const std::vect
 	}
 
 	// copy window shape to a storage buffer
-	Buffer<uint32_t> window_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
+	Buffer<uint32_t> window_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
 	window_shape_buffer.write(window_shape);
 
 	// calculate window elements
@@ -3678,7 +5182,7 @@ NGrid NGrid::pool_min(const std::vector<uint32_t>& window_shape, const std::vect
 
 	// copy stride shape to a storage buffer
 	// (if stride shape is empty, use window shape as default)
-	Buffer<uint32_t> stride_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> stride_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	stride_shape_buffer.write(stride_shape.size() == 0 ? window_shape : stride_shape);
 
 	// calculate result shape
@@ -3697,9 +5201,9 @@ NGrid NGrid::pool_min(const std::vector<uint32_t>& window_shape, const std::vect
 	}
 	NGrid result(result_shape);
 
-	static ShaderModule shader(manager->get_device(), POOL_MIN_SPIRV_BIN, POOL_MIN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(POOL_MIN_SPIRV_BIN, POOL_MIN_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(window_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -3707,7 +5211,7 @@ NGrid NGrid::pool_min(const std::vector<uint32_t>& window_shape, const std::vect
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(stride_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	PushConstants constants(
 		this->dimensions,
@@ -3716,9 +5220,8 @@ NGrid NGrid::pool_min(const std::vector<uint32_t>& window_shape, const std::vect
 		window_N
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements(), 1, 1, true);
 	return result;
 }
 
@@ -3739,7 +5242,7 @@ NGrid NGrid::pool_mean(const std::vector<uint32_t>& window_shape, const std::vec
 	}
 
 	// copy window shape to a storage buffer
-	Buffer<uint32_t> window_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
+	Buffer<uint32_t> window_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, window_shape.size());
 	window_shape_buffer.write(window_shape);
 
 	// calculate window elements
@@ -3750,7 +5253,7 @@ NGrid NGrid::pool_mean(const std::vector<uint32_t>& window_shape, const std::vec
 
 	// copy stride shape to a storage buffer
 	// (if stride shape is empty, use window shape as default)
-	Buffer<uint32_t> stride_shape_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> stride_shape_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	stride_shape_buffer.write(stride_shape.size() == 0 ? window_shape : stride_shape);
 
 	// calculate result shape
@@ -3770,10 +5273,10 @@ NGrid NGrid::pool_mean(const std::vector<uint32_t>& window_shape, const std::vec
 	NGrid result(result_shape);
 
 	// load shader
-	static ShaderModule shader(manager->get_device(), POOL_MEAN_SPIRV_BIN, POOL_MEAN_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(POOL_MEAN_SPIRV_BIN, POOL_MEAN_SPIRV_BYTES);
 
 	// define descriptor set
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(window_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -3781,7 +5284,7 @@ NGrid NGrid::pool_mean(const std::vector<uint32_t>& window_shape, const std::vec
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(stride_shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	// define push constants
 	PushConstants constants(
@@ -3792,9 +5295,8 @@ NGrid NGrid::pool_mean(const std::vector<uint32_t>& window_shape, const std::vec
 	);
 
 	// execute compute pipeline
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements(), 1, 1, true);
 	return result;
 }
 
@@ -3804,6 +5306,10 @@ NGrid NGrid::pool_mean(const std::initializer_list<uint32_t>& window_shape, cons
 	return this->pool_mean(window_shape_vec, stride_shape_vec);
 }
 
+// N-dimensional cross-correlation with a kernel of the same dimensions
+// (with 'padding_amount' elements of value 'padding_value' at both ends of each axis);
+// 1d, 2d and 3d grids run on the convolution engine (see conv2d()), with the depth of 3d grids
+// handled as input channels of a 2d convolution; higher dimensions use the generic shader
 NGrid NGrid::convolution(const NGrid& kernel, uint32_t padding_amount, float_t padding_value) const {
 	// check if kernel has valid dimensions
 	if (kernel.get_dimensions() != this->dimensions) {
@@ -3811,19 +5317,57 @@ NGrid NGrid::convolution(const NGrid& kernel, uint32_t padding_amount, float_t p
 			") must match the dimensions of 'this' (", this->dimensions, ")");
 		return *this; // return unmodified grid
 	}
+	std::vector<uint32_t> kernel_shape = kernel.get_shape();
+	for (uint32_t i = 0; i < this->dimensions; i++) {
+		if (kernel_shape[i] > this->shape[i] + 2 * padding_amount) {
+			Log::warning("invalid usage of NGrid::convolution: the kernel with shape ", kernel.get_shapestring(),
+				" is larger than the padded array with shape ", this->get_shapestring());
+			return *this; // return unmodified grid
+		}
+	}
 
 	// calculate result shape
 	std::vector<uint32_t> result_shape = this->shape;
 	for (uint32_t i = 0; i < this->dimensions; i++) {
-		result_shape[i] = result_shape[i] - kernel.get_shape()[i] + 1 + (2 * padding_amount);
+		result_shape[i] = result_shape[i] - kernel_shape[i] + 1 + (2 * padding_amount);
+	}
+
+	if (this->dimensions <= 3) {
+		// the engine pads with zeros, other padding values are applied to the input first
+		if (padding_amount != 0 && padding_value != 0.0f) {
+			return this->padding(padding_amount, padding_value).convolution(kernel);
+		}
+		NGrid result(result_shape);
+		uint32_t last = this->dimensions - 1;
+		ConvShape conv;
+		conv.width = this->shape[last];
+		conv.kernel_w = kernel_shape[last];
+		conv.out_w = result_shape[last];
+		conv.padding_x = padding_amount;
+		if (this->dimensions >= 2) {
+			conv.height = this->shape[last - 1];
+			conv.kernel_h = kernel_shape[last - 1];
+			conv.out_h = result_shape[last - 1];
+			conv.padding_y = padding_amount;
+		}
+		if (this->dimensions == 3) {
+			// output plane d correlates the input planes d - padding_amount ... d - padding_amount + kernel depth - 1
+			// with the kernel planes, i.e. it is a batch element whose input channels are consecutive planes
+			conv.batches = result_shape[0];
+			conv.in_channels = kernel_shape[0];
+			conv.plane_offset = padding_amount;
+			conv.total_planes = this->shape[0];
+		}
+		run_conv2d_auto(conv, *data_buffer, *kernel.get_buffer(), *result.get_buffer());
+		return result;
 	}
 	NGrid result(result_shape);
 
 	// load shader
-	static ShaderModule shader(manager->get_device(), CONVOLUTION_SPIRV_BIN, CONVOLUTION_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(CONVOLUTION_SPIRV_BIN, CONVOLUTION_SPIRV_BYTES);
 
 	// define descriptor set
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*kernel.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
@@ -3831,7 +5375,7 @@ NGrid NGrid::convolution(const NGrid& kernel, uint32_t padding_amount, float_t p
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	// define push constants
 	PushConstants constants(
@@ -3844,12 +5388,387 @@ NGrid NGrid::convolution(const NGrid& kernel, uint32_t padding_amount, float_t p
 	);
 
 	// execute compute pipeline
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-	command_buffer->compute(pipeline, result.get_elements(), 1, 1, true, fence_timeout_nanosec);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	execute(pipeline, set, result.get_elements());
+	return result;
+}
+
+// batched multi-channel 2D cross-correlation (as in convolutional layers);
+// the input has shape {in_channels, height, width} or {batch, in_channels, height, width},
+// the weights have shape {out_channels, in_channels, kernel_h, kernel_w}, the result has shape
+// {out_channels, out_h, out_w} or {batch, out_channels, out_h, out_w} with out_h = (height + 2 * padding - kernel_h) / stride + 1;
+// the input is zero-padded by 'padding' elements on each side; with CONV_AUTO the algorithm is chosen from the shapes
+NGrid NGrid::conv2d(const NGrid& weights, uint32_t stride, uint32_t padding, ConvAlgorithm algorithm) const {
+	ConvShape conv = conv2d_shape(weights, stride, padding);
+	std::vector<uint32_t> result_shape = { conv.out_channels, conv.out_h, conv.out_w };
+	if (this->dimensions == 4) {
+		result_shape.insert(result_shape.begin(), conv.batches);
+	}
+	NGrid result(result_shape);
+
+	if (algorithm != CONV_AUTO && !conv_supported(conv, algorithm)) {
+		Log::warning("invalid usage of NGrid::conv2d: algorithm ", algorithm, " doesn't support a ", conv.kernel_h, "x", conv.kernel_w,
+			" kernel with stride ", stride, " for an input with shape ", this->get_shapestring(), ", choosing the algorithm automatically");
+		algorithm = CONV_AUTO;
+	}
+	if (algorithm == CONV_AUTO) {
+		run_conv2d_auto(conv, *data_buffer, *weights.get_buffer(), *result.get_buffer());
+	}
+	else {
+		run_conv2d(conv, *data_buffer, *weights.get_buffer(), *result.get_buffer(), algorithm);
+	}
 	return result;
 }
 
+// returns the algorithm that conv2d() uses with CONV_AUTO for the given arguments
+// (the autotuned algorithm if the shape has been tuned before, otherwise the heuristic choice)
+NGrid::ConvAlgorithm NGrid::conv2d_algorithm(const NGrid& weights, uint32_t stride, uint32_t padding) const {
+	return select_conv_algorithm(conv2d_shape(weights, stride, padding));
+}
+
+// enables or disables autotuning of CONV_AUTO: if enabled, the first convolution of each shape (per device)
+// times all supported algorithms and remembers the fastest one for all subsequent convolutions of that shape
+void NGrid::set_conv_autotuning(bool enabled) {
+	conv_autotuning = enabled;
+}
+
+// validates the arguments of conv2d() and returns the geometry of the convolution
+NGrid::ConvShape NGrid::conv2d_shape(const NGrid& weights, uint32_t stride, uint32_t padding) const {
+	if ((this->dimensions != 3 && this->dimensions != 4) || weights.get_dimensions() != 4) {
+		Log::error("invalid call of NGrid::conv2d; the input must have shape {channels, height, width} or {batch, channels, height, width} ",
+			"and the weights must have shape {out_channels, in_channels, kernel_h, kernel_w}, but the shapes are ",
+			this->get_shapestring(), " and ", weights.get_shapestring());
+	}
+	std::vector<uint32_t> weights_shape = weights.get_shape();
+	uint32_t axis = this->dimensions - 3;
+	ConvShape conv;
+	conv.batches = this->dimensions == 4 ? this->shape[0] : 1;
+	conv.in_channels = this->shape[axis];
+	conv.height = this->shape[axis + 1];
+	conv.width = this->shape[axis + 2];
+	conv.out_channels = weights_shape[0];
+	conv.kernel_h = weights_shape[2];
+	conv.kernel_w = weights_shape[3];
+	conv.stride = stride;
+	conv.padding_y = padding;
+	conv.padding_x = padding;
+	if (weights_shape[1] != conv.in_channels) {
+		Log::error("invalid call of NGrid::conv2d; the weights with shape ", weights.get_shapestring(), " expect ", weights_shape[1],
+			" input channels, but the input with shape ", this->get_shapestring(), " has ", conv.in_channels);
+	}
+	if (stride == 0 || conv.kernel_h > conv.height + 2 * padding || conv.kernel_w > conv.width + 2 * padding) {
+		Log::error("invalid call of NGrid::conv2d; the stride must be at least 1 and the kernel of the weights with shape ", weights.get_shapestring(),
+			" must fit into the padded input with shape ", this->get_shapestring(), " (padding: ", padding, ")");
+	}
+	conv.out_h = (conv.height + 2 * padding - conv.kernel_h) / stride + 1;
+	conv.out_w = (conv.width + 2 * padding - conv.kernel_w) / stride + 1;
+
+	// consecutive input channels of a batch element are consecutive planes
+	conv.batch_planes = conv.in_channels;
+	conv.channel_planes = 1;
+	conv.plane_offset = 0;
+	conv.total_planes = conv.batches * conv.in_channels;
+	return conv;
+}
+
+// returns true if the algorithm can be used for the convolution
+// (kernel and stride limits of the shaders, sizes of the temporary buffers)
+bool NGrid::conv_supported(const ConvShape& conv, ConvAlgorithm algorithm) {
+	uint64_t max_floats = current_device().get_properties().limits.maxStorageBufferRange / sizeof(float_t);
+	uint64_t outputs = uint64_t(conv.batches) * conv.out_channels * conv.out_h * conv.out_w;
+	switch (algorithm) {
+	case CONV_DIRECT: {
+		// tile limits of conv2d_direct.comp
+		return conv.kernel_h <= 9 && conv.kernel_w <= 9 && conv.stride <= 2;
+	}
+	case CONV_WINOGRAD: {
+		uint64_t columns = uint64_t(conv.batches) * ((conv.out_h + 1) / 2) * ((conv.out_w + 1) / 2);
+		return conv.kernel_h == 3 && conv.kernel_w == 3 && conv.stride == 1
+			&& 16 * columns * std::max(conv.in_channels, conv.out_channels) <= max_floats;
+	}
+	case CONV_IM2COL: {
+		uint64_t columns = uint64_t(conv.batches) * conv.in_channels * conv.kernel_h * conv.kernel_w * conv.out_h * conv.out_w;
+		return columns <= max_floats;
+	}
+	case CONV_FFT: {
+		uint64_t plane_size = uint64_t(std::bit_ceil(conv.height + 2 * conv.padding_y)) * std::bit_ceil(conv.width + 2 * conv.padding_x);
+		uint64_t planes = std::max({ uint64_t(conv.batches) * conv.in_channels, uint64_t(conv.out_channels) * conv.in_channels, uint64_t(conv.batches) * conv.out_channels });
+		return 2 * planes * plane_size <= max_floats && outputs <= max_floats;
+	}
+	default:
+		return false;
+	}
+}
+
+// chooses an algorithm from the shapes: FFT for large kernels (the cost doesn't depend on the kernel size),
+// Winograd for 3x3 kernels (2.25x fewer multiplications), direct tiles for small kernels with few channels
+// and im2col + matrix product if the channels provide enough work for the tiled GEMM
+NGrid::ConvAlgorithm NGrid::conv_heuristic(const ConvShape& conv) {
+	uint32_t taps = conv.kernel_h * conv.kernel_w;
+	uint32_t channel_pairs = conv.in_channels * conv.out_channels;
+	if (taps >= 121 && conv.stride == 1 && conv_supported(conv, CONV_FFT)) {
+		return CONV_FFT;
+	}
+	if (conv.out_h * conv.out_w >= 16 && channel_pairs >= 16 && conv_supported(conv, CONV_WINOGRAD)) {
+		return CONV_WINOGRAD;
+	}
+	if (conv_supported(conv, CONV_DIRECT) && (channel_pairs <= 64 || !conv_supported(conv, CONV_IM2COL))) {
+		return CONV_DIRECT;
+	}
+	if (conv_supported(conv, CONV_IM2COL) || !conv_supported(conv, CONV_FFT)) {
+		return CONV_IM2COL;
+	}
+	return CONV_FFT;
+}
+
+// returns the algorithm for CONV_AUTO: the entry of the autotuning table if the shape has been tuned, otherwise the heuristic choice
+NGrid::ConvAlgorithm NGrid::select_conv_algorithm(const ConvShape& conv) {
+	std::lock_guard<std::mutex> lock(conv_tuning_mutex);
+	auto entry = conv_tuning_table.find(conv_tuning_key(conv));
+	return entry != conv_tuning_table.end() ? entry->second : conv_heuristic(conv);
+}
+
+// key of the autotuning table (device index and geometry)
+std::vector<uint32_t> NGrid::conv_tuning_key(const ConvShape& conv) {
+	return { context().device_index, conv.batches, conv.in_channels, conv.out_channels, conv.height, conv.width, conv.kernel_h, conv.kernel_w,
+		conv.stride, conv.padding_y, conv.padding_x, conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes };
+}
+
+// runs a convolution with CONV_AUTO; with autotuning enabled, the first convolution of each shape runs all supported
+// algorithms (a warm-up run for the pipeline creation, then a timed run) and stores the fastest one in the autotuning table;
+// every candidate writes the complete result, so no extra run is needed afterwards
+void NGrid::run_conv2d_auto(const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result) {
+	std::vector<uint32_t> key = conv_tuning_key(conv);
+	bool tuned = false;
+	{
+		std::lock_guard<std::mutex> lock(conv_tuning_mutex);
+		tuned = conv_tuning_table.count(key) != 0;
+	}
+	if (!conv_autotuning || tuned) {
+		run_conv2d(conv, input, weights, result, select_conv_algorithm(conv));
+		return;
+	}
+
+	ConvAlgorithm best = conv_heuristic(conv);
+	double best_seconds = std::numeric_limits<double>::max();
+	for (ConvAlgorithm candidate : { CONV_DIRECT, CONV_WINOGRAD, CONV_IM2COL, CONV_FFT }) {
+		if (!conv_supported(conv, candidate)) {
+			continue;
+		}
+		run_conv2d(conv, input, weights, result, candidate);
+		auto start = std::chrono::steady_clock::now();
+		run_conv2d(conv, input, weights, result, candidate);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+			best = candidate;
+		}
+	}
+	LOG_DEBUG("NGrid convolution autotuning: algorithm ", best, " for a ", conv.kernel_h, "x", conv.kernel_w, " kernel, ",
+		conv.in_channels, " -> ", conv.out_channels, " channels, ", conv.height, "x", conv.width, " input (", best_seconds * 1e6, " us)");
+	std::lock_guard<std::mutex> lock(conv_tuning_mutex);
+	conv_tuning_table[key] = best;
+}
+
+// runs a convolution with the given algorithm; all passes are recorded into the grid's own command buffer
+// and submitted at once, so any batched work on the operands has to be completed first
+void NGrid::run_conv2d(const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result, ConvAlgorithm algorithm) {
+	flush();
+	ReductionResources resources;
+	switch (algorithm) {
+	case CONV_WINOGRAD:
+		record_conv_winograd(resources, conv, input, weights, result);
+		break;
+	case CONV_IM2COL:
+		record_conv_im2col(resources, conv, input, weights, result);
+		break;
+	case CONV_FFT:
+		record_conv_fft(resources, conv, input, weights, result);
+		break;
+	default:
+		record_conv_direct(resources, conv, input, weights, result);
+		break;
+	}
+	submit_reduction(resources);
+}
+
+// records one dispatch of a multi-pass operation into the grid's own command buffer;
+// takes ownership of the push constants, which are kept alive by 'resources' together with the pipeline
+void NGrid::record_pass(ReductionResources& resources, const ShaderModule& shader, DescriptorSet& set, PushConstants* constants,
+	uint32_t global_size_x, uint32_t global_size_y, uint32_t global_size_z, uint32_t workgroup_size_x, uint32_t workgroup_size_y,
+	const std::vector<uint32_t>& specialization_constants, std::source_location location) {
+	resources.constants.emplace_back(constants);
+	resources.pipelines.emplace_back(new ComputePipeline(current_device(), shader, *constants, set,
+		workgroup_size_x, workgroup_size_y, 1, true, specialization_constants, location));
+#ifdef PROFILING
+	CommandBuffer::set_profile_label(Profiler::function_name(location.function_name()), "", Profiler::sample());
+#endif
+	context().command_buffer.compute(*resources.pipelines.back(), global_size_x, global_size_y, global_size_z, false, 0, true);
+}
+
+// allocates a descriptor set of a multi-pass operation with the given buffers (bindings in the given order)
+DescriptorSet& NGrid::record_set(ReductionResources& resources, const std::vector<const Buffer<float_t>*>& buffers) {
+	resources.sets.emplace_back(new DescriptorSet(current_device()));
+	DescriptorSet& set = *resources.sets.back();
+	for (const Buffer<float_t>* buffer : buffers) {
+		set.bind_buffer(*buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	}
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+	return set;
+}
+
+// direct convolution: one workgroup per output tile and output plane (see conv2d_direct.comp)
+void NGrid::record_conv_direct(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result) {
+	const ShaderModule& shader = shader_module(CONV2D_DIRECT_SPIRV_BIN, CONV2D_DIRECT_SPIRV_BYTES);
+	uint32_t max_invocations = current_device().get_properties().limits.maxComputeWorkGroupInvocations;
+	uint32_t wg_x = 16;
+	uint32_t wg_y = std::min(16u, max_invocations / wg_x);
+
+	DescriptorSet& set = record_set(resources, { &input, &weights, &result });
+	PushConstants* constants = new PushConstants(conv.in_channels, conv.out_channels, conv.height, conv.width, conv.kernel_h, conv.kernel_w,
+		conv.out_h, conv.out_w, conv.stride, conv.padding_y, conv.padding_x, conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes);
+	record_pass(resources, shader, set, constants, conv.out_w, conv.out_h, conv.batches * conv.out_channels, wg_x, wg_y);
+}
+
+// Winograd F(2x2, 3x3): transformed weights U{16, out, in} and input tiles V{16, in, tiles}, 16 batched matrix products
+// M[xi] = U[xi] x V[xi] and the inverse transform of the products (see winograd.comp)
+void NGrid::record_conv_winograd(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result) {
+	const ShaderModule& shader = shader_module(WINOGRAD_SPIRV_BIN, WINOGRAD_SPIRV_BYTES);
+	const ShaderModule& gemm_shader = shader_module(MATRIX_PRODUCT_TILED_SPIRV_BIN, MATRIX_PRODUCT_TILED_SPIRV_BYTES);
+	const uint32_t MODE_WEIGHTS = 0, MODE_INPUT = 1, MODE_OUTPUT = 2; // must match winograd.comp
+	uint32_t tiles = ((conv.out_h + 1) / 2) * ((conv.out_w + 1) / 2);
+	uint32_t columns = conv.batches * tiles;
+
+	resources.buffers.emplace_back(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, 16 * conv.out_channels * conv.in_channels, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+	Buffer<float_t>& transformed_weights = *resources.buffers.back();
+	resources.buffers.emplace_back(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, 16 * conv.in_channels * columns, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+	Buffer<float_t>& transformed_input = *resources.buffers.back();
+	resources.buffers.emplace_back(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, 16 * conv.out_channels * columns, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+	Buffer<float_t>& products = *resources.buffers.back();
+
+	DescriptorSet& set = record_set(resources, { &input, &weights, &transformed_weights, &transformed_input, &products, &result });
+	auto transform = [&](uint32_t mode, uint32_t invocations) {
+		PushConstants* constants = new PushConstants(mode, conv.batches, conv.in_channels, conv.out_channels, conv.height, conv.width,
+			conv.out_h, conv.out_w, conv.padding_y, conv.padding_x, conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes);
+		record_pass(resources, shader, set, constants, invocations, 1, 1, workgroup_size_1d, 1);
+	};
+	transform(MODE_WEIGHTS, conv.out_channels * conv.in_channels);
+	transform(MODE_INPUT, conv.in_channels * columns);
+
+	// M[xi]{out, columns} = U[xi]{out, in} x V[xi]{in, columns} for the 16 elements of the transformed tiles
+	GemmVariant variant = gemm_variant(conv.out_channels, columns, conv.in_channels % 4 == 0 && columns % 4 == 0);
+	DescriptorSet& gemm_set = record_set(resources, { &transformed_weights, &transformed_input, &products });
+	PushConstants* gemm_constants = new PushConstants(conv.out_channels, columns, conv.in_channels,
+		conv.out_channels * conv.in_channels, conv.in_channels * columns, conv.out_channels * columns,
+		conv.in_channels, columns, columns, uint32_t(0), uint32_t(0), uint32_t(0), 1.0f, 0.0f);
+	record_pass(resources, gemm_shader, gemm_set, gemm_constants, variant.groups_x * variant.wg_x, variant.groups_y * variant.wg_y, 16,
+		variant.wg_x, variant.wg_y, { variant.thread_m, variant.thread_n, variant.tile_k, variant.vec4_loads });
+
+	transform(MODE_OUTPUT, conv.out_channels * columns);
+}
+
+// im2col: the input patches are unfolded into column matrices {in * kernel_h * kernel_w, out_h * out_w} per batch element,
+// the weights {out, in * kernel_h * kernel_w} are broadcast across the batch of matrix products, which writes the result layout directly
+void NGrid::record_conv_im2col(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result) {
+	const ShaderModule& shader = shader_module(IM2COL_SPIRV_BIN, IM2COL_SPIRV_BYTES);
+	const ShaderModule& gemm_shader = shader_module(MATRIX_PRODUCT_TILED_SPIRV_BIN, MATRIX_PRODUCT_TILED_SPIRV_BYTES);
+	uint32_t inner = conv.in_channels * conv.kernel_h * conv.kernel_w;
+	uint32_t outputs = conv.out_h * conv.out_w;
+
+	resources.buffers.emplace_back(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, conv.batches * inner * outputs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+	Buffer<float_t>& columns = *resources.buffers.back();
+
+	DescriptorSet& set = record_set(resources, { &input, &columns });
+	PushConstants* constants = new PushConstants(conv.batches, conv.in_channels, conv.height, conv.width, conv.kernel_h, conv.kernel_w,
+		conv.out_h, conv.out_w, conv.stride, conv.padding_y, conv.padding_x, conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes);
+	record_pass(resources, shader, set, constants, conv.batches * inner * outputs, 1, 1, workgroup_size_1d, 1);
+
+	GemmVariant variant = gemm_variant(conv.out_channels, outputs, inner % 4 == 0 && outputs % 4 == 0);
+	DescriptorSet& gemm_set = record_set(resources, { &weights, &columns, &result });
+	PushConstants* gemm_constants = new PushConstants(conv.out_channels, outputs, inner,
+		uint32_t(0), inner * outputs, conv.out_channels * outputs,
+		inner, outputs, outputs, uint32_t(0), uint32_t(0), uint32_t(0), 1.0f, 0.0f);
+	record_pass(resources, gemm_shader, gemm_set, gemm_constants, variant.groups_x * variant.wg_x, variant.groups_y * variant.wg_y, conv.batches,
+		variant.wg_x, variant.wg_y, { variant.thread_m, variant.thread_n, variant.tile_k, variant.vec4_loads });
+}
+
+// FFT-based convolution: input and weights are zero-padded to power-of-two planes that are large enough to avoid
+// circular wrap-around, transformed by radix-2 Stockham passes (rows, then columns; see fft.comp),
+// multiplied and accumulated over the input channels in the frequency domain, transformed back and sampled with the stride
+void NGrid::record_conv_fft(ReductionResources& resources, const ConvShape& conv, const Buffer<float_t>& input, const Buffer<float_t>& weights, Buffer<float_t>& result) {
+	const ShaderModule& shader = shader_module(FFT_CONV_SPIRV_BIN, FFT_CONV_SPIRV_BYTES);
+	const ShaderModule& fft_shader = shader_module(FFT_SPIRV_BIN, FFT_SPIRV_BYTES);
+	const uint32_t MODE_PAD = 0, MODE_MAC = 1, MODE_EXTRACT = 2; // must match fft_conv.comp
+	uint32_t rows = std::bit_ceil(conv.height + 2 * conv.padding_y);
+	uint32_t cols = std::bit_ceil(conv.width + 2 * conv.padding_x);
+	uint32_t plane_size = rows * cols;
+	uint32_t input_planes = conv.batches * conv.in_channels;
+	uint32_t weight_planes = conv.out_channels * conv.in_channels;
+	uint32_t output_planes = conv.batches * conv.out_channels;
+
+	// complex planes (2 floats per value); the scratch buffer is shared by the three transforms
+	auto complex_buffer = [&](uint32_t planes) -> Buffer<float_t>& {
+		resources.buffers.emplace_back(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, 2 * planes * plane_size, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+		return *resources.buffers.back();
+	};
+	Buffer<float_t>& input_spectra = complex_buffer(input_planes);
+	Buffer<float_t>& weight_spectra = complex_buffer(weight_planes);
+	Buffer<float_t>& output_spectra = complex_buffer(output_planes);
+	Buffer<float_t>& scratch = complex_buffer(std::max({ input_planes, weight_planes, output_planes }));
+
+	// a transform alternates between its buffer and the scratch buffer; with an odd number of passes
+	// the transform starts in the scratch buffer, so that it always ends in its own buffer
+	uint32_t passes = std::countr_zero(rows) + std::countr_zero(cols);
+	auto start_buffer = [&](Buffer<float_t>& spectra) -> Buffer<float_t>& {
+		return passes % 2 == 1 ? scratch : spectra;
+	};
+	auto transform = [&](Buffer<float_t>& spectra, uint32_t planes, uint32_t inverse) {
+		Buffer<float_t>* source = &start_buffer(spectra);
+		Buffer<float_t>* target = source == &scratch ? &spectra : &scratch;
+		DescriptorSet& forward = record_set(resources, { source, target });
+		DescriptorSet& backward = record_set(resources, { target, source });
+		bool swapped = false;
+		for (uint32_t axis = 0; axis < 2; axis++) {
+			// rows have length cols and contiguous elements, columns have length rows and elements that are cols apart
+			uint32_t n = axis == 0 ? cols : rows;
+			uint32_t stride = axis == 0 ? 1 : cols;
+			uint32_t inner_count = axis == 0 ? 1 : cols;
+			uint32_t outer_stride = axis == 0 ? cols : plane_size;
+			uint32_t sequences = axis == 0 ? planes * rows : planes * cols;
+			for (uint32_t p = 1; p < n; p <<= 1) {
+				PushConstants* constants = new PushConstants(n, p, stride, inner_count, outer_stride, sequences, inverse);
+				record_pass(resources, fft_shader, swapped ? backward : forward, constants, sequences * (n / 2), 1, 1, workgroup_size_1d, 1);
+				swapped = !swapped;
+			}
+		}
+	};
+	auto constants = [&](uint32_t mode, uint32_t planes, uint32_t height, uint32_t width, uint32_t padding_y, uint32_t padding_x,
+		uint32_t batch_planes, uint32_t channel_planes, uint32_t plane_offset, uint32_t total_planes) {
+		return new PushConstants(mode, planes, conv.in_channels, conv.out_channels, height, width, rows, cols, padding_y, padding_x,
+			conv.stride, conv.out_h, conv.out_w, batch_planes, channel_planes, plane_offset, total_planes, 1.0f / float_t(plane_size));
+	};
+
+	// forward transforms of the input planes and of the kernels (the weights of an output channel are a batch element)
+	DescriptorSet& input_set = record_set(resources, { &input, &start_buffer(input_spectra), &weight_spectra, &output_spectra, &result });
+	record_pass(resources, shader, input_set, constants(MODE_PAD, input_planes, conv.height, conv.width, conv.padding_y, conv.padding_x,
+		conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes), input_planes * plane_size, 1, 1, workgroup_size_1d, 1);
+	transform(input_spectra, input_planes, 0);
+	DescriptorSet& weights_set = record_set(resources, { &weights, &start_buffer(weight_spectra), &input_spectra, &output_spectra, &result });
+	record_pass(resources, shader, weights_set, constants(MODE_PAD, weight_planes, conv.kernel_h, conv.kernel_w, 0, 0,
+		conv.in_channels, 1, 0, weight_planes), weight_planes * plane_size, 1, 1, workgroup_size_1d, 1);
+	transform(weight_spectra, weight_planes, 0);
+
+	// products, inverse transform and strided output samples
+	DescriptorSet& mac_set = record_set(resources, { &input, &input_spectra, &weight_spectra, &start_buffer(output_spectra), &result });
+	record_pass(resources, shader, mac_set, constants(MODE_MAC, output_planes, conv.height, conv.width, conv.padding_y, conv.padding_x,
+		conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes), output_planes * plane_size, 1, 1, workgroup_size_1d, 1);
+	transform(output_spectra, output_planes, 1);
+	DescriptorSet& extract_set = record_set(resources, { &input, &output_spectra, &weight_spectra, &input_spectra, &result });
+	record_pass(resources, shader, extract_set, constants(MODE_EXTRACT, output_planes, conv.height, conv.width, conv.padding_y, conv.padding_x,
+		conv.batch_planes, conv.channel_planes, conv.plane_offset, conv.total_planes), output_planes * conv.out_h * conv.out_w, 1, 1, workgroup_size_1d, 1);
+}
+
 NGrid NGrid::transpose(const std::vector<uint32_t> target_axis_order) const {
 
 	// check if target axis order is valid
@@ -3872,11 +5791,11 @@ NGrid NGrid::transpose(const std::vector<uint32_t> target_axis_order) const {
 
 	// create result + buffer to store the target axis order
 	NGrid result(result_shape);
-	Buffer<uint32_t> target_axis_order_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, target_axis_order.size());
+	Buffer<uint32_t> target_axis_order_buffer(current_device(), BufferUsage::STORAGE_BUFFER, target_axis_order.size());
 	target_axis_order_buffer.write(target_axis_order);
 
 	// load shader
-	static ShaderModule shader(manager->get_device(), TRANSPOSE_SPIRV_BIN, TRANSPOSE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(TRANSPOSE_SPIRV_BIN, TRANSPOSE_SPIRV_BYTES);
 
 	// define push constants
 	PushConstants constants(
@@ -3891,104 +5810,213 @@ NGrid NGrid::transpose(const std::vector<uint32_t> target_axis_order) const {
 		data_cpy.reshape({ this->shape[0], 1 }); // reshape to [n, 1]
 
 		// define descriptor set
-		DescriptorSet set(manager->get_device());
+		DescriptorSet set(current_device());
 		set.bind_buffer(*data_cpy.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(target_axis_order_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*result.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.finalize_layout();
-		descriptor_pool->allocate_set(set);
+		context().descriptor_pool.allocate_set(set);
 
 		// execute compute pipeline
-		ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-		command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-		descriptor_pool->release_set(set);
+		ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+		execute(pipeline, set, this->elements, 1, 1, true);
 	}
 	// if 'this' is 2d or higher, it can be transposed directly
 	else {
 		// define descriptor set
-		DescriptorSet set(manager->get_device());
+		DescriptorSet set(current_device());
 		set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(target_axis_order_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.bind_buffer(*result.get_shape_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 		set.finalize_layout();
-		descriptor_pool->allocate_set(set);
+		context().descriptor_pool.allocate_set(set);
 
 		// execute compute pipeline
-		ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
-		command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
-		descriptor_pool->release_set(set);
+		ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+		execute(pipeline, set, this->elements, 1, 1, true);
 	}
 	return result;
 }
 
+// LU decomposition with partial pivoting: P*A = L*U;
+// L is a lower triangular matrix, U is an upper triangular matrix, P is a permutation matrix;
+// please note that L and P are square matrices, while U (as a 'row echelon matrix') has the same shape as the source matrix;
+// 2d matrices use a blocked right-looking algorithm: per panel of 32 columns one workgroup factorizes the panel,
+// the block row right of the panel is solved against the panel (lu_trsm) and the trailing submatrix is updated
+// with the tiled matrix product; all passes are recorded into one command buffer and submitted once;
+// 3d arrays of shape {batch, n, n} are decomposed as a batch of independent matrices (see lu_batched())
 void  NGrid::lu_decomp(NGrid& L, NGrid& U, NGrid& P) const {
+	if (this->dimensions == 3) {
+		this->lu_batched(L, U, P, false);
+		return;
+	}
+
 	// check if the grid is a 2d matrix
 	if (this->dimensions != 2) {
 		Log::warning("invalid usage of NGrid::lu_decomp: only 2d matrices can be decomposed, returning unmodified grids");
 		return;
 	}
+	uint32_t rows = this->shape[0];
+	uint32_t cols = this->shape[1];
 
-	// initialize matrices
-	// L is a lower triangular matrix, U is an upper triangular matrix, P is a permutation matrix
-	// please note that L and P are square matrices, while U (as a 'row echelon matrix') has the same shape as the source matrix
-	L = L.reshape({ this->shape[0], this->shape[0] });	L.fill_identity();
-	U = *this; // U is initialized with the source matrix
-	P = P.reshape({ this->shape[0], this->shape[0] });	P.fill_identity();
+	// initialize matrices (all elements of L and P get overwritten, so existing buffers of the right shape are reused)
+	std::vector<uint32_t> square_shape = { rows, rows };
+	if (L.get_shape() != square_shape) {
+		L = NGrid(square_shape);
+	}
+	if (P.get_shape() != square_shape) {
+		P = NGrid(square_shape);
+	}
+	U = *this; // U is initialized with the source matrix and holds the packed factors until the final pass
 
-	// add a buffer to store the row to be swapped for current row 'k'
-	Buffer<uint32_t> swap_row(manager->get_device(), BufferUsage::STORAGE_BUFFER, 1);
+	// the decomposition is submitted on the grid's own command buffer,
+	// so any batched work on the input grids has to be completed first
+	flush();
 
-	// define descriptor set
-	DescriptorSet set(manager->get_device());
-	set.bind_buffer(*L.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	const ShaderModule& panel_shader = shader_module(LU_PANEL_SPIRV_BIN, LU_PANEL_SPIRV_BYTES);
+	const ShaderModule& trsm_shader = shader_module(LU_TRSM_SPIRV_BIN, LU_TRSM_SPIRV_BYTES);
+	const ShaderModule& unpack_shader = shader_module(LU_UNPACK_SPIRV_BIN, LU_UNPACK_SPIRV_BYTES);
+	const ShaderModule& gemm_shader = shader_module(MATRIX_PRODUCT_TILED_SPIRV_BIN, MATRIX_PRODUCT_TILED_SPIRV_BYTES);
+
+	// row permutation
+	Buffer<uint32_t> perm(current_device(), BufferUsage::STORAGE_BUFFER, rows,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+
+	// descriptor sets for the LU passes and for the trailing update (all operands are submatrices of U)
+	DescriptorSet set(current_device());
 	set.bind_buffer(*U.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(perm, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*L.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*P.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
-	set.bind_buffer(swap_row, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
-
-	// define push constants
-	uint32_t k = 0;
-	PushConstants constants(
-		this->shape[0],		// source matrix rows
-		this->shape[1],		// source matrix columns
-		k					// current row index
-	);
+	context().descriptor_pool.allocate_set(set);
+
+	DescriptorSet gemm_set(current_device());
+	gemm_set.bind_buffer(*U.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	gemm_set.bind_buffer(*U.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	gemm_set.bind_buffer(*U.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	gemm_set.finalize_layout();
+	context().descriptor_pool.allocate_set(gemm_set);
+
+	// push constants: rows, cols, k0, width (k0 and width are updated for each panel)
+	PushConstants constants(rows, cols, uint32_t(0), uint32_t(0));
+
+	// push constants of the trailing update C = -1 * A x B + 1 * C (see matrix_product_tiled.comp)
+	PushConstants gemm_constants(uint32_t(0), uint32_t(0), uint32_t(0), uint32_t(0), uint32_t(0), uint32_t(0),
+		cols, cols, cols, uint32_t(0), uint32_t(0), uint32_t(0), -1.0f, 1.0f);
+
+	// the panel is factorized by a single workgroup, so its size must be a power of two for the pivot reduction
+	uint32_t panel_workgroup_size = std::bit_floor(workgroup_size_1d);
+	ComputePipeline panel_pipeline(current_device(), panel_shader, constants, set, panel_workgroup_size);
+	ComputePipeline trsm_pipeline(current_device(), trsm_shader, constants, set, workgroup_size_1d);
+	ComputePipeline unpack_pipeline(current_device(), unpack_shader, constants, set, workgroup_size_1d);
+	std::vector<std::unique_ptr<ComputePipeline>> gemm_pipelines; // kept alive until the submission has completed
+
+	const uint32_t block = 32;
+	uint32_t steps = std::min(rows, cols);
+	for (uint32_t k0 = 0; k0 < steps; k0 += block) {
+		uint32_t width = std::min(block, steps - k0);
+		constants.add_values(k0, 8);
+		constants.add_values(width, 12);
+		context().command_buffer.compute(panel_pipeline, panel_workgroup_size, 1, 1, false, 0, true);
+
+		// block row right of the panel
+		uint32_t trailing_cols = cols - k0 - width;
+		if (trailing_cols == 0) {
+			continue;
+		}
+		context().command_buffer.compute(trsm_pipeline, trailing_cols, 1, 1, false, 0, true);
 
-	// main iterative loop for LU decomposition;
-	for (k = 0; k < this->shape[0]; k++) {
+		// trailing submatrix: A22 -= L21 x U12
+		uint32_t trailing_rows = rows - k0 - width;
+		if (trailing_rows == 0) {
+			continue;
+		}
+		bool aligned = cols % 4 == 0 && k0 % 4 == 0 && width % 4 == 0;
+		GemmVariant variant = gemm_variant(trailing_rows, trailing_cols, aligned);
+		gemm_constants.add_values(trailing_rows, 0);
+		gemm_constants.add_values(trailing_cols, 4);
+		gemm_constants.add_values(width, 8);
+		gemm_constants.add_values((k0 + width) * cols + k0, 36);
+		gemm_constants.add_values(k0 * cols + k0 + width, 40);
+		gemm_constants.add_values((k0 + width) * cols + k0 + width, 44);
+		gemm_pipelines.emplace_back(new ComputePipeline(current_device(), gemm_shader, gemm_constants, gemm_set, variant.wg_x, variant.wg_y, 1, true,
+			{ variant.thread_m, variant.thread_n, variant.tile_k, variant.vec4_loads }));
+		context().command_buffer.compute(*gemm_pipelines.back(), variant.groups_x * variant.wg_x, variant.groups_y * variant.wg_y, 1, false, 0, true);
+	}
+
+	// split the packed factors into L, U and P
+	context().command_buffer.compute(unpack_pipeline, rows * std::max(rows, cols), 1, 1, false, 0, true);
+
+	add_async_dependency(context().command_buffer);
+	Fence fence(current_device(), false);
+	context().command_buffer.submit(fence, fence_timeout_nanosec);
+	context().command_buffer.reset();
+
+	context().descriptor_pool.release_set(set);
+	context().descriptor_pool.release_set(gemm_set);
+}
+
+// batched LU decomposition (P*A = L*U) or inversion of a {batch, n, n} array with one workgroup per matrix;
+// the decomposition writes L, U and P (each {batch, n, n}), the inversion writes the inverses to 'first';
+// matrices that don't fit into shared memory (n > 32) are processed one by one
+void NGrid::lu_batched(NGrid& first, NGrid& second, NGrid& third, const bool inverse) const {
+	if (this->shape[1] != this->shape[2]) {
+		Log::warning("invalid usage of NGrid::", inverse ? "inverse" : "lu_decomp", ": the matrices of a batch must be square, but the array has shape ",
+			this->get_shapestring(), ", returning unmodified grids");
+		return;
+	}
+	uint32_t batch = this->shape[0];
+	uint32_t n = this->shape[1];
+	if (first.get_shape() != this->shape) {
+		first = NGrid(this->shape);
+	}
+	if (!inverse && second.get_shape() != this->shape) {
+		second = NGrid(this->shape);
+	}
+	if (!inverse && third.get_shape() != this->shape) {
+		third = NGrid(this->shape);
+	}
 
-		// update k in push constants (at offset 8 bytes)
-		constants.add_values(k, 8);
+	// fallback for large matrices
+	const uint32_t max_n = 32; // must match MAX_N of lu_batched.comp
+	if (n > max_n) {
+		NGrid matrix({ n, n });
+		NGrid L, U, P;
+		for (uint32_t b = 0; b < batch; b++) {
+			matrix.set(*this, n * n, b * n * n, 0);
+			if (inverse) {
+				first.set(matrix.inverse(), n * n, 0, b * n * n);
+			}
+			else {
+				matrix.lu_decomp(L, U, P);
+				first.set(L, n * n, 0, b * n * n);
+				second.set(U, n * n, 0, b * n * n);
+				third.set(P, n * n, 0, b * n * n);
+			}
+		}
+		return;
+	}
 
-		// check if row swap is needed
-		// (1d dispatch with one thread for each row)
-		static ShaderModule check_swap_shader(manager->get_device(), LU_DECOMP_CHECK_ROWSWAP_SPIRV_BIN, LU_DECOMP_CHECK_ROWSWAP_SPIRV_BYTES);
-		ComputePipeline check_swap_pipeline(manager->get_device(), check_swap_shader, constants, set, workgroup_size_1d, 1, 1);
-		command_buffer->compute(check_swap_pipeline, this->shape[0], 1, 1, false, 0, true);
+	const ShaderModule& shader = shader_module(LU_BATCHED_SPIRV_BIN, LU_BATCHED_SPIRV_BYTES);
 
-		// perform row swap (=if needed)
-		// (horizontal 1d dispatch with one thread for each column)
-		static ShaderModule perform_swap_shader(manager->get_device(), LU_DECOMP_PERFORM_ROWSWAP_SPIRV_BIN, LU_DECOMP_PERFORM_ROWSWAP_SPIRV_BYTES);
-		ComputePipeline perform_swap_pipeline(manager->get_device(), perform_swap_shader, constants, set, workgroup_size_1d, 1, 1);
-		command_buffer->compute(perform_swap_pipeline, this->shape[1], 1, 1, false, 0, true);
+	DescriptorSet set(current_device());
+	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*first.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*(inverse ? first : second).get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*(inverse ? first : third).get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
 
-		// update L matrix in column k
-		// (1d dispatch with one thread for each row)
-		static ShaderModule l_update_shader(manager->get_device(), LU_DECOMP_L_UPDATE_SPIRV_BIN, LU_DECOMP_L_UPDATE_SPIRV_BYTES);
-		ComputePipeline l_update_pipeline(manager->get_device(), l_update_shader, constants, set, workgroup_size_1d, 1, 1);
-		command_buffer->compute(l_update_pipeline, this->shape[0], 1, 1, false, 0, true);
+	PushConstants constants(n, static_cast<uint32_t>(inverse));
 
-		// update U matrix in rows [k+1] to [rows-1]
-		static ShaderModule u_update_shader(manager->get_device(), LU_DECOMP_U_UPDATE_SPIRV_BIN, LU_DECOMP_U_UPDATE_SPIRV_BYTES);
-		ComputePipeline u_update_pipeline(manager->get_device(), u_update_shader, constants, set, workgroup_size_1d, 1, 1);
-		command_buffer->compute(u_update_pipeline, U.get_elements(), 1, 1, true, fence_timeout_nanosec, true);
-	}
-	descriptor_pool->release_set(set);
+	uint32_t workgroup_size = std::min(64u, workgroup_size_1d);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size);
+	execute(pipeline, set, batch * workgroup_size);
 }
 
 // get the inverse of a lower triangular matrix L (using forward substitution)
@@ -3999,18 +6027,18 @@ NGrid NGrid::l_inverse() const {
 	}
 
 	// load shader module
-	static ShaderModule shader(manager->get_device(), L_INVERSE_SPIRV_BIN, L_INVERSE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(L_INVERSE_SPIRV_BIN, L_INVERSE_SPIRV_BYTES);
 
 	// create an identity matrix of this->shape
 	NGrid I(this->shape);
 	I.fill_identity();
 
 	// define descriptor set
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*this->data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*I.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	// define push constants
 	PushConstants constants(
@@ -4019,10 +6047,8 @@ NGrid NGrid::l_inverse() const {
 
 	// execute compute pipeline
 	// (1d dispatch with one thread for each column)
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, this->shape[1], 1, 1, true, fence_timeout_nanosec, true);
-
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	execute(pipeline, set, this->shape[1]);
 	return I;
 }
 
@@ -4035,18 +6061,18 @@ NGrid NGrid::u_inverse() const {
 	}
 
 	// load shader module
-	static ShaderModule shader(manager->get_device(), U_INVERSE_SPIRV_BIN, U_INVERSE_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(U_INVERSE_SPIRV_BIN, U_INVERSE_SPIRV_BYTES);
 
 	// create an identity matrix of this->shape
 	NGrid I(this->shape);
 	I.fill_identity();
 
 	// define descriptor set
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*this->data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*I.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	// define push constants
 	PushConstants constants(
@@ -4055,17 +6081,21 @@ NGrid NGrid::u_inverse() const {
 
 	// execute compute pipeline
 	// (1d dispatch with one thread for each column)
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, this->shape[1], 1, 1, true, fence_timeout_nanosec, true);
-
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	execute(pipeline, set, this->shape[1]);
 	return I;
 }
 
 // 2d matrix inversion
 // this algorithm uses LU decomposition and obtains A_inv = L_inv * U_inv * P;
 // in case of a non-square matrix, the Moore-Penrose pseudo-inverse is calculated;
+// 3d arrays of shape {batch, n, n} are inverted as a batch of independent square matrices with a single dispatch
 NGrid NGrid::inverse() const {
+	if (this->dimensions == 3) {
+		NGrid result;
+		this->lu_batched(result, result, result, true);
+		return result;
+	}
 
 	// check if the grid is a 2d matrix
 	if (this->dimensions != 2) {
@@ -4105,7 +6135,7 @@ NGrid NGrid::mirror(const std::vector<bool>& mirror_axes) const {
 	}
 
 	// copy the mirror axes to a storage buffer
-	Buffer<uint32_t> mirror_axes_buffer(manager->get_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
+	Buffer<uint32_t> mirror_axes_buffer(current_device(), BufferUsage::STORAGE_BUFFER, this->dimensions);
 	if (mirror_axes.size() == 0) {
 		// if no axes are specified, mirror all axes
 		for (uint32_t i = 0; i < this->dimensions; i++) {
@@ -4122,7 +6152,7 @@ NGrid NGrid::mirror(const std::vector<bool>& mirror_axes) const {
 	NGrid result(this->shape);
 
 	// load shader
-	static ShaderModule shader(manager->get_device(), MIRROR_SPIRV_BIN, MIRROR_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(MIRROR_SPIRV_BIN, MIRROR_SPIRV_BYTES);
 
 	// define push constants
 	PushConstants constants(
@@ -4131,18 +6161,17 @@ NGrid NGrid::mirror(const std::vector<bool>& mirror_axes) const {
 	);
 
 	// define descriptor set
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*this->data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*this->shape_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(mirror_axes_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	// execute compute pipeline
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec, true);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	execute(pipeline, set, this->elements, 1, 1, true);
 
 	return result;
 }
@@ -4177,15 +6206,15 @@ NGrid NGrid::remap(const NGrid& target_index_map) const {
 	NGrid result(this->shape);
 
 	// load shader
-	static ShaderModule shader(manager->get_device(), REMAP_SPIRV_BIN, REMAP_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(REMAP_SPIRV_BIN, REMAP_SPIRV_BYTES);
 
 	// define descriptor set
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*this->data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*target_index_map.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
-	descriptor_pool->allocate_set(set);
+	context().descriptor_pool.allocate_set(set);
 
 	// define push constants
 	PushConstants constants(
@@ -4193,9 +6222,8 @@ NGrid NGrid::remap(const NGrid& target_index_map) const {
 	);
 
 	// execute compute pipeline
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec, true);
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	execute(pipeline, set, this->elements);
 
 	return result;
 }
@@ -4565,7 +6593,7 @@ NGrid::RegressionResult NGrid::regression(const NGrid& other, const bool sample,
 	NGrid XtY = X_T * Y_2d;
 
 	*result.coefficients = XtX_inv * XtY; // This will be a (k+1) x 1 NGrid
-	result.coefficients_vec = result.coefficients->get_buffer()->read();
+	result.coefficients_vec = result.coefficients->get();
 
 	// --- Calculate Predicted Y Values ---
 	// Y_hat = X * beta_hat
@@ -4690,9 +6718,9 @@ NGrid NGrid::stationary(const uint32_t degree) const {
 	}
 
 	// Recursive Step: Perform one degree of differencing
-	static ShaderModule shader(manager->get_device(), STATIONARY_SPIRV_BIN, STATIONARY_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(STATIONARY_SPIRV_BIN, STATIONARY_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*differenced_result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 
@@ -4700,9 +6728,8 @@ NGrid NGrid::stationary(const uint32_t degree) const {
 		differenced_result.get_elements()
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, differenced_result.get_elements(), 1, 1, true, fence_timeout_nanosec, true); // dispatch with fence and buffer memory barriers
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	execute(pipeline, set, differenced_result.get_elements()); // dispatch with fence and buffer memory barriers
 
 	// Recursive Call for Higher Degrees
 	if (degree > 1) {
@@ -4743,9 +6770,9 @@ NGrid NGrid::stationary_log(const float_t log_base, const uint32_t degree) const
 	}
 
 	// Recursive Step: Perform one degree of differencing
-	static ShaderModule shader(manager->get_device(), STATIONARY_LOG_SPIRV_BIN, STATIONARY_LOG_SPIRV_BYTES);
+	const ShaderModule& shader = shader_module(STATIONARY_LOG_SPIRV_BIN, STATIONARY_LOG_SPIRV_BYTES);
 
-	DescriptorSet set(manager->get_device());
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*differenced_result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 
@@ -4754,9 +6781,8 @@ NGrid NGrid::stationary_log(const float_t log_base, const uint32_t degree) const
 		log_base
 	);
 
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d, 1, 1);
-	command_buffer->compute(pipeline, differenced_result.get_elements(), 1, 1, true, fence_timeout_nanosec, true); // dispatch with fence and buffer memory barriers
-	descriptor_pool->release_set(set);
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	execute(pipeline, set, differenced_result.get_elements()); // dispatch with fence and buffer memory barriers
 
 	// Recursive Call for Higher Degrees
 	if (degree > 1) {
@@ -4767,33 +6793,87 @@ NGrid NGrid::stationary_log(const float_t log_base, const uint32_t degree) const
 	}
 }
 
-// even-odd sorting algorithm for 1d vectors
+// sorting of 1d vectors via a bitonic sorting network;
+// all passes are recorded into one command buffer and submitted at once
 NGrid NGrid::sort(const bool ascending) const {
 	if (this->dimensions != 1) {
 		Log::warning("NGrid::sort() is invalid for multidimensional data structures. The underlying array has ", this->dimensions, ", dimensions");
 		return *this;
 	}
+	return this->sort_network(ascending, false);
+}
+
+// returns the indices that would sort the 1d vector (as float values);
+// elements with equal values keep their original order;
+// note: float values represent the indices exactly only up to 2^24 (16777216) elements
+NGrid NGrid::argsort(const bool ascending) const {
+	if (this->dimensions != 1) {
+		Log::warning("NGrid::argsort() is invalid for multidimensional data structures. The underlying array has ", this->dimensions, ", dimensions");
+		return NGrid();
+	}
+	if (this->elements > (1u << 24)) {
+		Log::warning("NGrid::argsort(): the indices of a vector with ", this->elements, " elements exceed 2^24 (16777216) and can't be represented exactly as float values; indices above this limit will be rounded");
+	}
+	return this->sort_network(ascending, true);
+}
 
+// helper method for sort() and argsort(): runs the bitonic sorting network on (value, index) pairs
+// and returns either the sorted values or the permutation indices
+NGrid NGrid::sort_network(const bool ascending, const bool return_indices) const {
 	NGrid result(this->shape);
+	if (this->elements == 0) {
+		return result;
+	}
+	flush(); // the sorting passes are submitted directly on the grid's own command buffer
+
+	const ShaderModule& shader = shader_module(BITONIC_SORT_SPIRV_BIN, BITONIC_SORT_SPIRV_BYTES);
 
-	static ShaderModule shader(manager->get_device(), EVEN_ODD_SORT_SPIRV_BIN, EVEN_ODD_SORT_SPIRV_BYTES);
+	// workgroup blocks are sorted in shared memory, so the workgroup size must be a power of two
+	uint32_t workgroup_size = std::bit_floor(workgroup_size_1d);
+	uint32_t padded = std::bit_ceil(this->elements);
 
-	DescriptorSet set(manager->get_device());
+	Buffer<float_t> keys = scratch_buffer(padded);
+	Buffer<uint32_t> indices(current_device(), BufferUsage::STORAGE_BUFFER, padded,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+
+	DescriptorSet set(current_device());
 	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(keys, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(indices, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
 	set.finalize_layout();
 
-	descriptor_pool->allocate_set(set);
-	uint32_t pass = 0;
-	PushConstants constants(this->elements, pass, static_cast<uint32_t>(ascending));
-	ComputePipeline pipeline(manager->get_device(), shader, constants, set, workgroup_size_1d);
+	context().descriptor_pool.allocate_set(set);
+
+	// push constants: N, P, k, j, ascending, mode (the values of k, j and mode are updated for each pass)
+	PushConstants constants(this->elements, padded, uint32_t(0), uint32_t(0), static_cast<uint32_t>(ascending), uint32_t(0));
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size);
 
-	for (pass = 0; pass < this->elements; pass++) {
-		constants.add_values(pass, 4); // (over-)write pass (offset 4 bytes)
-		command_buffer->compute(pipeline, this->elements, 1, 1, true, fence_timeout_nanosec);
+	auto record = [&](uint32_t mode, uint32_t k, uint32_t j, uint32_t invocations) {
+		constants.add_values(k, 8);
+		constants.add_values(j, 12);
+		constants.add_values(mode, 20);
+		context().command_buffer.compute(pipeline, invocations, 1, 1, false, 0, true);
+	};
+
+	// copy + padding, sorting of blocks of one workgroup, then merge stages with global steps
+	// for partner distances >= workgroup size and one local pass for the remaining distances
+	record(0, 0, 0, padded);
+	record(1, 0, 0, padded);
+	for (uint32_t k = 2 * workgroup_size; k <= padded; k <<= 1) {
+		for (uint32_t j = k >> 1; j >= workgroup_size; j >>= 1) {
+			record(2, k, j, padded);
+		}
+		record(3, k, workgroup_size >> 1, padded);
 	}
+	record(return_indices ? 5 : 4, 0, 0, this->elements);
 
-	descriptor_pool->release_set(set);
+	add_async_dependency(context().command_buffer);
+	Fence fence(current_device(), false);
+	context().command_buffer.submit(fence, fence_timeout_nanosec);
+	context().command_buffer.reset();
+
+	context().descriptor_pool.release_set(set);
 	return result;
 }
 
@@ -4801,29 +6881,304 @@ float_t NGrid::covariance(const NGrid& other) const {
 	return (*this - this->mean()).scalar_product(other - other.mean()) / this->elements;
 }
 
-
-// +=================================+   
-// | Output                          |
+// +=================================+
+// | batched time series statistics  |
 // +=================================+
 
-// print the vector or array to the console
-// use precision argument for decimal places (use negative number for unformatted full available precision)
-void NGrid::print(std::string comment, std::string delimiter, bool with_indices, bool rows_inline, int32_t precision) const {
-	uint32_t decimals = std::pow(10, precision);
+// differences of the given degree of every series of a {series, observations} array (result: {series, observations - degree});
+// all degrees are computed with a single dispatch (binomial coefficients) instead of one dispatch per degree
+NGrid NGrid::stationary_batched(const uint32_t degree) const {
+	if (degree == 0) {
+		return *this;
+	}
+	return series_stats(SERIES_DIFFERENCE, nullptr, degree, false, "stationary_batched");
+}
 
-	if (comment != "") {
-		std::cout << comment;
-		std::cout << "\n";
+// simple linear regressions y = f(x) of the series of 'this' (x) and 'other' (y), both with shape {series, observations};
+// returns a {series, 6} array with the columns {intercept, slope, r_squared, Pearson_R, covariance, MSE}
+NGrid NGrid::regression_batched(const NGrid& other, const bool sample) const {
+	return series_stats(SERIES_REGRESSION, &other, 0, sample, "regression_batched");
+}
+
+// Dickey-Fuller statistics (see NGrid::Dickey_Fuller()) of every series of a {series, observations} array (result: {series})
+NGrid NGrid::Dickey_Fuller_batched() const {
+	return series_stats(SERIES_DICKEY_FULLER, nullptr, 0, false, "Dickey_Fuller_batched");
+}
+
+// Engle-Granger cointegration tests of the series of 'this' and 'other' (both {series, observations}, result: {series}):
+// Dickey-Fuller statistic of the residuals of the regression other = f(this)
+NGrid NGrid::Engle_Granger_batched(const NGrid& other) const {
+	return series_stats(SERIES_ENGLE_GRANGER, &other, 0, false, "Engle_Granger_batched");
+}
+
+// helper method for the batched time series statistics: one workgroup per series (see series_stats.comp)
+NGrid NGrid::series_stats(SeriesMode mode, const NGrid* other, uint32_t degree, bool sample, const char* method) const {
+	if (this->dimensions != 2) {
+		Log::warning("invalid usage of NGrid::", method, "(): 'this' must be a 2d array of shape {series, observations}, but it has shape ",
+			this->get_shapestring(), ", returning empty result");
+		return NGrid();
+	}
+	if (other != nullptr && other->get_shape() != this->shape) {
+		Log::warning("invalid usage of NGrid::", method, "(): 'other' must have the same shape as 'this' (", this->get_shapestring(),
+			"), but it has shape ", other->get_shapestring(), ", returning empty result");
+		return NGrid();
+	}
+	uint32_t series = this->shape[0];
+	uint32_t n = this->shape[1];
+	uint32_t min_n = mode == SERIES_DIFFERENCE ? degree + 1 : 3;
+	if (n < min_n) {
+		Log::warning("invalid usage of NGrid::", method, "(): not enough observations per series (", n, ", at least ", min_n, " required), returning empty result");
+		return NGrid();
 	}
 
-	if (this->dimensions == 1) {
-		for (uint32_t x = 0; x < this->shape[0]; x++) {
-			if (with_indices) {
-				std::cout << "[" << x << "]=";
-			}
-			std::cout << this->get(x);
-			if (x != this->shape[0] - 1) {
-				if (rows_inline) {
+	NGrid result;
+	switch (mode) {
+	case SERIES_DIFFERENCE: result = NGrid({ series, n - degree }); break;
+	case SERIES_REGRESSION: result = NGrid({ series, 6 }); break;
+	default: result = NGrid({ series }); break;
+	}
+
+	const ShaderModule& shader = shader_module(SERIES_STATS_SPIRV_BIN, SERIES_STATS_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*this->data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*(other != nullptr ? other->get_buffer() : this->data_buffer.get()), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(
+		static_cast<uint32_t>(mode),
+		n,
+		degree,
+		static_cast<uint32_t>(sample),
+		series
+	);
+
+	// the sums are reduced in shared memory, so the workgroup size must be a power of two
+	uint32_t workgroup_size = std::bit_floor(std::min(256u, workgroup_size_1d));
+	// one workgroup per series; series beyond the max. workgroup count of the x axis continue along y
+	uint32_t groups_x = std::min(series, current_device().get_properties().limits.maxComputeWorkGroupCount[0]);
+	uint32_t groups_y = (series + groups_x - 1) / groups_x;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size);
+	result.execute(pipeline, set, groups_x * workgroup_size, groups_y);
+	return result;
+}
+
+// rolling mean values of a 1d series or of every series of a {series, observations} array;
+// result: {windows} or {series, windows} with windows = (observations - window) / step + 1
+NGrid NGrid::rolling_mean(const uint32_t window, const uint32_t step) const {
+	return rolling(ROLLING_MEAN, nullptr, window, step, false, "rolling_mean");
+}
+
+// rolling variances (sample or population), with the same result shape as NGrid::rolling_mean()
+NGrid NGrid::rolling_var(const uint32_t window, const uint32_t step, const bool sample) const {
+	return rolling(ROLLING_VAR, nullptr, window, step, sample, "rolling_var");
+}
+
+// rolling simple linear regressions y = f(x) of 'this' (x) and 'other' (y, same shape);
+// result: {windows, 3} or {series, windows, 3} with the values {intercept, slope, r_squared} per window
+NGrid NGrid::rolling_regression(const NGrid& other, const uint32_t window, const uint32_t step) const {
+	return rolling(ROLLING_REGRESSION, &other, window, step, false, "rolling_regression");
+}
+
+// helper method for the rolling window statistics: every invocation slides over a block of consecutive windows (see rolling.comp)
+NGrid NGrid::rolling(RollingMode mode, const NGrid* other, uint32_t window, uint32_t step, bool sample, const char* method) const {
+	if (this->dimensions != 1 && this->dimensions != 2) {
+		Log::warning("invalid usage of NGrid::", method, "(): 'this' must be a 1d series or a 2d array of shape {series, observations}, but it has shape ",
+			this->get_shapestring(), ", returning empty result");
+		return NGrid();
+	}
+	if (other != nullptr && other->get_shape() != this->shape) {
+		Log::warning("invalid usage of NGrid::", method, "(): 'other' must have the same shape as 'this' (", this->get_shapestring(),
+			"), but it has shape ", other->get_shapestring(), ", returning empty result");
+		return NGrid();
+	}
+	uint32_t series = this->dimensions == 1 ? 1 : this->shape[0];
+	uint32_t n = this->shape[this->dimensions - 1];
+	uint32_t min_window = mode == ROLLING_MEAN ? 1 : 2;
+	if (step == 0 || window < min_window || window > n) {
+		Log::warning("invalid usage of NGrid::", method, "(): invalid window (", window, ") or step (", step, ") for ", n,
+			" observations per series, returning empty result");
+		return NGrid();
+	}
+	uint32_t windows = (n - window) / step + 1;
+
+	std::vector<uint32_t> result_shape = { windows };
+	if (this->dimensions == 2) {
+		result_shape.insert(result_shape.begin(), series);
+	}
+	if (mode == ROLLING_REGRESSION) {
+		result_shape.push_back(3);
+	}
+	NGrid result(result_shape);
+
+	// windows per invocation: sliding the sums only pays off for overlapping windows,
+	// and blocks are kept small enough that there are still enough invocations to fill the device
+	uint32_t block = 1;
+	if (step < window) {
+		block = static_cast<uint32_t>(std::clamp<uint64_t>(uint64_t(series) * windows / 1024, 1, 64));
+	}
+	uint32_t blocks = (windows + block - 1) / block;
+
+	const ShaderModule& shader = shader_module(ROLLING_SPIRV_BIN, ROLLING_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*this->data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*(other != nullptr ? other->get_buffer() : this->data_buffer.get()), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(
+		static_cast<uint32_t>(mode),
+		n,
+		window,
+		step,
+		windows,
+		block,
+		series,
+		static_cast<uint32_t>(sample)
+	);
+
+	// series beyond the max. workgroup count of the y axis continue along z
+	uint32_t series_y = std::min(series, current_device().get_properties().limits.maxComputeWorkGroupCount[1]);
+	uint32_t series_z = (series + series_y - 1) / series_y;
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d, 1, 1);
+	result.execute(pipeline, set, blocks, series_y, series_z);
+	return result;
+}
+
+// +=================================+
+// | Probability Distributions       |
+// +=================================+
+
+// elementwise probability densities and cumulative distribution functions (see pdf.h and cdf.h);
+// the parameters have the same meaning as for the scalar host functions
+NGrid NGrid::pdf_gaussian(const float_t mu, const float_t sigma) const {
+	return distribution(DIST_GAUSSIAN, false, mu, sigma);
+}
+
+NGrid NGrid::pdf_cauchy(const float_t x_peak, const float_t gamma) const {
+	return distribution(DIST_CAUCHY, false, x_peak, gamma);
+}
+
+NGrid NGrid::pdf_laplace(const float_t mu, const float_t sigma) const {
+	return distribution(DIST_LAPLACE, false, mu, sigma);
+}
+
+NGrid NGrid::pdf_pareto(const float_t alpha, const float_t tail_index) const {
+	return distribution(DIST_PARETO, false, alpha, tail_index);
+}
+
+NGrid NGrid::pdf_lomax(const float_t alpha, const float_t tail_index) const {
+	return distribution(DIST_LOMAX, false, alpha, tail_index);
+}
+
+NGrid NGrid::pdf_F_distribution(const float_t d1, const float_t d2) const {
+	return distribution(DIST_F, false, d1, d2);
+}
+
+// Poisson probabilities of the (integral) values k of the grid
+NGrid NGrid::pdf_poisson(const float_t lambda) const {
+	return distribution(DIST_POISSON, false, lambda, 0);
+}
+
+NGrid NGrid::cdf_gaussian(const float_t mu, const float_t sigma) const {
+	return distribution(DIST_GAUSSIAN, true, mu, sigma);
+}
+
+NGrid NGrid::cdf_cauchy(const float_t x_peak, const float_t gamma) const {
+	return distribution(DIST_CAUCHY, true, x_peak, gamma);
+}
+
+NGrid NGrid::cdf_laplace(const float_t mu, const float_t sigma) const {
+	return distribution(DIST_LAPLACE, true, mu, sigma);
+}
+
+NGrid NGrid::cdf_pareto(const float_t alpha, const float_t tail_index) const {
+	return distribution(DIST_PARETO, true, alpha, tail_index);
+}
+
+NGrid NGrid::cdf_lomax(const float_t alpha, const float_t tail_index) const {
+	return distribution(DIST_LOMAX, true, alpha, tail_index);
+}
+
+NGrid NGrid::cdf_F_distribution(const float_t d1, const float_t d2) const {
+	return distribution(DIST_F, true, d1, d2);
+}
+
+NGrid NGrid::cdf_poisson(const float_t lambda) const {
+	return distribution(DIST_POISSON, true, lambda, 0);
+}
+
+// helper method for the distribution functions: small host-visible grids are evaluated
+// with the batch functions of pdf.h / cdf.h, otherwise with the distribution shader
+NGrid NGrid::distribution(Distribution dist, bool cumulative, float_t p1, float_t p2) const {
+	NGrid result(this->shape);
+	if (this->on_host(HOST_ACTIVATION, result)) {
+		std::span<const float_t> x(this->host_read(), this->elements);
+		std::span<float_t> out(result.host_write(), this->elements);
+		switch (dist) {
+		case DIST_GAUSSIAN: cumulative ? cdf::gaussian<float_t>(x, out, p1, p2) : pdf<float_t>::gaussian(x, out, p1, p2); break;
+		case DIST_CAUCHY: cumulative ? cdf::cauchy<float_t>(x, out, p1, p2) : pdf<float_t>::cauchy(x, out, p1, p2); break;
+		case DIST_LAPLACE: cumulative ? cdf::laplace<float_t>(x, out, p1, p2) : pdf<float_t>::laplace(x, out, p1, p2); break;
+		case DIST_PARETO: cumulative ? cdf::pareto<float_t>(x, out, p1, p2) : pdf<float_t>::pareto(x, out, p1, p2); break;
+		case DIST_LOMAX: cumulative ? cdf::lomax<float_t>(x, out, p1, p2) : pdf<float_t>::lomax(x, out, p1, p2); break;
+		case DIST_F: cumulative ? cdf::F_distribution<float_t>(x, out, p1, p2) : pdf<float_t>::F_distribution(x, out, p1, p2); break;
+		case DIST_POISSON: cumulative ? cdf::poisson<float_t>(x, out, p1) : pdf<float_t>::poisson(x, out, p1); break;
+		}
+		result.host_written();
+		return result;
+	}
+
+	const ShaderModule& shader = shader_module(DISTRIBUTION_SPIRV_BIN, DISTRIBUTION_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*data_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(
+		this->elements,
+		static_cast<uint32_t>(dist),
+		static_cast<uint32_t>(cumulative),
+		p1,
+		p2
+	);
+
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	result.execute(pipeline, set, this->elements);
+	return result;
+}
+
+
+// +=================================+   
+// | Output                          |
+// +=================================+
+
+// print the vector or array to the console
+// use precision argument for decimal places (use negative number for unformatted full available precision)
+void NGrid::print(std::string comment, std::string delimiter, bool with_indices, bool rows_inline, int32_t precision) const {
+	uint32_t decimals = std::pow(10, precision);
+
+	// read back all values at once instead of element by element
+	std::span<const float_t> values = this->view();
+
+	if (comment != "") {
+		std::cout << comment;
+		std::cout << "\n";
+	}
+
+	if (this->dimensions == 1) {
+		for (uint32_t x = 0; x < this->shape[0]; x++) {
+			if (with_indices) {
+				std::cout << "[" << x << "]=";
+			}
+			std::cout << values[x];
+			if (x != this->shape[0] - 1) {
+				if (rows_inline) {
 					std::cout << delimiter;
 				}
 				else {
@@ -4846,7 +7201,7 @@ void NGrid::print(std::string comment, std::string delimiter, bool with_indices,
 						}
 					}
 					uint32_t index = flat_index({ x, y });
-					float value = (precision > 0 ? std::round(this->get(index) * decimals) / decimals : this->get(index));
+					float value = (precision > 0 ? std::round(values[index] * decimals) / decimals : values[index]);
 					value = value == 0.0 ? 0.0f : value; // avoid printing -0.0
 					std::cout << value;
 					// add delimiter before next column
@@ -4861,7 +7216,7 @@ void NGrid::print(std::string comment, std::string delimiter, bool with_indices,
 							std::cout << "[" << x << "][" << y << "][" << z << "]=";
 						}
 						uint32_t index = flat_index({ x, y, z });
-						float value = (precision > 0 ? std::round(this->get(index) * decimals) / decimals : this->get(index));
+						float value = (precision > 0 ? std::round(values[index] * decimals) / decimals : values[index]);
 						value = value == 0.0 ? 0.0f : value; // avoid printing -0.0
 						std::cout << value;
 						if (z != this->shape[2] - 1) {
@@ -4875,7 +7230,7 @@ void NGrid::print(std::string comment, std::string delimiter, bool with_indices,
 					}
 				}
 				else {
-					Log::debug("invalid call of method NGrid::print() for an array of more than 3 dimensions; shape is ", this->get_shapestring());
+					LOG_DEBUG("invalid call of method NGrid::print() for an array of more than 3 dimensions; shape is ", this->get_shapestring());
 					return;
 				}
 			}
@@ -4906,7 +7261,7 @@ void NGrid::set_workgroup_size_1d(uint32_t size) {
 	if (!manager) {
 		NGrid x; // create an empty dummy NGrid to make the manager available
 	}
-	uint32_t max_size = manager->get_device().get_properties().limits.maxComputeWorkGroupSize[0];
+	uint32_t max_size = current_device().get_properties().limits.maxComputeWorkGroupSize[0];
 	if (workgroup_size_1d > max_size) {
 		Log::warning("NGrid::set_workgroup_size_1d() called with size ", workgroup_size_1d, ", which is larger than the maximum allowed size of ", max_size, ", setting to maximum size");
 		workgroup_size_1d = max_size;
@@ -4932,9 +7287,9 @@ void NGrid::set_workgroup_size_2d(uint32_t size) {
 	if (!manager) {
 		NGrid x; // create an empty dummy NGrid to make the manager available
 	}
-	uint32_t max_size_x = manager->get_device().get_properties().limits.maxComputeWorkGroupSize[0];
-	uint32_t max_size_y = manager->get_device().get_properties().limits.maxComputeWorkGroupSize[1];
-	uint32_t max_invocations = manager->get_device().get_properties().limits.maxComputeWorkGroupInvocations;
+	uint32_t max_size_x = current_device().get_properties().limits.maxComputeWorkGroupSize[0];
+	uint32_t max_size_y = current_device().get_properties().limits.maxComputeWorkGroupSize[1];
+	uint32_t max_invocations = current_device().get_properties().limits.maxComputeWorkGroupInvocations;
 	uint32_t requested_invocations = workgroup_size_2d * workgroup_size_2d;
 
 	if (workgroup_size_2d > max_size_x || workgroup_size_2d > max_size_y) {
@@ -4955,51 +7310,2940 @@ void NGrid::set_workgroup_size_2d(uint32_t size) {
 }
 
 // +=================================+   
-// | Protected Class Members         |
+// | Batched Execution               |
 // +=================================+
 
-// release resources from the shared static descriptor pool
-// (the function gets registered by the constructor to be called on program exit)
-void NGrid::release_descriptor_pool() {
-	if (descriptor_pool != nullptr) {
-		delete descriptor_pool;
-		descriptor_pool = nullptr;
+// starts a batch scope: subsequent operations only record their dispatches (+ barriers)
+// into the batch command buffer of the calling thread instead of submitting them one by one;
+// batch scopes can be nested, the recorded work gets submitted when the outermost scope ends
+void NGrid::begin_batch() {
+	Context& ctx = context();
+	ctx.batch_depth++;
+	LOG_DEBUG("NGrid batch scope started (depth: ", ctx.batch_depth, ")");
+}
+
+// ends a batch scope and submits the recorded work once the outermost scope has ended
+void NGrid::end_batch() {
+	Context& ctx = context();
+	if (ctx.batch_depth == 0) {
+		Log::warning("invalid usage of method NGrid::end_batch(): no active batch scope");
+		return;
+	}
+	ctx.batch_depth--;
+	LOG_DEBUG("NGrid batch scope ended (depth: ", ctx.batch_depth, ")");
+	if (ctx.batch_depth == 0) {
+		flush();
 	}
 }
 
-// set the fence timeout in nanoseconds
-// (default is 1 second = 1e9 nanoseconds)
-void NGrid::set_fence_timeout_nanosec(uint64_t timeout) {
-	fence_timeout_nanosec = timeout;
+// submits all dispatches recorded so far by the calling thread with a single queue submission and waits for them to finish;
+// descriptor sets and buffers that are referenced by the recorded dispatches are released afterwards;
+// this method is invoked automatically before any host access to the data of a grid
+void NGrid::flush() {
+	flush(context());
 }
 
-// returns a 'flat' equivalent to a multidimensional index
-uint32_t NGrid::flat_index(std::initializer_list<uint32_t> multi_index_list) const {
-	std::vector<uint32_t> multi_index_vec(multi_index_list);
-	return this->flat_index(multi_index_vec);
+void NGrid::flush(Context& ctx) {
+	if (ctx.capture != nullptr) {
+		Log::error("invalid usage of NGrid::capture(): host accesses and operations that are submitted directly ",
+			"(e.g. scalar reductions, sorting, scans, convolutions, decompositions) can't be captured");
+	}
+	if (ctx.batch_recorded_dispatches == 0) {
+		return;
+	}
+	LOG_DEBUG("flushing NGrid batch with ", ctx.batch_recorded_dispatches, " recorded dispatches");
+
+	// make shader writes visible to the host
+	DeviceMemoryBarrier host_barrier(
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+		VK_ACCESS_2_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_HOST_BIT,
+		VK_ACCESS_2_HOST_READ_BIT | VK_ACCESS_2_HOST_WRITE_BIT
+	);
+	ctx.batch_command_buffer.add_barrier(host_barrier);
+	add_async_dependency(ctx, ctx.batch_command_buffer);
+
+	Fence fence(*ctx.device, false);
+	ctx.batch_command_buffer.submit(fence, fence_timeout_nanosec);
+	ctx.batch_command_buffer.reset();
+	ctx.batch_recorded_dispatches = 0;
+
+	// release resources that had to be kept alive until completion
+	for (const DescriptorSet& set : ctx.batch_pending_sets) {
+		ctx.descriptor_pool.release_set(set);
+	}
+	ctx.batch_pending_sets.clear();
+	for (Buffer<float_t>* buffer : ctx.batch_pending_data_buffers) {
+		delete buffer;
+	}
+	ctx.batch_pending_data_buffers.clear();
+	for (Buffer<uint32_t>* buffer : ctx.batch_pending_shape_buffers) {
+		delete buffer;
+	}
+	ctx.batch_pending_shape_buffers.clear();
 }
 
-// returns a 'flat' equivalent to a multidimensional index
-uint32_t NGrid::flat_index(const std::vector<uint32_t>& multi_index) const {
-	// Check if the number of indices provided matches the array's dimensions
-	if (multi_index.size() != this->dimensions) {
-		Log::warning("Number of indices (", multi_index.size(), ") does not match array dimensions (",
-			this->dimensions, "). Returning 0 (potential trunctation).");
-		return UINT32_MAX;
+// returns true if a batch scope is currently active on the calling thread
+bool NGrid::is_batching() {
+	return context().batch_depth != 0;
+}
+
+// +=================================+   
+// | Compute Graphs                  |
+// +=================================+
+
+// runs the given operations once in capture mode: their dispatches are only recorded (with resolved pipelines,
+// descriptor sets and push constants) into the returned graph, which can then be replayed any number of times;
+// nothing is executed by the capture itself; operations that need their results on the host or that submit their work directly
+// (scalar reductions, sorting, scans, convolutions, decompositions, host accesses like get() or set()) can't be captured;
+// the captured operations always run on the GPU (no host backend); without push descriptors, a capture is limited
+// to MAX_DESCRIPTOR_SET_COUNT dispatches (the descriptor sets stay allocated for the lifetime of the graph)
+NGrid::Graph NGrid::capture(const std::function<void()>& operations) {
+	Context& ctx = context();
+	if (ctx.capture != nullptr) {
+		Log::error("invalid usage of method NGrid::capture(): captures can't be nested");
 	}
+	flush(ctx); // work that has been batched before isn't part of the graph
 
-	size_t flat_index_calc = 0;
-	for (size_t i = 0; i < this->dimensions; ++i) {
-		// row-major calculation
-		flat_index_calc = flat_index_calc * static_cast<size_t>(this->shape[i]) + static_cast<size_t>(multi_index[i]);
+	Graph graph;
+	graph.state = std::make_unique<Graph::State>(ctx);
+	ctx.capture = graph.state.get();
+	ctx.batch_depth++; // (keeps the operations off the host backend and makes nested batch scopes ineffective)
+	try {
+		operations();
 	}
+	catch (...) {
+		ctx.batch_depth--;
+		ctx.capture = nullptr;
+		throw;
+	}
+	ctx.batch_depth--;
+	ctx.capture = nullptr;
+	graph.state->pending_streams.clear();
+	graph.record();
+	LOG_DEBUG("NGrid graph captured (", graph.state->nodes.size(), " dispatches)");
+	return graph;
+}
 
-	// Check if the final result fits within the desired return type uint32_t
-	if (flat_index_calc > std::numeric_limits<uint32_t>::max()) {
-		Log::warning("Calculated flat index (", flat_index_calc, ") exceeds maximum value for uint32_t. Returning 0 (potential truncation).");
-		return UINT32_MAX;
+// returns true if a capture is active on the calling thread
+bool NGrid::is_capturing() {
+	return context().capture != nullptr;
+}
+
+uint32_t NGrid::get_captured_dispatches() {
+	Context& ctx = context();
+	return ctx.capture == nullptr ? 0 : static_cast<uint32_t>(ctx.capture->nodes.size());
+}
+
+NGrid::Graph::Graph(Graph&& other) noexcept : state(std::move(other.state)) {}
+
+NGrid::Graph& NGrid::Graph::operator=(Graph&& other) noexcept {
+	if (this != &other) {
+		state = std::move(other.state);
 	}
-	return static_cast<uint32_t>(flat_index_calc);
+	return *this;
+}
+
+NGrid::Graph::~Graph() = default;
+
+// submits the recorded dispatches and waits for their completion; batched work of the calling thread is submitted first
+void NGrid::Graph::replay() {
+	if (state == nullptr) {
+		Log::warning("invalid usage of method NGrid::Graph::replay(): the graph is empty");
+		return;
+	}
+	Context& ctx = context();
+	if (&ctx != state->ctx) {
+		Log::error("invalid usage of method NGrid::Graph::replay(): a graph can only be replayed by the thread that captured it (on the same device)");
+	}
+	flush(ctx);
+
+	// every replay of a random fill draws a new stream, like the fill itself would
+	for (Node& node : state->nodes) {
+		if (node.random_word != UINT32_MAX) {
+			RandomStream stream = next_random_stream(node.random_word);
+			node.constants[node.random_word] = stream.seed_lo;
+			node.constants[node.random_word + 1] = stream.seed_hi;
+			node.constants[node.random_word + 2] = stream.offset_lo;
+			node.constants[node.random_word + 3] = stream.offset_hi;
+			state->dirty = true;
+		}
+	}
+	if (state->dirty) {
+		record();
+	}
+
+	add_async_dependency(ctx, state->command_buffer);
+	Fence fence(*ctx.device, false);
+	state->command_buffer.submit(fence, fence_timeout_nanosec);
+}
+
+uint32_t NGrid::Graph::get_dispatch_count() const {
+	return state == nullptr ? 0 : static_cast<uint32_t>(state->nodes.size());
+}
+
+void NGrid::Graph::set_word(uint32_t dispatch, uint32_t word, uint32_t bits) {
+	if (state == nullptr || dispatch >= state->nodes.size() || word >= state->nodes[dispatch].constants.size()) {
+		Log::warning("invalid usage of method NGrid::Graph::set_constant(): the graph has no push constant word ", word, " at dispatch ", dispatch);
+		return;
+	}
+	state->nodes[dispatch].constants[word] = bits;
+	state->dirty = true;
+}
+
+// (re-)records all nodes into the reusable command buffer (only vkCmd* calls, the pipelines and descriptor sets are resolved already)
+void NGrid::Graph::record() {
+	CommandBuffer& command_buffer = state->command_buffer;
+	command_buffer.reset(); // (begins a new recording)
+	for (const Node& node : state->nodes) {
+		command_buffer.compute(node.pipeline, node.layout, *node.set, node.range, node.constants.data(),
+			node.workgroups_x, node.workgroups_y, node.workgroups_z);
+	}
+
+	// make shader writes visible to the host
+	DeviceMemoryBarrier host_barrier(
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+		VK_ACCESS_2_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_HOST_BIT,
+		VK_ACCESS_2_HOST_READ_BIT | VK_ACCESS_2_HOST_WRITE_BIT
+	);
+	command_buffer.add_barrier(host_barrier);
+	command_buffer.end_recording();
+	state->dirty = false;
+}
+
+NGrid::Graph::State::State(Context& ctx) :
+	ctx(&ctx),
+	command_buffer(*ctx.device, ctx.command_pool, ctx.queue_index) {
+	command_buffer.set_reusable(true);
+}
+
+// releases the descriptor sets to the pool of the capturing thread and deletes the buffers that have been kept alive
+NGrid::Graph::State::~State() {
+	for (Node& node : nodes) {
+		if (!node.set->is_push()) {
+			ctx->descriptor_pool.release_set(*node.set);
+		}
+	}
+	for (Buffer<float_t>* buffer : data_buffers) {
+		delete buffer;
+	}
+	for (Buffer<uint32_t>* buffer : shape_buffers) {
+		delete buffer;
+	}
+}
+
+// adds a dispatch of a captured operation; the graph takes over the descriptor set and copies the push constants
+void NGrid::Graph::State::add(ComputePipeline& pipeline, DescriptorSet& set, uint32_t global_size_x, uint32_t global_size_y, uint32_t global_size_z) {
+	if (!pipeline.cached()) {
+		Log::error("invalid usage of NGrid::capture(): the pipeline of a captured operation isn't owned by the pipeline cache");
+	}
+	Node node;
+	node.pipeline = pipeline.get();
+	node.layout = pipeline.get_layout();
+	node.workgroups_x = (global_size_x + pipeline.get_workgroup_size_x() - 1) / pipeline.get_workgroup_size_x();
+	node.workgroups_y = (global_size_y + pipeline.get_workgroup_size_y() - 1) / pipeline.get_workgroup_size_y();
+	node.workgroups_z = (global_size_z + pipeline.get_workgroup_size_z() - 1) / pipeline.get_workgroup_size_z();
+	node.set = std::make_unique<DescriptorSet>(std::move(set));
+	const PushConstants& constants = *pipeline.get_constants();
+	node.range = constants.get_range();
+	node.constants.assign(constants.get_data(), constants.get_data() + constants.get_size() / 4);
+
+	// the random stream of a random fill is patched by every replay at the push constant word reported by the fill
+	// (only if the stream was actually passed to this dispatch, and not e.g. drawn by a fill that didn't dispatch)
+	for (const PendingStream& pending : pending_streams) {
+		const uint32_t w = pending.word;
+		if (w + 4 <= node.constants.size() && node.constants[w] == pending.stream.seed_lo && node.constants[w + 1] == pending.stream.seed_hi
+			&& node.constants[w + 2] == pending.stream.offset_lo && node.constants[w + 3] == pending.stream.offset_hi) {
+			node.random_word = w;
+		}
+	}
+	pending_streams.clear();
+	nodes.push_back(std::move(node));
 }
 
+// +=================================+   
+// | Lazy Elementwise Expressions    |
+// +=================================+
+
+// returns a lazy expression that references this grid (see class NGrid::Expr)
+NGrid::Expr NGrid::lazy() const {
+	return Expr(*this);
+}
+
+// leaf expression referencing a grid
+NGrid::Expr::Expr(const NGrid& grid) {
+	if (grid.get_elements() == 0) {
+		Log::error("in NGrid::Expr constructor: expressions can't reference empty grids");
+	}
+	inputs.push_back({ &grid, nullptr });
+	program.push_back(OpCode::OP_INPUT);
+	stack_depth = 1;
+}
+
+// leaf expression referencing a packed grid
+NGrid::Expr::Expr(const Packed& packed) {
+	if (packed.get_elements() == 0) {
+		Log::error("in NGrid::Expr constructor: expressions can't reference empty grids");
+	}
+	inputs.push_back({ nullptr, &packed });
+	program.push_back(OpCode::OP_INPUT);
+	stack_depth = 1;
+}
+
+// leaf expression referencing a strided view
+NGrid::Expr::Expr(const View& view) {
+	if (view.get_elements() == 0) {
+		Log::error("in NGrid::Expr constructor: expressions can't reference empty views");
+	}
+	inputs.push_back({ nullptr, nullptr, &view });
+	program.push_back(OpCode::OP_INPUT);
+	stack_depth = 1;
+}
+
+// leaf expression for a scalar constant
+NGrid::Expr::Expr(const float_t value) {
+	constants.push_back(value);
+	program.push_back(OpCode::OP_CONST);
+	stack_depth = 1;
+}
+
+// logarithm to the given base (natural logarithm by default)
+NGrid::Expr NGrid::Expr::log(float_t base) const {
+	Expr result = this->unary(OP_LOG);
+	if (std::fabs(base - 2.718282f) > 1e-6f) {
+		result = result / std::log(base);
+	}
+	return result;
+}
+
+// concatenates the programs of both operands (remapping input slots and constant indices of 'b')
+// and appends the binary instruction
+NGrid::Expr NGrid::Expr::combine(const Expr& a, const Expr& b, OpCode opcode) {
+	Expr result = a;
+	uint32_t constant_offset = static_cast<uint32_t>(result.constants.size());
+	result.constants.insert(result.constants.end(), b.constants.begin(), b.constants.end());
+	for (uint32_t instruction : b.program) {
+		uint32_t operand = instruction >> 8;
+		switch (instruction & 0xFF) {
+		case OpCode::OP_INPUT: result.program.push_back((result.add_input(b.inputs[operand]) << 8) | OpCode::OP_INPUT); break;
+		case OpCode::OP_CONST: result.program.push_back(((operand + constant_offset) << 8) | OpCode::OP_CONST); break;
+		default: result.program.push_back(instruction);
+		}
+	}
+	result.program.push_back(opcode);
+	result.stack_depth = std::max(a.stack_depth, b.stack_depth + 1);
+	if (result.stack_depth > max_stack_depth) {
+		Log::error("in method NGrid::Expr::combine(): expression exceeds the max stack depth of ", max_stack_depth, "; please evaluate parts of it separately");
+	}
+	return result;
+}
+
+// appends a unary instruction
+NGrid::Expr NGrid::Expr::unary(OpCode opcode) const {
+	Expr result = *this;
+	result.program.push_back(opcode);
+	return result;
+}
+
+// returns the input slot of the given grid (adding it if not yet referenced)
+uint32_t NGrid::Expr::add_input(const Input& input) {
+	for (uint32_t i = 0; i < inputs.size(); i++) {
+		if (inputs[i] == input) {
+			return i;
+		}
+	}
+	if (inputs.size() >= max_inputs) {
+		Log::error("in method NGrid::Expr::add_input(): an expression can reference at most ", max_inputs, " different grids");
+	}
+	if (!inputs.empty() && input.elements() != inputs[0].elements()) {
+		Log::error("in method NGrid::Expr::add_input(): all grids of an expression must have the same number of elements (",
+			inputs[0].elements(), " vs. ", input.elements(), ")");
+	}
+	inputs.push_back(input);
+	return static_cast<uint32_t>(inputs.size() - 1);
+}
+
+const Buffer<float_t>& NGrid::Expr::Input::buffer() const {
+	if (view != nullptr) {
+		return *view->get_buffer();
+	}
+	return grid != nullptr ? *grid->get_buffer() : *packed->get_buffer();
+}
+
+NGrid::ElementType NGrid::Expr::Input::type() const {
+	return packed != nullptr ? packed->get_type() : FP32;
+}
+
+uint32_t NGrid::Expr::Input::elements() const {
+	if (view != nullptr) {
+		return view->get_elements();
+	}
+	return grid != nullptr ? grid->get_elements() : packed->get_elements();
+}
+
+std::vector<uint32_t> NGrid::Expr::Input::shape() const {
+	if (view != nullptr) {
+		return view->get_shape();
+	}
+	return grid != nullptr ? grid->get_shape() : packed->get_shape();
+}
+
+bool NGrid::Expr::Input::strided() const {
+	return view != nullptr && (view->get_offset() != 0 || !view->is_contiguous());
+}
+
+// evaluates the fused expression with a single dispatch
+NGrid NGrid::Expr::eval() const {
+	if (inputs.empty()) {
+		Log::error("in method NGrid::Expr::eval(): the expression doesn't reference any grid, so its shape is undefined");
+	}
+	NGrid result(inputs[0].shape());
+	this->run(*result.get_buffer(), result.get_device_index(), FP32);
+	return result;
+}
+
+// evaluates the fused expression with a single dispatch and stores the result in a packed storage element type
+NGrid::Packed NGrid::Expr::eval_packed(ElementType type) const {
+	if (inputs.empty()) {
+		Log::error("in method NGrid::Expr::eval_packed(): the expression doesn't reference any grid, so its shape is undefined");
+	}
+	Packed result(inputs[0].shape(), type);
+	this->run(*result.get_buffer(), result.get_device_index(), type);
+	return result;
+}
+
+// dispatches the interpreter shader for the expression; the PACKED variant of the shader is used
+// if any input or the result has a packed storage element type (one invocation per result word),
+// the STRIDED variant if any input or the result is a strided view
+void NGrid::Expr::run(const Buffer<float_t>& result, uint32_t device_index, ElementType result_type, const View* result_view) const {
+	uint32_t elements = result_view != nullptr ? result_view->get_elements() : inputs[0].elements();
+	bool packed = result_type != FP32;
+	bool strided = result_view != nullptr && Input{ nullptr, nullptr, result_view }.strided();
+	uint32_t input_types = 0;
+	for (uint32_t i = 0; i < inputs.size(); i++) {
+		packed = packed || inputs[i].type() != FP32;
+		strided = strided || inputs[i].strided();
+		input_types |= static_cast<uint32_t>(inputs[i].type()) << (i * 4);
+	}
+	if (packed && strided) {
+		Log::error("in method NGrid::Expr::run(): strided views can't be combined with packed grids in one expression; use View::contiguous() first");
+	}
+
+	// strided layouts of the input slots and of the result (slot max_inputs): offset, dimensions, shape, strides;
+	// regular grids are described as contiguous 1d views
+	Buffer<uint32_t>* layouts_buffer = nullptr;
+	if (strided) {
+		const uint32_t layout_size = 2 + 2 * View::max_dimensions;
+		std::vector<uint32_t> layouts((max_inputs + 1) * layout_size, 0);
+		auto add_layout = [&](uint32_t slot, const View* view) {
+			uint32_t* layout = &layouts[slot * layout_size];
+			if (view == nullptr) {
+				layout[1] = 1;
+				layout[2] = elements;
+				layout[2 + View::max_dimensions] = 1;
+				return;
+			}
+			layout[0] = view->get_offset();
+			layout[1] = view->get_dimensions();
+			for (uint32_t d = 0; d < view->get_dimensions(); d++) {
+				layout[2 + d] = view->shape[d];
+				layout[2 + View::max_dimensions + d] = static_cast<uint32_t>(view->strides[d]); // reinterpreted as int by the shader
+			}
+		};
+		for (uint32_t i = 0; i < inputs.size(); i++) {
+			add_layout(i, inputs[i].view);
+		}
+		add_layout(max_inputs, result_view);
+		layouts_buffer = new Buffer<uint32_t>(current_device(), BufferUsage::STORAGE_BUFFER, static_cast<uint32_t>(layouts.size()));
+		layouts_buffer->write(layouts);
+	}
+
+	// upload program and constants
+	// (heap allocated, so that their release can be deferred in case of batched execution)
+	Buffer<uint32_t>* program_buffer = new Buffer<uint32_t>(current_device(), BufferUsage::STORAGE_BUFFER, get_program_length());
+	program_buffer->write(program);
+	Buffer<float_t>* constants_buffer = new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, std::max(uint32_t(1), uint32_t(constants.size())));
+	if (!constants.empty()) {
+		constants_buffer->write(constants);
+	}
+
+	// load shader
+	const ShaderModule& shader = packed
+		? shader_module(ELEMENTWISE_PROGRAM_PACKED_SPIRV_BIN, ELEMENTWISE_PROGRAM_PACKED_SPIRV_BYTES)
+		: strided
+		? shader_module(ELEMENTWISE_PROGRAM_STRIDED_SPIRV_BIN, ELEMENTWISE_PROGRAM_STRIDED_SPIRV_BYTES)
+		: shader_module(ELEMENTWISE_PROGRAM_SPIRV_BIN, ELEMENTWISE_PROGRAM_SPIRV_BYTES);
+
+	// bind buffers to a descriptor set (unused input slots are bound to the first input,
+	// or to the result for expressions without inputs that are assigned to a view)
+	DescriptorSet set(current_device());
+	for (uint32_t i = 0; i < max_inputs; i++) {
+		set.bind_buffer(inputs.empty() ? result : inputs[i < inputs.size() ? i : 0].buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	}
+	set.bind_buffer(result, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*program_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*constants_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	if (layouts_buffer != nullptr) {
+		set.bind_buffer(*layouts_buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	}
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+
+	// define push constants and execute compute pipeline
+	if (packed) {
+		PushConstants push_constants(elements, get_program_length(), input_types, static_cast<uint32_t>(result_type));
+		ComputePipeline pipeline(current_device(), shader, push_constants, set, workgroup_size_1d);
+		dispatch(device_index, pipeline, set, (elements + Packed::elements_per_word(result_type) - 1) / Packed::elements_per_word(result_type));
+	}
+	else {
+		PushConstants push_constants(elements, get_program_length());
+		ComputePipeline pipeline(current_device(), shader, push_constants, set, workgroup_size_1d);
+		dispatch(device_index, pipeline, set, elements);
+	}
+
+	release_buffer(program_buffer);
+	release_buffer(constants_buffer);
+	release_buffer(layouts_buffer);
+}
+
+// +=================================+
+// | Reductions                      |
+// +=================================+
+
+// records a multi-level reduction of the grid data into a command buffer (without submitting it);
+// full reduction if axis >= dimensions, otherwise one result per position of the remaining axes;
+// level 0 reduces the data into partial results per workgroup, consecutive levels reduce the partial results
+// until a single workgroup per output is left (with at most workgroup_size partials per output, this takes two levels);
+// the output buffer receives one value per output (five values (count, mean, M2, M3, M4) for REDUCE_MOMENTS);
+// the descriptor sets are allocated from the given pool and, like all other temporary objects,
+// kept in 'resources' until the submission has completed
+void NGrid::record_reduction(CommandBuffer& command_buffer, DescriptorPool& pool, ReductionResources& resources, ReductionOp op,
+	Buffer<float_t>& output, uint32_t axis, float_t scale) const {
+	record_buffer_reduction(command_buffer, pool, resources, op, *this->data_buffer, FP32, this->shape, output, axis, scale);
+}
+
+// records a multi-level reduction of the given input buffer (with the elements of a grid of the given shape and element type)
+void NGrid::record_buffer_reduction(CommandBuffer& command_buffer, DescriptorPool& pool, ReductionResources& resources, ReductionOp op,
+	const Buffer<float_t>& input_buffer, ElementType input_type, const std::vector<uint32_t>& shape, Buffer<float_t>& output, uint32_t axis, float_t scale) {
+	// subgroup operations are used for the workgroup level if the device supports them;
+	// packed input is decoded by the PACKED variant of the shaders
+	const bool use_subgroups = current_device().supports_subgroup_arithmetic();
+	const bool packed = input_type != FP32;
+	const ShaderModule& shader = packed
+		? shader_module(
+			use_subgroups ? REDUCE_SUBGROUP_PACKED_SPIRV_BIN : REDUCE_PACKED_SPIRV_BIN,
+			use_subgroups ? REDUCE_SUBGROUP_PACKED_SPIRV_BYTES : REDUCE_PACKED_SPIRV_BYTES)
+		: shader_module(
+			use_subgroups ? REDUCE_SUBGROUP_SPIRV_BIN : REDUCE_SPIRV_BIN,
+			use_subgroups ? REDUCE_SUBGROUP_SPIRV_BYTES : REDUCE_SPIRV_BYTES);
+	std::vector<uint32_t> spec_constants = { static_cast<uint32_t>(op) };
+	if (packed) {
+		spec_constants.push_back(static_cast<uint32_t>(input_type));
+	}
+
+	// segments = independent outputs; elements of a segment are 'inner' apart
+	uint32_t elements = 1;
+	for (uint32_t size : shape) {
+		elements *= size;
+	}
+	uint32_t dimensions = static_cast<uint32_t>(shape.size());
+	uint32_t length = elements;
+	uint32_t inner = 1;
+	if (axis < dimensions) {
+		length = shape[axis];
+		for (uint32_t d = axis + 1; d < dimensions; d++) {
+			inner *= shape[d];
+		}
+	}
+	uint32_t segments = length == 0 ? 0 : elements / length;
+	uint32_t outer_stride = length * inner;
+	if (segments == 0) {
+		return;
+	}
+
+	uint32_t workgroup_size = std::bit_floor(workgroup_size_1d);
+	uint32_t width = op == REDUCE_MOMENTS ? 5 : 1;
+	uint32_t max_segments_y = current_device().get_properties().limits.maxComputeWorkGroupCount[1];
+	uint32_t segments_y = std::min(segments, max_segments_y);
+	uint32_t segments_z = (segments + segments_y - 1) / segments_y;
+
+	const Buffer<float_t>* input = &input_buffer;
+	uint32_t first_level = 1;
+	while (true) {
+		// each invocation should accumulate a few elements before the workgroup level
+		uint32_t groups = std::clamp((length + 4 * workgroup_size - 1) / (4 * workgroup_size), 1u, workgroup_size);
+		Buffer<float_t>* target = &output;
+		if (groups > 1) {
+			resources.buffers.emplace_back(new Buffer<float_t>(scratch_buffer(segments * groups * width)));
+			target = resources.buffers.back().get();
+		}
+
+		resources.sets.emplace_back(new DescriptorSet(current_device()));
+		DescriptorSet& set = *resources.sets.back();
+		set.bind_buffer(*input, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+		set.bind_buffer(*target, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+		set.finalize_layout();
+		pool.allocate_set(set);
+
+		resources.constants.emplace_back(new PushConstants(length, inner, outer_stride, segments, groups, first_level, scale));
+		resources.pipelines.emplace_back(new ComputePipeline(current_device(), shader, *resources.constants.back(), set,
+			workgroup_size, 1, 1, true, spec_constants));
+		command_buffer.compute(*resources.pipelines.back(), groups * workgroup_size, segments_y, segments_z, false, 0, true);
+
+		if (groups == 1) {
+			break;
+		}
+
+		// the partial results of each segment are contiguous
+		input = target;
+		length = groups;
+		inner = 1;
+		outer_stride = groups;
+		first_level = 0;
+	}
+}
+
+// submits reductions that have been recorded into the grid's own command buffer and waits for completion
+void NGrid::submit_reduction(ReductionResources& resources) {
+	add_async_dependency(context().command_buffer);
+	Fence fence(current_device(), false);
+	context().command_buffer.submit(fence, fence_timeout_nanosec);
+	context().command_buffer.reset();
+	for (auto& set : resources.sets) {
+		context().descriptor_pool.release_set(*set);
+	}
+}
+
+// full reduction of all elements with a single submission;
+// returns one value (five values (count, mean, M2, M3, M4) for REDUCE_MOMENTS)
+std::vector<float_t> NGrid::reduce(ReductionOp op) const {
+	uint32_t width = op == REDUCE_MOMENTS ? 5 : 1;
+	if (this->elements == 0) {
+		return std::vector<float_t>(width, 0.0f);
+	}
+	if (op != REDUCE_MOMENTS && this->on_host(HOST_REDUCTION, *this)) {
+		const float_t* data = this->host_read();
+		switch (op) {
+		case REDUCE_SUM: return { static_cast<float_t>(hostkernels::sum(data, this->elements)) };
+		case REDUCE_MIN: return { hostkernels::min(data, this->elements) };
+		case REDUCE_MAX: return { hostkernels::max(data, this->elements) };
+		default: return { hostkernels::maxabs(data, this->elements) };
+		}
+	}
+	flush(); // the reduction is submitted directly on the grid's own command buffer
+	Buffer<float_t> output = scratch_buffer(width);
+	ReductionResources resources;
+	this->record_reduction(context().command_buffer, context().descriptor_pool, resources, op, output);
+	this->submit_reduction(resources);
+	return output.read();
+}
+
+// reduction along one axis with a single submission;
+// the result has the shape of the grid without the reduced axis (or shape {1} for 1d grids)
+NGrid NGrid::reduce_axis(ReductionOp op, uint32_t axis, float_t scale) const {
+	if (axis >= this->dimensions) {
+		Log::error("invalid axis argument for a reduction of an array with shape ", this->get_shapestring(), ": axis is ", axis);
+	}
+	std::vector<uint32_t> result_shape;
+	for (uint32_t d = 0; d < this->dimensions; d++) {
+		if (d != axis) {
+			result_shape.push_back(this->shape[d]);
+		}
+	}
+	if (result_shape.empty()) {
+		result_shape.push_back(1);
+	}
+	NGrid result(result_shape);
+	if (this->elements == 0) {
+		return result;
+	}
+	flush(); // the reduction is submitted directly on the grid's own command buffer
+	ReductionResources resources;
+	this->record_reduction(context().command_buffer, context().descriptor_pool, resources, op, *result.get_buffer(), axis, scale);
+	this->submit_reduction(resources);
+	return result;
+}
+
+// +=================================+   
+// | Packed Storage Types            |
+// +=================================+
+
+// returns a copy of the grid data in a compact storage element type (see class NGrid::Packed)
+NGrid::Packed NGrid::pack(ElementType type) const {
+	return Packed(*this, type);
+}
+
+// number of elements per 32-bit word of the storage buffer
+uint32_t NGrid::Packed::elements_per_word(ElementType type) {
+	switch (type) {
+	case FP16:
+	case BF16: return 2;
+	case INT8:
+	case UINT8: return 4;
+	default: return 1;
+	}
+}
+
+uint32_t NGrid::Packed::get_words() const {
+	return (elements + elements_per_word(type) - 1) / elements_per_word(type);
+}
+
+// allocates the storage buffer on the current device of the calling thread (without initializing it);
+// the buffer is only accessed by shaders, so it always uses device-local memory
+NGrid::Packed::Packed(const std::vector<uint32_t>& shape, ElementType type) : shape(shape), type(type) {
+	init_manager();
+	this->device_index = context().device_index;
+	this->elements = 1;
+	for (uint32_t size : shape) {
+		this->elements *= size;
+	}
+	if (shape.empty()) {
+		this->elements = 0;
+	}
+	if (this->elements != 0) {
+		words = new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, get_words(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+}
+
+// converts the data of a grid into the given storage element type (on the GPU)
+NGrid::Packed::Packed(const NGrid& source, ElementType type) : Packed(source.get_shape(), type) {
+	if (this->elements == 0) {
+		return;
+	}
+
+	// load shader
+	const ShaderModule& shader = shader_module(PACK_SPIRV_BIN, PACK_SPIRV_BYTES);
+
+	// bind buffers to a descriptor set
+	DescriptorSet set(current_device());
+	set.bind_buffer(*source.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*this->words, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+
+	// define push constants
+	PushConstants push_constants(this->elements);
+
+	// execute compute pipeline (one invocation per word)
+	ComputePipeline pipeline(current_device(), shader, push_constants, set, workgroup_size_1d, 1, 1, true, { static_cast<uint32_t>(type) });
+	source.execute(pipeline, set, get_words());
+}
+
+NGrid::Packed::~Packed() {
+	release_buffer(words);
+}
+
+NGrid::Packed::Packed(Packed&& other) noexcept :
+	shape(std::move(other.shape)), elements(other.elements), type(other.type), device_index(other.device_index), words(other.words) {
+	other.elements = 0;
+	other.words = nullptr;
+}
+
+NGrid::Packed& NGrid::Packed::operator=(Packed&& other) noexcept {
+	if (this != &other) {
+		release_buffer(words);
+		shape = std::move(other.shape);
+		elements = other.elements;      other.elements = 0;
+		type = other.type;
+		device_index = other.device_index;
+		words = other.words;            other.words = nullptr;
+	}
+	return *this;
+}
+
+// converts the data back into a regular (fp32) grid
+NGrid NGrid::Packed::unpack() const {
+	NGrid result(shape);
+	if (this->elements == 0) {
+		return result;
+	}
+
+	// load shader
+	const ShaderModule& shader = shader_module(UNPACK_SPIRV_BIN, UNPACK_SPIRV_BYTES);
+
+	// bind buffers to a descriptor set
+	DescriptorSet set(current_device());
+	set.bind_buffer(*this->words, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+	context().descriptor_pool.allocate_set(set);
+
+	// define push constants
+	PushConstants push_constants(this->elements);
+
+	// execute compute pipeline
+	ComputePipeline pipeline(current_device(), shader, push_constants, set, workgroup_size_1d, 1, 1, true, { static_cast<uint32_t>(type) });
+	result.execute(pipeline, set, this->elements);
+	return result;
+}
+
+// returns the decoded elements (via a temporary fp32 grid)
+std::vector<float_t> NGrid::Packed::get() const {
+	return this->unpack().get();
+}
+
+// returns a lazy expression that references this grid (see class NGrid::Expr)
+NGrid::Expr NGrid::Packed::lazy() const {
+	return Expr(*this);
+}
+
+// full reduction of the packed data (decoded by the PACKED variant of the reduction shaders)
+std::vector<float_t> NGrid::Packed::reduce(ReductionOp op) const {
+	uint32_t width = op == REDUCE_MOMENTS ? 5 : 1;
+	if (this->elements == 0) {
+		return std::vector<float_t>(width, 0.0f);
+	}
+	if (this->device_index != context().device_index) {
+		Log::error("in method NGrid::Packed::reduce(): the grid resides on device ", this->device_index, ", but the current device of the calling thread is ", context().device_index);
+	}
+	flush(); // the reduction is submitted directly on the command buffer of the calling thread
+	Buffer<float_t> output = scratch_buffer(width);
+	ReductionResources resources;
+	record_buffer_reduction(context().command_buffer, context().descriptor_pool, resources, op, *this->words, this->type, this->shape, output, UINT32_MAX, 1.0f);
+	submit_reduction(resources);
+	return output.read();
+}
+
+float_t NGrid::Packed::sum() const {
+	return this->reduce(REDUCE_SUM)[0];
+}
+
+float_t NGrid::Packed::mean() const {
+	return this->elements == 0 ? 0.0f : this->sum() / this->elements;
+}
+
+float_t NGrid::Packed::min() const {
+	return this->reduce(REDUCE_MIN)[0];
+}
+
+float_t NGrid::Packed::max() const {
+	return this->reduce(REDUCE_MAX)[0];
+}
+
+float_t NGrid::Packed::maxabs() const {
+	return this->reduce(REDUCE_MAXABS)[0];
+}
+
+// count, mean and central moment sums of all elements with a single reduction
+NGrid::Moments NGrid::Packed::moments() const {
+	std::vector<float_t> values = this->reduce(REDUCE_MOMENTS);
+	Moments result;
+	result.count = values[0];
+	result.mean = values[1];
+	result.M2 = values[2];
+	result.M3 = values[3];
+	result.M4 = values[4];
+	return result;
+}
+
+// +=================================+   
+// | Sparse Matrices                 |
+// +=================================+
+
+// converts the grid into a sparse matrix in compressed sparse row format (see class NGrid::Sparse)
+NGrid::Sparse NGrid::to_sparse(float_t threshold) const {
+	return Sparse(*this, threshold);
+}
+
+NGrid::Sparse NGrid::to_sparse(const NGrid& mask) const {
+	return Sparse(*this, mask);
+}
+
+NGrid::Sparse::Sparse(const NGrid& dense, float_t threshold) {
+	this->compress(dense, nullptr, threshold);
+}
+
+NGrid::Sparse::Sparse(const NGrid& dense, const NGrid& mask) {
+	if (mask.get_elements() != dense.get_elements()) {
+		Log::error("invalid call of NGrid::Sparse constructor: the mask must have as many elements as the dense grid; ",
+			"grid has shape ", dense.get_shapestring(), ", mask has shape ", mask.get_shapestring());
+	}
+	this->compress(dense, &mask, 0.0f);
+}
+
+// creates a sparse matrix from COO triplets (in any order) on the host
+NGrid::Sparse NGrid::Sparse::from_coo(uint32_t rows, uint32_t cols, const std::vector<uint32_t>& row_indices, const std::vector<uint32_t>& column_indices,
+	const std::vector<float_t>& values) {
+	if (row_indices.size() != values.size() || column_indices.size() != values.size()) {
+		Log::error("invalid call of NGrid::Sparse::from_coo(): ", row_indices.size(), " row indices, ", column_indices.size(), " column indices and ",
+			values.size(), " values; the numbers must match");
+	}
+
+	// sort the triplets by row and column, duplicates are summed up
+	std::vector<uint32_t> order(values.size());
+	for (uint32_t i = 0; i < order.size(); i++) {
+		if (row_indices[i] >= rows || column_indices[i] >= cols) {
+			Log::error("invalid call of NGrid::Sparse::from_coo(): position (", row_indices[i], ", ", column_indices[i], ") is outside of the matrix shape {", rows, ",", cols, "}");
+		}
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return row_indices[a] != row_indices[b] ? row_indices[a] < row_indices[b] : column_indices[a] < column_indices[b];
+	});
+	std::vector<float_t> stored_values, stored_columns;
+	std::vector<float_t> row_offsets(rows + 1, 0.0f);
+	std::vector<uint32_t> row_counts(rows, 0);
+	for (uint32_t i = 0; i < order.size(); i++) {
+		uint32_t t = order[i];
+		if (i > 0 && row_indices[t] == row_indices[order[i - 1]] && column_indices[t] == column_indices[order[i - 1]]) {
+			stored_values.back() += values[t];
+			continue;
+		}
+		stored_values.push_back(values[t]);
+		stored_columns.push_back(std::bit_cast<float_t>(column_indices[t]));
+		row_counts[row_indices[t]]++;
+	}
+	uint32_t offset = 0;
+	for (uint32_t row = 0; row <= rows; row++) {
+		row_offsets[row] = std::bit_cast<float_t>(offset);
+		if (row < rows) {
+			offset += row_counts[row];
+		}
+	}
+
+	Sparse result;
+	init_manager();
+	result.device_index = context().device_index;
+	result.rows = rows;
+	result.cols = cols;
+	result.nonzeros = static_cast<uint32_t>(stored_values.size());
+	result.values = NGrid(std::vector<uint32_t>{ result.nonzeros });
+	result.values.set(stored_values);
+	std::shared_ptr<NGrid> column_grid = std::make_shared<NGrid>(std::vector<uint32_t>{ std::max(1u, result.nonzeros) });
+	column_grid->set(stored_columns);
+	std::shared_ptr<NGrid> offset_grid = std::make_shared<NGrid>(std::vector<uint32_t>{ rows + 1 });
+	offset_grid->set(row_offsets);
+	result.columns = column_grid;
+	result.offsets = offset_grid;
+	return result;
+}
+
+// stream compaction of the selected elements: the mask (given or derived from the threshold) is scanned into
+// output positions on the GPU, the number of stored values is read back for the allocation of the value and index grids
+void NGrid::Sparse::compress(const NGrid& dense, const NGrid* mask, float_t threshold) {
+	if (dense.get_dimensions() > 2) {
+		Log::error("invalid call of NGrid::Sparse constructor: the dense grid must be 1d or 2d, but has shape ", dense.get_shapestring());
+	}
+	std::vector<uint32_t> dense_shape = dense.get_shape();
+	this->device_index = dense.get_device_index();
+	this->rows = dense_shape.size() == 2 ? dense_shape[0] : (dense_shape.size() == 1 ? 1 : 0);
+	this->cols = dense_shape.size() == 2 ? dense_shape[1] : (dense_shape.size() == 1 ? dense_shape[0] : 0);
+	this->nonzeros = 0;
+	uint32_t N = rows * cols;
+
+	std::shared_ptr<NGrid> offset_grid = std::make_shared<NGrid>(std::vector<uint32_t>{ rows + 1 });
+	this->offsets = offset_grid;
+	if (N == 0) {
+		offset_grid->fill_zero();
+		this->columns = std::make_shared<NGrid>(std::vector<uint32_t>{ 1 });
+		this->values = NGrid(std::vector<uint32_t>{ 0 });
+		return;
+	}
+
+	// threshold mask
+	const Buffer<float_t>* dense_buffer = dense.get_buffer();
+	NGrid selection;
+	if (mask == nullptr) {
+		selection = NGrid(std::vector<uint32_t>{ N });
+		this->convert(MASK, { dense_buffer, selection.get_buffer(), dense_buffer, dense_buffer, dense_buffer, dense_buffer, dense_buffer }, N, threshold);
+		mask = &selection;
+	}
+
+	// output positions = inclusive scan of the mask predicates
+	flush(); // the scan is submitted directly on the command buffer of the calling thread
+	ReductionResources resources;
+	resources.buffers.emplace_back(new Buffer<float_t>(scratch_buffer(N)));
+	Buffer<float_t>& counts = *resources.buffers.back();
+	record_scan(resources, SCAN_COUNT, *mask->get_buffer(), counts, N);
+	submit_reduction(resources);
+	this->nonzeros = std::bit_cast<uint32_t>(counts.read_element(N - 1));
+
+	// compaction into values and column indices, row offsets
+	std::shared_ptr<NGrid> column_grid = std::make_shared<NGrid>(std::vector<uint32_t>{ std::max(1u, nonzeros) });
+	this->columns = column_grid;
+	this->values = NGrid(std::vector<uint32_t>{ nonzeros });
+	const Buffer<float_t>* value_buffer = nonzeros != 0 ? values.get_buffer() : column_grid->get_buffer();
+	this->convert(COMPRESS, { dense_buffer, mask->get_buffer(), &counts, value_buffer, column_grid->get_buffer(), offset_grid->get_buffer(), offset_grid->get_buffer() },
+		N + 1, 0.0f, true); // ('counts' is local)
+}
+
+// runs one mode of the sparse.comp shader with the buffers of its 7 bindings
+void NGrid::Sparse::convert(ConvertMode mode, const std::vector<const Buffer<float_t>*>& buffers, uint32_t invocations, float_t threshold, bool host_sync) const {
+	const ShaderModule& shader = shader_module(SPARSE_SPIRV_BIN, SPARSE_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
+	for (const Buffer<float_t>* buffer : buffers) {
+		set.bind_buffer(*buffer, DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	}
+	set.finalize_layout();
+
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(static_cast<uint32_t>(mode), rows, cols, threshold);
+
+	ComputePipeline pipeline(current_device(), shader, constants, set, workgroup_size_1d);
+	dispatch(this->device_index, pipeline, set, invocations, 1, 1, host_sync);
+}
+
+// expands the matrix into a dense grid of shape {rows, cols}
+NGrid NGrid::Sparse::to_dense() const {
+	NGrid result(std::vector<uint32_t>{ rows, cols });
+	if (result.get_elements() == 0) {
+		return result;
+	}
+	result.fill_zero();
+	if (nonzeros != 0) {
+		const Buffer<float_t>* index = offsets->get_buffer(); // (placeholder for the unused bindings)
+		this->convert(DENSE, { result.get_buffer(), index, index, values.get_buffer(), columns->get_buffer(), offsets->get_buffer(), index }, rows);
+	}
+	return result;
+}
+
+// returns the row index of every stored value (the COO representation is given by the
+// row indices, the column indices and the values)
+NGrid NGrid::Sparse::row_indices() const {
+	NGrid result(std::vector<uint32_t>{ nonzeros });
+	if (nonzeros != 0) {
+		const Buffer<float_t>* index = offsets->get_buffer();
+		this->convert(ROWS, { index, index, index, values.get_buffer(), columns->get_buffer(), offsets->get_buffer(), result.get_buffer() }, rows);
+	}
+	return result;
+}
+
+// returns the column index of every stored value
+NGrid NGrid::Sparse::column_indices() const {
+	NGrid result(std::vector<uint32_t>{ nonzeros });
+	if (nonzeros != 0) {
+		const Buffer<float_t>* index = offsets->get_buffer();
+		this->convert(COLUMNS, { index, index, index, values.get_buffer(), columns->get_buffer(), offsets->get_buffer(), result.get_buffer() }, rows);
+	}
+	return result;
+}
+
+std::vector<uint32_t> NGrid::Sparse::get_row_offsets() const {
+	std::vector<uint32_t> result;
+	if (offsets == nullptr) {
+		return result;
+	}
+	for (float_t word : offsets->get()) {
+		result.push_back(std::bit_cast<uint32_t>(word));
+	}
+	return result;
+}
+
+std::vector<uint32_t> NGrid::Sparse::get_columns() const {
+	std::vector<uint32_t> result;
+	if (nonzeros == 0) {
+		return result;
+	}
+	std::vector<float_t> words = columns->get();
+	for (uint32_t k = 0; k < nonzeros; k++) {
+		result.push_back(std::bit_cast<uint32_t>(words[k]));
+	}
+	return result;
+}
+
+// copy of the matrix with the same sparsity pattern (shared index grids) and other values
+NGrid::Sparse NGrid::Sparse::with_values(NGrid new_values) const {
+	Sparse result;
+	result.rows = rows;
+	result.cols = cols;
+	result.nonzeros = nonzeros;
+	result.device_index = device_index;
+	result.values = std::move(new_values);
+	result.columns = columns;
+	result.offsets = offsets;
+	return result;
+}
+
+// operands of elementwise operations must have the same sparsity pattern
+// (index grids that aren't shared are compared on the host)
+void NGrid::Sparse::check_pattern(const Sparse& other, const char* method) const {
+	if (this->columns == other.columns && this->offsets == other.offsets) {
+		return;
+	}
+	if (this->rows != other.rows || this->cols != other.cols || this->nonzeros != other.nonzeros
+		|| this->get_row_offsets() != other.get_row_offsets() || this->get_columns() != other.get_columns()) {
+		Log::error("invalid call of NGrid::Sparse::", method, "(): the operands must have the same sparsity pattern; ",
+			"shapes are {", rows, ",", cols, "} with ", nonzeros, " values and {", other.rows, ",", other.cols, "} with ", other.nonzeros, " values");
+	}
+}
+
+// applies an elementwise operation to the stored values; the operation has to return a grid with one element per value
+NGrid::Sparse NGrid::Sparse::map(std::function<NGrid(const NGrid&)> op) const {
+	if (nonzeros == 0) {
+		return *this;
+	}
+	NGrid result_values = op(values);
+	if (result_values.get_elements() != nonzeros) {
+		Log::error("invalid call of NGrid::Sparse::map(): the operation returned ", result_values.get_elements(), " elements for ", nonzeros, " stored values");
+	}
+	return with_values(std::move(result_values));
+}
+
+NGrid::Sparse NGrid::Sparse::operator+(const Sparse& other) const {
+	this->check_pattern(other, "operator+");
+	return nonzeros == 0 ? *this : with_values(values + other.values);
+}
+
+NGrid::Sparse NGrid::Sparse::operator-(const Sparse& other) const {
+	this->check_pattern(other, "operator-");
+	return nonzeros == 0 ? *this : with_values(values - other.values);
+}
+
+NGrid::Sparse NGrid::Sparse::Hadamard_product(const Sparse& other) const {
+	this->check_pattern(other, "Hadamard_product");
+	return nonzeros == 0 ? *this : with_values(values.Hadamard_product(other.values));
+}
+
+// samples the dense grid (rows x cols elements) at the positions of the stored values
+NGrid::Sparse NGrid::Sparse::Hadamard_product(const NGrid& dense) const {
+	if (dense.get_elements() != rows * cols) {
+		Log::error("invalid call of NGrid::Sparse::Hadamard_product(): the dense grid (shape ", dense.get_shapestring(), ") must have ",
+			rows, " x ", cols, " elements");
+	}
+	if (nonzeros == 0) {
+		return *this;
+	}
+	NGrid result_values(std::vector<uint32_t>{ nonzeros });
+	const Buffer<float_t>* index = offsets->get_buffer();
+	this->convert(SAMPLE, { dense.get_buffer(), index, index, values.get_buffer(), columns->get_buffer(), offsets->get_buffer(), result_values.get_buffer() }, rows);
+	return with_values(std::move(result_values));
+}
+
+float_t NGrid::Sparse::sum() const {
+	return nonzeros == 0 ? 0.0f : values.sum();
+}
+
+float_t NGrid::Sparse::mean() const {
+	return rows * cols == 0 ? 0.0f : this->sum() / (float_t(rows) * cols);
+}
+
+// min and max include the elements that aren't stored (zero) if the matrix isn't full
+float_t NGrid::Sparse::min() const {
+	if (nonzeros == 0) {
+		return 0.0f;
+	}
+	return nonzeros < rows * cols ? std::min(0.0f, values.min()) : values.min();
+}
+
+float_t NGrid::Sparse::max() const {
+	if (nonzeros == 0) {
+		return 0.0f;
+	}
+	return nonzeros < rows * cols ? std::max(0.0f, values.max()) : values.max();
+}
+
+float_t NGrid::Sparse::maxabs() const {
+	return nonzeros == 0 ? 0.0f : values.maxabs();
+}
+
+// sparse x dense matrix product (see sparse_matrix_product.comp); the workgroups span the columns of the dense matrix
+// (up to the workgroup size), so that matrix-vector products use the whole workgroup for rows
+NGrid NGrid::Sparse::matrix_product(const NGrid& dense) const {
+	std::vector<uint32_t> dense_shape = dense.get_shape();
+	if (dense_shape.empty() || dense_shape.size() > 2 || dense_shape[0] != cols) {
+		Log::error("invalid call of NGrid::Sparse::matrix_product(): the sparse matrix has shape {", rows, ",", cols, "}, the dense grid has shape ",
+			dense.get_shapestring(), "; the dense grid must be 1d or 2d with ", cols, " rows");
+	}
+	uint32_t n = dense_shape.size() == 2 ? dense_shape[1] : 1;
+	NGrid result(dense_shape.size() == 2 ? std::vector<uint32_t>{ rows, n } : std::vector<uint32_t>{ rows });
+	if (result.get_elements() == 0) {
+		return result;
+	}
+	if (nonzeros == 0) {
+		result.fill_zero();
+		return result;
+	}
+
+	const ShaderModule& shader = shader_module(SPARSE_MATRIX_PRODUCT_SPIRV_BIN, SPARSE_MATRIX_PRODUCT_SPIRV_BYTES);
+
+	DescriptorSet set(current_device());
+	set.bind_buffer(*values.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*columns->get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*offsets->get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*dense.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.bind_buffer(*result.get_buffer(), DescriptorType::STORAGE_BUFFER_DESCRIPTOR);
+	set.finalize_layout();
+
+	context().descriptor_pool.allocate_set(set);
+
+	PushConstants constants(rows, n);
+
+	const auto& limits = current_device().get_properties().limits;
+	uint32_t invocations = workgroup_size_2d * workgroup_size_2d;
+	uint32_t wg_x = std::min({ invocations, std::bit_ceil(n), limits.maxComputeWorkGroupSize[0] });
+	uint32_t wg_y = std::min(invocations / wg_x, limits.maxComputeWorkGroupSize[1]);
+	ComputePipeline pipeline(current_device(), shader, constants, set, wg_x, wg_y);
+	result.execute(pipeline, set, n, rows);
+
+	return result;
+}
+
+// +=================================+   
+// | Strided Views                   |
+// +=================================+
+
+// zero-copy views of the grid data (see class NGrid::View)
+NGrid::View NGrid::as_view() const {
+	return View(*this);
+}
+
+NGrid::View NGrid::subgrid_view(const std::vector<uint32_t>& source_offset, const std::vector<uint32_t>& subgrid_shape) const {
+	return View(*this).subgrid(source_offset, subgrid_shape);
+}
+
+NGrid::View NGrid::transpose_view(const std::vector<uint32_t>& target_axis_order) const {
+	return View(*this).transpose(target_axis_order);
+}
+
+NGrid::View NGrid::reshape_view(const std::vector<uint32_t>& new_shape) const {
+	return View(*this).reshape(new_shape);
+}
+
+NGrid::View NGrid::flatten_view() const {
+	return View(*this).flatten();
+}
+
+NGrid::View NGrid::mirror_view(const std::vector<bool>& mirror_axes) const {
+	return View(*this).mirror(mirror_axes);
+}
+
+// view of the whole grid (row-major strides)
+NGrid::View::View(const NGrid& grid) :
+	storage(grid.data_buffer),
+	shape(grid.get_shape()),
+	elements(grid.get_elements()),
+	device_index(grid.get_device_index()) {
+	if (shape.size() > max_dimensions) {
+		Log::error("in NGrid::View constructor: views support up to ", max_dimensions, " dimensions, the grid has ", shape.size());
+	}
+	strides.resize(shape.size());
+	int32_t stride = 1;
+	for (int32_t d = int32_t(shape.size()) - 1; d >= 0; d--) {
+		strides[d] = stride;
+		stride *= int32_t(shape[d]);
+	}
+}
+
+// view of a rectangular region
+NGrid::View NGrid::View::subgrid(const std::vector<uint32_t>& source_offset, const std::vector<uint32_t>& subgrid_shape) const {
+	if (source_offset.size() != shape.size() || subgrid_shape.size() != shape.size()) {
+		Log::error("in method NGrid::View::subgrid(): offset and shape need ", shape.size(), " dimensions");
+	}
+	View result = *this;
+	result.elements = 1;
+	for (uint32_t d = 0; d < shape.size(); d++) {
+		if (subgrid_shape[d] == 0 || source_offset[d] + subgrid_shape[d] > shape[d]) {
+			Log::error("in method NGrid::View::subgrid(): the subgrid exceeds the viewed shape in dimension ", d);
+		}
+		result.offset = uint32_t(int64_t(result.offset) + int64_t(source_offset[d]) * strides[d]);
+		result.shape[d] = subgrid_shape[d];
+		result.elements *= subgrid_shape[d];
+	}
+	return result;
+}
+
+// view with one axis fixed at the given index
+NGrid::View NGrid::View::select(uint32_t axis, uint32_t index) const {
+	if (axis >= shape.size() || index >= shape[axis]) {
+		Log::error("in method NGrid::View::select(): index ", index, " along axis ", axis, " is out of bounds");
+	}
+	View result = *this;
+	result.offset = uint32_t(int64_t(offset) + int64_t(index) * strides[axis]);
+	result.elements = elements / shape[axis];
+	result.shape.erase(result.shape.begin() + axis);
+	result.strides.erase(result.strides.begin() + axis);
+	if (result.shape.empty()) {
+		result.shape = { 1 };
+		result.strides = { 1 };
+	}
+	return result;
+}
+
+// view with permuted axes
+NGrid::View NGrid::View::transpose(const std::vector<uint32_t>& target_axis_order) const {
+	if (target_axis_order.size() != shape.size()) {
+		Log::error("in method NGrid::View::transpose(): the axis order needs ", shape.size(), " entries");
+	}
+	std::vector<bool> used(shape.size(), false);
+	View result = *this;
+	for (uint32_t i = 0; i < target_axis_order.size(); i++) {
+		uint32_t axis = target_axis_order[i];
+		if (axis >= shape.size() || used[axis]) {
+			Log::error("in method NGrid::View::transpose(): the axis order isn't a permutation of the axes");
+		}
+		used[axis] = true;
+		result.shape[i] = shape[axis];
+		result.strides[i] = strides[axis];
+	}
+	return result;
+}
+
+// view with a new shape of the same elements; only contiguous views can be reshaped without a copy
+NGrid::View NGrid::View::reshape(const std::vector<uint32_t>& new_shape) const {
+	uint32_t new_elements = 1;
+	for (uint32_t size : new_shape) {
+		new_elements *= size;
+	}
+	if (new_shape.empty() || new_shape.size() > max_dimensions || new_elements != elements) {
+		Log::error("in method NGrid::View::reshape(): the new shape must have ", elements, " elements and up to ", max_dimensions, " dimensions");
+	}
+	if (!is_contiguous()) {
+		Log::error("in method NGrid::View::reshape(): the view isn't contiguous; use contiguous().reshape() instead");
+	}
+	View result = *this;
+	result.shape = new_shape;
+	result.strides.resize(new_shape.size());
+	int32_t stride = 1;
+	for (int32_t d = int32_t(new_shape.size()) - 1; d >= 0; d--) {
+		result.strides[d] = stride;
+		stride *= int32_t(new_shape[d]);
+	}
+	return result;
+}
+
+NGrid::View NGrid::View::flatten() const {
+	return reshape({ elements });
+}
+
+// view with reversed element order along the selected axes
+NGrid::View NGrid::View::mirror(const std::vector<bool>& mirror_axes) const {
+	if (mirror_axes.size() != shape.size()) {
+		Log::error("in method NGrid::View::mirror(): the mirror axes need ", shape.size(), " entries");
+	}
+	View result = *this;
+	for (uint32_t d = 0; d < shape.size(); d++) {
+		if (mirror_axes[d]) {
+			result.offset = uint32_t(int64_t(result.offset) + int64_t(shape[d] - 1) * strides[d]);
+			result.strides[d] = -strides[d];
+		}
+	}
+	return result;
+}
+
+NGrid::View NGrid::View::mirror() const {
+	return mirror(std::vector<bool>(shape.size(), true));
+}
+
+// true if the viewed elements are consecutive in row-major order (axes of size 1 are ignored)
+bool NGrid::View::is_contiguous() const {
+	int64_t expected = 1;
+	for (int32_t d = int32_t(shape.size()) - 1; d >= 0; d--) {
+		if (shape[d] == 1) {
+			continue;
+		}
+		if (strides[d] != expected) {
+			return false;
+		}
+		expected *= shape[d];
+	}
+	return true;
+}
+
+// copies the viewed elements into a new contiguous grid (single strided dispatch)
+NGrid NGrid::View::contiguous() const {
+	if (elements == 0) {
+		return NGrid();
+	}
+	return lazy().eval();
+}
+
+std::vector<float_t> NGrid::View::get() const {
+	return contiguous().get();
+}
+
+NGrid::Expr NGrid::View::lazy() const {
+	return Expr(*this);
+}
+
+// evaluates an expression of the same number of elements into the viewed elements (in row-major order);
+// writes through to the viewed grid
+void NGrid::View::assign(const Expr& expr) {
+	if (elements == 0) {
+		Log::error("in method NGrid::View::assign(): can't assign to an empty view");
+	}
+	if (!expr.inputs.empty() && expr.inputs[0].elements() != elements) {
+		Log::error("in method NGrid::View::assign(): the expression has ", expr.inputs[0].elements(), " elements, the view has ", elements);
+	}
+	expr.run(*storage, device_index, FP32, this);
+}
+
+void NGrid::View::assign(const NGrid& source) {
+	assign(source.lazy());
+}
+
+// +=================================+   
+// | Binary Files                    |
+// +=================================+
+
+// writes the grid to a binary file (see class NGrid::File for the layout);
+// the payload is stored in the given storage element type (packed for types other than FP32);
+// chunk_rows = slices along axis 0 per chunk (0 = single chunk)
+void NGrid::save(const std::string& filepath, ElementType type, uint32_t chunk_rows) const {
+	if (this->elements == 0) {
+		Log::warning("in method NGrid::save(): the grid is empty, no file is written");
+		return;
+	}
+	if (this->dimensions > File::max_dimensions) {
+		Log::error("in method NGrid::save(): grid files support up to ", File::max_dimensions, " dimensions, the grid has ", this->dimensions);
+	}
+	uint32_t rows = this->shape[0];
+	uint32_t row_elements = this->elements / rows;
+	if (chunk_rows == 0 || chunk_rows > rows) {
+		chunk_rows = rows;
+	}
+	uint32_t per_word = Packed::elements_per_word(type);
+
+	File::Header header = {};
+	std::memcpy(header.magic, "NGRD", 4);
+	header.version = File::version;
+	header.type = static_cast<uint32_t>(type);
+	header.dimensions = this->dimensions;
+	for (uint32_t d = 0; d < this->dimensions; d++) {
+		header.shape[d] = this->shape[d];
+	}
+	header.elements = this->elements;
+	header.chunk_rows = chunk_rows;
+	header.chunks = (rows + chunk_rows - 1) / chunk_rows;
+	header.chunk_bytes = File::aligned(uint64_t((uint64_t(chunk_rows) * row_elements + per_word - 1) / per_word) * 4);
+	header.payload_offset = File::aligned(sizeof(File::Header));
+
+	std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+	if (!stream) {
+		Log::error("in method NGrid::save(): can't open file '", filepath, "' for writing");
+	}
+	const std::vector<char> zeros(File::alignment, 0);
+	auto pad_to = [&](uint64_t position) {
+		uint64_t current = static_cast<uint64_t>(stream.tellp());
+		while (current < position) {
+			uint64_t count = std::min<uint64_t>(position - current, zeros.size());
+			stream.write(zeros.data(), count);
+			current += count;
+		}
+	};
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// FP32 chunks are written straight from the (mapped) grid data, other types are packed chunk by chunk
+	std::span<const float_t> values;
+	if (type == FP32) {
+		values = this->view();
+	}
+	for (uint32_t chunk = 0; chunk < header.chunks; chunk++) {
+		pad_to(header.payload_offset + chunk * header.chunk_bytes);
+		uint32_t first_row = chunk * chunk_rows;
+		uint32_t chunk_elements = std::min(chunk_rows, rows - first_row) * row_elements;
+		if (type == FP32) {
+			stream.write(reinterpret_cast<const char*>(values.data() + uint64_t(first_row) * row_elements), uint64_t(chunk_elements) * sizeof(float_t));
+			continue;
+		}
+		std::vector<uint32_t> chunk_shape = this->shape;
+		chunk_shape[0] = chunk_elements / row_elements;
+		NGrid part(chunk_shape);
+		part.set(*this, chunk_elements, first_row * row_elements, 0);
+		Packed packed = part.pack(type);
+		std::vector<float_t> words(packed.get_words());
+		get_staging(packed.get_device_index()).download(*packed.get_buffer(), words.data(), packed.get_words());
+		stream.write(reinterpret_cast<const char*>(words.data()), uint64_t(words.size()) * 4);
+	}
+	pad_to(File::aligned(static_cast<uint64_t>(stream.tellp())));
+	if (!stream) {
+		Log::error("in method NGrid::save(): writing to file '", filepath, "' failed");
+	}
+}
+
+// loads a grid file that was written by save()
+NGrid NGrid::load(const std::string& filepath) {
+	return File(filepath).load();
+}
+
+// opens a grid file and maps it into memory (read-only)
+NGrid::File::File(const std::string& filepath) : path(filepath) {
+	auto fail = [&](const std::string& reason) {
+		this->close();
+		Log::error("in NGrid::File constructor: ", reason, " ('", filepath, "')");
+	};
+#ifdef _WIN32
+	file_handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE) {
+		fail("can't open file");
+	}
+	LARGE_INTEGER size;
+	GetFileSizeEx(file_handle, &size);
+	file_bytes = static_cast<uint64_t>(size.QuadPart);
+	if (file_bytes < sizeof(Header)) {
+		fail("the file is too small for a grid file header");
+	}
+	mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_handle != nullptr) {
+		mapped = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	}
+#else
+	file_descriptor = ::open(filepath.c_str(), O_RDONLY);
+	if (file_descriptor < 0) {
+		fail("can't open file");
+	}
+	struct stat status;
+	fstat(file_descriptor, &status);
+	file_bytes = static_cast<uint64_t>(status.st_size);
+	if (file_bytes < sizeof(Header)) {
+		fail("the file is too small for a grid file header");
+	}
+	void* address = mmap(nullptr, file_bytes, PROT_READ, MAP_SHARED, file_descriptor, 0);
+	if (address != MAP_FAILED) {
+		mapped = static_cast<const uint8_t*>(address);
+	}
+#endif
+	if (mapped == nullptr) {
+		fail("can't map file into memory");
+	}
+
+	// validate the header
+	Header header;
+	std::memcpy(&header, mapped, sizeof(Header));
+	if (std::memcmp(header.magic, "NGRD", 4) != 0) {
+		fail("not a grid file");
+	}
+	if (header.version != version) {
+		fail("unsupported grid file version " + std::to_string(header.version));
+	}
+	if (header.type > static_cast<uint32_t>(UINT8) || header.dimensions == 0 || header.dimensions > max_dimensions
+		|| header.chunk_rows == 0 || header.payload_offset < sizeof(Header)) {
+		fail("invalid grid file header");
+	}
+	type = static_cast<ElementType>(header.type);
+	shape.assign(header.shape, header.shape + header.dimensions);
+	// (the sizes are computed in 64 bit, so that a malformed header can't wrap them around)
+	uint64_t total_elements = 1;
+	for (uint32_t size : shape) {
+		total_elements *= size;
+		if (total_elements > UINT32_MAX) {
+			fail("invalid grid file header");
+		}
+	}
+	if (total_elements == 0 || total_elements != header.elements || header.chunk_rows > shape[0]
+		|| header.chunks != (shape[0] + header.chunk_rows - 1) / header.chunk_rows) {
+		fail("invalid grid file header");
+	}
+	elements = static_cast<uint32_t>(total_elements);
+	row_elements = elements / shape[0];
+	chunk_rows = header.chunk_rows;
+	chunks = header.chunks;
+	chunk_bytes = header.chunk_bytes;
+	payload_offset = header.payload_offset;
+
+	// every chunk must fit into its stride (a full chunk has chunk_rows slices at the stored type),
+	// and all chunks must lie within the mapped file
+	uint32_t per_word = Packed::elements_per_word(type);
+	auto payload_bytes = [&](uint32_t rows) { return (uint64_t(rows) * row_elements + per_word - 1) / per_word * 4; };
+	if (chunk_bytes < payload_bytes(chunk_rows)) {
+		fail("invalid grid file header (chunk size is smaller than the payload of a chunk)");
+	}
+	if (payload_offset > file_bytes || uint64_t(chunks - 1) > (file_bytes - payload_offset) / chunk_bytes
+		|| payload_bytes(rows_of_chunk(chunks - 1)) > file_bytes - payload_offset - uint64_t(chunks - 1) * chunk_bytes) {
+		fail("the file is truncated");
+	}
+}
+
+NGrid::File::~File() {
+	this->close();
+}
+
+NGrid::File::File(File&& other) noexcept {
+	*this = std::move(other);
+}
+
+NGrid::File& NGrid::File::operator=(File&& other) noexcept {
+	if (this != &other) {
+		this->close();
+		path = std::move(other.path);
+		shape = std::move(other.shape);
+		type = other.type;
+		elements = other.elements;
+		row_elements = other.row_elements;
+		chunk_rows = other.chunk_rows;
+		chunks = other.chunks;
+		chunk_bytes = other.chunk_bytes;
+		payload_offset = other.payload_offset;
+		file_bytes = other.file_bytes;
+		mapped = std::exchange(other.mapped, nullptr);
+#ifdef _WIN32
+		file_handle = std::exchange(other.file_handle, INVALID_HANDLE_VALUE);
+		mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#else
+		file_descriptor = std::exchange(other.file_descriptor, -1);
+#endif
+	}
+	return *this;
+}
+
+void NGrid::File::close() {
+#ifdef _WIN32
+	if (mapped != nullptr) {
+		UnmapViewOfFile(mapped);
+	}
+	if (mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+		mapping_handle = nullptr;
+	}
+	if (file_handle != INVALID_HANDLE_VALUE) {
+		CloseHandle(file_handle);
+		file_handle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (mapped != nullptr) {
+		munmap(const_cast<uint8_t*>(mapped), file_bytes);
+	}
+	if (file_descriptor >= 0) {
+		::close(file_descriptor);
+		file_descriptor = -1;
+	}
+#endif
+	mapped = nullptr;
+}
+
+NGrid NGrid::File::load() const {
+	return load_rows(0, shape.empty() ? 0 : shape[0]);
+}
+
+NGrid NGrid::File::load_chunk(uint32_t chunk) const {
+	if (chunk >= chunks) {
+		Log::error("in method NGrid::File::load_chunk(): chunk index ", chunk, " is out of bounds (", chunks, " chunks)");
+	}
+	return load_rows(chunk * chunk_rows, rows_of_chunk(chunk));
+}
+
+// loads consecutive slices along axis 0; FP32 data is uploaded straight from the mapped pages,
+// packed chunks are uploaded into a packed grid and decoded on the device
+NGrid NGrid::File::load_rows(uint32_t first_row, uint32_t rows) const {
+	if (!is_open()) {
+		Log::error("in method NGrid::File::load_rows(): the file isn't open");
+	}
+	if (rows == 0 || first_row + rows > shape[0]) {
+		Log::error("in method NGrid::File::load_rows(): rows [", first_row, ", ", first_row + rows, ") are out of bounds (", shape[0], " rows)");
+	}
+	std::vector<uint32_t> result_shape = shape;
+	result_shape[0] = rows;
+	NGrid result(result_shape);
+	flush();
+	for (uint32_t chunk = first_row / chunk_rows; chunk <= (first_row + rows - 1) / chunk_rows; chunk++) {
+		uint32_t chunk_first = chunk * chunk_rows;
+		uint32_t begin = std::max(first_row, chunk_first);
+		uint32_t end = std::min(first_row + rows, chunk_first + rows_of_chunk(chunk));
+		uint32_t copied_elements = (end - begin) * row_elements;
+		uint32_t source_offset = (begin - chunk_first) * row_elements;
+		uint32_t target_offset = (begin - first_row) * row_elements;
+		if (type == FP32) {
+			result.upload(chunk_data(chunk) + source_offset, copied_elements, target_offset);
+			continue;
+		}
+		std::vector<uint32_t> chunk_shape = shape;
+		chunk_shape[0] = rows_of_chunk(chunk);
+		Packed packed(chunk_shape, type);
+		get_staging(packed.get_device_index()).upload(*packed.get_buffer(), chunk_data(chunk), packed.get_words());
+		result.set(packed.unpack(), copied_elements, source_offset, target_offset);
+	}
+	return result;
+}
+
+uint32_t NGrid::File::rows_of_chunk(uint32_t chunk) const {
+	return std::min(chunk_rows, shape[0] - chunk * chunk_rows);
+}
+
+// start of the mapped chunk data (packed chunks as 32-bit words)
+const float_t* NGrid::File::chunk_data(uint32_t chunk) const {
+	return reinterpret_cast<const float_t*>(mapped + payload_offset + uint64_t(chunk) * chunk_bytes);
+}
+
+// +=================================+   
+// | Out-of-Core Streaming           |
+// +=================================+
+
+NGrid::Streaming::Streaming(std::span<const float_t> source, uint32_t chunk_elements, uint32_t buffers) :
+	source(source),
+	chunk_elements(chunk_elements),
+	buffers(buffers) {
+	if (chunk_elements == 0 || buffers == 0) {
+		Log::error("in NGrid::Streaming constructor: chunk_elements and buffers must be at least 1");
+	}
+}
+
+// uploads the chunks into a ring of device grids and runs the operation on each of them;
+// the upload of chunk k + buffers is submitted as soon as the operation on chunk k has returned,
+// so that up to buffers - 1 uploads are in flight on the transfer queue while the compute queue works on a chunk
+void NGrid::Streaming::for_each(std::function<void(const NGrid& chunk, uint64_t offset)> op) const {
+	if (source.empty()) {
+		return;
+	}
+	flush();
+	Context& ctx = context();
+	uint64_t chunks = get_chunks();
+	uint32_t slots = static_cast<uint32_t>(std::min<uint64_t>(buffers, chunks));
+	auto chunk_size = [&](uint64_t chunk) {
+		return static_cast<uint32_t>(std::min<uint64_t>(chunk_elements, source.size() - chunk * chunk_elements));
+	};
+	std::vector<NGrid> grids;
+	for (uint32_t slot = 0; slot < slots; slot++) {
+		grids.emplace_back(std::vector<uint32_t>{ chunk_size(slot) });
+	}
+
+	// transfer queue resources (only needed for device-local grids)
+	bool overlapped = grids[0].is_device_local() && ctx.device->supports_timeline_semaphores();
+	std::unique_ptr<CommandPool> pool;
+	std::vector<CommandBuffer> command_buffers;
+	std::vector<std::unique_ptr<Buffer<float_t>>> staging;
+	std::unique_ptr<Semaphore> timeline;
+	std::vector<uint64_t> slot_values(slots, 0); // timeline value of the last upload per slot
+	uint64_t submitted_value = 0;
+	if (overlapped) {
+		pool = std::make_unique<CommandPool>(*ctx.device, QueueFamily::TRANSFER_QUEUE);
+		timeline = std::make_unique<Semaphore>(*ctx.device, VK_SEMAPHORE_TYPE_TIMELINE, 0);
+		for (uint32_t slot = 0; slot < slots; slot++) {
+			command_buffers.emplace_back(*ctx.device, *pool);
+			staging.emplace_back(new Buffer<float_t>(*ctx.device, BufferUsage::TRANSFER_BUFFER, chunk_size(slot),
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+		}
+	}
+
+	auto upload = [&](uint64_t chunk) {
+		uint32_t slot = static_cast<uint32_t>(chunk % slots);
+		uint32_t size = chunk_size(chunk);
+		const float_t* data = source.data() + chunk * chunk_elements;
+		if (grids[slot].get_elements() != size) {
+			grids[slot] = NGrid(std::vector<uint32_t>{ size }); // last chunk
+		}
+		if (!overlapped) {
+			grids[slot].upload(data, size, 0);
+			return;
+		}
+		if (slot_values[slot] != 0) {
+			timeline->wait_for(slot_values[slot], fence_timeout_nanosec);
+			command_buffers[slot].reset();
+		}
+		staging[slot]->write(data, size);
+		command_buffers[slot].copy_buffer(*staging[slot], *grids[slot].get_buffer(), uint64_t(size) * sizeof(float_t));
+		slot_values[slot] = ++submitted_value;
+		command_buffers[slot].signal_semaphore(*timeline, slot_values[slot]);
+		command_buffers[slot].submit();
+	};
+	auto finish = [&]() {
+		if (overlapped && submitted_value != 0) {
+			timeline->wait_for(submitted_value, fence_timeout_nanosec);
+		}
+	};
+
+	try {
+		for (uint64_t chunk = 0; chunk < slots; chunk++) {
+			upload(chunk);
+		}
+		for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+			uint32_t slot = static_cast<uint32_t>(chunk % slots);
+			if (overlapped) {
+				timeline->wait_for(slot_values[slot], fence_timeout_nanosec); // chunk has arrived
+			}
+			op(grids[slot], chunk * chunk_elements);
+			flush();
+			if (chunk + slots < chunks) {
+				upload(chunk + slots);
+			}
+		}
+	}
+	catch (...) {
+		finish(); // pending transfers must complete before their buffers are released
+		throw;
+	}
+	finish();
+}
+
+// applies an elementwise operation chunk by chunk and writes the results to the target
+void NGrid::Streaming::map(std::span<float_t> target, std::function<NGrid(const NGrid&)> op) const {
+	if (target.size() < source.size()) {
+		Log::error("in method NGrid::Streaming::map(): the target has ", target.size(), " elements, the source has ", source.size());
+	}
+	for_each([&](const NGrid& chunk, uint64_t offset) {
+		NGrid result = op(chunk);
+		if (result.get_elements() != chunk.get_elements()) {
+			Log::error("in method NGrid::Streaming::map(): the operation returned ", result.get_elements(), " elements for a chunk of ", chunk.get_elements());
+		}
+		flush();
+		result.download(target.data() + offset, result.get_elements(), 0);
+	});
+}
+
+// scales all elements to the given range; needs two streaming passes (global min/max and scaling)
+void NGrid::Streaming::scale_minmax(std::span<float_t> target, float_t range_from, float_t range_to) const {
+	float_t lowest = std::numeric_limits<float_t>::max();
+	float_t highest = std::numeric_limits<float_t>::lowest();
+	for_each([&](const NGrid& chunk, uint64_t) {
+		lowest = std::min(lowest, chunk.min());
+		highest = std::max(highest, chunk.max());
+	});
+	float_t factor = highest > lowest ? (range_to - range_from) / (highest - lowest) : 0.0f;
+	map(target, [&](const NGrid& chunk) { return ((chunk.lazy() - lowest) * factor + range_from).eval(); });
+}
+
+float_t NGrid::Streaming::sum() const {
+	double total = 0;
+	for_each([&](const NGrid& chunk, uint64_t) { total += chunk.sum(); });
+	return static_cast<float_t>(total);
+}
+
+float_t NGrid::Streaming::mean() const {
+	return source.empty() ? 0.0f : static_cast<float_t>(double(this->sum()) / double(source.size()));
+}
+
+// variance from the moments of the chunks (pairwise combination of count, mean and M2)
+float_t NGrid::Streaming::var(bool sample_var) const {
+	double count = 0, mean = 0, M2 = 0;
+	for_each([&](const NGrid& chunk, uint64_t) {
+		Moments m = chunk.moments();
+		double combined = count + m.count;
+		double delta = m.mean - mean;
+		mean += delta * m.count / combined;
+		M2 += m.M2 + delta * delta * count * m.count / combined;
+		count = combined;
+	});
+	return static_cast<float_t>(M2 / (sample_var ? count - 1 : count));
+}
+
+float_t NGrid::Streaming::stdev(bool sample_var) const {
+	return std::sqrt(this->var(sample_var));
+}
+
+float_t NGrid::Streaming::min() const {
+	float_t result = std::numeric_limits<float_t>::max();
+	for_each([&](const NGrid& chunk, uint64_t) { result = std::min(result, chunk.min()); });
+	return source.empty() ? 0.0f : result;
+}
+
+float_t NGrid::Streaming::max() const {
+	float_t result = std::numeric_limits<float_t>::lowest();
+	for_each([&](const NGrid& chunk, uint64_t) { result = std::max(result, chunk.max()); });
+	return source.empty() ? 0.0f : result;
+}
+
+// +=================================+   
+// | Asynchronous Results            |
+// +=================================+
+
+// asynchronous version of NGrid::sum()
+NGrid::Async NGrid::sum_async() const {
+	if (!async_supported()) {
+		return Async(this->sum());
+	}
+	Async handle = begin_async();
+	this->record_async_reduction(handle, REDUCE_SUM);
+	submit_async(handle, [](const std::vector<float_t>& values) { return values[0]; });
+	return handle;
+}
+
+// asynchronous version of NGrid::mean()
+NGrid::Async NGrid::mean_async() const {
+	if (!async_supported()) {
+		return Async(this->mean());
+	}
+	Async handle = begin_async();
+	this->record_async_reduction(handle, REDUCE_SUM);
+	uint32_t n = this->elements;
+	submit_async(handle, [n](const std::vector<float_t>& values) { return values[0] / n; });
+	return handle;
+}
+
+// asynchronous version of NGrid::var()
+NGrid::Async NGrid::var_async(bool sample_var) const {
+	if (!async_supported()) {
+		return Async(this->var(sample_var));
+	}
+	Async handle = begin_async();
+	this->record_async_reduction(handle, REDUCE_MOMENTS);
+	submit_async(handle, [sample_var](const std::vector<float_t>& values) { return values[2] / (sample_var ? values[0] - 1 : values[0]); });
+	return handle;
+}
+
+// asynchronous version of NGrid::scalar_product();
+// (the elementwise product is computed synchronously, only the reduction runs asynchronously)
+NGrid::Async NGrid::scalar_product_async(const NGrid& other) const {
+	if (!async_supported()) {
+		return Async(this->scalar_product(other));
+	}
+	NGrid product = this->Hadamard_product(other);
+	Async handle = begin_async();
+	product.record_async_reduction(handle, REDUCE_SUM);
+	submit_async(handle, [](const std::vector<float_t>& values) { return values[0]; });
+	handle.state->keep_alive.push_back(std::move(product));
+	return handle;
+}
+
+// asynchronous version of NGrid::Dickey_Fuller();
+// the Pearson correlation between the series and its first order differences is obtained
+// from five sums (x, y, x*y, x*x, y*y) that get reduced within a single submission
+NGrid::Async NGrid::Dickey_Fuller_async() const {
+	if (this->dimensions != 1 || (this->dimensions == 2 && this->shape[1] != 1)) {
+		Log::warning("NGrid::Dickey_Fuller_async() is only valid for 1d vectors, returning NAN");
+		return Async(float_t(NAN));
+	}
+	if (!async_supported()) {
+		return Async(this->Dickey_Fuller());
+	}
+	// prepare the elementwise terms with a single submission
+	NGrid x, y, xy, xx, yy;
+	{
+		Batch batch;
+		x = this->subgrid({ 1 }, { this->shape[0] - 1 });
+		y = this->stationary();
+		xy = x.Hadamard_product(y);
+		xx = x.Hadamard_product(x);
+		yy = y.Hadamard_product(y);
+	}
+
+	Async handle = begin_async();
+	for (const NGrid* grid : { &x, &y, &xy, &xx, &yy }) {
+		grid->record_async_reduction(handle, REDUCE_SUM);
+	}
+	float_t n = static_cast<float_t>(this->elements - 1);
+	submit_async(handle, [n](const std::vector<float_t>& values) {
+		float_t sx = values[0], sy = values[1], sxy = values[2], sxx = values[3], syy = values[4];
+		float_t R = (n * sxy - sx * sy) / std::sqrt((n * sxx - sx * sx) * (n * syy - sy * sy));
+		return R * std::sqrt(n / (1 - std::pow(R, 2)));
+	});
+	for (NGrid* grid : { &x, &y, &xy, &xx, &yy }) {
+		handle.state->keep_alive.push_back(std::move(*grid));
+	}
+	return handle;
+}
+
+// blocks until all asynchronous submissions of the calling thread have completed
+void NGrid::wait_async() {
+	Context& ctx = context();
+	if (ctx.async_timeline == nullptr || ctx.async_timeline_value == 0) {
+		return;
+	}
+	ctx.async_timeline->wait_for(ctx.async_timeline_value, fence_timeout_nanosec);
+}
+
+// handle for a result that has already been computed synchronously
+NGrid::Async::Async(float_t result) {
+	this->immediate = true;
+	this->immediate_result = result;
+}
+
+// returns true if the handle refers to a result
+bool NGrid::Async::valid() const {
+	return immediate || state != nullptr;
+}
+
+// returns true if the result is available (non-blocking)
+bool NGrid::Async::ready() const {
+	if (immediate) { return true; }
+	if (state == nullptr) { return false; }
+	return state->done || state->timeline->counter() >= state->value;
+}
+
+// blocks until the GPU work of the submission has completed
+void NGrid::Async::wait() const {
+	if (immediate || state == nullptr || state->done) {
+		return;
+	}
+	VkResult result = state->timeline->wait_for(state->value, fence_timeout_nanosec);
+	if (result != VK_SUCCESS) {
+		Log::error("in method NGrid::Async::wait(): failed to wait for the timeline semaphore (VkResult = ", result, ")");
+	}
+}
+
+// blocks until the result is available and returns it
+// (the GPU resources of the submission are released on the first call)
+float_t NGrid::Async::get() const {
+	if (immediate) {
+		return immediate_result;
+	}
+	if (state == nullptr) {
+		Log::error("invalid usage of method NGrid::Async::get(): the handle doesn't refer to a result");
+	}
+	if (!state->done) {
+		wait();
+		std::vector<float_t> values;
+		values.reserve(state->results.size());
+		for (const auto& buffer : state->results) {
+			std::vector<float_t> buffer_values = buffer->read();
+			values.insert(values.end(), buffer_values.begin(), buffer_values.end());
+		}
+		state->result = state->finish(values);
+		state->done = true;
+	}
+	return state->result;
+}
+
+// returns the timeline semaphore that signals completion (nullptr if computed synchronously)
+const Semaphore* NGrid::Async::get_semaphore() const {
+	return (immediate || state == nullptr) ? nullptr : state->timeline.get();
+}
+
+// returns the timeline value that signals completion
+uint64_t NGrid::Async::get_value() const {
+	return state != nullptr ? state->value : 0;
+}
+
+NGrid::Async::State::State() :
+	command_pool(current_device(), QueueFamily::COMPUTE_QUEUE),
+	command_buffer(current_device(), command_pool, context().queue_index),
+	pool(current_device(), max_dispatches, { {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * max_dispatches} }) {
+}
+
+// waits for completion before the resources get released
+NGrid::Async::State::~State() {
+	if (submitted && timeline != nullptr) {
+		timeline->wait_for(value, fence_timeout_nanosec);
+	}
+}
+
+// +=================================+   
+// | Sharded Grids                   |
+// +=================================+
+
+// creates a sharded grid of the given shape; the rows (axis 0) are split into contiguous parts of (almost) equal size,
+// one per device index (the number of shards is limited by the number of rows)
+NGrid::Sharded::Sharded(const std::vector<uint32_t>& shape, const std::vector<uint32_t>& device_indices) : shape(shape) {
+	if (shape.empty() || shape[0] == 0) {
+		Log::error("invalid call of NGrid::Sharded constructor: axis 0 must have at least one row");
+	}
+	if (device_indices.empty()) {
+		Log::error("invalid call of NGrid::Sharded constructor: no devices specified");
+	}
+	uint32_t count = std::min(static_cast<uint32_t>(device_indices.size()), shape[0]);
+	uint32_t rows_per_shard = shape[0] / count;
+	uint32_t remainder = shape[0] % count;
+	uint32_t offset = 0;
+	std::vector<uint32_t> row_counts;
+	for (uint32_t i = 0; i < count; i++) {
+		devices.push_back(device_indices[i]);
+		offsets.push_back(offset);
+		row_counts.push_back(rows_per_shard + (i < remainder ? 1 : 0));
+		offset += row_counts.back();
+	}
+	shards.resize(count);
+	run([&](uint32_t i) {
+		std::vector<uint32_t> shard_shape = this->shape;
+		shard_shape[0] = row_counts[i];
+		shards[i] = NGrid(shard_shape);
+	});
+}
+
+// copy constructor (the shards are copied on their devices)
+NGrid::Sharded::Sharded(const Sharded& other) : shape(other.shape), devices(other.devices), offsets(other.offsets) {
+	shards.resize(other.shards.size());
+	run([&](uint32_t i) { shards[i] = other.shards[i]; });
+}
+
+// copy assignment (the shards are copied on their devices)
+NGrid::Sharded& NGrid::Sharded::operator=(const Sharded& other) {
+	if (this != &other) {
+		Sharded copy(other);
+		*this = std::move(copy);
+	}
+	return *this;
+}
+
+// splits a grid along axis 0 across the given devices (the data is distributed via host memory)
+NGrid::Sharded NGrid::Sharded::scatter(const NGrid& source, const std::vector<uint32_t>& device_indices) {
+	Sharded result(source.get_shape(), device_indices);
+	result.set(source.get());
+	return result;
+}
+
+// combines the shards into a single grid on the current device of the calling thread
+NGrid NGrid::Sharded::gather() const {
+	NGrid result(shape);
+	result.set(get());
+	return result;
+}
+
+// returns the elements of all shards in row-major order
+std::vector<float_t> NGrid::Sharded::get() const {
+	std::vector<float_t> values(get_elements());
+	uint32_t row_size = row_elements();
+	run([&](uint32_t i) {
+		std::vector<float_t> part = shards[i].get();
+		std::copy(part.begin(), part.end(), values.begin() + static_cast<size_t>(offsets[i]) * row_size);
+	});
+	return values;
+}
+
+// writes the elements (in row-major order) to the shards
+void NGrid::Sharded::set(const std::vector<float_t>& data) {
+	if (data.size() != get_elements()) {
+		Log::error("invalid call of NGrid::Sharded::set(): ", data.size(), " values for ", get_elements(), " elements");
+	}
+	uint32_t row_size = row_elements();
+	run([&](uint32_t i) {
+		shards[i].set(data, shards[i].get_elements(), offsets[i] * row_size, 0);
+	});
+}
+
+uint32_t NGrid::Sharded::get_elements() const {
+	uint32_t elements = 0;
+	for (const NGrid& s : shards) {
+		elements += s.get_elements();
+	}
+	return elements;
+}
+
+NGrid& NGrid::Sharded::shard(uint32_t index) {
+	if (index >= shards.size()) {
+		Log::error("in method NGrid::Sharded::shard(): invalid shard index ", index, " (", shards.size(), " shards)");
+	}
+	return shards[index];
+}
+
+const NGrid& NGrid::Sharded::shard(uint32_t index) const {
+	if (index >= shards.size()) {
+		Log::error("in method NGrid::Sharded::shard(): invalid shard index ", index, " (", shards.size(), " shards)");
+	}
+	return shards[index];
+}
+
+uint32_t NGrid::Sharded::get_shard_device(uint32_t index) const {
+	return devices.at(index);
+}
+
+uint32_t NGrid::Sharded::get_shard_offset(uint32_t index) const {
+	return offsets.at(index);
+}
+
+// applies an operation to every shard on its own device; the operation may change the row count of the shards
+NGrid::Sharded NGrid::Sharded::map(std::function<NGrid(const NGrid&)> op) const {
+	Sharded result;
+	result.devices = devices;
+	result.shards.resize(shards.size());
+	run([&](uint32_t i) { result.shards[i] = op(shards[i]); });
+	result.update_shape();
+	return result;
+}
+
+// applies an in-place operation to every shard on its own device
+void NGrid::Sharded::for_each(std::function<void(NGrid&)> op) {
+	run([&](uint32_t i) { op(shards[i]); });
+	update_shape();
+}
+
+NGrid::Sharded NGrid::Sharded::operator+(const Sharded& other) const {
+	return zip(other, "operator+", [](const NGrid& a, const NGrid& b) { return a + b; });
+}
+
+NGrid::Sharded NGrid::Sharded::operator-(const Sharded& other) const {
+	return zip(other, "operator-", [](const NGrid& a, const NGrid& b) { return a - b; });
+}
+
+NGrid::Sharded NGrid::Sharded::Hadamard_product(const Sharded& other) const {
+	return zip(other, "Hadamard_product", [](const NGrid& a, const NGrid& b) { return a.Hadamard_product(b); });
+}
+
+// sum of all elements (the partial sums are accumulated in double precision)
+float_t NGrid::Sharded::sum() const {
+	std::vector<float_t> partial(shards.size());
+	run([&](uint32_t i) { partial[i] = shards[i].sum(); });
+	double total = 0;
+	for (float_t value : partial) {
+		total += value;
+	}
+	return static_cast<float_t>(total);
+}
+
+float_t NGrid::Sharded::mean() const {
+	uint32_t elements = get_elements();
+	return elements == 0 ? 0.0f : this->sum() / elements;
+}
+
+float_t NGrid::Sharded::min() const {
+	std::vector<float_t> partial(shards.size());
+	run([&](uint32_t i) { partial[i] = shards[i].min(); });
+	return partial.empty() ? 0.0f : *std::min_element(partial.begin(), partial.end());
+}
+
+float_t NGrid::Sharded::max() const {
+	std::vector<float_t> partial(shards.size());
+	run([&](uint32_t i) { partial[i] = shards[i].max(); });
+	return partial.empty() ? 0.0f : *std::max_element(partial.begin(), partial.end());
+}
+
+// matrix product with a (replicated) right-hand side: every device computes the rows of its shard;
+// the right-hand side is copied to the devices via host memory
+NGrid::Sharded NGrid::Sharded::matrix_product(const NGrid& other) const {
+	if (shape.size() != 2 || other.get_dimensions() != 2 || shape[1] != other.get_size(0)) {
+		Log::error("invalid call of method NGrid::Sharded::matrix_product(): the sharded grid must be 2d and its column count must match the rows of the ",
+			other.get_shapestring(), " right-hand side");
+	}
+	std::vector<float_t> replica = other.get();
+	std::vector<uint32_t> replica_shape = other.get_shape();
+	return map([&](const NGrid& s) {
+		NGrid local(replica_shape);
+		local.set(replica);
+		return s.matrix_product(local);
+	});
+}
+
+// concatenation; along axis 0 the shards of the other grid are appended (as copies on their devices),
+// along any other axis the shards are concatenated pairwise (requires identical partitioning of the rows)
+NGrid::Sharded NGrid::Sharded::concatenate(const Sharded& other, const uint32_t axis) const {
+	if (axis != 0) {
+		return zip(other, "concatenate", [axis](const NGrid& a, const NGrid& b) { return a.concatenate(b, axis); });
+	}
+	if (other.shape.size() != shape.size() || !std::equal(shape.begin() + 1, shape.end(), other.shape.begin() + 1)) {
+		Log::error("invalid call of method NGrid::Sharded::concatenate(): both grids must have the same size along all axes except axis 0");
+	}
+	Sharded result(*this);
+	Sharded appended(other);
+	for (uint32_t i = 0; i < appended.shards.size(); i++) {
+		result.devices.push_back(appended.devices[i]);
+		result.shards.push_back(std::move(appended.shards[i]));
+	}
+	result.update_shape();
+	return result;
+}
+
+NGrid::Sharded NGrid::Sharded::zip(const Sharded& other, const char* method, std::function<NGrid(const NGrid&, const NGrid&)> op) const {
+	check_partitioning(other, method);
+	Sharded result;
+	result.devices = devices;
+	result.shards.resize(shards.size());
+	run([&](uint32_t i) { result.shards[i] = op(shards[i], other.shards[i]); });
+	result.update_shape();
+	return result;
+}
+
+void NGrid::Sharded::check_partitioning(const Sharded& other, const char* method) const {
+	if (other.devices != devices || other.offsets != offsets || other.shape[0] != shape[0]) {
+		Log::error("invalid call of method NGrid::Sharded::", method, "(): both grids must have the same partitioning along axis 0 (same row count and devices)");
+	}
+}
+
+// derives the shape and the row offsets from the shards (after shard-local operations)
+void NGrid::Sharded::update_shape() {
+	offsets.clear();
+	shape.clear();
+	uint32_t rows = 0;
+	for (const NGrid& s : shards) {
+		offsets.push_back(rows);
+		rows += s.get_dimensions() == 0 ? 0 : s.get_size(0);
+	}
+	if (!shards.empty()) {
+		shape = shards[0].get_shape();
+		if (!shape.empty()) {
+			shape[0] = rows;
+		}
+	}
+}
+
+uint32_t NGrid::Sharded::row_elements() const {
+	if (shape.empty() || shape[0] == 0) {
+		return 0;
+	}
+	uint32_t elements = 1;
+	for (uint32_t i = 1; i < shape.size(); i++) {
+		elements *= shape[i];
+	}
+	return elements;
+}
+
+// runs the task for every shard on the worker thread of its device and waits for all of them;
+// the first exception of a task is rethrown afterwards
+void NGrid::Sharded::run(const std::function<void(uint32_t)>& task) const {
+	std::vector<std::future<void>> futures;
+	for (uint32_t i = 0; i < shards.size(); i++) {
+		futures.push_back(worker(devices[i]).submit([&task, i]() { task(i); }));
+	}
+	for (std::future<void>& f : futures) {
+		f.wait();
+	}
+	for (std::future<void>& f : futures) {
+		f.get();
+	}
+}
+
+// returns the worker thread of a device (created on first use, joined at program exit)
+NGrid::Sharded::Worker& NGrid::Sharded::worker(uint32_t device_index) {
+	if (device_index >= get_device_count()) {
+		Log::error("in NGrid::Sharded: invalid physical device index ", device_index, " (", get_device_count(), " devices available)");
+	}
+	static std::mutex mtx;
+	static std::map<uint32_t, std::unique_ptr<Worker>> workers;
+	std::lock_guard<std::mutex> lock(mtx);
+	std::unique_ptr<Worker>& w = workers[device_index];
+	if (w == nullptr) {
+		w = std::make_unique<Worker>(device_index);
+	}
+	return *w;
+}
+
+NGrid::Sharded::Worker::Worker(uint32_t device_index) : device_index(device_index) {
+	thread = std::thread(&Worker::loop, this);
+}
+
+NGrid::Sharded::Worker::~Worker() {
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stopping = true;
+	}
+	cv.notify_one();
+	thread.join();
+}
+
+std::future<void> NGrid::Sharded::Worker::submit(std::function<void()> task) {
+	std::packaged_task<void()> packaged(std::move(task));
+	std::future<void> result = packaged.get_future();
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		tasks.push_back(std::move(packaged));
+	}
+	cv.notify_one();
+	return result;
+}
+
+void NGrid::Sharded::Worker::loop() {
+	NGrid::set_current_device(device_index);
+	while (true) {
+		std::packaged_task<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			if (tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
+
+// +=================================+   
+// | Protected Class Members         |
+// +=================================+
+
+// creates the shared manager for instance, device and command pools on first use;
+// the first call might happen on any thread, so the initialization is guarded
+void NGrid::init_manager() {
+	static std::once_flag once;
+	std::call_once(once, []() {
+		manager = VulkanManager::get_singleton() != nullptr ? VulkanManager::get_singleton() : VulkanManager::make_singleton_for_compute(1, 3, 0);
+	});
+}
+
+// returns the execution context of the calling thread for its current device
+// (the default device, unless NGrid::set_current_device() has been called on this thread)
+NGrid::Context& NGrid::context() {
+	if (Context::current == nullptr) {
+		init_manager();
+		Context::current = &context(manager->get_default_device_index());
+	}
+	return *Context::current;
+}
+
+// returns the execution context of the calling thread for the given physical device index
+// (created on first use, destroyed on thread exit)
+NGrid::Context& NGrid::context(uint32_t device_index) {
+	init_manager();
+	thread_local std::map<uint32_t, std::unique_ptr<Context>> instances;
+	auto it = instances.find(device_index);
+	if (it == instances.end()) {
+		it = instances.emplace(device_index, std::make_unique<Context>(device_index)).first;
+	}
+	return *it->second;
+}
+
+NGrid::Context::Context(uint32_t device_index) :
+	device_index(device_index),
+	device(&manager->get_device(device_index)),
+	queue_index(assign_queue(*device)),
+	command_pool(*device, QueueFamily::COMPUTE_QUEUE),
+	command_buffer(*device, command_pool, queue_index),
+	batch_command_buffer(*device, command_pool, queue_index),
+	descriptor_pool(*device, MAX_DESCRIPTOR_SET_COUNT, {
+		{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_DESCRIPTOR_SET_COUNT * MAX_DESCRIPTOR_SET_BINDINGS},
+		{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 20}
+	}) {
+	LOG_DEBUG("NGrid execution context created (device: ", device_index, ", compute queue: ", queue_index, ")");
+}
+
+// submits pending batched work and waits for asynchronous submissions before the pools get released
+NGrid::Context::~Context() {
+	batch_depth = 0;
+	flush(*this);
+	if (async_timeline != nullptr && async_timeline_value != 0) {
+		async_timeline->wait_for(async_timeline_value, fence_timeout_nanosec);
+	}
+	if (current == this) {
+		current = nullptr;
+	}
+}
+
+// assigns the queues of the compute queue family round-robin to the threads
+uint32_t NGrid::Context::assign_queue(Device& device) {
+	return next_queue++ % device.get_compute_queue_count();
+}
+
+// returns the current device of the calling thread
+Device& NGrid::current_device() {
+	return *context().device;
+}
+
+// returns the shader module for a SPIR-V binary on the current device of the calling thread
+// (created on first use; the modules live until program exit)
+const ShaderModule& NGrid::shader_module(const unsigned char* binary, size_t size_bytes) {
+	static std::mutex mtx;
+	static std::map<std::pair<VkDevice, const unsigned char*>, std::unique_ptr<ShaderModule>> modules;
+	Device& device = current_device();
+	std::lock_guard<std::mutex> lock(mtx);
+	std::unique_ptr<ShaderModule>& module = modules[{ device.get_logical(), binary }];
+	if (module == nullptr) {
+		if (size_bytes == 0) {
+			// e.g. a shader that failed to compile or an outdated fallback header (include/spirv_bin_precompiled.h)
+			Log::error("in method NGrid::shader_module(): empty SPIR-V binary; rebuild the shaders with COMPILE_GLSL_SHADERS=ON or update the fallback header with the 'update_spirv_fallback' target");
+		}
+		module = std::make_unique<ShaderModule>(device, binary, size_bytes);
+	}
+	return *module;
+}
+
+// deletes a buffer or, if it may still be referenced by recorded (but not yet submitted)
+// dispatches of the current batch, defers its deletion until the next flush
+void NGrid::release_buffer(Buffer<float_t>*& buffer) {
+	if (buffer == nullptr) { return; }
+	if (Context::current != nullptr && Context::current->capture != nullptr) {
+		Context::current->capture->data_buffers.push_back(buffer); // (kept by the graph)
+	}
+	else if (Context::current != nullptr && Context::current->batch_recorded_dispatches != 0) {
+		Context::current->batch_pending_data_buffers.push_back(buffer);
+	}
+	else {
+		delete buffer;
+	}
+	buffer = nullptr;
+}
+
+void NGrid::release_buffer(Buffer<uint32_t>*& buffer) {
+	if (buffer == nullptr) { return; }
+	if (Context::current != nullptr && Context::current->capture != nullptr) {
+		Context::current->capture->shape_buffers.push_back(buffer);
+	}
+	else if (Context::current != nullptr && Context::current->batch_recorded_dispatches != 0) {
+		Context::current->batch_pending_shape_buffers.push_back(buffer);
+	}
+	else {
+		delete buffer;
+	}
+	buffer = nullptr;
+}
+
+// drops a reference to a shared data buffer; the buffer gets released (see above) with its last reference
+void NGrid::release_buffer(std::shared_ptr<Buffer<float_t>>& buffer) {
+	buffer.reset();
+}
+
+// takes ownership of a data buffer that may be shared by grids and views
+std::shared_ptr<Buffer<float_t>> NGrid::shared_buffer(Buffer<float_t>* buffer) {
+	return std::shared_ptr<Buffer<float_t>>(buffer, [](Buffer<float_t>* released) { release_buffer(released); });
+}
+
+// byte ranges of the rows (along the last axis) of a tile of the grid (invalid tiles give no ranges)
+std::vector<std::pair<VkDeviceSize, VkDeviceSize>> NGrid::tile_ranges(const std::vector<uint32_t>& tile_offset, const std::vector<uint32_t>& tile_shape, const char* method) const {
+	std::vector<std::pair<VkDeviceSize, VkDeviceSize>> ranges;
+	if (this->dimensions == 0 || tile_offset.size() != this->dimensions || tile_shape.size() != this->dimensions) {
+		Log::warning("invalid usage of method NGrid::", method, "(): the tile offset and shape must have ", this->dimensions, " dimensions");
+		return ranges;
+	}
+	for (uint32_t axis = 0; axis < this->dimensions; axis++) {
+		if (tile_shape[axis] == 0) {
+			return ranges;
+		}
+		if (tile_offset[axis] + tile_shape[axis] > this->shape[axis]) {
+			Log::warning("invalid usage of method NGrid::", method, "(): the tile exceeds the grid (shape ", this->get_shapestring(), ") along axis ", axis);
+			return ranges;
+		}
+	}
+	std::vector<uint32_t> index = tile_offset;
+	while (true) {
+		ranges.push_back({ VkDeviceSize(flat_index(index)) * sizeof(float_t), VkDeviceSize(tile_shape.back()) * sizeof(float_t) });
+		int32_t axis = int32_t(this->dimensions) - 2;
+		for (; axis >= 0; axis--) {
+			if (++index[axis] < tile_offset[axis] + tile_shape[axis]) {
+				break;
+			}
+			index[axis] = tile_offset[axis];
+		}
+		if (axis < 0) {
+			return ranges;
+		}
+	}
+}
+
+// binds (resident = true) or releases the pages of the given byte ranges of a sparse data buffer;
+// releases are limited to the pages that lie completely within a range
+uint32_t NGrid::change_residency(std::vector<std::pair<VkDeviceSize, VkDeviceSize>> ranges, bool resident, const char* method) {
+	if (!is_sparse_resident()) {
+		Log::warning("invalid usage of method NGrid::", method, "(): the grid doesn't have sparse residency (see NGrid::sparse_resident())");
+		return 0;
+	}
+	if (is_capturing()) {
+		Log::error("in method NGrid::", method, "(): residency changes can't be captured into a graph");
+	}
+	if (ranges.empty()) {
+		return 0;
+	}
+	flush(); // recorded dispatches must see the residency in program order
+	Device& device = *context(this->device_index).device;
+	if (resident) {
+		return data_buffer->bind_pages(device, ranges);
+	}
+	wait_async_reads();
+	VkDeviceSize page_size = data_buffer->get_page_size();
+	for (auto& [offset_bytes, range_bytes] : ranges) {
+		VkDeviceSize begin = (offset_bytes + page_size - 1) / page_size * page_size;
+		VkDeviceSize end = offset_bytes + range_bytes >= data_buffer->get_size_bytes() ? data_buffer->get_page_count() * page_size // (including the tail page)
+			: (offset_bytes + range_bytes) / page_size * page_size;
+		offset_bytes = begin;
+		range_bytes = end > begin ? end - begin : 0;
+	}
+	return data_buffer->unbind_pages(device, ranges);
+}
+
+// executes a compute pipeline with the given descriptor set;
+// with direct submission (default) the dispatch gets submitted immediately and the set is released;
+// inside a batch scope, the dispatch is only recorded and the set is kept allocated until the next flush;
+// host_sync=true forces a flush after recording, which is required if the caller reads results
+// on the host or if the dispatch references buffers that are local to the calling method
+void NGrid::execute(ComputePipeline& pipeline, DescriptorSet& set, uint32_t global_size_x, uint32_t global_size_y, uint32_t global_size_z, bool host_sync,
+	std::source_location location) const {
+#ifdef PROFILING
+	// the dispatch is tagged with the calling method and the shape of the result
+	bool sampled = Profiler::sample();
+	CommandBuffer::set_profile_label(sampled ? Profiler::function_name(location.function_name()) : "", sampled ? get_shapestring() : "", sampled);
+#endif
+	dispatch(this->device_index, pipeline, set, global_size_x, global_size_y, global_size_z, host_sync, location);
+}
+
+// executes a compute pipeline for a result that resides on the given device (see NGrid::execute())
+void NGrid::dispatch(uint32_t device_index, ComputePipeline& pipeline, DescriptorSet& set, uint32_t global_size_x, uint32_t global_size_y, uint32_t global_size_z, bool host_sync,
+	std::source_location location) {
+	Context& ctx = context();
+#ifdef PROFILING
+	if (!CommandBuffer::get_profile_label().assigned) {
+		CommandBuffer::set_profile_label(Profiler::function_name(location.function_name()), "", Profiler::sample());
+	}
+#endif
+	if (device_index != ctx.device_index) {
+		Log::error("in method NGrid::execute(): the grid resides on device ", device_index, ", but the current device of the calling thread is ", ctx.device_index,
+			"; use NGrid::set_current_device() before operating on the grid");
+	}
+	if (ctx.capture != nullptr) {
+		if (host_sync) {
+			Log::error("invalid usage of NGrid::capture(): a captured operation requires its results on the host or uses temporary buffers");
+		}
+		ctx.capture->add(pipeline, set, global_size_x, global_size_y, global_size_z);
+		return;
+	}
+	if (ctx.batch_depth == 0) {
+		add_async_dependency(ctx, ctx.command_buffer);
+		ctx.command_buffer.compute(pipeline, global_size_x, global_size_y, global_size_z, true, fence_timeout_nanosec, true);
+		ctx.descriptor_pool.release_set(set);
+		return;
+	}
+
+	ctx.batch_command_buffer.compute(pipeline, global_size_x, global_size_y, global_size_z, false, 0, true);
+	if (!set.is_push()) {
+		// (push descriptors are captured by the recording; only sets allocated from the pool have to outlive it)
+		ctx.batch_pending_sets.push_back(std::move(set));
+	}
+	ctx.batch_recorded_dispatches++;
+
+	// pipelines that aren't owned by the pipeline cache are destroyed by the caller, so they need to complete right away;
+	// a full descriptor pool also requires a flush before the next operation can allocate its set
+	if (host_sync || !pipeline.cached() || ctx.descriptor_pool.get_current_sets_count() >= ctx.descriptor_pool.get_max_sets()) {
+		flush();
+	}
+}
+
+// returns true if asynchronous submissions are available,
+// i.e. if the device supports timeline semaphores (the timeline of the calling thread is created on first use)
+bool NGrid::async_supported() {
+	Context& ctx = context();
+	if (ctx.async_timeline == nullptr) {
+		if (!current_device().supports_timeline_semaphores()) {
+			return false;
+		}
+		ctx.async_timeline = std::make_shared<Semaphore>(current_device(), VK_SEMAPHORE_TYPE_TIMELINE, 0);
+	}
+	return true;
+}
+
+// lets the next submission of the command buffer wait for pending asynchronous work of the calling thread
+// (so that subsequent writes can't overtake asynchronous reads of the same grid)
+void NGrid::add_async_dependency(CommandBuffer& command_buffer) {
+	add_async_dependency(context(), command_buffer);
+}
+
+void NGrid::add_async_dependency(Context& ctx, CommandBuffer& command_buffer) {
+	if (ctx.async_timeline != nullptr && ctx.async_timeline->counter() < ctx.async_timeline_value) {
+		command_buffer.wait_semaphore(*ctx.async_timeline, ctx.async_timeline_value, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+	}
+}
+
+// blocks until asynchronous operations that read this grid have completed (on whichever thread they were submitted);
+// required before the data buffer is written from the host or released
+void NGrid::wait_async_reads() const {
+	if (async_read_value == 0 || async_read_timeline == nullptr) {
+		return;
+	}
+	if (async_read_timeline->counter() < async_read_value) {
+		async_read_timeline->wait_for(async_read_value, fence_timeout_nanosec);
+	}
+	async_read_value = 0;
+	async_read_timeline.reset();
+}
+
+// returns a new handle for an asynchronous submission;
+// pending batched work has to be submitted first, because the asynchronous work might depend on it
+NGrid::Async NGrid::begin_async() {
+	flush();
+	Async handle;
+	handle.state = std::make_shared<Async::State>();
+	return handle;
+}
+
+// records a full reduction of this grid into the command buffer of an asynchronous submission;
+// the result values are appended to the values that are passed to the 'finish' function
+// (one value, or five values (count, mean, M2, M3, M4) for REDUCE_MOMENTS)
+void NGrid::record_async_reduction(Async& handle, ReductionOp op) const {
+	Async::State& state = *handle.state;
+	if (this->device_index != context().device_index) {
+		Log::error("in method NGrid::record_async_reduction(): the grid resides on device ", this->device_index, ", but the current device of the calling thread is ", context().device_index);
+	}
+	if (state.resources.sets.size() + 2 > Async::max_dispatches) {
+		Log::error("in method NGrid::record_async_reduction(): max number of dispatches per asynchronous submission (", Async::max_dispatches, ") exceeded");
+	}
+	uint32_t width = op == REDUCE_MOMENTS ? 5 : 1;
+	state.results.emplace_back(new Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, width));
+	if (this->elements == 0) {
+		state.results.back()->set_all(0.0f);
+		return;
+	}
+	this->record_reduction(state.command_buffer, state.pool, state.resources, op, *state.results.back());
+	state.readers.push_back(this);
+}
+
+// submits the recorded work of an asynchronous handle without waiting for it;
+// completion is signaled via the timeline semaphore of the calling thread
+void NGrid::submit_async(Async& handle, std::function<float_t(const std::vector<float_t>&)> finish) {
+	Context& ctx = context();
+	Async::State& state = *handle.state;
+	state.finish = std::move(finish);
+	state.timeline = ctx.async_timeline;
+	state.value = ++ctx.async_timeline_value;
+
+	// make shader writes visible to the host
+	DeviceMemoryBarrier host_barrier(
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+		VK_ACCESS_2_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_HOST_BIT,
+		VK_ACCESS_2_HOST_READ_BIT
+	);
+	state.command_buffer.add_barrier(host_barrier);
+	state.command_buffer.signal_semaphore(*ctx.async_timeline, state.value);
+	state.command_buffer.submit();
+	state.submitted = true;
+
+	for (const NGrid* grid : state.readers) {
+		grid->async_read_value = state.value;
+		grid->async_read_timeline = ctx.async_timeline;
+	}
+	state.readers.clear();
+}
+
+// set the fence timeout in nanoseconds
+// (default is 1 second = 1e9 nanoseconds)
+void NGrid::set_fence_timeout_nanosec(uint64_t timeout) {
+	fence_timeout_nanosec = timeout;
+}
+
+// returns the index of the compute queue that the calling thread submits to
+// (threads are assigned round-robin to the queues of the compute queue family)
+uint32_t NGrid::get_thread_queue_index() {
+	return context().queue_index;
+}
+
+// selects the physical device (enumeration index, see NGrid::get_device_count()) that the calling thread
+// creates new grids on and executes operations on; every thread starts with the default device of the manager;
+// must not be called inside a batch scope
+void NGrid::set_current_device(uint32_t device_index) {
+	if (Context::current != nullptr && Context::current->batch_depth != 0) {
+		Log::error("invalid call of method NGrid::set_current_device(): the current device can't be changed inside a batch scope");
+	}
+	Context::current = &context(device_index);
+	LOG_DEBUG("NGrid current device of the calling thread set to ", device_index);
+}
+
+// returns the physical device index of the current device of the calling thread
+uint32_t NGrid::get_current_device() {
+	return context().device_index;
+}
+
+// returns the number of available physical devices
+uint32_t NGrid::get_device_count() {
+	init_manager();
+	return manager->get_device_count();
+}
+
+// returns the physical device properties of the current device of the calling thread
+const VkPhysicalDeviceProperties& NGrid::get_device_properties() {
+	return current_device().get_properties();
+}
+
+// returns the physical device index of the device that holds the buffers of this grid
+uint32_t NGrid::get_device_index() const {
+	return this->device_index;
+}
+
+// sets the memory residency policy for the data buffers of grids that are created afterwards;
+// existing grids keep their current buffers until they get resized
+void NGrid::set_default_residency(Residency residency) {
+	default_residency = residency;
+}
+
+// returns true if the data buffer resides in pure device-local memory,
+// i.e. host access goes through staging buffers
+bool NGrid::is_device_local() const {
+	return this->device_local;
+}
+
+// creates a grid whose data buffer has sparse residency: device memory is only bound to the pages that have been made
+// resident with make_resident() (e.g. for the touched tiles of a large, mostly empty grid); writes to the other pages are
+// discarded, reads from them return zero on devices with strict residency (see Device::reads_non_resident_as_zero());
+// the contents of newly resident pages are undefined until they get written;
+// falls back to a regular grid if the device doesn't support sparse residency buffers
+NGrid NGrid::sparse_resident(const std::vector<uint32_t>& shape) {
+	NGrid result;
+	if (!current_device().supports_sparse_residency()) {
+		Log::warning("in method NGrid::sparse_resident(): the device doesn't support sparse residency buffers; creating a regular grid instead");
+		result.create(shape);
+		return result;
+	}
+	result.create(shape, true);
+	return result;
+}
+
+bool NGrid::is_sparse_resident() const {
+	return data_buffer != nullptr && data_buffer->is_sparse();
+}
+
+// binds device memory to all pages that overlap the given range of elements
+uint32_t NGrid::make_resident(uint32_t first_element, uint32_t count) {
+	if (first_element >= this->elements) {
+		return 0;
+	}
+	count = std::min(count, this->elements - first_element);
+	return change_residency({ { VkDeviceSize(first_element) * sizeof(float_t), VkDeviceSize(count) * sizeof(float_t) } }, true, "make_resident");
+}
+
+// binds device memory to all pages that overlap the given tile (subgrid region)
+uint32_t NGrid::make_resident(const std::vector<uint32_t>& tile_offset, const std::vector<uint32_t>& tile_shape) {
+	return change_residency(tile_ranges(tile_offset, tile_shape, "make_resident"), true, "make_resident");
+}
+
+// releases the memory of all pages that lie completely within the given range of elements
+uint32_t NGrid::evict(uint32_t first_element, uint32_t count) {
+	if (first_element >= this->elements) {
+		return 0;
+	}
+	count = std::min(count, this->elements - first_element);
+	return change_residency({ { VkDeviceSize(first_element) * sizeof(float_t), VkDeviceSize(count) * sizeof(float_t) } }, false, "evict");
+}
+
+// releases the memory of all pages that lie completely within the rows of the given tile (subgrid region)
+uint32_t NGrid::evict(const std::vector<uint32_t>& tile_offset, const std::vector<uint32_t>& tile_shape) {
+	return change_residency(tile_ranges(tile_offset, tile_shape, "evict"), false, "evict");
+}
+
+// returns the number of pages with bound device memory (0 for grids without sparse residency)
+uint32_t NGrid::get_resident_pages() const {
+	return is_sparse_resident() ? data_buffer->get_resident_pages() : 0;
+}
+
+// returns the number of elements per page of the sparse data buffer (0 for grids without sparse residency)
+uint32_t NGrid::get_page_elements() const {
+	return is_sparse_resident() ? static_cast<uint32_t>(data_buffer->get_page_size() / sizeof(float_t)) : 0;
+}
+
+// +=================================+   
+// | Host Backend                    |
+// +=================================+
+
+// sets the max. number of elements for which the operations of a class run on the host (SIMD kernels of hostkernels.h)
+// instead of the GPU, skipping the fixed costs of pipeline binding, submission and fence wait; 0 disables the host path
+// (toolbox_bench --tune-host measures the crossover sizes of a system)
+void NGrid::set_host_threshold(HostOp op, uint32_t max_elements) {
+	if (op >= HOST_OP_COUNT) {
+		Log::warning("NGrid::set_host_threshold() called with invalid operation class ", uint32_t(op));
+		return;
+	}
+	host_thresholds[op] = max_elements;
+}
+
+uint32_t NGrid::get_host_threshold(HostOp op) {
+	return op < HOST_OP_COUNT ? host_thresholds[op].load() : 0;
+}
+
+// sets the number of threads that share the host work of large grids (recreates the shared ThreadPool)
+void NGrid::set_host_threads(uint32_t threads) {
+	ThreadPool::set_shared_threads(threads);
+}
+
+// returns true if an operation of the given class on this grid runs on the host: all grids have to be small enough,
+// host-visible (device-local grids stay where their data is) and on the current device, and no batch may be recording
+// (the recorded work hasn't run yet); results are written to the host-visible memory directly, so that the next
+// operation can use them on either side without a transfer
+bool NGrid::on_host(HostOp op, const NGrid& out, const NGrid* other) const {
+	if (this->elements == 0 || this->elements > host_thresholds[op] || this->data_buffer == nullptr || this->device_local || out.device_local) {
+		return false;
+	}
+	if (other != nullptr && (other->shape != this->shape || other->device_local || other->device_index != this->device_index)) {
+		return false;
+	}
+	const Context& ctx = context();
+	return ctx.batch_depth == 0 && this->device_index == ctx.device_index && out.device_index == ctx.device_index;
+}
+
+// host pointer to the grid data for reading (non-coherent memory is invalidated first)
+const float_t* NGrid::host_read() const {
+	if (!data_buffer->host_coherent()) {
+		data_buffer->invalidate();
+	}
+	return data_buffer->data();
+}
+
+// host pointer to the grid data for writing (waits for asynchronous reads of the old data)
+float_t* NGrid::host_write() {
+	wait_async_reads();
+	return data_buffer->data();
+}
+
+// makes host writes visible to the device (flushes non-coherent memory)
+void NGrid::host_written() {
+	if (!data_buffer->host_coherent()) {
+		data_buffer->flush();
+	}
+}
+
+// validates the result grid of an '_into' method: it must be preallocated with the shape of this grid;
+// aliasing this grid (or a full-size operand) is allowed, because every invocation only reads
+// the elements at its own index before writing the result
+void NGrid::check_output(const NGrid& out, const char* method) const {
+	if (out.get_shape() != this->shape) {
+		Log::error("invalid call of method NGrid::", method, "(): the result grid has shape ", out.get_shapestring(),
+			" instead of ", this->get_shapestring());
+	}
+}
+
+// selects the variant of the tiled matrix product kernel for a result of the given size:
+// 4x4 register blocks per invocation (64x64 tiles) for large results, one element per invocation otherwise,
+// a single column of invocations for matrix-vector products; 'aligned' allows vec4 loads (16-byte aligned rows of A and B)
+NGrid::GemmVariant NGrid::gemm_variant(uint32_t rows, uint32_t cols, bool aligned) {
+	GemmVariant variant;
+	uint32_t max_invocations = current_device().get_properties().limits.maxComputeWorkGroupInvocations;
+	variant.wg_y = std::min(16u, max_invocations / variant.wg_x);
+	if (rows >= 64 && cols >= 64) {
+		variant.thread_m = 4;
+		variant.thread_n = 4;
+	}
+	else if (cols < 4) {
+		variant.wg_x = 1;
+		variant.wg_y = std::min(64u, max_invocations);
+	}
+	uint32_t tile_m = variant.wg_y * variant.thread_m;
+	uint32_t tile_n = variant.wg_x * variant.thread_n;
+	variant.vec4_loads = (aligned && tile_n % 4 == 0) ? 1 : 0;
+	variant.groups_x = (cols + tile_n - 1) / tile_n;
+	variant.groups_y = (rows + tile_m - 1) / tile_m;
+	return variant;
+}
+
+// returns a temporary host-visible buffer for intermediate results (e.g. of reductions);
+// the memory comes from the bump allocator of the memory arena, so the buffer should be short-lived
+Buffer<float_t> NGrid::scratch_buffer(uint32_t elements) {
+	return Buffer<float_t>(current_device(), BufferUsage::STORAGE_BUFFER, elements,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+}
+
+// returns the staging helper of the calling thread for the given device (created on first use)
+StagingTransfer& NGrid::get_staging(uint32_t device_index) {
+	Context& ctx = context(device_index);
+	if (ctx.staging == nullptr) {
+		ctx.transfer_pool = std::make_unique<CommandPool>(*ctx.device, QueueFamily::TRANSFER_QUEUE);
+		ctx.staging = std::make_unique<StagingTransfer>(*ctx.device, *ctx.transfer_pool, fence_timeout_nanosec);
+	}
+	return *ctx.staging;
+}
+
+// copies host data into the data buffer, either directly (host-visible memory)
+// or via a staging buffer on the transfer queue (device-local memory)
+void NGrid::upload(const float_t* source, uint32_t copied_elements, uint32_t target_offset_elements) {
+	wait_async_reads();
+	if (!this->device_local) {
+		data_buffer->write(source, copied_elements, 0, target_offset_elements);
+		return;
+	}
+	if (target_offset_elements + copied_elements > this->elements) {
+		Log::warning("in method NGrid::set(): attempting to write past the end of the grid; clipping copy region size to fit");
+		copied_elements = this->elements > target_offset_elements ? this->elements - target_offset_elements : 0;
+	}
+	get_staging(this->device_index).upload(*data_buffer, source, copied_elements, target_offset_elements);
+}
+
+// copies elements of the data buffer to host memory, either directly (host-visible memory)
+// or via a staging buffer on the transfer queue (device-local memory)
+void NGrid::download(float_t* target, uint32_t copied_elements, uint32_t source_offset_elements) const {
+	if (!this->device_local) {
+		std::vector<float_t> values = data_buffer->read(copied_elements, source_offset_elements);
+		std::copy(values.begin(), values.end(), target);
+		return;
+	}
+	get_staging(this->device_index).download(*data_buffer, target, copied_elements, source_offset_elements);
+}
+
+// returns a 'flat' equivalent to a multidimensional index
+uint32_t NGrid::flat_index(std::initializer_list<uint32_t> multi_index_list) const {
+	std::vector<uint32_t> multi_index_vec(multi_index_list);
+	return this->flat_index(multi_index_vec);
+}
+
+// returns a 'flat' equivalent to a multidimensional index
+uint32_t NGrid::flat_index(const std::vector<uint32_t>& multi_index) const {
+	// Check if the number of indices provided matches the array's dimensions
+	if (multi_index.size() != this->dimensions) {
+		Log::warning("Number of indices (", multi_index.size(), ") does not match array dimensions (",
+			this->dimensions, "). Returning 0 (potential trunctation).");
+		return UINT32_MAX;
+	}
+
+	size_t flat_index_calc = 0;
+	for (size_t i = 0; i < this->dimensions; ++i) {
+		// row-major calculation
+		flat_index_calc = flat_index_calc * static_cast<size_t>(this->shape[i]) + static_cast<size_t>(multi_index[i]);
+	}
+
+	// Check if the final result fits within the desired return type uint32_t
+	if (flat_index_calc > std::numeric_limits<uint32_t>::max()) {
+		Log::warning("Calculated flat index (", flat_index_calc, ") exceeds maximum value for uint32_t. Returning 0 (potential truncation).");
+		return UINT32_MAX;
+	}
+	return static_cast<uint32_t>(flat_index_calc);
+}
+
+// compile-time check: grids and lazy expressions can be combined with the grid on either side
+// (the variadic shape constructor must not make the grid operators viable for expressions)
+static_assert(requires(const NGrid& grid, const NGrid::Expr& expr) {
+	{ grid + expr } -> std::same_as<NGrid::Expr>;
+	{ grid * expr } -> std::same_as<NGrid::Expr>;
+	{ expr - grid } -> std::same_as<NGrid::Expr>;
+});
+
 #endif
\ No newline at end of file
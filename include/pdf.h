@@ -13,6 +13,11 @@ the probability of a random variable taking on a particular value. */
 #define PROBABILITY_DENSITY_FUNCTIONS_H
 
 #include <cmath>
+#include <hostkernels.h>        // SIMD kernels and thread pool for the batch evaluation over spans
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 
 
 template<typename T>
@@ -29,10 +34,22 @@ public:
     static T lomax(T x_val, T alpha = 1, T tail_index = 1);
     static T F_distribution(T x_val, T d1, T d2);
     static T poisson(T k, T lambda);
+    // batch evaluation: out[i] = f(x[i]) ('out' needs at least x.size() elements);
+    // gaussian, cauchy and laplace are vectorized for <float>, large spans are split over the thread pool
+    static void gaussian(std::span<const T> x, std::span<T> out, T mu = 0, T sigma = 1);
+    static void cauchy(std::span<const T> x, std::span<T> out, T x_peak, T gamma);
+    static void laplace(std::span<const T> x, std::span<T> out, T mu = 0, T sigma = 1);
+    static void pareto(std::span<const T> x, std::span<T> out, T alpha = 1, T tail_index = 1);
+    static void lomax(std::span<const T> x, std::span<T> out, T alpha = 1, T tail_index = 1);
+    static void F_distribution(std::span<const T> x, std::span<T> out, T d1, T d2);
+    static void poisson(std::span<const T> k, std::span<T> out, T lambda);
     // constructor
     PdfObject() {};
     // destructor
     ~PdfObject() {};
+private:
+    template<typename Op>
+    static void transform(std::span<const T> x, std::span<T> out, Op op);
 };
 
 // ------------------------------------------------------------------
@@ -63,8 +80,7 @@ T PdfObject<T>::cauchy(T x_val, T x_peak, T gamma) {
 // scale factor default: sigma/sqrt(2)=0.707106781
 template<typename T>
 T PdfObject<T>::laplace(T x_val, T mu, T sigma) {
-    static double scale_factor = 0.707106781;
-    scale_factor = sigma / sqrt(2);
+    T scale_factor = sigma / sqrt(2);
     return exp(-fabs(x_val - mu) / scale_factor) / (2 * scale_factor);
 }
 
@@ -89,19 +105,100 @@ T PdfObject<T>::lomax(T x_val, T alpha, T tail_index) {
     return (alpha / tail_index) * pow(1 + std::fmax(x_val, 0) / tail_index, -(alpha + 1));
 }
 
+// F probability density function (d1, d2 = degrees of freedom);
+// sqrt((d1*x)^d1 * d2^d2 / (d1*x + d2)^(d1+d2)) / (x * B(d1/2, d2/2)), evaluated in log space
 template<typename T>
 T PdfObject<T>::F_distribution(T x_val, T d1, T d2) {
     if (x_val < 0) {
         return 0;
     }
-    T numerator = pow(d1 * x_val, d1 / 2) * pow(d2, d2 / 2);
-    T denominator = pow((d1 * x_val + d2), (d1 + d2) / 2) * gamma(d1 / 2) * gamma(d2 / 2);
-    return numerator / denominator;
+    if (x_val == 0) {
+        return d1 < 2 ? std::numeric_limits<T>::infinity() : (d1 == 2 ? 1 : 0);
+    }
+    T log_beta = std::lgamma(d1 / 2) + std::lgamma(d2 / 2) - std::lgamma((d1 + d2) / 2);
+    return exp(0.5 * (d1 * log(d1 * x_val) + d2 * log(d2) - (d1 + d2) * log(d1 * x_val + d2)) - log(x_val) - log_beta);
 }
 
+// Poisson probability mass function (lambda = mean);
+// lambda^k * exp(-lambda) / k!, evaluated in log space (like distribution.comp), so that large k don't overflow
 template<typename T>
 T PdfObject<T>::poisson(T k, T lambda) {
-    return pow(lambda, k) * exp(-lambda) / tgamma(k + 1);
+    if (k < 0) {
+        return 0;
+    }
+    if (k == 0) {
+        return exp(-lambda);
+    }
+    return exp(k * log(lambda) - lambda - std::lgamma(k + 1));
+}
+
+// helper for the batch evaluation: out[i] = op(x[i])
+template<typename T>
+template<typename Op>
+void PdfObject<T>::transform(std::span<const T> x, std::span<T> out, Op op) {
+    if (out.size() < x.size()) {
+        throw std::invalid_argument("pdf: the output span has fewer elements than the input span");
+    }
+    hostkernels::transform_scalar(x.data(), out.data(), x.size(), op);
+}
+
+template<typename T>
+void PdfObject<T>::gaussian(std::span<const T> x, std::span<T> out, T mu, T sigma) {
+    if constexpr (std::is_same<T, float>::value) {
+        if (out.size() < x.size()) {
+            throw std::invalid_argument("pdf: the output span has fewer elements than the input span");
+        }
+        hostkernels::gaussian_pdf(x.data(), mu, sigma, out.data(), x.size());
+    }
+    else {
+        transform(x, out, [mu, sigma](T x_val) { return gaussian(x_val, mu, sigma); });
+    }
+}
+
+template<typename T>
+void PdfObject<T>::cauchy(std::span<const T> x, std::span<T> out, T x_peak, T gamma) {
+    if constexpr (std::is_same<T, float>::value) {
+        if (out.size() < x.size()) {
+            throw std::invalid_argument("pdf: the output span has fewer elements than the input span");
+        }
+        hostkernels::cauchy_pdf(x.data(), x_peak, gamma, out.data(), x.size());
+    }
+    else {
+        transform(x, out, [x_peak, gamma](T x_val) { return cauchy(x_val, x_peak, gamma); });
+    }
+}
+
+template<typename T>
+void PdfObject<T>::laplace(std::span<const T> x, std::span<T> out, T mu, T sigma) {
+    if constexpr (std::is_same<T, float>::value) {
+        if (out.size() < x.size()) {
+            throw std::invalid_argument("pdf: the output span has fewer elements than the input span");
+        }
+        hostkernels::laplace_pdf(x.data(), mu, sigma, out.data(), x.size());
+    }
+    else {
+        transform(x, out, [mu, sigma](T x_val) { return laplace(x_val, mu, sigma); });
+    }
+}
+
+template<typename T>
+void PdfObject<T>::pareto(std::span<const T> x, std::span<T> out, T alpha, T tail_index) {
+    transform(x, out, [alpha, tail_index](T x_val) { return pareto(x_val, alpha, tail_index); });
+}
+
+template<typename T>
+void PdfObject<T>::lomax(std::span<const T> x, std::span<T> out, T alpha, T tail_index) {
+    transform(x, out, [alpha, tail_index](T x_val) { return lomax(x_val, alpha, tail_index); });
+}
+
+template<typename T>
+void PdfObject<T>::F_distribution(std::span<const T> x, std::span<T> out, T d1, T d2) {
+    transform(x, out, [d1, d2](T x_val) { return F_distribution(x_val, d1, d2); });
+}
+
+template<typename T>
+void PdfObject<T>::poisson(std::span<const T> k, std::span<T> out, T lambda) {
+    transform(k, out, [lambda](T k_val) { return poisson(k_val, lambda); });
 }
 
 
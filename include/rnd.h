@@ -7,9 +7,15 @@
 #ifndef RANDOM_DISTRIBUTIONS_H
 #define RANDOM_DISTRIBUTIONS_H
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <span>
+#include <thread>
 
 
 namespace rnd {
@@ -26,75 +32,145 @@ namespace rnd {
     template<typename T = float> static T sign();
     template<typename T = float> static uint32_t seed32();
 
+    // counter-based Philox4x32-10 generator (same algorithm, counters and conversions as the GPU fills, see philox.inc)
+    static std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key);
+    static float philox_uniform(uint32_t word);
+    static float philox_gaussian(uint32_t word0, uint32_t word1);
+    class Philox;
+
+    // batch API: element i is drawn from the counter (first_index + i, 0, offset) of the stream (seed, offset),
+    // i.e. it equals element first_index + i of the corresponding NGrid fill with the same seed and offset;
+    // threads can fill disjoint index ranges (or use different offsets) without any shared state
+    static void uniform(std::span<float> target, float min, float max, uint64_t seed, uint64_t offset = 0, uint32_t first_index = 0);
+    static void gaussian(std::span<float> target, float mu, float sigma, uint64_t seed, uint64_t offset = 0, uint32_t first_index = 0);
+
 
     //+------------------------------------------------------------------+
     //|                          DEFINITIONS                             |
     //+------------------------------------------------------------------+
 
+    constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+    constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+    constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+    constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+
+    // 10 rounds of Philox4x32
+    std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+        for (int round = 0; round < 10; round++) {
+            uint64_t product0 = uint64_t(PHILOX_M0) * counter[0];
+            uint64_t product1 = uint64_t(PHILOX_M1) * counter[2];
+            counter = {
+                uint32_t(product1 >> 32) ^ counter[1] ^ key[0], uint32_t(product1),
+                uint32_t(product0 >> 32) ^ counter[3] ^ key[1], uint32_t(product0) };
+            key[0] += PHILOX_W0;
+            key[1] += PHILOX_W1;
+        }
+        return counter;
+    }
+
+    // uniform value in (0, 1] (24 bit resolution)
+    float philox_uniform(uint32_t word) {
+        return (float(word >> 8) + 1.0f) * (1.0f / 16777216.0f);
+    }
+
+    // standard normal value (Box-Muller transform of two words)
+    float philox_gaussian(uint32_t word0, uint32_t word1) {
+        return std::sqrt(-2.0f * std::log(philox_uniform(word0))) * std::cos(6.283185307179586f * philox_uniform(word1));
+    }
 
-    // get random value from a gaussian normal distribution with a given  and sigma
+    // sequential stream of random words of the counter-based generator;
+    // used by the scalar functions via one instance per thread (seeded from the clock and the thread id)
+    class Philox {
+    public:
+        Philox(uint64_t seed, uint64_t offset = 0) :
+            key{ uint32_t(seed), uint32_t(seed >> 32) }, offset(offset) {}
+
+        // returns the next random word
+        uint32_t next() {
+            if (used == 4) {
+                block = philox4x32({ uint32_t(index), uint32_t(index >> 32), uint32_t(offset), uint32_t(offset >> 32) }, key);
+                index++;
+                used = 0;
+            }
+            return block[used++];
+        }
+
+        // returns a uniform value in (0, 1) with 53 bit resolution
+        double uniform() {
+            uint64_t bits = (uint64_t(next()) << 21) ^ (next() >> 11);
+            return (double(bits) + 0.5) * (1.0 / 9007199254740992.0);
+        }
+
+        // generator of the calling thread
+        static Philox& thread_instance() {
+            thread_local Philox instance(uint64_t(seed32()) ^ (uint64_t(std::hash<std::thread::id>{}(std::this_thread::get_id())) << 16));
+            return instance;
+        }
+
+    private:
+        std::array<uint32_t, 2> key;
+        uint64_t offset = 0;
+        uint64_t index = 0;
+        std::array<uint32_t, 4> block = {};
+        uint32_t used = 4;
+    };
+
+    // get random value from a gaussian normal distribution with a given  and sigma (Box-Muller transform)
     template<typename T>
     T gaussian(T mu, T sigma) {
-        static double M_PI = 3.141592653589793;
-        double random = (double)rand() / RAND_MAX;                      // get random value within range 0-1
-        random /= sqrt(2 * M_PI * pow(sigma, 2));                       // reduce to the top of the distribution (f(x_val=mu))
-        char sign = rand() > (0.5 * RAND_MAX) ? 1 : -1;                 // get random algebraic sign
-        return T((mu + sigma * sqrt(-2 * log(random / (1 / sqrt(2 * M_PI * pow(sigma, 2)))))) * sign);
+        Philox& generator = Philox::thread_instance();
+        double u1 = generator.uniform();
+        double u2 = generator.uniform();
+        return T(mu + sigma * std::sqrt(-2 * std::log(u1)) * std::cos(2 * PI * u2));
     }
 
-    // get random value from a Cauchy distribution with a given x_peak and gamma
+    // get random value from a Cauchy distribution with a given x_peak and gamma (inverse transform sampling)
     template<typename T>
     T cauchy(T x_peak, T gamma) {
-        double random = (double)rand() / RAND_MAX;                      // random value within range 0-1
-        random /= PI * gamma;                                         // reduce to the top of the distribution (=f(x_val=x_peak))
-        char sign = rand() > (0.5 * RAND_MAX) ? 1 : -1;                 // get random algebraic sign   
-        return T((sqrt(gamma / (random * PI) - pow(gamma, 2)) + x_peak) * sign);
+        double random = Philox::thread_instance().uniform();            // random value within range 0-1
+        return T(x_peak + gamma * std::tan(PI * (random - 0.5)));
     }
 
     // get random value from a uniform distribution
     template<typename T>
     T uniform(T min, T max) {
-        double random = (double)rand() / RAND_MAX;                      // random value within range +/- 1
+        double random = Philox::thread_instance().uniform();            // random value within range 0-1
         random *= (max - min);                                          // expand range
         return T(random + min);                                         // shift by lower margin
     }
 
-    // get random value from a Laplace distribution
+    // get random value from a Laplace distribution (inverse transform sampling)
     template<typename T>
     T laplace(T mu, T sigma) {
         double scale_factor = sigma / sqrt(2);
-        double random = (double)rand() / RAND_MAX;                      // random value within range 0-1
-        random /= 2 * scale_factor;                                     // reduce to top of distribution (f(x_val=mu)
-        char sign = rand() > (0.5 * RAND_MAX) ? 1 : -1;                 // get random algebraic sign
-        return T(mu + scale_factor * log(random * 2 * scale_factor) * sign);
+        double random = Philox::thread_instance().uniform() - 0.5;      // random value within range +/- 0.5
+        return T(mu - scale_factor * (random < 0 ? -1 : 1) * std::log(1 - 2 * std::abs(random)));
     }
 
-    // get random value from a Pareto distribution
+    // get random value from a Pareto distribution (shape alpha, scale tail_index; inverse transform sampling)
     template<typename T>
     T pareto(T alpha, T tail_index) {
-        double random = (double)rand() / RAND_MAX;                      // random value within range 0-1
-        random *= (alpha * pow(tail_index, alpha)) / pow(tail_index, alpha + 1); // top of distribution is given for x_val=tail_index
-        return T(pow((alpha * pow(tail_index, alpha)) / random, 1 / (alpha + 1)));
+        double random = Philox::thread_instance().uniform();            // random value within range 0-1
+        return T(tail_index * std::pow(random, -1.0 / alpha));
     }
 
-    // get random value from a Lomax distribution
+    // get random value from a Lomax distribution (shape alpha, scale tail_index; inverse transform sampling)
     template<typename T>
     T lomax(T alpha, T tail_index) {
-        double random = (double)rand() / RAND_MAX;                      // random value within range 0-1
-        random *= (alpha / tail_index) * pow(1 / tail_index, -(alpha + 1));
-        return T(tail_index * (pow((random * tail_index) / alpha, -1 / (alpha + 1)) - 1));
+        double random = Philox::thread_instance().uniform();            // random value within range 0-1
+        return T(tail_index * (std::pow(random, -1.0 / alpha) - 1));
     }
 
     // random binary
     template<typename T>
     T binary() {
-        return T((int)rand() % 2);
+        return T(Philox::thread_instance().next() & 1);
     }
 
     // random sign
     template<typename T>
     T sign() {
-        return T(rand() > (0.5 * RAND_MAX) ? 1 : -1);                   // get random algebraic sign
+        return T(Philox::thread_instance().next() & 1 ? 1 : -1);        // get random algebraic sign
     }
 
     // Function to extract a 32-bit seed from std::chrono::time_point
@@ -104,5 +180,54 @@ namespace rnd {
         std::chrono::milliseconds ms_since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
         return static_cast<uint32_t>(ms_since_epoch.count());
     }
+
+    // Philox4x32 for a block of consecutive counters, written lane by lane so that compilers vectorize the rounds (SIMD);
+    // calls transform(words) for every element of the block
+    template<typename F>
+    static void philox_fill(std::span<float> target, uint64_t seed, uint64_t offset, uint32_t first_index, F transform) {
+        constexpr uint32_t LANES = 8;
+        for (size_t start = 0; start < target.size(); start += LANES) {
+            uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+            for (uint32_t l = 0; l < LANES; l++) {
+                c0[l] = first_index + uint32_t(start) + l;
+                c1[l] = 0;
+                c2[l] = uint32_t(offset);
+                c3[l] = uint32_t(offset >> 32);
+            }
+            uint32_t k0 = uint32_t(seed);
+            uint32_t k1 = uint32_t(seed >> 32);
+            for (int round = 0; round < 10; round++) {
+                for (uint32_t l = 0; l < LANES; l++) {
+                    uint64_t product0 = uint64_t(PHILOX_M0) * c0[l];
+                    uint64_t product1 = uint64_t(PHILOX_M1) * c2[l];
+                    c0[l] = uint32_t(product1 >> 32) ^ c1[l] ^ k0;
+                    c1[l] = uint32_t(product1);
+                    c2[l] = uint32_t(product0 >> 32) ^ c3[l] ^ k1;
+                    c3[l] = uint32_t(product0);
+                }
+                k0 += PHILOX_W0;
+                k1 += PHILOX_W1;
+            }
+            size_t count = std::min<size_t>(LANES, target.size() - start);
+            for (size_t l = 0; l < count; l++) {
+                target[start + l] = transform(c0[l], c1[l]);
+            }
+        }
+    }
+
+    // fills the target with values from a uniform distribution in (min, max]
+    void uniform(std::span<float> target, float min, float max, uint64_t seed, uint64_t offset, uint32_t first_index) {
+        philox_fill(target, seed, offset, first_index, [min, max](uint32_t word0, uint32_t) {
+            return philox_uniform(word0) * (max - min) + min;
+        });
+    }
+
+    // fills the target with values from a gaussian normal distribution
+    void gaussian(std::span<float> target, float mu, float sigma, uint64_t seed, uint64_t offset, uint32_t first_index) {
+        philox_fill(target, seed, offset, first_index, [mu, sigma](uint32_t word0, uint32_t word1) {
+            return mu + sigma * philox_gaussian(word0, word1);
+        });
+    }
 }
-#endif
\ No newline at end of file
+
+#endif
@@ -0,0 +1,204 @@
+// author: cyberchriz(Christian Suer)
+// description: work-stealing thread pool for data-parallel loops on the host
+
+
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// thread pool for parallel_for loops: every thread owns a job queue; the chunks of a loop are distributed
+// round-robin over the queues, a thread takes its own jobs (LIFO) and steals from the other queues (FIFO)
+// when its own queue is empty; the calling thread works on the chunks too (nested loops are possible)
+// usage:   ThreadPool::shared().parallel_for(n, 4096, [&](size_t begin, size_t end) { ... });
+class ThreadPool {
+public:
+    explicit ThreadPool(uint32_t threads = 0);  // 0 = one thread per hardware thread (including the calling thread)
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // calls body(begin, end) for consecutive chunks of 'grain' indices of [0, count) and blocks until all chunks are done;
+    // the first exception of a chunk is rethrown
+    void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+    uint32_t get_threads() const { return static_cast<uint32_t>(queues.size()); }
+
+    // pool that is shared by the library (created on first use)
+    static ThreadPool& shared();
+    static void set_shared_threads(uint32_t threads); // recreates the shared pool; must not be called while the pool is in use
+
+private:
+    struct Group {                              // the chunks of one parallel_for call
+        std::atomic<size_t> pending = 0;
+        std::exception_ptr error;
+        std::mutex error_mutex;
+    };
+    struct Job {
+        const std::function<void(size_t, size_t)>* body = nullptr;
+        size_t begin = 0, end = 0;
+        Group* group = nullptr;
+    };
+    struct Queue {
+        std::mutex mtx;
+        std::deque<Job> jobs;
+    };
+
+    bool try_pop(size_t index, Job& job);
+    static void run(const Job& job);
+    void loop(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues; // queue 0 belongs to the calling threads, queue i to worker i
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued = 0;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    static std::unique_ptr<ThreadPool> shared_instance;
+    static std::mutex shared_mutex;
+    static uint32_t shared_threads;
+};
+
+ThreadPool::ThreadPool(uint32_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (uint32_t i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (uint32_t i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    grain = std::max<size_t>(1, grain);
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || workers.empty()) {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    Group group;
+    group.pending = chunks;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        queued += chunks; // (counted before pushing, so that try_pop() can't decrement below zero)
+    }
+    for (size_t c = 0; c < chunks; c++) {
+        Queue& queue = *queues[c % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        queue.jobs.push_back({ &body, c * grain, std::min(count, (c + 1) * grain), &group });
+    }
+    cv.notify_all();
+
+    // work on the chunks (of this or any other loop) until all chunks of this loop are done
+    Job job;
+    while (group.pending.load() > 0) {
+        if (try_pop(0, job)) {
+            run(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
+
+// takes a job from the own queue (newest first) or steals one from another queue (oldest first)
+bool ThreadPool::try_pop(size_t index, Job& job) {
+    for (size_t i = 0; i < queues.size(); i++) {
+        Queue& queue = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        else {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(const Job& job) {
+    try {
+        (*job.body)(job.begin, job.end);
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(job.group->error_mutex);
+        if (!job.group->error) {
+            job.group->error = std::current_exception();
+        }
+    }
+    job.group->pending--; // (the group may be gone after this)
+}
+
+void ThreadPool::loop(size_t index) {
+    Job job;
+    while (true) {
+        if (try_pop(index, job)) {
+            run(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (shared_instance == nullptr) {
+        shared_instance = std::make_unique<ThreadPool>(shared_threads);
+    }
+    return *shared_instance;
+}
+
+void ThreadPool::set_shared_threads(uint32_t threads) {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    shared_threads = threads;
+    shared_instance.reset();
+}
+
+// static member definitions
+std::unique_ptr<ThreadPool> ThreadPool::shared_instance;
+std::mutex ThreadPool::shared_mutex;
+uint32_t ThreadPool::shared_threads = 0;
+
+#endif
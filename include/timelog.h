@@ -5,9 +5,16 @@
 #ifndef TIMELOG_H
 #define TIMELOG_H
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <fstream>
 #include <log.h>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 
 // macro shortcuts
@@ -17,6 +24,134 @@
 #define TIMER_RESTART timer.restart();              // restart timer
 
 
+// profiling macros: PROFILE_SCOPE(name) records the lifetime of the enclosing scope as a host event of the Profiler;
+// the macro (and the per-dispatch GPU timestamps of vkcontext.h / ngrid.h) are only compiled if the flag PROFILING is defined
+#ifdef PROFILING
+#define PROFILE_SCOPE(name) ProfileScope profile_scope(name);
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+
+// aggregates timings of named operations (e.g. GPU dispatches, pipeline creation, submission, readback, host scopes)
+// into per-op counters and keeps a bounded list of events that can be written as a Chrome trace (chrome://tracing, Perfetto)
+class Profiler {
+public:
+    // aggregate counters of one operation (= category + name + shape)
+    struct Stats {
+        std::string category;
+        std::string name;
+        std::string shape;
+        uint64_t count = 0;
+        double total_ns = 0;
+        double mean_ns = 0;
+        double min_ns = 0;
+        double max_ns = 0;
+        double p99_ns = 0;
+        uint64_t bytes = 0;    // total bytes touched by all samples
+        double gbps = 0;       // achieved bandwidth (bytes / total time)
+    };
+
+    // records a sample; timestamps are in nanoseconds (host events: since the first call of now_ns())
+    static void record(const std::string& category, const std::string& name, const std::string& shape, double start_ns, double duration_ns, uint64_t bytes = 0, uint32_t track = 0);
+
+    // returns the aggregate counters, sorted by total time (descending)
+    static std::vector<Stats> get_stats();
+
+    // writes the aggregate counters as CSV (one line per operation)
+    static void write_csv(const std::string& filepath);
+
+    // writes the recorded events in the Chrome trace event format (JSON);
+    // host events use pid 0 (tid = track), GPU events pid 1 (timestamps of the GPU clock)
+    static void write_trace(const std::string& filepath);
+
+    // clears all counters and events
+    static void reset();
+
+    // enables or disables recording at runtime (default: enabled);
+    // the flag and the sample interval are read by every compute thread, so they are relaxed atomics
+    static void set_enabled(bool active = true) { enabled.store(active, std::memory_order_relaxed); }
+    static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // only every n-th dispatch of a thread is measured (default: 1 = all)
+    static void set_sample_interval(uint32_t interval) { sample_interval.store(interval == 0 ? 1 : interval, std::memory_order_relaxed); }
+    static uint32_t get_sample_interval() { return sample_interval.load(std::memory_order_relaxed); }
+
+    // max number of events kept for write_trace() (older events are dropped; default: 100000);
+    // changing the capacity clears the recorded events
+    static void set_trace_capacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mtx);
+        trace_capacity = capacity;
+        events.clear();
+        next_event = 0;
+    }
+
+    // returns true if the next operation of the calling thread should be measured
+    static bool sample() {
+        if (!enabled.load(std::memory_order_relaxed)) { return false; }
+        thread_local uint32_t counter = 0;
+        return counter++ % sample_interval.load(std::memory_order_relaxed) == 0;
+    }
+
+    // returns the method name of a function signature (e.g. "sum" for "NGrid NGrid::sum() const")
+    static std::string function_name(const char* signature) {
+        std::string text(signature);
+        size_t end = text.find('(');
+        if (end == std::string::npos) { end = text.size(); }
+        size_t begin = text.find_last_of(": ", end == 0 ? 0 : end - 1);
+        begin = begin == std::string::npos || begin >= end ? 0 : begin + 1;
+        return text.substr(begin, end - begin);
+    }
+
+    // host clock in nanoseconds since the first call
+    static double now_ns() {
+        static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+private:
+    struct Entry {
+        Stats stats;
+        std::vector<float> durations; // most recent durations for the percentile (ring of max_durations)
+    };
+
+    struct Event {
+        std::string category;
+        std::string name;
+        std::string shape;
+        double start_ns;
+        double duration_ns;
+        uint64_t bytes;
+        uint32_t track;
+    };
+
+    static std::string escape(const std::string& text);
+
+    static constexpr size_t max_durations = 4096;
+    static std::map<std::string, Entry> entries;
+    static std::vector<Event> events;
+    static size_t next_event;
+    static size_t trace_capacity;
+    static std::atomic<bool> enabled;
+    static std::atomic<uint32_t> sample_interval;
+    static std::mutex mtx;
+};
+
+// records the lifetime of a scope as a host event (see PROFILE_SCOPE)
+class ProfileScope {
+public:
+    ProfileScope(const std::string& name) : name(name) {
+        begin = Profiler::now_ns();
+    }
+    ~ProfileScope() {
+        Profiler::record("host", name, "", begin, Profiler::now_ns() - begin);
+    }
+private:
+    std::string name;
+    double begin = 0;
+};
+
+
 class Timer {
 public:
     double elapsed_sec() {
@@ -37,6 +172,9 @@ public:
 
     void stop() {
         double elapsed = elapsed_sec();
+#ifdef PROFILING
+        Profiler::record("host", caller_function == "" ? "timer" : caller_function, "", Profiler::now_ns() - elapsed * 1e9, elapsed * 1e9);
+#endif
         if (elapsed > 60) {
             Log::force("timer in scope ", caller_function == "" ? "<unknown>" : caller_function,
                 " stopped after ", elapsed / 60.0, " minutes");
@@ -87,4 +225,138 @@ private:
     std::string caller_function = "";
 };
 
+// +-----------------------------------+
+// |  Definitions of member functions  |
+// +-----------------------------------+
+
+void Profiler::record(const std::string& category, const std::string& name, const std::string& shape, double start_ns, double duration_ns, uint64_t bytes, uint32_t track) {
+    if (!enabled.load(std::memory_order_relaxed)) { return; }
+    std::lock_guard<std::mutex> lock(mtx);
+    Entry& entry = entries[category + '\n' + name + '\n' + shape];
+    Stats& stats = entry.stats;
+    if (stats.count == 0) {
+        stats.category = category;
+        stats.name = name;
+        stats.shape = shape;
+        stats.min_ns = duration_ns;
+        stats.max_ns = duration_ns;
+    }
+    if (entry.durations.size() < max_durations) {
+        entry.durations.push_back(float(duration_ns));
+    }
+    else {
+        entry.durations[stats.count % max_durations] = float(duration_ns);
+    }
+    stats.count++;
+    stats.total_ns += duration_ns;
+    stats.min_ns = std::min(stats.min_ns, duration_ns);
+    stats.max_ns = std::max(stats.max_ns, duration_ns);
+    stats.bytes += bytes;
+
+    if (trace_capacity == 0) { return; }
+    Event event = { category, name, shape, start_ns, duration_ns, bytes, track };
+    if (events.size() < trace_capacity) {
+        events.push_back(std::move(event));
+    }
+    else {
+        events[next_event % trace_capacity] = std::move(event);
+    }
+    next_event++;
+}
+
+std::vector<Profiler::Stats> Profiler::get_stats() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<Stats> result;
+    result.reserve(entries.size());
+    for (const auto& [key, entry] : entries) {
+        Stats stats = entry.stats;
+        stats.mean_ns = stats.total_ns / double(stats.count);
+        stats.gbps = stats.total_ns > 0 ? double(stats.bytes) / stats.total_ns : 0; // bytes per ns = GB/s
+        std::vector<float> sorted = entry.durations;
+        size_t index = (sorted.size() * 99 + 99) / 100 - 1; // ceil(0.99 * n) - 1
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        stats.p99_ns = sorted[index];
+        result.push_back(stats);
+    }
+    std::sort(result.begin(), result.end(), [](const Stats& a, const Stats& b) { return a.total_ns > b.total_ns; });
+    return result;
+}
+
+void Profiler::write_csv(const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        Log::warning("in method Profiler::write_csv(): unable to open file '", filepath, "'");
+        return;
+    }
+    file << "category,name,shape,count,total_ms,mean_us,min_us,max_us,p99_us,bytes,gb_per_s\n";
+    for (const Stats& stats : get_stats()) {
+        file << stats.category << ",\"" << stats.name << "\",\"" << stats.shape << "\"," << stats.count << ","
+            << stats.total_ns * 1e-6 << "," << stats.mean_ns * 1e-3 << "," << stats.min_ns * 1e-3 << ","
+            << stats.max_ns * 1e-3 << "," << stats.p99_ns * 1e-3 << "," << stats.bytes << "," << stats.gbps << "\n";
+    }
+}
+
+void Profiler::write_trace(const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        Log::warning("in method Profiler::write_trace(): unable to open file '", filepath, "'");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    // GPU timestamps are shifted to start at the first host event
+    double host_origin = 0, gpu_origin = 0;
+    bool host_found = false, gpu_found = false;
+    for (const Event& event : events) {
+        bool gpu = event.category == "gpu";
+        double& origin = gpu ? gpu_origin : host_origin;
+        bool& found = gpu ? gpu_found : host_found;
+        if (!found || event.start_ns < origin) {
+            origin = event.start_ns;
+            found = true;
+        }
+    }
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"host\"}},\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+    file.precision(15);
+    size_t first = events.size() < trace_capacity ? 0 : next_event % trace_capacity; // oldest event
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& event = events[(first + i) % events.size()];
+        bool gpu = event.category == "gpu";
+        double ts = gpu ? event.start_ns - gpu_origin + host_origin : event.start_ns;
+        file << ",\n{\"name\":\"" << escape(event.name) << "\",\"cat\":\"" << escape(event.category) << "\",\"ph\":\"X\",\"pid\":" << (gpu ? 1 : 0)
+            << ",\"tid\":" << event.track << ",\"ts\":" << ts * 1e-3 << ",\"dur\":" << event.duration_ns * 1e-3
+            << ",\"args\":{\"shape\":\"" << escape(event.shape) << "\",\"bytes\":" << event.bytes << "}}";
+    }
+    file << "\n]}\n";
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    entries.clear();
+    events.clear();
+    next_event = 0;
+}
+
+std::string Profiler::escape(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
+
+// Initialization of static members (outside class)
+std::map<std::string, Profiler::Entry> Profiler::entries;
+std::vector<Profiler::Event> Profiler::events;
+size_t Profiler::next_event = 0;
+size_t Profiler::trace_capacity = 100000;
+std::atomic<bool> Profiler::enabled{ true };
+std::atomic<uint32_t> Profiler::sample_interval{ 1 };
+std::mutex Profiler::mtx;
+
 #endif
\ No newline at end of file
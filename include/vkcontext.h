@@ -6,18 +6,26 @@
 #define NULLOPT std::nullopt
 
 // include headers
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <initializer_list>
 #include <iostream>
 #include <log.h>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <renderdoc_enable.h>
+#include <source_location>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <timelog.h>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -99,6 +107,13 @@ enum QueueFamily {
 	UNKNOWN_QUEUE
 };
 
+enum MemoryAllocationMode {
+	ARENA_ALLOCATION,     // sub-allocation from the shared memory arena
+	SCRATCH_ALLOCATION,   // short-lived sub-allocation from the bump allocator of the shared memory arena
+	DEDICATED_ALLOCATION, // separate vkAllocateMemory call
+	SPARSE_RESIDENCY      // sparse buffer without memory; pages are bound on demand (see Buffer::bind_pages())
+};
+
 enum AttachmentType {
 	INPUT_TYPE,
 	COLOR_TYPE,
@@ -141,7 +156,7 @@ public:
 			if (instance != nullptr) {
 				vkDestroyInstance(instance, nullptr);
 				instance = nullptr;
-				Log::info("[OLD INSTANCE DESTROYED]");
+				LOG_INFO("[OLD INSTANCE DESTROYED]");
 			}
 			// Move resources from the 'other' object
 			instance = std::exchange(other.instance, nullptr);
@@ -163,7 +178,7 @@ public:
 		if (instance != nullptr) {
 			vkDestroyInstance(instance, nullptr);
 			instance = nullptr;
-			Log::info("[INSTANCE DESTROYED]");
+			LOG_INFO("[INSTANCE DESTROYED]");
 		}
 	}
 
@@ -191,9 +206,9 @@ public:
 			vkEnumerateInstanceLayerProperties(&count, nullptr);
 			std::vector<VkLayerProperties> properties(count);
 			vkEnumerateInstanceLayerProperties(&count, properties.data());
-			Log::info(count, " layer types available");
+			LOG_INFO(count, " layer types available");
 			for (uint32_t i = 0; i < count; i++) {
-				Log::debug("(", i + 1, ") ", properties[i].layerName);
+				LOG_DEBUG("(", i + 1, ") ", properties[i].layerName);
 			}
 		}
 	}
@@ -216,9 +231,9 @@ public:
 			vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
 			std::vector<VkExtensionProperties> available_extensions(count);
 			vkEnumerateInstanceExtensionProperties(nullptr, &count, available_extensions.data());
-			Log::info(count, " instance extensions available");
+			LOG_INFO(count, " instance extensions available");
 			for (uint32_t i = 0; i < count; i++) {
-				Log::debug("(", i + 1, ") ", available_extensions[i].extensionName);
+				LOG_DEBUG("(", i + 1, ") ", available_extensions[i].extensionName);
 			}
 		}
 	}
@@ -239,7 +254,7 @@ public:
 		if (instance != nullptr) {
 			vkDestroyInstance(instance, nullptr);
 			instance = nullptr;
-			Log::info("[OLD INSTANCE DESTROYED]");
+			LOG_INFO("[OLD INSTANCE DESTROYED]");
 		}
 
 		VkInstanceCreateInfo instance_create_info = {};
@@ -254,7 +269,7 @@ public:
 
 		VkResult result = vkCreateInstance(&instance_create_info, nullptr, &instance);
 		if (result == VK_SUCCESS) {
-			Log::info("Vulkan instance successfully created.");
+			LOG_INFO("Vulkan instance successfully created.");
 		}
 		else {
 			Log::error("Failed to create Vulkan Instance (VkResult=", result, ")");
@@ -279,8 +294,10 @@ public:
 	// delete default constructor
 	Device() = delete;
 
-	// parametric constructor
-	Device(const Instance& instance, const VkPhysicalDeviceFeatures& enabled_features = {}, const std::vector<const char*>& enabled_extension_names = {}, uint32_t id = 0) {
+	// parametric constructor;
+	// the physical device is selected by its deviceID ('id') or, if physical_device_index >= 0, by its enumeration index
+	// (which is required to tell several GPUs of the same model apart)
+	Device(const Instance& instance, const VkPhysicalDeviceFeatures& enabled_features = {}, const std::vector<const char*>& enabled_extension_names = {}, uint32_t id = 0, int32_t physical_device_index = -1) {
 		// confirm valid instance
 		if (instance.get() == nullptr) {
 			Log::error("Device constructor called with invalid instance parameter: create a valid object of the Instance() class first!");
@@ -304,29 +321,36 @@ public:
 		uint32_t selected_index = 0;
 		physical = devices[selected_index];
 		uint32_t selected_id = 0;
-		Log::info("available physical devices with Vulkan support:");
+		LOG_INFO("available physical devices with Vulkan support:");
 
 		for (uint32_t i = 0; i < num_devices; i++) {
 			vkGetPhysicalDeviceProperties(devices[i], &properties);
 			if (i == selected_index) {
 				selected_id = properties.deviceID;
 			}
-			Log::info("(", i, ") ", properties.deviceName, ", deviceID ", properties.deviceID, ", vendorID ", properties.vendorID,
+			LOG_INFO("(", i, ") ", properties.deviceName, ", deviceID ", properties.deviceID, ", vendorID ", properties.vendorID,
 				", type ", properties.deviceType, ", API version ", properties.apiVersion, ", driver version ", properties.driverVersion);
-			// chose specific device (instead of default index 0) if passed id matches
-			if (id == properties.deviceID) {
+			// chose specific device (instead of default index 0) if passed id or index matches
+			if (physical_device_index >= 0 ? i == static_cast<uint32_t>(physical_device_index) : id == properties.deviceID) {
 				physical = devices[i];
 				selected_id = properties.deviceID;
 				selected_index = i;
 			}
 		}
-		Log::info("Selected physical device ", selected_index, " with ID ", selected_id);
+		if (physical_device_index >= static_cast<int32_t>(num_devices)) {
+			Log::warning("physical device index ", physical_device_index, " out of range; using device ", selected_index);
+		}
+		this->physical_index = selected_index;
+		LOG_INFO("Selected physical device ", selected_index, " with ID ", selected_id);
 
 		// store properties for selected device
 		vkGetPhysicalDeviceProperties(physical, &properties);
+		subgroup_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+		subgroup_properties.pNext = nullptr;
 		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
-		properties2.pNext = nullptr;
+		properties2.pNext = &subgroup_properties;
 		vkGetPhysicalDeviceProperties2(physical, &properties2);
+		properties2.pNext = nullptr; // (the subgroup properties are kept separately)
 
 		// get available extensions for the selected device
 		uint32_t available_extension_count;
@@ -336,9 +360,9 @@ public:
 
 		// log available extensions
 		if (Log::get_level() >= LogLevel::LEVEL_INFO) {
-			Log::debug(available_extension_count, " device extensions available");
+			LOG_DEBUG(available_extension_count, " device extensions available");
 			for (uint32_t i = 0; i < available_extension_count; i++) {
-				Log::debug("(", i + 1, ") ", available_extensions[i].extensionName);
+				LOG_DEBUG("(", i + 1, ") ", available_extensions[i].extensionName);
 			}
 		}
 
@@ -366,6 +390,23 @@ public:
 		}
 		device_extension_names = supported_extensions; // Update the member with only supported extensions
 
+		// query the push descriptor limit (the extension properties may only be chained if the extension is supported)
+		bool use_push_descriptor = false;
+		for (const char* extension : device_extension_names) {
+			if (strcmp(extension, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) == 0) {
+				use_push_descriptor = true;
+			}
+		}
+		if (use_push_descriptor) {
+			push_descriptor_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
+			push_descriptor_properties.pNext = nullptr;
+			VkPhysicalDeviceProperties2 push_properties2 = {};
+			push_properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			push_properties2.pNext = &push_descriptor_properties;
+			vkGetPhysicalDeviceProperties2(physical, &push_properties2);
+			push_descriptor_properties.pNext = nullptr;
+		}
+
 		// prepare device features
 		enabled_features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
 		void* next_ptr = nullptr;
@@ -378,12 +419,34 @@ public:
 			synchronization2_features.synchronization2 = VK_TRUE; // Enable synchronization2 features
 		}
 
+		// enable timeline semaphores (Vulkan 1.2 core feature) if supported by the physical device
+		timeline_semaphore_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timeline_semaphore_features.pNext = nullptr;
+		VkPhysicalDeviceFeatures2 supported_features2 = {};
+		supported_features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supported_features2.pNext = &timeline_semaphore_features;
+		vkGetPhysicalDeviceFeatures2(physical, &supported_features2);
+		if (timeline_semaphore_features.timelineSemaphore) {
+			timeline_semaphore_features.pNext = next_ptr;
+			next_ptr = &timeline_semaphore_features;
+		}
+		else {
+			LOG_INFO("timeline semaphores are not supported by this device");
+		}
+
 		enabled_features2.pNext = next_ptr;
 		enabled_features2.features = enabled_features;
 
+		// sparse binding and residency are optional: requests for unsupported sparse features are dropped
+		// instead of failing the device creation (see supports_sparse_residency())
+		enabled_features2.features.sparseBinding &= supported_features2.features.sparseBinding;
+		enabled_features2.features.sparseResidencyBuffer &= supported_features2.features.sparseResidencyBuffer;
+		if (enabled_features.sparseResidencyBuffer && !enabled_features2.features.sparseResidencyBuffer) {
+			LOG_INFO("sparse residency buffers are not supported by this device");
+		}
+
 		// Queue creation
 		uint32_t num_queue_families;
-		float priority = 1.0f; // default priority for all queue types
 		vkGetPhysicalDeviceQueueFamilyProperties(physical, &num_queue_families, nullptr);
 		std::vector<VkQueueFamilyProperties> queue_families(num_queue_families);
 		vkGetPhysicalDeviceQueueFamilyProperties(physical, &num_queue_families, queue_families.data());
@@ -403,13 +466,8 @@ public:
 			// Check for graphics queue support
 			if (!graphics_queue_assigned && (queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
 				graphics_queue_family_index = i;
-				queue_create_infos.push_back({});
-				queue_create_infos[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-				queue_create_infos[i].queueFamilyIndex = i;
-				queue_create_infos[i].queueCount = 1;
-				queue_create_infos[i].pQueuePriorities = &priority;
 				graphics_queue_assigned = true;
-				Log::info("GRAPHICS queue supported -> added to queue_create_infos for this device");
+				LOG_INFO("GRAPHICS queue family supported (index: ", i, ")");
 				compute_fallback = queue_families[i].queueFlags & VK_QUEUE_COMPUTE_BIT ? i : -1;
 				transfer_fallback = queue_families[i].queueFlags & VK_QUEUE_TRANSFER_BIT ? i : -1;
 				continue;
@@ -418,13 +476,8 @@ public:
 			// Check for compute queue support
 			if (!compute_queue_assigned && (queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
 				compute_queue_family_index = i;
-				queue_create_infos.push_back({});
-				queue_create_infos[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-				queue_create_infos[i].queueFamilyIndex = i;
-				queue_create_infos[i].queueCount = 1;
-				queue_create_infos[i].pQueuePriorities = &priority;
 				compute_queue_assigned = true;
-				Log::info("COMPUTE queue supported -> added to queue_create_infos for this device");
+				LOG_INFO("COMPUTE queue family supported (index: ", i, ")");
 				graphics_fallback = queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT ? i : -1;
 				transfer_fallback = queue_families[i].queueFlags & VK_QUEUE_TRANSFER_BIT ? i : -1;
 				continue;
@@ -433,13 +486,8 @@ public:
 			// Check for transfer queue support
 			if (!transfer_queue_assigned && (queue_family.queueFlags & VK_QUEUE_TRANSFER_BIT)) {
 				transfer_queue_family_index = i;
-				queue_create_infos.push_back({});
-				queue_create_infos[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-				queue_create_infos[i].queueFamilyIndex = i;
-				queue_create_infos[i].queueCount = 1;
-				queue_create_infos[i].pQueuePriorities = &priority;
 				transfer_queue_assigned = true;
-				Log::info("TRANSFER queue supported -> added to queue_create_infos for this device");
+				LOG_INFO("TRANSFER queue family supported (index: ", i, ")");
 				graphics_fallback = queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT ? i : -1;
 				compute_fallback = queue_families[i].queueFlags & VK_QUEUE_COMPUTE_BIT ? i : -1;
 				continue;
@@ -451,7 +499,7 @@ public:
 			if (graphics_fallback != -1) {
 				graphics_queue_family_index = graphics_fallback;
 				graphics_queue_assigned = true;
-				Log::info("no dedicated GRAPHICS queue family found; using fallback queue family index ", graphics_queue_family_index, " (shared queue)");
+				LOG_INFO("no dedicated GRAPHICS queue family found; using fallback queue family index ", graphics_queue_family_index, " (shared queue)");
 			}
 			else {
 				Log::warning("no dedicated GRAPHICS queue family found; no fallback available");
@@ -461,7 +509,7 @@ public:
 			if (compute_fallback != -1) {
 				compute_queue_family_index = compute_fallback;
 				compute_queue_assigned = true;
-				Log::info("no dedicated COMPUTE queue family found; using fallback queue family index ", compute_queue_family_index, " (shared queue)");
+				LOG_INFO("no dedicated COMPUTE queue family found; using fallback queue family index ", compute_queue_family_index, " (shared queue)");
 			}
 			else {
 				Log::warning("no dedicated COMPUTE queue family found; no fallback available");
@@ -471,13 +519,33 @@ public:
 			if (transfer_fallback != -1) {
 				transfer_queue_family_index = transfer_fallback;
 				transfer_queue_assigned = true;
-				Log::info("no dedicated TRANSFER queue family found; using fallback queue family index ", transfer_queue_family_index, " (shared queue)");
+				LOG_INFO("no dedicated TRANSFER queue family found; using fallback queue family index ", transfer_queue_family_index, " (shared queue)");
 			}
 			else {
 				Log::warning("no dedicated TRANSFER queue family found; no fallback available");
 			}
 		}
 
+		// sparse memory bindings are submitted to the compute queue
+		compute_sparse_binding = queue_families[compute_queue_family_index].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT;
+
+		// one create info per distinct queue family; the compute family gets all of its queues,
+		// so that independent submissions (e.g. from different threads) can run concurrently
+		std::map<uint32_t, uint32_t> family_queue_counts;
+		family_queue_counts[graphics_queue_family_index] = 1;
+		family_queue_counts[transfer_queue_family_index] = 1;
+		family_queue_counts[compute_queue_family_index] = std::max(1u, queue_families[compute_queue_family_index].queueCount);
+		std::vector<float> priorities(family_queue_counts[compute_queue_family_index], 1.0f); // default priority for all queues
+		for (const auto& [family_index, queue_count] : family_queue_counts) {
+			VkDeviceQueueCreateInfo queue_create_info = {};
+			queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+			queue_create_info.queueFamilyIndex = family_index;
+			queue_create_info.queueCount = queue_count;
+			queue_create_info.pQueuePriorities = priorities.data();
+			queue_create_infos.push_back(queue_create_info);
+			LOG_INFO("requesting ", queue_count, " queue(s) of queue family ", family_index);
+		}
+
 		// Create logical device
 		VkDeviceCreateInfo device_create_info = {};
 		device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -490,29 +558,47 @@ public:
 		device_create_info.pEnabledFeatures = NULL;
 		result = vkCreateDevice(physical, &device_create_info, nullptr, &logical);
 		if (result == VK_SUCCESS) {
-			Log::info("successfully created logical device (handle: ", logical, ")");
+			LOG_INFO("successfully created logical device (handle: ", logical, ")");
 		}
 		else {
 			Log::error("Failed to create Vulkan logical device (VkResult=", result, ")");
 		}
 
+		// extension commands aren't exported by the loader and have to be queried from the device
+		if (use_push_descriptor) {
+			cmd_push_descriptor_set = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(vkGetDeviceProcAddr(logical, "vkCmdPushDescriptorSetKHR"));
+			if (cmd_push_descriptor_set == nullptr) {
+				LOG_INFO("vkCmdPushDescriptorSetKHR is not available; descriptor sets will be allocated from descriptor pools");
+			}
+		}
+
 		// Acquire queue handles for this logical device
 		if (graphics_queue == nullptr) {
 			vkGetDeviceQueue(logical, graphics_queue_family_index, 0, &graphics_queue);
-			Log::info("adding graphics queue to logical device (handle: ", graphics_queue, ")");
+			LOG_INFO("adding graphics queue to logical device (handle: ", graphics_queue, ")");
 		}
 
-		if (compute_queue == nullptr) {
-			vkGetDeviceQueue(logical, compute_queue_family_index, 0, &compute_queue);
-			Log::info("adding compute queue to logical device (handle: ", compute_queue, ")");
+		compute_queues.resize(family_queue_counts[compute_queue_family_index]);
+		for (uint32_t i = 0; i < compute_queues.size(); i++) {
+			vkGetDeviceQueue(logical, compute_queue_family_index, i, &compute_queues[i]);
+			LOG_INFO("adding compute queue ", i, " to logical device (handle: ", compute_queues[i], ")");
 		}
+		compute_queue = compute_queues[0];
 
 		if (transfer_queue == nullptr) {
 			vkGetDeviceQueue(logical, transfer_queue_family_index, 0, &transfer_queue);
-			Log::info("adding transfer queue to logical device (handle: ", transfer_queue, ")");
+			LOG_INFO("adding transfer queue to logical device (handle: ", transfer_queue, ")");
 		}
 
-		Log::info("[DEVICE COMPLETED]");
+		// submissions to the same queue must be externally synchronized
+		for (VkQueue queue : { graphics_queue, transfer_queue }) {
+			queue_mutexes[queue] = std::make_unique<std::mutex>();
+		}
+		for (VkQueue queue : compute_queues) {
+			queue_mutexes[queue] = std::make_unique<std::mutex>();
+		}
+
+		LOG_INFO("[DEVICE COMPLETED]");
 	}
 
 	// move constructor
@@ -525,7 +611,7 @@ public:
 		if (this != &other) {
 			destroy(); // release resource from 'this'
 			move_resources(other);
-			Log::info("Device resources from 'other' moved to 'this'");
+			LOG_INFO("Device resources from 'other' moved to 'this'");
 		}
 		return *this;
 	}
@@ -542,6 +628,9 @@ public:
 	VkPhysicalDevice get_physical() const { return physical; }
 	VkQueue get_graphics_queue() const { return graphics_queue; }
 	VkQueue get_compute_queue() const { return compute_queue; }
+	VkQueue get_compute_queue(uint32_t index) const { return compute_queues[index % compute_queues.size()]; }
+	uint32_t get_compute_queue_count() const { return static_cast<uint32_t>(compute_queues.size()); }
+	uint32_t get_physical_device_index() const { return physical_index; }
 	VkQueue get_transfer_queue() const { return transfer_queue; }
 	uint32_t get_graphics_queue_family_index() const { return graphics_queue_family_index; }
 	uint32_t get_compute_queue_family_index() const { return compute_queue_family_index; }
@@ -560,8 +649,92 @@ public:
 		return memory_properties;
 	}
 
+	// returns true if the device has a host-visible + host-coherent device-local memory type
+	// on a heap of at least the specified size (e.g. with resizable BAR or on unified memory architectures)
+	bool supports_host_visible_device_memory(VkDeviceSize min_heap_size = 256ull * 1024 * 1024) {
+		const VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		const auto& mem_properties = get_memory_properties();
+		for (uint32_t i = 0; i < mem_properties.memoryTypeCount; i++) {
+			if ((mem_properties.memoryTypes[i].propertyFlags & flags) == flags
+				&& mem_properties.memoryHeaps[mem_properties.memoryTypes[i].heapIndex].size >= min_heap_size) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	const VkPhysicalDeviceFeatures2& get_features() const { return enabled_features2; }
+
+	// returns the mutex that has to be locked for submissions to the given queue
+	// (queues are externally synchronized objects; queues of different families may alias the same handle)
+	std::mutex& get_queue_mutex(VkQueue queue) const {
+		auto it = queue_mutexes.find(queue);
+		if (it == queue_mutexes.end()) {
+			Log::error("in method Device::get_queue_mutex(): the queue (handle: ", queue, ") doesn't belong to this device");
+		}
+		return *it->second;
+	}
 	const VkPhysicalDeviceSynchronization2Features& get_synchronization_features() const { return synchronization2_features; }
+	bool supports_timeline_semaphores() const { return timeline_semaphore_features.timelineSemaphore == VK_TRUE; }
+	const VkPhysicalDeviceSubgroupProperties& get_subgroup_properties() const { return subgroup_properties; }
+
+	// returns true if descriptors can be pushed directly into command buffers (VK_KHR_push_descriptor)
+	bool supports_push_descriptors() const { return cmd_push_descriptor_set != nullptr; }
+	uint32_t get_max_push_descriptors() const { return push_descriptor_properties.maxPushDescriptors; }
+
+	// records a vkCmdPushDescriptorSetKHR command (requires supports_push_descriptors())
+	void push_descriptor_set(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout, uint32_t set_index, uint32_t write_count, const VkWriteDescriptorSet* writes) const {
+		cmd_push_descriptor_set(command_buffer, bind_point, layout, set_index, write_count, writes);
+	}
+
+	// returns a descriptor set layout for the given bindings and create flags;
+	// layouts are created once per signature and owned by the device
+	VkDescriptorSetLayout get_descriptor_set_layout(const std::vector<VkDescriptorSetLayoutBinding>& bindings, VkDescriptorSetLayoutCreateFlags flags) const {
+		std::vector<uint64_t> key;
+		key.reserve(4 * bindings.size() + 1);
+		key.push_back(uint64_t(flags));
+		for (const auto& binding : bindings) {
+			key.push_back(binding.binding);
+			key.push_back(uint64_t(binding.descriptorType));
+			key.push_back(binding.descriptorCount);
+			key.push_back(uint64_t(binding.stageFlags));
+		}
+		std::lock_guard<std::mutex> lock(set_layouts_mutex);
+		auto it = set_layouts.find(key);
+		if (it != set_layouts.end()) {
+			return it->second;
+		}
+		VkDescriptorSetLayoutCreateInfo create_info = {};
+		create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		create_info.pNext = NULL;
+		create_info.flags = flags;
+		create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+		create_info.pBindings = bindings.data();
+		VkDescriptorSetLayout layout = nullptr;
+		VkResult result = vkCreateDescriptorSetLayout(logical, &create_info, nullptr, &layout);
+		if (result != VK_SUCCESS) {
+			Log::error("in method Device::get_descriptor_set_layout(): failed to create descriptor set layout (VkResult ", result, ")");
+		}
+		LOG_INFO("descriptor set layout created (", bindings.size(), " bindings, layout handle : ", layout, ")");
+		set_layouts[key] = layout;
+		return layout;
+	}
+	size_t get_descriptor_set_layout_count() const { return set_layouts.size(); }
+
+	// returns true if buffers can be created with partially resident memory (see MemoryAllocationMode::SPARSE_RESIDENCY);
+	// requires the sparseBinding and sparseResidencyBuffer features and sparse binding support of the compute queue family
+	bool supports_sparse_residency() const {
+		return enabled_features2.features.sparseBinding && enabled_features2.features.sparseResidencyBuffer && compute_sparse_binding;
+	}
+
+	// returns true if the device returns zero for reads from unbound pages of sparse buffers
+	bool reads_non_resident_as_zero() const { return properties.sparseProperties.residencyNonResidentStrict == VK_TRUE; }
+
+	// returns true if compute shaders can use subgroup arithmetic operations (subgroupAdd, subgroupMin, subgroupMax, ...)
+	bool supports_subgroup_arithmetic() const {
+		return (subgroup_properties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT)
+			&& (subgroup_properties.supportedOperations & VK_SUBGROUP_FEATURE_ARITHMETIC_BIT);
+	}
 
 	// destructor
 	~Device() {
@@ -574,9 +747,13 @@ protected:
 		// destroy logical device
 		if (logical != nullptr) {
 			vkDeviceWaitIdle(logical);
+			for (auto& entry : set_layouts) {
+				vkDestroyDescriptorSetLayout(logical, entry.second, nullptr);
+			}
+			set_layouts.clear();
 			vkDestroyDevice(logical, nullptr);
 			logical = nullptr;
-			Log::info("[LOGICAL DEVICE DESTROYED]");
+			LOG_INFO("[LOGICAL DEVICE DESTROYED]");
 		}
 	}
 
@@ -585,9 +762,12 @@ protected:
 		// Transfer ownership of Vulkan handles/resources using std::exchange;
 		// std::move may not be supported with some Vulkan objects
 		this->physical = std::exchange(other.physical, nullptr);
+		this->physical_index = other.physical_index;
 		this->logical = std::exchange(other.logical, nullptr);
 		this->graphics_queue = std::exchange(other.graphics_queue, nullptr);
 		this->compute_queue = std::exchange(other.compute_queue, nullptr);
+		this->compute_queues = std::move(other.compute_queues);
+		this->queue_mutexes = std::move(other.queue_mutexes);
 		this->transfer_queue = std::exchange(other.transfer_queue, nullptr);
 		this->graphics_queue_assigned = std::move(other.graphics_queue_assigned);
 		this->compute_queue_assigned = std::move(other.compute_queue_assigned);
@@ -595,33 +775,50 @@ protected:
 		this->graphics_queue_family_index = std::move(other.graphics_queue_family_index);
 		this->compute_queue_family_index = std::move(other.compute_queue_family_index);
 		this->transfer_queue_family_index = std::move(other.transfer_queue_family_index);
+		this->compute_sparse_binding = other.compute_sparse_binding;
 		this->properties = std::exchange(other.properties, VkPhysicalDeviceProperties{});
 		this->properties2 = std::exchange(other.properties2, VkPhysicalDeviceProperties2{});
+		this->subgroup_properties = std::exchange(other.subgroup_properties, VkPhysicalDeviceSubgroupProperties{});
 		this->extensions = std::move(other.get_extensions());
 		this->device_extension_names = std::move(other.device_extension_names);
 		this->memory_properties = std::exchange(other.memory_properties, VkPhysicalDeviceMemoryProperties{});
 		this->enabled_features2 = std::move(other.enabled_features2);
 		this->synchronization2_features = std::move(other.synchronization2_features);
+		this->timeline_semaphore_features = std::move(other.timeline_semaphore_features);
+		this->push_descriptor_properties = std::exchange(other.push_descriptor_properties, VkPhysicalDevicePushDescriptorPropertiesKHR{});
+		this->cmd_push_descriptor_set = std::exchange(other.cmd_push_descriptor_set, nullptr);
+		this->set_layouts = std::move(other.set_layouts);
+		other.set_layouts.clear();
 	}
 
 	VkPhysicalDevice physical = nullptr;
+	uint32_t physical_index = 0;              // enumeration index of the physical device
 	VkDevice logical = nullptr;
 	VkQueue graphics_queue = nullptr;
 	VkQueue compute_queue = nullptr;
 	VkQueue transfer_queue = nullptr;
+	std::vector<VkQueue> compute_queues = {};  // all queues of the compute queue family (compute_queue = compute_queues[0])
+	std::map<VkQueue, std::unique_ptr<std::mutex>> queue_mutexes = {};
 	bool graphics_queue_assigned = false;
 	bool compute_queue_assigned = false;
 	bool transfer_queue_assigned = false;
 	uint32_t graphics_queue_family_index = 0;
 	uint32_t compute_queue_family_index = 0;
 	uint32_t transfer_queue_family_index = 0;
+	bool compute_sparse_binding = false;      // true if the compute queue family supports vkQueueBindSparse
 	VkPhysicalDeviceProperties properties = {};
 	VkPhysicalDeviceProperties2 properties2 = {};
+	VkPhysicalDeviceSubgroupProperties subgroup_properties = {}; // Vulkan 1.1+ subgroup size and supported operations
 	std::vector<const char*> extensions = {};
 	std::vector<const char*> device_extension_names = {};
 	VkPhysicalDeviceMemoryProperties memory_properties = {};
 	VkPhysicalDeviceFeatures2 enabled_features2 = {}; // Vulkan 1.1+ feature set, can be extended with pNext
 	VkPhysicalDeviceSynchronization2Features synchronization2_features = {}; // Vulkan 1.3+ feature set for synchronization2
+	VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_features = {}; // Vulkan 1.2+ feature set for timeline semaphores
+	VkPhysicalDevicePushDescriptorPropertiesKHR push_descriptor_properties = {};
+	PFN_vkCmdPushDescriptorSetKHR cmd_push_descriptor_set = nullptr;
+	mutable std::map<std::vector<uint64_t>, VkDescriptorSetLayout> set_layouts = {}; // shared descriptor set layouts by binding signature
+	mutable std::mutex set_layouts_mutex;
 };
 
 class Image {
@@ -690,7 +887,7 @@ public:
 			image = VK_NULL_HANDLE;
 			Log::error("in constructor Image::Image(...): Failed to bind image memory (VkResult=", result, ")");
 		}
-		Log::debug("in constructor Image::Image(...): image created successfully (handle: ", image, ")");
+		LOG_DEBUG("in constructor Image::Image(...): image created successfully (handle: ", image, ")");
 	}
 
 	// move constructor
@@ -746,7 +943,7 @@ protected:
 			memory = VK_NULL_HANDLE;
 		}
 		if (image != VK_NULL_HANDLE) {
-			Log::info("Destroying image (handle: ", image, ")");
+			LOG_INFO("Destroying image (handle: ", image, ")");
 			vkDestroyImage(logical, image, nullptr);
 			image = VK_NULL_HANDLE;
 		}
@@ -799,7 +996,7 @@ public:
 			// Handle error
 			return;
 		}
-		Log::info("ImageView created successfully (handle: ", image_view, ")");
+		LOG_INFO("ImageView created successfully (handle: ", image_view, ")");
 	}
 
 	// move constructor
@@ -834,7 +1031,7 @@ protected:
 	// helper method to release resources
 	void destroy() {
 		if (image_view != VK_NULL_HANDLE) {
-			Log::info("Destroying image view (handle: ", image_view, ")");
+			LOG_INFO("Destroying image view (handle: ", image_view, ")");
 			vkDestroyImageView(logical, image_view, nullptr);
 			image_view = VK_NULL_HANDLE;
 		}
@@ -1121,7 +1318,7 @@ public:
 			Log::error("Failed to create Win32 surface (VkResult=", result, ")");
 		}
 		else {
-			Log::info("Win32 Vulkan surface created successfully (handle: ", surface, ")");
+			LOG_INFO("Win32 Vulkan surface created successfully (handle: ", surface, ")");
 		}
 	}
 #endif
@@ -1149,7 +1346,7 @@ public:
 			Log::error("Failed to create Android surface (VkResult=", result, ")");
 		}
 		else {
-			Log::info("Android Vulkan surface created successfully (handle: ", surface, ")");
+			LOG_INFO("Android Vulkan surface created successfully (handle: ", surface, ")");
 		}
 	}
 #endif
@@ -1177,7 +1374,7 @@ public:
 			Log::error("Failed to create XCB surface (VkResult=", result, ")");
 		}
 		else {
-			Log::info("XCB Vulkan surface created successfully (handle: ", surface, ")");
+			LOG_INFO("XCB Vulkan surface created successfully (handle: ", surface, ")");
 		}
 	}
 #endif
@@ -1209,7 +1406,7 @@ public:
 			Log::error("Failed to create Metal surface (VkResult=", result, ")");
 		}
 		else {
-			Log::info("Metal Vulkan surface created successfully (handle: ", surface, ")");
+			LOG_INFO("Metal Vulkan surface created successfully (handle: ", surface, ")");
 		}
 	}
 #endif
@@ -1344,7 +1541,7 @@ protected:
 	void destroy() {
 		if (surface != VK_NULL_HANDLE && instance_handle != VK_NULL_HANDLE) {
 			vkDestroySurfaceKHR(instance_handle, surface, nullptr);
-			Log::info("[SURFACE DESTROYED] (handle: ", surface, ")");
+			LOG_INFO("[SURFACE DESTROYED] (handle: ", surface, ")");
 		}
 		surface = VK_NULL_HANDLE;
 	}
@@ -1504,6 +1701,17 @@ public:
 		return vkWaitSemaphores(logical, &wait_info, timeout_nanosec);
 	}
 
+	// wait for the counter of a timeline semaphore to reach the specified value
+	VkResult wait_for(uint64_t value, uint64_t timeout_nanosec = UINT64_MAX) {
+		wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		wait_info.pNext = NULL;
+		wait_info.flags = 0;
+		wait_info.semaphoreCount = 1;
+		wait_info.pSemaphores = &semaphore;
+		wait_info.pValues = &value;
+		return vkWaitSemaphores(logical, &wait_info, timeout_nanosec);
+	}
+
 	// query semaphore counter value
 	uint64_t counter() const {
 		uint64_t value;
@@ -1523,6 +1731,7 @@ public:
 	// returns the semaphore handle
 	VkSemaphore get() const { return semaphore; }
 	const VkSemaphore* get_ptr() const { return &semaphore; }
+	VkSemaphoreType get_type() const { return type; }
 
 private:
 	VkSemaphore semaphore = nullptr;
@@ -1694,7 +1903,7 @@ public:
 			Log::error("Failed to create swapchain (VkResult=", result, ")");
 		}
 		else {
-			Log::debug("Swapchain created successfully.");
+			LOG_DEBUG("Swapchain created successfully.");
 		}
 
 		// get images
@@ -1721,7 +1930,7 @@ public:
 				Log::error("Failed to create swapchain image view ", i);
 			}
 		}
-		Log::info("Swapchain created with ", num_images, " images/views.");
+		LOG_INFO("Swapchain created with ", num_images, " images/views.");
 
 	}
 
@@ -1759,7 +1968,7 @@ public:
 			}
 		}
 
-		Log::info("Swapchain framebuffers created successfully.");
+		LOG_INFO("Swapchain framebuffers created successfully.");
 	}
 
 	void acquire_next_image(const Semaphore& image_available_semaphore, const std::optional<Fence>& fence = NULLOPT, uint64_t timeout = UINT64_MAX) {
@@ -1776,7 +1985,7 @@ public:
 			this->recreate();
 		}
 		else if (result == VK_SUBOPTIMAL_KHR) {
-			Log::info("Swapchain suboptimal during acquire. Okay to continue, but should be recreated soon.");
+			LOG_INFO("Swapchain suboptimal during acquire. Okay to continue, but should be recreated soon.");
 		}
 		else if (result != VK_SUCCESS) {
 			Log::error("Failed to acquire swapchain image (VkResult=", result, ")");
@@ -1796,14 +2005,16 @@ public:
 		present_info.pImageIndices = &current_image_index;
 		present_info.pResults = nullptr;
 
+		std::unique_lock<std::mutex> queue_lock(device->get_queue_mutex(device->get_graphics_queue()));
 		VkResult result = vkQueuePresentKHR(device->get_graphics_queue(), &present_info);
+		queue_lock.unlock();
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			Log::warning("Swapchain out of date during present -> recreating");
 			this->recreate();
 		}
 		else if (result == VK_SUBOPTIMAL_KHR) {
-			Log::info("Swapchain suboptimal during present. Okay to continue, but should be recreated soon");
+			LOG_INFO("Swapchain suboptimal during present. Okay to continue, but should be recreated soon");
 		}
 		else if (result != VK_SUCCESS) {
 			Log::error("Failed to present swapchain image (VkResult=", result, ")");
@@ -1824,14 +2035,16 @@ public:
 		present_info.pImageIndices = &current_image_index;
 		present_info.pResults = nullptr;
 
+		std::unique_lock<std::mutex> queue_lock(device->get_queue_mutex(device->get_graphics_queue()));
 		VkResult result = vkQueuePresentKHR(device->get_graphics_queue(), &present_info);
+		queue_lock.unlock();
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			Log::warning("Swapchain out of date during present -> recreating");
 			this->recreate();
 		}
 		else if (result == VK_SUBOPTIMAL_KHR) {
-			Log::info("Swapchain suboptimal during present. Okay to continue, but should be recreated soon");
+			LOG_INFO("Swapchain suboptimal during present. Okay to continue, but should be recreated soon");
 		}
 		else if (result != VK_SUCCESS) {
 			Log::error("Failed to present swapchain image (VkResult=", result, ")");
@@ -1856,14 +2069,16 @@ public:
 		present_info.pImageIndices = &current_image_index;
 		present_info.pResults = nullptr;
 
+		std::unique_lock<std::mutex> queue_lock(device->get_queue_mutex(device->get_graphics_queue()));
 		VkResult result = vkQueuePresentKHR(device->get_graphics_queue(), &present_info);
+		queue_lock.unlock();
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			Log::warning("Swapchain out of date during present -> recreating");
 			this->recreate();
 		}
 		else if (result == VK_SUBOPTIMAL_KHR) {
-			Log::info("Swapchain suboptimal during present. Okay to continue, but should be recreated soon");
+			LOG_INFO("Swapchain suboptimal during present. Okay to continue, but should be recreated soon");
 		}
 		else if (result != VK_SUCCESS) {
 			Log::error("Failed to present swapchain image (VkResult=", result, ")");
@@ -1970,7 +2185,7 @@ protected:
 		framebuffer.clear();
 		image.clear();
 		num_images = 0;
-		Log::info("Swapchain destroyed.");
+		LOG_INFO("Swapchain destroyed.");
 	}
 
 	uint32_t num_images = 0;
@@ -2018,7 +2233,7 @@ public:
 		}
 		VkResult result = vkCreateCommandPool(logical, &create_info, nullptr, &pool);
 		if (result == VK_SUCCESS) {
-			Log::info("command pool created (handle: ", pool, ")");
+			LOG_INFO("command pool created (handle: ", pool, ")");
 		}
 		else {
 			Log::error("failed to create command pool (VkResult=", result, ")");
@@ -2028,7 +2243,7 @@ public:
 	~CommandPool() {
 		if (pool != nullptr) {
 			// destroy command pool
-			Log::info("CommandPool destructor: destroying command pool with handle ", pool);
+			LOG_INFO("CommandPool destructor: destroying command pool with handle ", pool);
 			vkDestroyCommandPool(logical, pool, nullptr);
 			pool = nullptr;
 		}
@@ -2099,14 +2314,14 @@ public:
 
 		// free old resource first in case a previous module exists
 		if (module != nullptr) {
-			Log::info("destroying previous shader module");
+			LOG_INFO("destroying previous shader module");
 			vkDestroyShaderModule(logical, module, nullptr);
 		}
 
 		// allocate new module
 		VkResult result = vkCreateShaderModule(logical, &shader_module_create_info, nullptr, &module);
 		if (result == VK_SUCCESS) {
-			Log::debug("new shader module successfully created (handle: ", module, ")");
+			LOG_DEBUG("new shader module successfully created (handle: ", module, ")");
 		}
 		else {
 			Log::error("failed to create shader module (VkResult = ", result, ")");
@@ -2137,7 +2352,7 @@ public:
 			Log::error("Failed to open shader file: ", file_path);
 		}
 		else {
-			Log::debug("reading shader file: ", file_path.c_str());
+			LOG_DEBUG("reading shader file: ", file_path.c_str());
 			fseek(file, 0, SEEK_END);
 			file_size = ftell(file);
 			fseek(file, 0, SEEK_SET);
@@ -2151,14 +2366,14 @@ public:
 
 			// free old resource first in case a previous module exists
 			if (module != nullptr) {
-				Log::info("destroying previous shader module");
+				LOG_INFO("destroying previous shader module");
 				vkDestroyShaderModule(logical, module, nullptr);
 			}
 
 			// allocate new module
 			VkResult result = vkCreateShaderModule(logical, &shader_module_create_info, nullptr, &module);
 			if (result == VK_SUCCESS) {
-				Log::debug("new shader module successfully created (handle: ", module, ")");
+				LOG_DEBUG("new shader module successfully created (handle: ", module, ")");
 			}
 			else {
 				Log::error("failed to create shader module (VkResult = ", result, ")");
@@ -2171,7 +2386,7 @@ public:
 	// move constructor
 	ShaderModule(ShaderModule&& other) noexcept : module(std::exchange(other.module, nullptr)), logical(std::exchange(other.logical, nullptr)) {
 		if (module != nullptr) {
-			Log::info("shader module moved (handle: ", module, ")");
+			LOG_INFO("shader module moved (handle: ", module, ")");
 		}
 	}
 
@@ -2179,14 +2394,14 @@ public:
 	ShaderModule& operator=(ShaderModule&& other) noexcept {
 		if (this != &other) {
 			if (module != nullptr) {
-				Log::info("move assignment operation: destroying previous shader module (handle: ", module, ")");
+				LOG_INFO("move assignment operation: destroying previous shader module (handle: ", module, ")");
 				vkDestroyShaderModule(logical, module, nullptr);
 				module = nullptr;
 			}
 			module = std::exchange(other.module, nullptr);
 			logical = std::exchange(other.logical, nullptr);
 			if (module != nullptr) {
-				Log::info("shader module moved to 'this' (handle: ", module, ")");
+				LOG_INFO("shader module moved to 'this' (handle: ", module, ")");
 			}
 		}
 		return *this;
@@ -2340,13 +2555,331 @@ protected:
 };
 
 // buffer class for vertex data, index data, storage data, uniform data, etc.
+// range of device memory that has been reserved for a single buffer
+struct MemoryAllocation {
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize offset = 0;     // offset in bytes within 'memory'
+	VkDeviceSize size = 0;       // reserved size in bytes (>= requested size)
+	void* mapped = nullptr;      // persistent host mapping of the range (nullptr for device-local or dedicated memory)
+	uint32_t type_index = 0;
+	uint32_t size_class = 0;
+	MemoryAllocationMode mode = MemoryAllocationMode::DEDICATED_ALLOCATION;
+};
+
+// device memory arena for sub-allocation of buffer memory;
+// the arena reserves large blocks per memory type and hands out ranges of power-of-two size classes,
+// so that most buffers don't need a vkAllocateMemory call of their own (avoiding the driver's
+// maxMemoryAllocationCount limit and the allocation latency for small buffers);
+// freed ranges are kept in free lists per memory type and size class for reuse;
+// short-lived scratch buffers (e.g. for reduction results) are placed in a separate block per memory type
+// with a bump allocator that rewinds as soon as all scratch allocations of the block have been freed;
+// host-visible blocks are mapped persistently
+class MemoryArena {
+public:
+	// constructor
+	MemoryArena() = delete;
+	MemoryArena(Device& device, VkDeviceSize block_size = 64ull * 1024 * 1024, VkDeviceSize scratch_block_size = 16ull * 1024 * 1024) {
+		this->logical = device.get_logical();
+		this->memory_properties = device.get_memory_properties();
+		this->non_coherent_atom_size = std::max(VkDeviceSize(1), device.get_properties().limits.nonCoherentAtomSize);
+		this->block_size = block_size;
+		this->scratch_block_size = scratch_block_size;
+
+		// size classes range from min_class_size to 1/8 of the block size;
+		// larger requests get a dedicated allocation
+		this->max_size_class = 0;
+		while ((min_class_size << (max_size_class + 1)) <= block_size / 8) {
+			max_size_class++;
+		}
+
+		if (shared == nullptr) {
+			shared = this;
+		}
+		std::lock_guard<std::mutex> lock(registry_mtx);
+		registry.emplace(logical, this); // (keeps the first arena of the device)
+	}
+
+	// destructor: releases all memory blocks;
+	// make sure no buffers that use memory of this arena are still in use by the device
+	~MemoryArena() {
+		for (Block* block : blocks) {
+			release_block(block);
+		}
+		blocks.clear();
+		if (shared == this) {
+			shared = nullptr;
+		}
+		std::lock_guard<std::mutex> lock(registry_mtx);
+		auto it = registry.find(logical);
+		if (it != registry.end() && it->second == this) {
+			registry.erase(it);
+		}
+	}
+
+	// deleted copy constructor and assignment
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+
+	// reserves memory for the given requirements from a memory type;
+	// requests that exceed the largest size class fall back to a dedicated allocation,
+	// scratch requests that don't fit into the scratch block fall back to a regular arena allocation
+	MemoryAllocation allocate(const VkMemoryRequirements& requirements, uint32_t type_index, MemoryAllocationMode mode = MemoryAllocationMode::ARENA_ALLOCATION) {
+		if (type_index >= memory_properties.memoryTypeCount) {
+			Log::error("in method MemoryArena::allocate(): invalid memory type index ", type_index);
+		}
+		VkDeviceSize alignment = std::max(requirements.alignment, VkDeviceSize(1));
+		if (is_host_visible(type_index)) {
+			// keep ranges on separate atoms in order to allow flushing/invalidating non-coherent memory per buffer
+			alignment = std::max(alignment, non_coherent_atom_size);
+		}
+
+		std::lock_guard<std::mutex> lock(mtx);
+
+		// bump allocation from the scratch block of the memory type
+		if (mode == MemoryAllocationMode::SCRATCH_ALLOCATION) {
+			Block*& block = scratch_blocks[type_index];
+			if (block == nullptr) {
+				block = create_block(type_index, scratch_block_size);
+			}
+			VkDeviceSize offset = align_up(block->used, alignment);
+			VkDeviceSize size = align_up(requirements.size, alignment);
+			if (offset + size <= block->size) {
+				block->used = offset + size;
+				block->live++;
+				return make_allocation(block, offset, size, 0, mode);
+			}
+			mode = MemoryAllocationMode::ARENA_ALLOCATION;
+		}
+
+		// size class allocation
+		uint32_t size_class = get_size_class(requirements.size);
+		if (mode == MemoryAllocationMode::ARENA_ALLOCATION && size_class <= max_size_class) {
+			VkDeviceSize class_size = min_class_size << size_class;
+
+			// reuse a previously freed range with sufficient alignment
+			std::vector<Slot>& slots = free_slots[slot_key(type_index, size_class)];
+			for (size_t i = slots.size(); i-- > 0;) {
+				if (slots[i].offset % alignment == 0) {
+					Slot slot = slots[i];
+					slots.erase(slots.begin() + i);
+					slot.block->live++;
+					return make_allocation(slot.block, slot.offset, class_size, size_class, mode);
+				}
+			}
+
+			// carve a new range from the current block of the memory type
+			Block*& block = current_blocks[type_index];
+			VkDeviceSize offset = block != nullptr ? align_up(block->used, alignment) : 0;
+			if (block == nullptr || offset + class_size > block->size) {
+				block = create_block(type_index, block_size);
+				offset = 0;
+			}
+			block->used = offset + class_size;
+			block->live++;
+			return make_allocation(block, offset, class_size, size_class, mode);
+		}
+
+		// dedicated allocation
+		VkMemoryAllocateInfo allocate_info = {};
+		allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocate_info.allocationSize = requirements.size;
+		allocate_info.memoryTypeIndex = type_index;
+		MemoryAllocation allocation = {};
+		VkResult result = vkAllocateMemory(logical, &allocate_info, nullptr, &allocation.memory);
+		if (result != VK_SUCCESS) {
+			Log::error("in method MemoryArena::allocate(): failed to allocate dedicated memory (", requirements.size, " bytes), VkResult=", result);
+		}
+		allocation.size = requirements.size;
+		allocation.type_index = type_index;
+		allocation.mode = MemoryAllocationMode::DEDICATED_ALLOCATION;
+		dedicated_allocations++;
+		return allocation;
+	}
+
+	// returns a range to the arena (or frees the memory of a dedicated allocation)
+	void free(const MemoryAllocation& allocation) {
+		if (allocation.memory == VK_NULL_HANDLE) { return; }
+		std::lock_guard<std::mutex> lock(mtx);
+		if (allocation.mode == MemoryAllocationMode::DEDICATED_ALLOCATION) {
+			vkFreeMemory(logical, allocation.memory, nullptr);
+			dedicated_allocations--;
+			return;
+		}
+		auto entry = block_lookup.find(allocation.memory);
+		if (entry == block_lookup.end()) {
+			Log::warning("in method MemoryArena::free(): memory handle ", allocation.memory, " doesn't belong to this arena");
+			return;
+		}
+		Block* block = entry->second;
+		block->live--;
+		if (allocation.mode == MemoryAllocationMode::SCRATCH_ALLOCATION) {
+			if (block->live == 0) {
+				block->used = 0; // rewind the bump allocator
+			}
+			return;
+		}
+		free_slots[slot_key(allocation.type_index, allocation.size_class)].push_back({ block, allocation.offset });
+	}
+
+	// releases all blocks that currently have no live allocations
+	void trim() {
+		std::lock_guard<std::mutex> lock(mtx);
+		for (auto& entry : free_slots) {
+			std::vector<Slot>& slots = entry.second;
+			slots.erase(std::remove_if(slots.begin(), slots.end(), [](const Slot& slot) { return slot.block->live == 0; }), slots.end());
+		}
+		for (auto& entry : current_blocks) {
+			if (entry.second != nullptr && entry.second->live == 0) { entry.second = nullptr; }
+		}
+		for (auto& entry : scratch_blocks) {
+			if (entry.second != nullptr && entry.second->live == 0) { entry.second = nullptr; }
+		}
+		for (size_t i = blocks.size(); i-- > 0;) {
+			if (blocks[i]->live == 0) {
+				release_block(blocks[i]);
+				blocks.erase(blocks.begin() + i);
+			}
+		}
+	}
+
+	// getters
+	VkDevice get_logical() const { return logical; }
+	size_t get_block_count() const { return blocks.size(); }
+	size_t get_dedicated_allocation_count() const { return dedicated_allocations; }
+	VkDeviceSize get_block_size() const { return block_size; }
+	VkDeviceSize get_scratch_block_size() const { return scratch_block_size; }
+	VkDeviceSize get_reserved_bytes() const {
+		VkDeviceSize total = 0;
+		for (const Block* block : blocks) { total += block->size; }
+		return total;
+	}
+	size_t get_live_allocations() const {
+		size_t total = 0;
+		for (const Block* block : blocks) { total += block->live; }
+		return total + dedicated_allocations;
+	}
+
+	// returns the first arena that has been created for the process (or nullptr)
+	static MemoryArena* get_shared() { return shared; }
+
+	// returns the first arena that has been created for the given logical device (or nullptr)
+	static MemoryArena* get_shared(VkDevice logical) {
+		std::lock_guard<std::mutex> lock(registry_mtx);
+		auto it = registry.find(logical);
+		return it != registry.end() ? it->second : nullptr;
+	}
+
+private:
+	struct Block {
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		VkDeviceSize used = 0;   // bump offset for carving new ranges
+		void* mapped = nullptr;
+		uint32_t type_index = 0;
+		uint32_t live = 0;       // number of live allocations within the block
+	};
+
+	struct Slot {
+		Block* block;
+		VkDeviceSize offset;
+	};
+
+	Block* create_block(uint32_t type_index, VkDeviceSize size) {
+		VkMemoryAllocateInfo allocate_info = {};
+		allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocate_info.allocationSize = size;
+		allocate_info.memoryTypeIndex = type_index;
+		Block* block = new Block;
+		VkResult result = vkAllocateMemory(logical, &allocate_info, nullptr, &block->memory);
+		if (result != VK_SUCCESS) {
+			delete block;
+			Log::error("in method MemoryArena::create_block(): failed to allocate memory block (", size, " bytes, memory type ", type_index, "), VkResult=", result);
+		}
+		block->size = size;
+		block->type_index = type_index;
+		if (is_host_visible(type_index)) {
+			result = vkMapMemory(logical, block->memory, 0, VK_WHOLE_SIZE, VkMemoryMapFlags(0), &block->mapped);
+			if (result != VK_SUCCESS) {
+				Log::error("in method MemoryArena::create_block(): failed to map memory block, VkResult=", result);
+			}
+		}
+		blocks.push_back(block);
+		block_lookup[block->memory] = block;
+		LOG_DEBUG("memory arena: allocated new block (memory handle: ", block->memory, ", size: ", size, " bytes, memory type: ", type_index, ")");
+		return block;
+	}
+
+	void release_block(Block* block) {
+		if (block->mapped != nullptr) {
+			vkUnmapMemory(logical, block->memory);
+		}
+		vkFreeMemory(logical, block->memory, nullptr);
+		block_lookup.erase(block->memory);
+		delete block;
+	}
+
+	MemoryAllocation make_allocation(Block* block, VkDeviceSize offset, VkDeviceSize size, uint32_t size_class, MemoryAllocationMode mode) const {
+		MemoryAllocation allocation = {};
+		allocation.memory = block->memory;
+		allocation.offset = offset;
+		allocation.size = size;
+		allocation.mapped = block->mapped != nullptr ? static_cast<char*>(block->mapped) + offset : nullptr;
+		allocation.type_index = block->type_index;
+		allocation.size_class = size_class;
+		allocation.mode = mode;
+		return allocation;
+	}
+
+	uint32_t get_size_class(VkDeviceSize size) const {
+		uint32_t size_class = 0;
+		while ((min_class_size << size_class) < size) {
+			size_class++;
+		}
+		return size_class;
+	}
+
+	bool is_host_visible(uint32_t type_index) const {
+		return memory_properties.memoryTypes[type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+	}
+
+	static VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	static uint64_t slot_key(uint32_t type_index, uint32_t size_class) {
+		return (uint64_t(type_index) << 32) | size_class;
+	}
+
+	static constexpr VkDeviceSize min_class_size = 256;
+	VkDevice logical = nullptr;
+	VkPhysicalDeviceMemoryProperties memory_properties = {};
+	VkDeviceSize non_coherent_atom_size = 1;
+	VkDeviceSize block_size = 0;
+	VkDeviceSize scratch_block_size = 0;
+	uint32_t max_size_class = 0;
+	size_t dedicated_allocations = 0;
+	std::vector<Block*> blocks;
+	std::map<VkDeviceMemory, Block*> block_lookup;
+	std::map<uint32_t, Block*> current_blocks;   // block that new ranges are carved from, per memory type
+	std::map<uint32_t, Block*> scratch_blocks;   // bump allocator block, per memory type
+	std::map<uint64_t, std::vector<Slot>> free_slots;
+	std::mutex mtx;
+	static MemoryArena* shared;
+	static std::map<VkDevice, MemoryArena*> registry; // first arena per logical device
+	static std::mutex registry_mtx;
+};
+
 template<typename T>
 class Buffer {
 public:
 	Buffer() = delete;  // non-parametric buffer construction not allowed;
 	// all buffers must be created with a specific size and usage
 
-	Buffer(Device& device, BufferUsage usage, uint32_t elements, VkMemoryPropertyFlags memory_property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+	// (if more than one queue family index is specified, the buffer is created for concurrent access by these queue families,
+	// e.g. for compute + transfer queue access of a device-local buffer without explicit ownership transfers;
+	// by default the memory is sub-allocated from the shared MemoryArena, if one exists for the device;
+	// SPARSE_RESIDENCY creates a device-local buffer without memory, its pages get bound with bind_pages())
+	Buffer(Device& device, BufferUsage usage, uint32_t elements, VkMemoryPropertyFlags memory_property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, const std::vector<uint32_t>& queue_family_indices = {}, MemoryAllocationMode allocation_mode = MemoryAllocationMode::ARENA_ALLOCATION) {
 		this->logical = device.get_logical();
 		this->physical = device.get_physical();
 		this->memory_property_flags = memory_property_flags;
@@ -2359,28 +2892,42 @@ public:
 
 		is_device_local_only = (memory_property_flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) && !(memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 		is_host_visible = memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		non_coherent_atom_size = std::max(VkDeviceSize(1), device.get_properties().limits.nonCoherentAtomSize);
 
 		// translate BufferUsage enum argument
 		VkBufferUsageFlags vk_buffer_usage;
 		switch (usage) {
 		case BufferUsage::VERTEX_BUFFER:   vk_buffer_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT; break;
 		case BufferUsage::INDEX_BUFFER:    vk_buffer_usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT; break;
-		case BufferUsage::STORAGE_BUFFER:  vk_buffer_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; break;
+		case BufferUsage::STORAGE_BUFFER:  vk_buffer_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT; break; // transfer usage required for staging
 		case BufferUsage::UNIFORM_BUFFER:  vk_buffer_usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT; break;
 		case BufferUsage::TRANSFER_BUFFER: vk_buffer_usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT; break;
 		default: Log::error("in method Buffer::Buffer(): invalid BufferUsage argument: ", usage);
 		}
 
+		const bool sparse = allocation_mode == MemoryAllocationMode::SPARSE_RESIDENCY;
+		if (sparse && (!device.supports_sparse_residency() || is_host_visible)) {
+			Log::error("in Buffer::Buffer() constructor: sparse residency requires device support (see Device::supports_sparse_residency()) and device-local memory");
+		}
+
 		// create buffer
 		VkBufferCreateInfo buffer_create_info = {};
 		buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		buffer_create_info.flags = sparse ? VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT : 0;
 		buffer_create_info.size = size_bytes;
 		buffer_create_info.usage = vk_buffer_usage;
-		buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Assuming exclusive access for simplicity
+		if (queue_family_indices.size() > 1) {
+			buffer_create_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			buffer_create_info.queueFamilyIndexCount = static_cast<uint32_t>(queue_family_indices.size());
+			buffer_create_info.pQueueFamilyIndices = queue_family_indices.data();
+		}
+		else {
+			buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		}
 
 		VkResult result = vkCreateBuffer(logical, &buffer_create_info, nullptr, &buffer);
 		if (result == VK_SUCCESS) {
-			Log::info("data buffer successfully created (handle: ", buffer, ")");
+			LOG_INFO("data buffer successfully created (handle: ", buffer, ")");
 		}
 		else {
 			Log::error("failed to create data buffer, VkResult=", result);
@@ -2392,31 +2939,63 @@ public:
 
 		// find suitable memory type index
 		uint32_t type_index = UINT32_MAX;
-		Log::info("in Buffer::Buffer() constructor: searching for buffer memory types (requested: ", memory_property_flags, ")");
+		LOG_INFO("in Buffer::Buffer() constructor: searching for buffer memory types (requested: ", memory_property_flags, ")");
 		const auto& mem_properties = device.get_memory_properties();
 		for (uint32_t i = 0; i < mem_properties.memoryTypeCount; i++) {
-			Log::debug("memory type ", i, ": ", mem_properties.memoryTypes[i].propertyFlags);
+			LOG_DEBUG("memory type ", i, ": ", mem_properties.memoryTypes[i].propertyFlags);
 			if ((memory_requirements.memoryTypeBits & (1 << i)) && (mem_properties.memoryTypes[i].propertyFlags & memory_property_flags) == memory_property_flags) {
 				type_index = i;
-				Log::info("[SUCCESS]");
+				LOG_INFO("[SUCCESS]");
 			}
 		}
 		if (type_index == UINT32_MAX) {
 			Log::warning("in Buffer::Buffer() constructor:: no suitable memory type found");
 		}
+		else {
+			is_host_coherent = mem_properties.memoryTypes[type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		}
 
-		// allocate memory
-		VkMemoryAllocateInfo allocate_info = {};
-		allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocate_info.allocationSize = memory_requirements.size;
-		allocate_info.memoryTypeIndex = type_index;
-		result = vkAllocateMemory(logical, &allocate_info, nullptr, &memory);
-		if (result != VK_SUCCESS) {
-			Log::error("in Buffer::Buffer() constructor: failed to allocate buffer memory, VkResult=", result);
+		// sparse buffers: the memory requirements (alignment = page size) are kept for binding pages later
+		MemoryArena* shared_arena = MemoryArena::get_shared(logical);
+		if (sparse) {
+			this->sparse_requirements = memory_requirements;
+			this->allocation.type_index = type_index;
+			this->allocation.mode = MemoryAllocationMode::SPARSE_RESIDENCY;
+			this->arena = shared_arena; // (for the page allocations)
+			return;
+		}
+
+		// allocate memory (sub-allocation from the shared arena or dedicated allocation)
+		if (allocation_mode != MemoryAllocationMode::DEDICATED_ALLOCATION && shared_arena != nullptr && shared_arena->get_logical() == logical) {
+			this->arena = shared_arena;
+			this->allocation = arena->allocate(memory_requirements, type_index, allocation_mode);
+		}
+		else {
+			VkMemoryAllocateInfo allocate_info = {};
+			allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocate_info.allocationSize = memory_requirements.size;
+			allocate_info.memoryTypeIndex = type_index;
+			result = vkAllocateMemory(logical, &allocate_info, nullptr, &allocation.memory);
+			if (result != VK_SUCCESS) {
+				Log::error("in Buffer::Buffer() constructor: failed to allocate buffer memory, VkResult=", result);
+			}
+			allocation.size = memory_requirements.size;
+			allocation.type_index = type_index;
+		}
+		this->memory = allocation.memory;
+
+		// host-visible memory stays mapped for the lifetime of the buffer
+		// (sub-allocations are already mapped persistently by the arena)
+		if (is_host_visible && allocation.mapped == nullptr) {
+			result = vkMapMemory(logical, memory, 0, VK_WHOLE_SIZE, VkMemoryMapFlags(0), &allocation.mapped);
+			if (result != VK_SUCCESS) {
+				Log::error("in Buffer::Buffer() constructor: failed to map buffer memory, VkResult=", result);
+			}
+			owns_mapping = true;
 		}
 
 		// bind memory to buffer
-		result = vkBindBufferMemory(logical, buffer, memory, 0);
+		result = vkBindBufferMemory(logical, buffer, memory, allocation.offset);
 		if (result != VK_SUCCESS) {
 			Log::error("in Buffer::Buffer() constructor: failed to bind buffer memory, VkResult=", result);
 		}
@@ -2431,11 +3010,18 @@ public:
 		this->size_bytes = other.size_bytes;
 		this->buffer = other.buffer;
 		this->memory = other.memory;
+		this->allocation = other.allocation;
+		this->arena = other.arena;
+		this->owns_mapping = other.owns_mapping;
 		this->is_device_local_only = other.is_device_local_only;
 		this->is_host_visible = other.is_host_visible;
+		this->is_host_coherent = other.is_host_coherent;
+		this->non_coherent_atom_size = other.non_coherent_atom_size;
 		this->memory_property_flags = other.memory_property_flags;
+		this->sparse_requirements = other.sparse_requirements;
+		this->pages = other.pages;
 		if (buffer != VK_NULL_HANDLE) {
-			Log::debug("buffer copied, handle: ", buffer);
+			LOG_DEBUG("buffer copied, handle: ", buffer);
 		}
 	}
 
@@ -2444,10 +3030,9 @@ public:
 		if (this != &other) {
 			// release existing resources owned by 'this' object
 			if (buffer != VK_NULL_HANDLE) {
-				vkFreeMemory(logical, memory, nullptr);
-				memory = VK_NULL_HANDLE;
 				vkDestroyBuffer(logical, buffer, nullptr);
 				buffer = VK_NULL_HANDLE;
+				release_memory();
 			}
 			// copy the data from 'other' to 'this'
 			this->logical = other.logical;
@@ -2456,11 +3041,18 @@ public:
 			this->size_bytes = other.size_bytes;
 			this->buffer = other.buffer;
 			this->memory = other.memory;
+			this->allocation = other.allocation;
+			this->arena = other.arena;
+			this->owns_mapping = other.owns_mapping;
 			this->is_device_local_only = other.is_device_local_only;
 			this->is_host_visible = other.is_host_visible;
+			this->is_host_coherent = other.is_host_coherent;
+			this->non_coherent_atom_size = other.non_coherent_atom_size;
 			this->memory_property_flags = other.memory_property_flags;
+			this->sparse_requirements = other.sparse_requirements;
+			this->pages = other.pages;
 			if (buffer != VK_NULL_HANDLE) {
-				Log::debug("buffer copied, handle: ", buffer);
+				LOG_DEBUG("buffer copied, handle: ", buffer);
 			}
 		}
 		return *this;
@@ -2470,20 +3062,32 @@ public:
 	Buffer(Buffer<T>&& other) noexcept
 		: buffer(other.buffer),
 		memory(other.memory),
+		allocation(other.allocation),
+		arena(other.arena),
+		owns_mapping(other.owns_mapping),
 		elements(other.elements),
 		logical(other.logical),
 		physical(other.physical),
 		size_bytes(other.size_bytes),
 		is_device_local_only(other.is_device_local_only),
 		is_host_visible(other.is_host_visible),
-		memory_property_flags(other.memory_property_flags) {
+		is_host_coherent(other.is_host_coherent),
+		non_coherent_atom_size(other.non_coherent_atom_size),
+		memory_property_flags(other.memory_property_flags),
+		sparse_requirements(other.sparse_requirements),
+		pages(std::move(other.pages)) {
 		// Invalidate the source object ('other') so its destructor doesn't release the resources
-		delete other.buffer;
+		other.pages.clear();
+		other.buffer = VK_NULL_HANDLE;
+		other.memory = VK_NULL_HANDLE;
+		other.allocation = {};
+		other.arena = nullptr;
+		other.owns_mapping = false;
 		other.elements = 0;
 		other.size_bytes = 0;
 
 		if (buffer != VK_NULL_HANDLE) {
-			Log::info("Buffer moved (new owner), handle: ", buffer);
+			LOG_INFO("Buffer moved (new owner), handle: ", buffer);
 		}
 	}
 
@@ -2491,33 +3095,42 @@ public:
 	Buffer& operator=(Buffer<T>&& other) noexcept {
 		if (this != &other) { // Prevent self-assignment
 			// 1. Release existing resources owned by 'this' object
-			if (memory != VK_NULL_HANDLE && memory != VkDeviceMemory(0xdddddddddddddddd)) {
-				Log::debug("in Buffer<T> move assignment: freeing previous buffer memory (memory handle: ", memory, ")");
-				vkFreeMemory(logical, memory, nullptr);
-			}
 			if (buffer != VK_NULL_HANDLE && buffer != VkBuffer(0xdddddddddddddddd)) {
-				Log::debug("in Buffer<T> move assignment: destroying previous buffer (buffer handle: ", buffer, ")");
+				LOG_DEBUG("in Buffer<T> move assignment: destroying previous buffer (buffer handle: ", buffer, ")");
 				vkDestroyBuffer(logical, buffer, nullptr);
 			}
+			release_memory();
 
 			// 2. Transfer ownership of resources from 'other' to 'this'
 			buffer = other.buffer;
 			memory = other.memory;
+			allocation = other.allocation;
+			arena = other.arena;
+			owns_mapping = other.owns_mapping;
 			elements = other.elements;
 			logical = other.logical;       // Transfer device handles
 			physical = other.physical;
 			size_bytes = other.size_bytes;
 			is_device_local_only = other.is_device_local_only;
 			is_host_visible = other.is_host_visible;
+			is_host_coherent = other.is_host_coherent;
+			non_coherent_atom_size = other.non_coherent_atom_size;
 			memory_property_flags = other.memory_property_flags;
+			sparse_requirements = other.sparse_requirements;
+			pages = std::move(other.pages);
 
 			// 3. Invalidate the source object ('other')
-			delete other.buffer;
+			other.pages.clear();
+			other.buffer = VK_NULL_HANDLE;
+			other.memory = VK_NULL_HANDLE;
+			other.allocation = {};
+			other.arena = nullptr;
+			other.owns_mapping = false;
 			other.elements = 0;
 			other.size_bytes = 0;
 
 			if (buffer != VK_NULL_HANDLE) {
-				Log::info("Buffer move assigned (new owner), handle: ", buffer);
+				LOG_INFO("Buffer move assigned (new owner), handle: ", buffer);
 			}
 		}
 		return *this;
@@ -2543,13 +3156,12 @@ public:
 			vector_size_bytes = (this->size_bytes > target_offset_bytes) ? this->size_bytes - target_offset_bytes : 0;
 		}
 		if (vector_size_bytes == 0) {
-			Log::debug("in Buffer<T>::write(): requested copy region has size ", vector_size_bytes, " bytes, i.e.nothing to copy");
+			LOG_DEBUG("in Buffer<T>::write(): requested copy region has size ", vector_size_bytes, " bytes, i.e.nothing to copy");
 			return;
 		}
-		void* data;
-		vkMapMemory(logical, memory, target_offset_bytes, vector_size_bytes, VkMemoryMapFlags(0), &data);
+		void* data = map_memory(target_offset_bytes, vector_size_bytes);
 		memcpy(data, source_vector.data() + source_offset_elements, vector_size_bytes);
-		vkUnmapMemory(logical, memory);
+		commit_memory(target_offset_bytes, vector_size_bytes);
 	}
 
 	// copy data elements from a std::array to a host visible buffer
@@ -2564,13 +3176,12 @@ public:
 			array_size_bytes = (this->size_bytes > target_offset_bytes) ? this->size_bytes - target_offset_bytes : 0;
 		}
 		if (array_size_bytes <= 0) {
-			Log::debug("in Buffer<T>::write(): requested copy region has size ", array_size_bytes, " bytes, i.e.nothing to copy");
+			LOG_DEBUG("in Buffer<T>::write(): requested copy region has size ", array_size_bytes, " bytes, i.e.nothing to copy");
 			return;
 		}
-		void* data;
-		vkMapMemory(logical, memory, target_offset_bytes, array_size_bytes, VkMemoryMapFlags(0), &data);
+		void* data = map_memory(target_offset_bytes, array_size_bytes);
 		memcpy(data, source_array + source_offset_elements, array_size_bytes);
-		vkUnmapMemory(logical, memory);
+		commit_memory(target_offset_bytes, array_size_bytes);
 	}
 
 	// copy data elements from a std::initializer_list to a host visible buffer
@@ -2585,13 +3196,12 @@ public:
 			list_size_bytes = (this->size_bytes > target_offset_bytes) ? this->size_bytes - target_offset_bytes : 0;
 		}
 		if (list_size_bytes <= 0) {
-			Log::debug("in Buffer<T>::write(): requested copy region has size ", list_size_bytes, " bytes, i.e.nothing to copy");
+			LOG_DEBUG("in Buffer<T>::write(): requested copy region has size ", list_size_bytes, " bytes, i.e.nothing to copy");
 			return;
 		}
-		void* data;
-		vkMapMemory(logical, memory, target_offset_bytes, list_size_bytes, VkMemoryMapFlags(0), &data);
+		void* data = map_memory(target_offset_bytes, list_size_bytes);
 		memcpy(data, list.begin(), list_size_bytes);
-		vkUnmapMemory(logical, memory);
+		commit_memory(target_offset_bytes, list_size_bytes);
 	}
 
 	// copy data elements from one host visible buffer to another
@@ -2616,45 +3226,34 @@ public:
 			source_size_bytes = (this->size_bytes > target_offset_bytes) ? this->size_bytes - target_offset_bytes : 0;
 		}
 		if (source_size_bytes == 0) {
-			Log::debug("in Buffer<T>::write(): requested copy region has size 0, i.e. nothing to copy");
+			LOG_DEBUG("in Buffer<T>::write(): requested copy region has size 0, i.e. nothing to copy");
 			return;
 		}
-		void* source = nullptr;
-		void* target = nullptr;
-		vkMapMemory(logical, sourcebuffer.memory, source_offset_bytes, source_size_bytes, VkMemoryMapFlags(0), &source);
-		vkMapMemory(logical, this->memory, target_offset_bytes, source_size_bytes, VkMemoryMapFlags(0), &target);
+		void* source = sourcebuffer.map_memory(source_offset_bytes, source_size_bytes);
+		void* target = this->map_memory(target_offset_bytes, source_size_bytes);
 		memcpy(target, source, source_size_bytes);
-		vkUnmapMemory(logical, this->memory);
-		vkUnmapMemory(logical, sourcebuffer.memory);
+		this->commit_memory(target_offset_bytes, source_size_bytes);
 	}
 
 	// flush host writes to host memory demain
 	// this is only necessary if the memory allocation doesn't have the flag VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-	// (can be made available to the device memory domain by using a pipeline barrier with the VK_ACCESS_HOST_WRITE_BIT access type flag)
-	void flush(uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE) {
-		void* source = nullptr;
-		vkMapMemory(logical, this->memory, offset, size, VkMemoryMapFlags(0), &source);
-
-		VkMappedMemoryRange range;
-		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		range.pNext = NULL;
-		range.memory = this->memory;
-		range.offset = offset;
-		range.size = size;
-
-		VkResult result = vkFlushMappedMemoryRanges(this->logical, 1, &range);
-		if (result != VK_SUCCESS) {
-			if (result == VK_ERROR_OUT_OF_HOST_MEMORY) {
-				Log::warning("Buffer<T>::flush() failed: out of host memory !");
-			}
-			else if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY) {
-				Log::warning("Buffer<T>::flush() failed: out of device memory !");
-			}
-		}
+	// (can be made available to the device memory domain by using a pipeline barrier with the VK_ACCESS_HOST_WRITE_BIT access type flag);
+	// offset and size are in bytes and get extended to multiples of nonCoherentAtomSize
+	void flush(uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE) const {
+		sync_range(offset, size, true);
+	}
 
-		vkUnmapMemory(logical, this->memory);
+	// invalidate a range of host memory, making device writes visible to the host
+	// (only necessary if the memory allocation doesn't have the flag VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+	void invalidate(uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE) const {
+		sync_range(offset, size, false);
 	}
 
+	// returns a pointer to the persistently mapped buffer memory (nullptr if not host-visible);
+	// for non-coherent memory, use invalidate() before reading and flush() after writing
+	T* data() { return static_cast<T*>(allocation.mapped); }
+	const T* data() const { return static_cast<const T*>(allocation.mapped); }
+
 	// returns a continous data sequence from a host visible data buffer as a std::vector<T>
 	// (set read_elements to 0 to read all)
 	std::vector<T> read(uint32_t read_elements = 0, uint32_t source_offset_elements = 0) {
@@ -2677,13 +3276,11 @@ public:
 		VkDeviceSize source_offset_bytes = source_offset_elements * sizeof(T);
 		std::vector<T> result(source_elements);
 		if (source_size_bytes == 0) {
-			Log::debug("in Buffer<T>::read(): requested region has size 0; returning an empty vector");
+			LOG_DEBUG("in Buffer<T>::read(): requested region has size 0; returning an empty vector");
 			return result;
 		}
-		void* data;
-		vkMapMemory(logical, memory, source_offset_bytes, source_size_bytes, VkMemoryMapFlags(0), &data);
+		void* data = map_memory(source_offset_bytes, source_size_bytes);
 		memcpy(result.data(), data, source_size_bytes);
-		vkUnmapMemory(logical, memory);
 		return result;
 	}
 
@@ -2695,14 +3292,9 @@ public:
 		if (element_index >= this->elements) {
 			Log::error("in method Buffer::get(): element index ", element_index, " is out of bounds (allowed indices: 0-", this->elements - 1, ")");
 		}
-		void* data = nullptr;
 		T element = static_cast<T>(0);
-		VkResult result = vkMapMemory(logical, memory, element_index * sizeof(T), sizeof(T), VkMemoryMapFlags(0), &data);
-		if (result != VK_SUCCESS) {
-			Log::error("in method Buffer<T>::get(uint32_t element_index): failed to map buffer memory (VkResult = ", result, ")");
-		}
+		void* data = map_memory(element_index * sizeof(T), sizeof(T));
 		memcpy(&element, data, sizeof(T));
-		vkUnmapMemory(logical, memory);
 		return element;
 	}
 
@@ -2714,13 +3306,9 @@ public:
 		if (element_index >= this->elements) {
 			Log::error("in method Buffer::set(): element index ", element_index, " is out of bounds (allowed indices: 0-", this->elements - 1, ")");
 		}
-		void* data = nullptr;
-		VkResult result = vkMapMemory(logical, memory, element_index * sizeof(T), sizeof(T), VkMemoryMapFlags(0), &data);
-		if (result != VK_SUCCESS) {
-			Log::error("in method Buffer<T>::set(uint32_t element_index, T value): failed to map buffer memory (VkResult = ", result, ")");
-		}
+		void* data = map_memory(element_index * sizeof(T), sizeof(T));
 		memcpy(data, &value, sizeof(T));
-		vkUnmapMemory(logical, memory);
+		commit_memory(element_index * sizeof(T), sizeof(T));
 	}
 
 	// assigns the same value to continous sequence of buffer elements
@@ -2740,13 +3328,77 @@ public:
 		}
 		VkDeviceSize offset_bytes = offset_elements * element_size;
 		VkDeviceSize write_bytes = write_elements == 0 ? (this->elements - offset_elements) * element_size : write_elements * element_size;
-		void* data;
-		vkMapMemory(logical, memory, offset_bytes, write_bytes, VkMemoryMapFlags(0), &data);
+		void* data = map_memory(offset_bytes, write_bytes);
 		for (size_t offset = 0; offset < write_bytes; offset += element_size) {
-			memcpy((T*)data + offset, &value, element_size);
+			memcpy(static_cast<char*>(data) + offset, &value, element_size);
+		}
+		commit_memory(offset_bytes, write_bytes);
+	}
+
+	// binds device memory to the pages of a sparse buffer that overlap the given byte ranges (offset, size) (resident pages are kept);
+	// all bindings are submitted to the compute queue at once and waited for; returns the number of newly bound pages
+	uint32_t bind_pages(const Device& device, const std::vector<std::pair<VkDeviceSize, VkDeviceSize>>& ranges) {
+		if (!is_sparse()) {
+			Log::error("method Buffer<T>::bind_pages() called on a buffer without sparse residency (handle: ", buffer, ")");
+		}
+		std::vector<VkSparseMemoryBind> binds;
+		for (const auto& [offset_bytes, range_bytes] : ranges) {
+			for (VkDeviceSize page = offset_bytes / get_page_size(); page < end_page(offset_bytes, range_bytes); page++) {
+				if (pages.count(page) != 0) { continue; }
+				MemoryAllocation page_allocation = allocate_page();
+				pages[page] = page_allocation;
+				VkSparseMemoryBind bind = {};
+				bind.resourceOffset = page * get_page_size();
+				bind.size = get_page_size();
+				bind.memory = page_allocation.memory;
+				bind.memoryOffset = page_allocation.offset;
+				binds.push_back(bind);
+			}
+		}
+		submit_binds(device, binds);
+		return static_cast<uint32_t>(binds.size());
+	}
+	uint32_t bind_pages(const Device& device, VkDeviceSize offset_bytes, VkDeviceSize range_bytes) {
+		return bind_pages(device, { { offset_bytes, range_bytes } });
+	}
+
+	// unbinds the pages of a sparse buffer that overlap the given byte ranges and releases their memory;
+	// the caller has to make sure that the device doesn't access these pages anymore; returns the number of released pages
+	uint32_t unbind_pages(const Device& device, const std::vector<std::pair<VkDeviceSize, VkDeviceSize>>& ranges) {
+		if (!is_sparse()) {
+			Log::error("method Buffer<T>::unbind_pages() called on a buffer without sparse residency (handle: ", buffer, ")");
+		}
+		std::vector<VkSparseMemoryBind> binds;
+		std::vector<MemoryAllocation> released;
+		for (const auto& [offset_bytes, range_bytes] : ranges) {
+			for (VkDeviceSize page = offset_bytes / get_page_size(); page < end_page(offset_bytes, range_bytes); page++) {
+				auto it = pages.find(page);
+				if (it == pages.end()) { continue; }
+				VkSparseMemoryBind bind = {};
+				bind.resourceOffset = page * get_page_size();
+				bind.size = get_page_size();
+				bind.memory = VK_NULL_HANDLE;
+				binds.push_back(bind);
+				released.push_back(it->second);
+				pages.erase(it);
+			}
+		}
+		submit_binds(device, binds);
+		for (const MemoryAllocation& page_allocation : released) {
+			free_page(page_allocation);
 		}
-		vkUnmapMemory(logical, memory);
+		return static_cast<uint32_t>(released.size());
 	}
+	uint32_t unbind_pages(const Device& device, VkDeviceSize offset_bytes, VkDeviceSize range_bytes) {
+		return unbind_pages(device, { { offset_bytes, range_bytes } });
+	}
+
+	// sparse residency getters (a buffer without sparse residency counts as fully resident)
+	bool is_sparse() const { return allocation.mode == MemoryAllocationMode::SPARSE_RESIDENCY; }
+	VkDeviceSize get_page_size() const { return sparse_requirements.alignment; }
+	uint32_t get_page_count() const { return is_sparse() ? static_cast<uint32_t>(sparse_requirements.size / get_page_size()) : 0; }
+	uint32_t get_resident_pages() const { return static_cast<uint32_t>(pages.size()); }
+	bool is_resident(VkDeviceSize offset_bytes) const { return !is_sparse() || pages.count(offset_bytes / get_page_size()) != 0; }
 
 	// getters
 	uint32_t get_elements() const { return this->elements; }
@@ -2754,24 +3406,163 @@ public:
 	VkDeviceMemory get_memory() const { return memory; }
 	VkBuffer get() const { return buffer; }
 	VkMemoryPropertyFlags get_memory_property_flags() const { return memory_property_flags; }
+	bool host_visible() const { return is_host_visible; }
+	bool host_coherent() const { return is_host_coherent; }
+	VkDeviceSize get_memory_offset() const { return allocation.offset; }
+	MemoryAllocationMode get_allocation_mode() const { return allocation.mode; }
 
 	// destructor
 	~Buffer() {
-		if (memory != VK_NULL_HANDLE && memory != VkDeviceMemory(0xdddddddddddddddd)) {
-			Log::debug("in Buffer<T> destructor: freeing buffer memory (memory handle: ", memory, ")");
-			vkFreeMemory(logical, memory, nullptr);
-			memory = VK_NULL_HANDLE;
-		}
 		if (buffer != VK_NULL_HANDLE && buffer != VkBuffer(0xdddddddddddddddd)) {
-			Log::debug("in Buffer<T> destructor: destroying buffer (buffer handle: ", buffer, ")");
+			LOG_DEBUG("in Buffer<T> destructor: destroying buffer (buffer handle: ", buffer, ")");
 			vkDestroyBuffer(logical, buffer, nullptr);
 			buffer = VK_NULL_HANDLE;
 		}
+		release_memory();
 	}
 
 protected:
+	// returns a host pointer to a byte range of the persistently mapped buffer memory (relative to the start of the buffer);
+	// for non-coherent memory, the range gets invalidated first in order to make device writes visible to the host
+	void* map_memory(VkDeviceSize offset_bytes, VkDeviceSize size_bytes) const {
+		if (allocation.mapped == nullptr) {
+			Log::error("in method Buffer<T>::map_memory(): buffer memory isn't mapped (handle: ", buffer, ")");
+		}
+		if (!is_host_coherent) {
+			sync_range(offset_bytes, size_bytes, false);
+		}
+		return static_cast<char*>(allocation.mapped) + offset_bytes;
+	}
+
+	// makes host writes to a byte range visible to the device (only required for non-coherent memory)
+	void commit_memory(VkDeviceSize offset_bytes, VkDeviceSize size_bytes) const {
+		if (!is_host_coherent) {
+			sync_range(offset_bytes, size_bytes, true);
+		}
+	}
+
+	// flushes or invalidates a byte range of mapped memory;
+	// the range gets extended to multiples of nonCoherentAtomSize (limited by the end of the allocation)
+	void sync_range(VkDeviceSize offset_bytes, VkDeviceSize size_bytes, bool flush_writes) const {
+		if (allocation.mapped == nullptr) { return; }
+		VkDeviceSize allocation_end = allocation.offset + allocation.size;
+		VkDeviceSize begin = allocation.offset + offset_bytes;
+		VkDeviceSize end = size_bytes == VK_WHOLE_SIZE ? allocation_end : begin + size_bytes;
+		begin = begin / non_coherent_atom_size * non_coherent_atom_size;
+		end = std::min((end + non_coherent_atom_size - 1) / non_coherent_atom_size * non_coherent_atom_size, allocation_end);
+
+		VkMappedMemoryRange range = {};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.pNext = NULL;
+		range.memory = this->memory;
+		range.offset = begin;
+		range.size = end - begin;
+
+		VkResult result = flush_writes ? vkFlushMappedMemoryRanges(logical, 1, &range) : vkInvalidateMappedMemoryRanges(logical, 1, &range);
+		if (result != VK_SUCCESS) {
+			if (result == VK_ERROR_OUT_OF_HOST_MEMORY) {
+				Log::warning("Buffer<T>::", flush_writes ? "flush" : "invalidate", "() failed: out of host memory !");
+			}
+			else if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY) {
+				Log::warning("Buffer<T>::", flush_writes ? "flush" : "invalidate", "() failed: out of device memory !");
+			}
+		}
+	}
+
+	// returns the memory to the arena or frees a dedicated allocation
+	// (if the arena has already been destroyed, its blocks have been released with it)
+	// index of the first page behind the given byte range (clipped to the buffer)
+	VkDeviceSize end_page(VkDeviceSize offset_bytes, VkDeviceSize range_bytes) const {
+		VkDeviceSize page_size = get_page_size();
+		return std::min(VkDeviceSize(get_page_count()), (offset_bytes + range_bytes + page_size - 1) / page_size);
+	}
+
+	// page memory is sub-allocated from the shared arena (or allocated separately if there's none)
+	MemoryAllocation allocate_page() {
+		VkMemoryRequirements page_requirements = sparse_requirements;
+		page_requirements.size = get_page_size();
+		if (arena != nullptr && arena == MemoryArena::get_shared(logical)) {
+			return arena->allocate(page_requirements, allocation.type_index);
+		}
+		VkMemoryAllocateInfo allocate_info = {};
+		allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocate_info.allocationSize = page_requirements.size;
+		allocate_info.memoryTypeIndex = allocation.type_index;
+		MemoryAllocation page_allocation = {};
+		VkResult result = vkAllocateMemory(logical, &allocate_info, nullptr, &page_allocation.memory);
+		if (result != VK_SUCCESS) {
+			Log::error("in method Buffer<T>::allocate_page(): failed to allocate page memory, VkResult=", result);
+		}
+		page_allocation.size = page_requirements.size;
+		page_allocation.type_index = allocation.type_index;
+		return page_allocation;
+	}
+
+	void free_page(const MemoryAllocation& page_allocation) {
+		if (arena != nullptr && arena == MemoryArena::get_shared(logical)) {
+			arena->free(page_allocation);
+		}
+		else if (page_allocation.mode == MemoryAllocationMode::DEDICATED_ALLOCATION) {
+			vkFreeMemory(logical, page_allocation.memory, nullptr);
+		}
+	}
+
+	// submits sparse memory (un)bindings for this buffer to the compute queue and waits for their completion
+	void submit_binds(const Device& device, const std::vector<VkSparseMemoryBind>& binds) const {
+		if (binds.empty()) { return; }
+		VkSparseBufferMemoryBindInfo buffer_bind = {};
+		buffer_bind.buffer = buffer;
+		buffer_bind.bindCount = static_cast<uint32_t>(binds.size());
+		buffer_bind.pBinds = binds.data();
+		VkBindSparseInfo bind_info = {};
+		bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+		bind_info.bufferBindCount = 1;
+		bind_info.pBufferBinds = &buffer_bind;
+		Fence fence(device);
+		VkResult result;
+		{
+			std::lock_guard<std::mutex> lock(device.get_queue_mutex(device.get_compute_queue()));
+			result = vkQueueBindSparse(device.get_compute_queue(), 1, &bind_info, fence.get());
+		}
+		if (result != VK_SUCCESS) {
+			Log::error("in method Buffer<T>::submit_binds(): vkQueueBindSparse failed, VkResult=", result);
+		}
+		fence.wait();
+		LOG_DEBUG("in Buffer<T>: submitted ", binds.size(), " sparse page binding(s) (buffer handle: ", buffer, ")");
+	}
+
+	// releases the memory of all resident pages of a sparse buffer (after the buffer has been destroyed)
+	void release_pages() {
+		for (const auto& entry : pages) {
+			free_page(entry.second);
+		}
+		pages.clear();
+	}
+
+	void release_memory() {
+		release_pages();
+		if (memory == VK_NULL_HANDLE || memory == VkDeviceMemory(0xdddddddddddddddd)) { return; }
+		LOG_DEBUG("in Buffer<T>: releasing buffer memory (memory handle: ", memory, ", offset: ", allocation.offset, ")");
+		if (owns_mapping) {
+			vkUnmapMemory(logical, memory);
+			owns_mapping = false;
+		}
+		if (arena != nullptr && arena == MemoryArena::get_shared(logical)) {
+			arena->free(allocation);
+		}
+		else if (allocation.mode == MemoryAllocationMode::DEDICATED_ALLOCATION) {
+			vkFreeMemory(logical, memory, nullptr);
+		}
+		memory = VK_NULL_HANDLE;
+		allocation = {};
+		arena = nullptr;
+	}
+
 	VkBuffer buffer = nullptr;
 	VkDeviceMemory memory = nullptr;
+	MemoryAllocation allocation = {};
+	MemoryArena* arena = nullptr;
+	bool owns_mapping = false;                  // true if the mapping has been created by the buffer (not by the arena)
 	uint32_t elements = 0;
 	VkDevice logical = nullptr;
 	VkPhysicalDevice physical = nullptr;
@@ -2779,6 +3570,10 @@ protected:
 	uint64_t size_bytes = 0;
 	bool is_device_local_only = false;
 	bool is_host_visible = false;
+	bool is_host_coherent = false;
+	VkDeviceSize non_coherent_atom_size = 1;
+	VkMemoryRequirements sparse_requirements = {};    // memory requirements of a sparse buffer (alignment = page size)
+	std::map<VkDeviceSize, MemoryAllocation> pages;   // memory of the resident pages of a sparse buffer, by page index
 };
 
 // Sampler class for texture sampling
@@ -2816,7 +3611,7 @@ public:
 	~Sampler() {
 		if (sampler != nullptr) {
 			vkDestroySampler(logical, sampler, nullptr);
-			Log::info("destroyed image sampler (handle: ", sampler, ")");
+			LOG_INFO("destroyed image sampler (handle: ", sampler, ")");
 			sampler = nullptr;
 		}
 	}
@@ -2827,35 +3622,50 @@ protected:
 	VkSamplerCreateInfo sampler_create_info = {};
 };
 
-// DescriptorSets hold binding information for shader resources
+// DescriptorSets hold binding information for shader resources;
+// on devices with VK_KHR_push_descriptor the bindings are pushed directly into the command buffer
+// by CommandBuffer::bind_descriptor_set() and no set is allocated from a descriptor pool
+// (pass allow_push_descriptors = false for sets that have to stay valid across re-recordings, e.g. with replace_image())
 class DescriptorSet {
 	friend class DescriptorPool;
 public:
 	// constructor
 	DescriptorSet() = delete;
-	DescriptorSet(const Device& device) {
+	DescriptorSet(const Device& device, bool allow_push_descriptors = true) {
 		this->logical = device.get_logical();
+		this->device = &device;
+		this->allow_push_descriptors = allow_push_descriptors;
 	}
 
 	// move constructor
 	DescriptorSet(DescriptorSet&& other) noexcept
 		: logical(std::exchange(other.logical, nullptr)),
-		layout(std::exchange(other.layout, nullptr)),
+		device(std::exchange(other.device, nullptr)),
+		layout_create_info(other.layout_create_info),
+		layout_bindings(std::move(other.layout_bindings)),
+		image_bindings(std::move(other.image_bindings)),
+		buffer_bindings(std::move(other.buffer_bindings)),
 		set(std::exchange(other.set, nullptr)),
+		layout(std::exchange(other.layout, nullptr)),
 		layout_finalized(other.layout_finalized),
-		layout_bindings(std::move(other.layout_bindings)),
-		image_bindings(std::move(other.image_bindings)) {
+		allow_push_descriptors(other.allow_push_descriptors),
+		push_descriptors(other.push_descriptors) {
 	}
 
 	// move assignment
 	DescriptorSet& operator=(DescriptorSet&& other) noexcept {
 		if (this != &other) {
 			logical = std::exchange(other.logical, nullptr);
+			device = std::exchange(other.device, nullptr);
 			layout = std::exchange(other.layout, nullptr);
 			set = std::exchange(other.set, nullptr);
 			layout_finalized = other.layout_finalized;
+			allow_push_descriptors = other.allow_push_descriptors;
+			push_descriptors = other.push_descriptors;
+			layout_create_info = other.layout_create_info;
 			layout_bindings = std::move(other.layout_bindings);
 			image_bindings = std::move(other.image_bindings);
+			buffer_bindings = std::move(other.buffer_bindings);
 		}
 		return *this;
 	}
@@ -2864,20 +3674,17 @@ public:
 	DescriptorSet(const DescriptorSet&) = delete;
 	DescriptorSet& operator=(const DescriptorSet&) = delete;
 
-	// finalizes the descriptor set layout and creates the descriptor set
+	// finalizes the descriptor set layout; layouts are shared by all sets with identical bindings
+	// and owned by the device (see Device::get_descriptor_set_layout())
 	void finalize_layout() {
+		push_descriptors = allow_push_descriptors && device->supports_push_descriptors()
+			&& layout_bindings.size() <= device->get_max_push_descriptors();
 		layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
 		layout_create_info.pNext = NULL;
-		layout_create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layout_create_info.flags = push_descriptors ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 		layout_create_info.pBindings = layout_bindings.data();
 		layout_create_info.bindingCount = static_cast<uint32_t>(layout_bindings.size());
-		VkResult result = vkCreateDescriptorSetLayout(logical, &layout_create_info, nullptr, &layout);
-		if (result == VK_SUCCESS) {
-			Log::info("descriptor set layout created (", layout_bindings.size(), " bindings, layout handle : ", layout, ")");
-		}
-		else {
-			Log::error("in method DescriptorPool::allocate_set(): failed to finalize descriptor set layout (VkResult ", result, ")");
-		}
+		layout = device->get_descriptor_set_layout(layout_bindings, layout_create_info.flags);
 		layout_finalized = true;
 	}
 
@@ -2895,7 +3702,7 @@ public:
 		layout_bindings[binding_index].stageFlags = shader_stage_flags;
 		layout_bindings[binding_index].pImmutableSamplers = nullptr;
 
-		Log::debug("binding buffer ", buffer.get(), " to descriptor set (handle: ", set, ") at binding index ", binding_index);
+		LOG_DEBUG("binding buffer ", buffer.get(), " to descriptor set (handle: ", set, ") at binding index ", binding_index);
 
 		// store the buffer information for updating the descriptor set later
 		BufferBindingInfo buffer_binding = {};
@@ -2903,16 +3710,13 @@ public:
 		buffer_binding.buffer = buffer.get();
 		buffer_binding.offset = 0;
 		buffer_binding.range = VK_WHOLE_SIZE;
+		buffer_binding.size = buffer.get_size_bytes();
 		buffer_binding.descriptor_type = get_descriptor_type(type);
 		buffer_bindings.push_back(buffer_binding);
 
-		// recreate the descriptor set layout if it has previously been finalized
+		// look up the layout for the new bindings if it has previously been finalized
 		if (layout_finalized) {
-			if (layout != nullptr) {
-				vkDestroyDescriptorSetLayout(logical, layout, nullptr);
-				layout = nullptr;
-			}
-			Log::info("in method DescriptorSet::bind_buffer(): the descriptor set layout has already been finalized and needs to be recreated");
+			LOG_INFO("in method DescriptorSet::bind_buffer(): the descriptor set layout has already been finalized and needs to be replaced");
 			finalize_layout();
 		}
 
@@ -2926,7 +3730,19 @@ public:
 			Log::warning("in method DescriptorSet::replace_buffer(): argument for the target binding index is invalid; value is ", target_binding_index, " but the highest available index is ", layout_bindings.size() - 1);
 		}
 		else {
-			Log::debug("replacing buffer at binding index ", target_binding_index, " with new buffer ", new_buffer.get(), " in descriptor set (handle: ", set, ")");
+			LOG_DEBUG("replacing buffer at binding index ", target_binding_index, " with new buffer ", new_buffer.get(), " in descriptor set (handle: ", set, ")");
+		}
+		for (auto& binding_info : buffer_bindings) {
+			if (binding_info.binding_index == target_binding_index) {
+				binding_info.buffer = new_buffer.get();
+				binding_info.size = new_buffer.get_size_bytes();
+				binding_info.descriptor_type = get_descriptor_type(type);
+				break;
+			}
+		}
+		if (push_descriptors) {
+			// (pushed with the next bind)
+			return;
 		}
 		VkDescriptorBufferInfo buffer_info = {};
 		buffer_info.buffer = new_buffer.get();
@@ -2963,7 +3779,7 @@ public:
 		layout_bindings[binding_index].stageFlags = shader_stage_flags;
 		layout_bindings[binding_index].pImmutableSamplers = nullptr;
 
-		Log::debug("binding image view ", image_view.get(), " to descriptor set (handle: ", set, ") at binding index ", binding_index);
+		LOG_DEBUG("binding image view ", image_view.get(), " to descriptor set (handle: ", set, ") at binding index ", binding_index);
 
 		// Store the image view and sampler for updating the descriptor set later
 		ImageBindingInfo image_binding = {}; // = custom struct, not part of the Vulkan API
@@ -2973,13 +3789,9 @@ public:
 		image_binding.descriptor_type = get_descriptor_type(type);
 		image_bindings.push_back(image_binding);
 
-		// recreate the descriptor set layout if it has previously been finalized
+		// look up the layout for the new bindings if it has previously been finalized
 		if (layout_finalized) {
-			if (layout != nullptr) {
-				vkDestroyDescriptorSetLayout(logical, layout, nullptr);
-				layout = nullptr;
-			}
-			Log::info("in method DescriptorSet::bind_buffer(): the descriptor set layout has already been finalized and needs to be recreated");
+			LOG_INFO("in method DescriptorSet::bind_image(): the descriptor set layout has already been finalized and needs to be replaced");
 			finalize_layout();
 		}
 		return binding_index;
@@ -3020,19 +3832,22 @@ public:
 		image_info.imageView = new_image_view.get();
 		image_info.imageLayout = image_layout; // e.g. VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
 
-		VkWriteDescriptorSet descriptor_write = {};
-		descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptor_write.pNext = nullptr;
-		descriptor_write.dstSet = set;
-		descriptor_write.dstBinding = target_binding_index;
-		descriptor_write.dstArrayElement = 0;
-		descriptor_write.descriptorCount = 1;
-		descriptor_write.descriptorType = get_descriptor_type(type);
-		descriptor_write.pImageInfo = &image_info;
-		descriptor_write.pTexelBufferView = nullptr;
-		descriptor_write.pBufferInfo = nullptr;
+		// (push descriptors are written with the next bind)
+		if (!push_descriptors) {
+			VkWriteDescriptorSet descriptor_write = {};
+			descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptor_write.pNext = nullptr;
+			descriptor_write.dstSet = set;
+			descriptor_write.dstBinding = target_binding_index;
+			descriptor_write.dstArrayElement = 0;
+			descriptor_write.descriptorCount = 1;
+			descriptor_write.descriptorType = get_descriptor_type(type);
+			descriptor_write.pImageInfo = &image_info;
+			descriptor_write.pTexelBufferView = nullptr;
+			descriptor_write.pBufferInfo = nullptr;
 
-		vkUpdateDescriptorSets(logical, 1, &descriptor_write, 0, nullptr);
+			vkUpdateDescriptorSets(logical, 1, &descriptor_write, 0, nullptr);
+		}
 
 		// Update the stored image binding info if it exists
 		for (auto& binding_info : image_bindings) {
@@ -3047,6 +3862,10 @@ public:
 
 	// updates the descriptor set with the current image bindings
 	void update() {
+		if (push_descriptors) {
+			// (the bindings are pushed into the command buffer by CommandBuffer::bind_descriptor_set())
+			return;
+		}
 		if (set == VK_NULL_HANDLE) {
 			// This can happen if update() is called before allocation.
 			Log::warning("in method DescriptorSet::update(): descriptor set handle is null (this can e.g. happen if update() is called before set allocation to a descriptor pool, skipping vkUpdateDescriptorSets call.");
@@ -3055,8 +3874,69 @@ public:
 		std::vector<VkWriteDescriptorSet> descriptor_writes;
 		std::vector<VkDescriptorImageInfo> image_infos;
 		std::vector<VkDescriptorBufferInfo> buffer_infos;
+		collect_writes(descriptor_writes, image_infos, buffer_infos);
+
+		// Perform the update if there's anything to write
+		if (!descriptor_writes.empty()) {
+			vkUpdateDescriptorSets(logical, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
+			LOG_DEBUG("DescriptorSet::update() called vkUpdateDescriptorSets for set ", set, " with ", descriptor_writes.size(), " writes.");
+		}
+		else {
+			LOG_DEBUG("DescriptorSet::update() called for set ", set, ", but no bindings needed updating.");
+		}
+	}
+
+	// records the current bindings into a command buffer with vkCmdPushDescriptorSetKHR
+	// (only for sets with is_push() == true; the pipeline layout has to be created from this set's layout)
+	void push(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout pipeline_layout) const {
+		std::vector<VkWriteDescriptorSet> descriptor_writes;
+		std::vector<VkDescriptorImageInfo> image_infos;
+		std::vector<VkDescriptorBufferInfo> buffer_infos;
+		collect_writes(descriptor_writes, image_infos, buffer_infos);
+		if (!descriptor_writes.empty()) {
+			device->push_descriptor_set(command_buffer, bind_point, pipeline_layout, 0, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data());
+		}
+	}
+
+	// returns true if the bindings are pushed into command buffers instead of being allocated from a descriptor pool
+	// (decided by finalize_layout())
+	bool is_push() const { return push_descriptors; }
+
+protected:
+	struct ImageBindingInfo {
+		uint32_t binding_index;
+		VkImageView image_view;
+		VkSampler sampler;
+		VkDescriptorType descriptor_type;
+	};
 
+	struct BufferBindingInfo {
+		uint32_t binding_index;
+		VkBuffer buffer;
+		VkDeviceSize offset; // Usually 0
+		VkDeviceSize range;  // Usually VK_WHOLE_SIZE
+		VkDescriptorType descriptor_type;
+		VkDeviceSize size;   // size of the buffer in bytes
+	};
+
+public:
+	// getters
+	VkDescriptorSet get() const { return set; }
+	const VkDescriptorSet* get_ptr() const { return &set; }
+	const VkDescriptorSetLayout& get_layout() const { return layout; }
+	const std::vector<BufferBindingInfo>& get_buffer_bindings() const { return buffer_bindings; }
+	const std::vector<ImageBindingInfo>& get_image_bindings() const { return image_bindings; }
+	const std::vector<VkDescriptorSetLayoutBinding>& get_layout_bindings() const { return layout_bindings; }
+	VkDescriptorSetLayoutCreateFlags get_layout_flags() const { return layout_create_info.flags; }
+
+	// (no destructor needed: the layout is owned by the device and the set by the descriptor pool)
+
+protected:
+	// builds one descriptor write per image and buffer binding
+	// (the info vectors have to outlive the writes)
+	void collect_writes(std::vector<VkWriteDescriptorSet>& descriptor_writes, std::vector<VkDescriptorImageInfo>& image_infos, std::vector<VkDescriptorBufferInfo>& buffer_infos) const {
 		// pre-allocation
+		descriptor_writes.reserve(image_bindings.size() + buffer_bindings.size());
 		image_infos.reserve(image_bindings.size());
 		buffer_infos.reserve(buffer_bindings.size());
 
@@ -3103,52 +3983,8 @@ public:
 			descriptor_write.pTexelBufferView = nullptr;
 			descriptor_writes.push_back(descriptor_write);
 		}
-
-		// Perform the update if there's anything to write
-		if (!descriptor_writes.empty()) {
-			vkUpdateDescriptorSets(logical, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
-			Log::debug("DescriptorSet::update() called vkUpdateDescriptorSets for set ", set, " with ", descriptor_writes.size(), " writes.");
-		}
-		else {
-			Log::debug("DescriptorSet::update() called for set ", set, ", but no bindings needed updating.");
-		}
 	}
 
-protected:
-	struct ImageBindingInfo {
-		uint32_t binding_index;
-		VkImageView image_view;
-		VkSampler sampler;
-		VkDescriptorType descriptor_type;
-	};
-
-	struct BufferBindingInfo {
-		uint32_t binding_index;
-		VkBuffer buffer;
-		VkDeviceSize offset; // Usually 0
-		VkDeviceSize range;  // Usually VK_WHOLE_SIZE
-		VkDescriptorType descriptor_type;
-	};
-
-public:
-	// getters
-	VkDescriptorSet get() const { return set; }
-	const VkDescriptorSet* get_ptr() const { return &set; }
-	const VkDescriptorSetLayout& get_layout() const { return layout; }
-	const std::vector<BufferBindingInfo>& get_buffer_bindings() const { return buffer_bindings; }
-	const std::vector<ImageBindingInfo>& get_image_bindings() const { return image_bindings; }
-
-	// destructor
-	~DescriptorSet() {
-		if (layout != nullptr) {
-			Log::debug("destroying descriptor set layout (handle: ", layout, ")");
-			vkDestroyDescriptorSetLayout(logical, layout, nullptr);
-			layout = nullptr;
-			Log::info("[DESCRIPTORSET LAYOUT DESTROYED]");
-		}
-	}
-
-protected:
 	VkDescriptorType get_descriptor_type(DescriptorType type) const {
 		switch (type) {
 		case DescriptorType::STORAGE_BUFFER_DESCRIPTOR: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -3161,6 +3997,7 @@ protected:
 	}
 
 	VkDevice logical = nullptr;
+	const Device* device = nullptr;
 	VkDescriptorSetLayoutCreateInfo layout_create_info = {};
 	std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
 	std::vector<ImageBindingInfo> image_bindings;
@@ -3168,6 +4005,8 @@ protected:
 	VkDescriptorSet set = nullptr;
 	VkDescriptorSetLayout layout = nullptr;
 	bool layout_finalized = false;
+	bool allow_push_descriptors = true;
+	bool push_descriptors = false;
 };
 
 // DescriptorPool manages descriptor sets and their memory allocation
@@ -3192,7 +4031,7 @@ public:
 		// Create the descriptor pool
 		VkResult result = vkCreateDescriptorPool(logical, &create_info, nullptr, &pool);
 		if (result == VK_SUCCESS) {
-			Log::debug("successfully created descriptor pool (handle: ", pool, ")");
+			LOG_DEBUG("successfully created descriptor pool (handle: ", pool, ")");
 		}
 		else {
 			Log::error("failed to create descriptor pool (VkResult =  ", result, ")");
@@ -3202,11 +4041,11 @@ public:
 	// destructor
 	~DescriptorPool() {
 		if (pool != nullptr) {
-			Log::debug("destroying descriptor pool (handle: ", pool, ")");
+			LOG_DEBUG("destroying descriptor pool (handle: ", pool, ")");
 			release_all_sets();
 			vkDestroyDescriptorPool(logical, pool, nullptr);
 			pool = nullptr;
-			Log::info("[DESCRIPTOR POOL DESTROYED]");
+			LOG_INFO("[DESCRIPTOR POOL DESTROYED]");
 		}
 	}
 
@@ -3217,7 +4056,7 @@ public:
 		sets(std::move(other.sets)),
 		max_sets(other.max_sets) {
 		if (pool != nullptr) {
-			Log::info("descriptor pool moved (handle: ", pool, ")");
+			LOG_INFO("descriptor pool moved (handle: ", pool, ")");
 		}
 	}
 
@@ -3225,7 +4064,7 @@ public:
 	DescriptorPool& operator=(DescriptorPool&& other) noexcept {
 		if (this != &other) {
 			if (pool != nullptr) {
-				Log::info("move assignment operation: destroying previous descriptor pool (handle: ", pool, ")");
+				LOG_INFO("move assignment operation: destroying previous descriptor pool (handle: ", pool, ")");
 				vkDestroyDescriptorPool(logical, pool, nullptr);
 				pool = nullptr;
 			}
@@ -3234,7 +4073,7 @@ public:
 			sets = std::move(other.sets);
 			max_sets = other.max_sets;
 			if (pool != nullptr) {
-				Log::info("descriptor pool moved to 'this' (handle: ", pool, ")");
+				LOG_INFO("descriptor pool moved to 'this' (handle: ", pool, ")");
 			}
 		}
 		return *this;
@@ -3255,7 +4094,7 @@ public:
 		if (sets.empty()) { return; }
 		VkResult result = vkFreeDescriptorSets(logical, pool, sets.size(), sets.data());
 		if (result == VK_SUCCESS) {
-			Log::debug("all descriptor sets removed from pool, memory allocation freed");
+			LOG_DEBUG("all descriptor sets removed from pool, memory allocation freed");
 		}
 		else {
 			Log::warning("failed to remove descriptor sets from pool (VkResult = ", result, ")");
@@ -3264,8 +4103,9 @@ public:
 	}
 
 	// releases a single descriptor sets from the pool
+	// (push descriptor sets were never allocated from the pool; nothing to do)
 	uint32_t release_set(const DescriptorSet& set) {
-		if (sets.empty()) { return; }
+		if (sets.empty() || set.is_push()) { return static_cast<uint32_t>(sets.size()); }
 
 		// remove from VkDescriptorSet vector of the pool
 		for (uint32_t i = 0; i < sets.size(); i++) {
@@ -3277,7 +4117,7 @@ public:
 		// free set
 		VkResult result = vkFreeDescriptorSets(logical, pool, 1, set.get_ptr());
 		if (result == VK_SUCCESS) {
-			Log::debug("descriptor set removed from pool, memory allocation freed");
+			LOG_DEBUG("descriptor set removed from pool, memory allocation freed");
 		}
 		else {
 			Log::warning("failed to remove descriptor set from pool (VkResult = ", result, ")");
@@ -3285,15 +4125,19 @@ public:
 		return sets.size();
 	}
 
-	// allocates a new descriptor set to the pool and returns its index
+	// allocates a new descriptor set to the pool and returns its index;
+	// push descriptor sets are only finalized (they occupy no pool memory and the returned index is the current set count)
 	uint32_t allocate_set(DescriptorSet& descriptor_set) {
-		if (sets.size() >= max_sets) {
-			Log::error("in method DescriptorPool::allocate_set(): max number of sets for this pool is ", max_sets, " (as defined by the pool constructor) and has been reached; no more descriptor sets can be added");
-		}
 		if (!descriptor_set.layout_finalized) {
-			Log::info("in method DescriptorPool::allocate_set(): descriptor set layout has not been finalized yet; finalizing now");
+			LOG_INFO("in method DescriptorPool::allocate_set(): descriptor set layout has not been finalized yet; finalizing now");
 			descriptor_set.finalize_layout();
 		}
+		if (descriptor_set.is_push()) {
+			return static_cast<uint32_t>(sets.size());
+		}
+		if (sets.size() >= max_sets) {
+			Log::error("in method DescriptorPool::allocate_set(): max number of sets for this pool is ", max_sets, " (as defined by the pool constructor) and has been reached; no more descriptor sets can be added");
+		}
 		VkDescriptorSetAllocateInfo allocate_info = {};
 		allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocate_info.descriptorPool = pool;
@@ -3304,7 +4148,7 @@ public:
 			Log::error("failed to allocate descriptor set (VkResult ", result, ")");
 		}
 		uint32_t index = static_cast<uint32_t>(sets.size());
-		Log::debug("adding new descriptor set (set index = ", index, ") to descriptor pool (pool handle: ", pool, ")");
+		LOG_DEBUG("adding new descriptor set (set index = ", index, ") to descriptor pool (pool handle: ", pool, ")");
 		sets.push_back(descriptor_set.set);
 		descriptor_set.update();
 		return index;
@@ -3473,7 +4317,7 @@ public:
 
 		VkResult result = vkCreatePipelineLayout(logical, &layout_create_info, nullptr, &layout);
 		if (result == VK_SUCCESS) {
-			Log::info("created pipeline layout for graphics pipeline (handle: ", layout, ")");
+			LOG_INFO("created pipeline layout for graphics pipeline (handle: ", layout, ")");
 			pipeline_create_info.layout = layout;
 		}
 		else {
@@ -3546,7 +4390,7 @@ public:
 		pipeline_create_info.subpass = renderpass.get_subpass_count() > 0 ? subpass_index : 0;
 		result = vkCreateGraphicsPipelines(logical, 0, 1, &pipeline_create_info, nullptr, &pipeline);
 		if (result == VK_SUCCESS) {
-			Log::info("graphics pipeline successfully created");
+			LOG_INFO("graphics pipeline successfully created");
 		}
 		else {
 			Log::error("failed to create graphics pipeline (VkResult=", result, ")");
@@ -3560,7 +4404,7 @@ public:
 
 	// destructor
 	~GraphicsPipeline() {
-		Log::info("destroying graphics pipeline");
+		LOG_INFO("destroying graphics pipeline");
 		vkDestroyPipeline(logical, pipeline, nullptr);
 		vkDestroyPipelineLayout(logical, layout, nullptr);
 	}
@@ -3572,6 +4416,312 @@ protected:
 	VkViewport viewport = {};
 };
 
+// process-wide cache for compute pipelines and their pipeline layouts;
+// pipelines are keyed by shader module, descriptor set layout signature, push constant range
+// and specialization constants (= workgroup size + optional kernel parameters), so that repeated dispatches of the same
+// operation can skip vkCreatePipelineLayout / vkCreateComputePipelines;
+// shader compilation results are additionally kept in a VkPipelineCache that is
+// loaded from and saved to disk in order to speed up warm starts
+class ComputePipelineCache {
+public:
+	// constructor
+	ComputePipelineCache() = delete;
+	ComputePipelineCache(const Device& device, const std::string& filepath = "") {
+		this->logical = device.get_logical();
+		this->filepath = filepath;
+
+		// read previously saved pipeline cache data (if any)
+		std::vector<char> initial_data;
+		if (!filepath.empty()) {
+			std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+			if (file.is_open()) {
+				std::streamsize size = file.tellg();
+				file.seekg(0, std::ios::beg);
+				initial_data.resize(size_t(size));
+				if (size > 0 && file.read(initial_data.data(), size)) {
+					if (!is_compatible(device, initial_data)) {
+						LOG_INFO("pipeline cache file '", filepath, "' was created by a different device or driver and will be ignored");
+						initial_data.clear();
+					}
+				}
+				else {
+					initial_data.clear();
+				}
+			}
+		}
+
+		VkPipelineCacheCreateInfo create_info = {};
+		create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		create_info.pNext = NULL;
+		create_info.flags = 0;
+		create_info.initialDataSize = initial_data.size();
+		create_info.pInitialData = initial_data.empty() ? nullptr : initial_data.data();
+		VkResult result = vkCreatePipelineCache(logical, &create_info, nullptr, &cache);
+		if (result == VK_SUCCESS) {
+			LOG_DEBUG("created pipeline cache (handle: ", cache, ", initial data: ", initial_data.size(), " bytes)");
+		}
+		else {
+			Log::warning("failed to create pipeline cache (VkResult=", result, "); pipelines will be compiled without a cache");
+			cache = VK_NULL_HANDLE;
+		}
+
+		if (shared == nullptr) {
+			shared = this;
+		}
+		std::lock_guard<std::mutex> lock(registry_mtx);
+		registry.emplace(logical, this); // (keeps the first cache of the device)
+	}
+
+	// destructor: saves the pipeline cache to disk and destroys all cached objects
+	~ComputePipelineCache() {
+		save();
+		clear();
+		if (cache != VK_NULL_HANDLE) {
+			LOG_DEBUG("destroying pipeline cache (handle: ", cache, ")");
+			vkDestroyPipelineCache(logical, cache, nullptr);
+			cache = VK_NULL_HANDLE;
+		}
+		if (shared == this) {
+			shared = nullptr;
+		}
+		std::lock_guard<std::mutex> lock(registry_mtx);
+		auto it = registry.find(logical);
+		if (it != registry.end() && it->second == this) {
+			registry.erase(it);
+		}
+	}
+
+	// deleted copy constructor and assignment
+	ComputePipelineCache(const ComputePipelineCache&) = delete;
+	ComputePipelineCache& operator=(const ComputePipelineCache&) = delete;
+
+	// returns a cached compute pipeline and the associated pipeline layout
+	// (or creates them on the first request); the returned handles remain owned by the cache
+	void get(
+		VkShaderModule shader_module,
+		const DescriptorSet& descriptor_set,
+		const PushConstants& push_constants,
+		const std::array<uint32_t, 3>& workgroup_size,
+		const std::vector<uint32_t>& specialization_constants,
+		VkPipeline& pipeline_out,
+		VkPipelineLayout& layout_out
+	) {
+		std::lock_guard<std::mutex> lock(mtx);
+
+		// key for the pipeline layout: descriptor set layout signature + push constant range
+		std::vector<uint64_t> layout_key;
+		layout_key.reserve(4 * descriptor_set.get_layout_bindings().size() + 4);
+		layout_key.push_back(uint64_t(descriptor_set.get_layout_flags()));
+		for (const auto& binding : descriptor_set.get_layout_bindings()) {
+			layout_key.push_back(binding.binding);
+			layout_key.push_back(uint64_t(binding.descriptorType));
+			layout_key.push_back(binding.descriptorCount);
+			layout_key.push_back(uint64_t(binding.stageFlags));
+		}
+		const VkPushConstantRange& range = push_constants.get_range();
+		layout_key.push_back(uint64_t(range.stageFlags));
+		layout_key.push_back(range.offset);
+		layout_key.push_back(range.size);
+
+		// key for the pipeline: shader module + layout key + specialization constants
+		std::vector<uint64_t> pipeline_key = layout_key;
+		pipeline_key.push_back(reinterpret_cast<uint64_t>(shader_module));
+		pipeline_key.push_back(workgroup_size[0]);
+		pipeline_key.push_back(workgroup_size[1]);
+		pipeline_key.push_back(workgroup_size[2]);
+		for (uint32_t value : specialization_constants) {
+			pipeline_key.push_back(value);
+		}
+
+		auto cached_pipeline = pipelines.find(pipeline_key);
+		if (cached_pipeline != pipelines.end()) {
+			pipeline_out = cached_pipeline->second.pipeline;
+			layout_out = cached_pipeline->second.layout;
+			return;
+		}
+
+		VkPipelineLayout layout = get_layout(layout_key, descriptor_set, push_constants);
+		VkPipeline pipeline = create_pipeline(shader_module, layout, workgroup_size, specialization_constants);
+		pipelines[pipeline_key] = { pipeline, layout };
+		pipeline_out = pipeline;
+		layout_out = layout;
+	}
+
+	// writes the current pipeline cache data to the file specified at construction time
+	void save() const {
+		if (cache == VK_NULL_HANDLE || filepath.empty()) { return; }
+		size_t size = 0;
+		if (vkGetPipelineCacheData(logical, cache, &size, nullptr) != VK_SUCCESS || size == 0) { return; }
+		std::vector<char> data(size);
+		if (vkGetPipelineCacheData(logical, cache, &size, data.data()) != VK_SUCCESS) {
+			Log::warning("in method ComputePipelineCache::save(): failed to retrieve pipeline cache data");
+			return;
+		}
+		std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			Log::warning("in method ComputePipelineCache::save(): failed to open file '", filepath, "' for writing");
+			return;
+		}
+		file.write(data.data(), std::streamsize(size));
+		LOG_DEBUG("saved pipeline cache (", size, " bytes) to file '", filepath, "'");
+	}
+
+	// destroys all cached pipelines, pipeline layouts and descriptor set layouts;
+	// make sure none of them are still in use by the device
+	void clear() {
+		std::lock_guard<std::mutex> lock(mtx);
+		for (auto& entry : pipelines) {
+			vkDestroyPipeline(logical, entry.second.pipeline, nullptr);
+		}
+		pipelines.clear();
+		for (auto& entry : layouts) {
+			vkDestroyPipelineLayout(logical, entry.second.layout, nullptr);
+			vkDestroyDescriptorSetLayout(logical, entry.second.set_layout, nullptr);
+		}
+		layouts.clear();
+	}
+
+	// getters
+	VkPipelineCache get() const { return cache; }
+	VkDevice get_logical() const { return logical; }
+	size_t get_pipeline_count() const { return pipelines.size(); }
+	size_t get_layout_count() const { return layouts.size(); }
+	const std::string& get_filepath() const { return filepath; }
+
+	// returns the first cache that has been created for the process (or nullptr)
+	static ComputePipelineCache* get_shared() { return shared; }
+
+	// returns the first cache that has been created for the given logical device (or nullptr)
+	static ComputePipelineCache* get_shared(VkDevice logical) {
+		std::lock_guard<std::mutex> lock(registry_mtx);
+		auto it = registry.find(logical);
+		return it != registry.end() ? it->second : nullptr;
+	}
+
+private:
+	struct LayoutEntry {
+		VkPipelineLayout layout;
+		VkDescriptorSetLayout set_layout;
+	};
+
+	struct PipelineEntry {
+		VkPipeline pipeline;
+		VkPipelineLayout layout;
+	};
+
+	// returns a cached pipeline layout for the given key or creates a new one;
+	// the cache owns a private copy of the descriptor set layout, which is compatible
+	// with any descriptor set that has been created with an identical set of bindings
+	VkPipelineLayout get_layout(const std::vector<uint64_t>& key, const DescriptorSet& descriptor_set, const PushConstants& push_constants) {
+		auto cached_layout = layouts.find(key);
+		if (cached_layout != layouts.end()) {
+			return cached_layout->second.layout;
+		}
+
+		LayoutEntry entry = {};
+		VkDescriptorSetLayoutCreateInfo set_layout_create_info = {};
+		set_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		set_layout_create_info.pNext = NULL;
+		set_layout_create_info.flags = descriptor_set.get_layout_flags();
+		set_layout_create_info.bindingCount = static_cast<uint32_t>(descriptor_set.get_layout_bindings().size());
+		set_layout_create_info.pBindings = descriptor_set.get_layout_bindings().data();
+		VkResult result = vkCreateDescriptorSetLayout(logical, &set_layout_create_info, nullptr, &entry.set_layout);
+		if (result != VK_SUCCESS) {
+			Log::error("in method ComputePipelineCache::get_layout(): failed to create descriptor set layout (VkResult=", result, ")");
+		}
+
+		VkPipelineLayoutCreateInfo layout_create_info = {};
+		layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layout_create_info.pNext = NULL;
+		layout_create_info.setLayoutCount = 1;
+		layout_create_info.pSetLayouts = &entry.set_layout;
+		if (push_constants.get_size() == 0) {
+			layout_create_info.pushConstantRangeCount = 0;
+			layout_create_info.pPushConstantRanges = NULL;
+		}
+		else {
+			layout_create_info.pushConstantRangeCount = 1;
+			layout_create_info.pPushConstantRanges = &push_constants.get_range();
+		}
+		result = vkCreatePipelineLayout(logical, &layout_create_info, nullptr, &entry.layout);
+		if (result == VK_SUCCESS) {
+			LOG_DEBUG("created cached pipeline layout (handle: ", entry.layout, ")");
+		}
+		else {
+			Log::error("in method ComputePipelineCache::get_layout(): failed to create pipeline layout (VkResult=", result, ")");
+		}
+		layouts[key] = entry;
+		return entry.layout;
+	}
+
+	// creates a new compute pipeline with the workgroup size passed as specialization constants 0, 1 and 2
+	// and any additional kernel parameters as specialization constants 3, 4, ...
+	VkPipeline create_pipeline(VkShaderModule shader_module, VkPipelineLayout layout, const std::array<uint32_t, 3>& workgroup_size, const std::vector<uint32_t>& specialization_constants) {
+		std::vector<uint32_t> specialization_data = { workgroup_size[0], workgroup_size[1], workgroup_size[2] };
+		specialization_data.insert(specialization_data.end(), specialization_constants.begin(), specialization_constants.end());
+		std::vector<VkSpecializationMapEntry> specialization_map_entries(specialization_data.size());
+		for (uint32_t i = 0; i < specialization_data.size(); i++) {
+			specialization_map_entries[i].constantID = i; // for the GLSL shader: local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2, constant_id = 3...
+			specialization_map_entries[i].offset = static_cast<uint32_t>(i * sizeof(uint32_t));
+			specialization_map_entries[i].size = sizeof(uint32_t);
+		}
+
+		VkSpecializationInfo specialization_info = {};
+		specialization_info.mapEntryCount = static_cast<uint32_t>(specialization_map_entries.size());
+		specialization_info.pMapEntries = specialization_map_entries.data();
+		specialization_info.dataSize = specialization_data.size() * sizeof(uint32_t);
+		specialization_info.pData = specialization_data.data();
+
+		VkPipelineShaderStageCreateInfo shader_stage_create_info = {};
+		shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shader_stage_create_info.pNext = NULL;
+		shader_stage_create_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		shader_stage_create_info.module = shader_module;
+		shader_stage_create_info.pName = "main";
+		shader_stage_create_info.pSpecializationInfo = &specialization_info;
+
+		VkComputePipelineCreateInfo pipeline_create_info = {};
+		pipeline_create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipeline_create_info.pNext = NULL;
+		pipeline_create_info.stage = shader_stage_create_info;
+		pipeline_create_info.layout = layout;
+		pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(logical, cache, 1, &pipeline_create_info, nullptr, &pipeline);
+		if (result == VK_SUCCESS) {
+			LOG_DEBUG("created cached compute pipeline (handle: ", pipeline, ", workgroup size: ", workgroup_size[0], "x", workgroup_size[1], "x", workgroup_size[2], ")");
+		}
+		else {
+			Log::error("in method ComputePipelineCache::create_pipeline(): failed to create compute pipeline (VkResult=", result, ")");
+		}
+		return pipeline;
+	}
+
+	// checks the header of a pipeline cache blob against the properties of the device
+	static bool is_compatible(const Device& device, const std::vector<char>& data) {
+		constexpr size_t header_size = 16 + VK_UUID_SIZE;
+		if (data.size() < header_size) { return false; }
+		uint32_t header[4];
+		memcpy(header, data.data(), sizeof(header));
+		const VkPhysicalDeviceProperties& properties = device.get_properties();
+		return header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header[2] == properties.vendorID
+			&& header[3] == properties.deviceID
+			&& memcmp(data.data() + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+
+	VkDevice logical = nullptr;
+	VkPipelineCache cache = VK_NULL_HANDLE;
+	std::string filepath;
+	std::map<std::vector<uint64_t>, LayoutEntry> layouts;
+	std::map<std::vector<uint64_t>, PipelineEntry> pipelines;
+	std::mutex mtx;
+	static ComputePipelineCache* shared;
+	static std::map<VkDevice, ComputePipelineCache*> registry; // first cache per logical device
+	static std::mutex registry_mtx;
+};
+
 class ComputePipeline {
 public:
 	// constructor
@@ -3583,8 +4733,14 @@ public:
 		DescriptorSet& descriptor_set,
 		uint32_t workgroup_size_x,
 		uint32_t workgroup_size_y = 1,
-		uint32_t workgroup_size_z = 1
+		uint32_t workgroup_size_z = 1,
+		bool use_cache = true,
+		const std::vector<uint32_t>& specialization_constants = {}, // additional kernel parameters (constant_id = 3, 4, ...)
+		std::source_location location = std::source_location::current() // caller (label for the Profiler)
 	) {
+#ifdef PROFILING
+		double profile_start = Profiler::now_ns();
+#endif
 		this->logical = device.get_logical();
 		this->set = &descriptor_set;
 		this->constants = &push_constants;
@@ -3592,6 +4748,23 @@ public:
 		this->workgroup_size_y = workgroup_size_y;
 		this->workgroup_size_z = workgroup_size_z;
 
+		// use the pipeline cache of the device where available
+		ComputePipelineCache* cache = ComputePipelineCache::get_shared(this->logical);
+		if (cache != nullptr && use_cache && cache->get_logical() == this->logical) {
+#ifdef PROFILING
+			size_t cached_pipelines = cache->get_pipeline_count();
+#endif
+			cache->get(compute_shader_module.get(), descriptor_set, push_constants, { workgroup_size_x, workgroup_size_y, workgroup_size_z }, specialization_constants, pipeline, layout);
+			is_cached = true;
+#ifdef PROFILING
+			// (only cache misses are recorded)
+			if (cache->get_pipeline_count() > cached_pipelines) {
+				Profiler::record("pipeline", Profiler::function_name(location.function_name()), "", profile_start, Profiler::now_ns() - profile_start);
+			}
+#endif
+			return;
+		}
+
 		// setup specialization constants for the workgroup dimensions
 		std::vector<uint32_t> specialization_data = { workgroup_size_x, workgroup_size_y, workgroup_size_z };
 		std::vector<VkSpecializationMapEntry> specialization_map_entries;
@@ -3614,10 +4787,20 @@ public:
 		workgroup_z_entry.size = sizeof(uint32_t);
 		specialization_map_entries.push_back(workgroup_z_entry);
 
+		// additional kernel parameters
+		for (uint32_t i = 0; i < specialization_constants.size(); i++) {
+			VkSpecializationMapEntry entry = {};
+			entry.constantID = 3 + i;
+			entry.offset = static_cast<uint32_t>((3 + i) * sizeof(uint32_t));
+			entry.size = sizeof(uint32_t);
+			specialization_map_entries.push_back(entry);
+			specialization_data.push_back(specialization_constants[i]);
+		}
+
 		VkSpecializationInfo specialization_info = {};
-		specialization_info.mapEntryCount = 3;
+		specialization_info.mapEntryCount = static_cast<uint32_t>(specialization_map_entries.size());
 		specialization_info.pMapEntries = specialization_map_entries.data();
-		specialization_info.dataSize = 3 * sizeof(uint32_t);
+		specialization_info.dataSize = specialization_data.size() * sizeof(uint32_t);
 		specialization_info.pData = specialization_data.data();
 
 		// setup pipeline layout        
@@ -3636,7 +4819,7 @@ public:
 		layout_create_info.pNext = NULL;
 		VkResult result = vkCreatePipelineLayout(logical, &layout_create_info, nullptr, &layout);
 		if (result == VK_SUCCESS) {
-			Log::info("created pipeline layout for compute pipeline (handle: ", layout, ")");
+			LOG_INFO("created pipeline layout for compute pipeline (handle: ", layout, ")");
 		}
 		else {
 			Log::error("failed to create compute pipeline layout (VkResult=", result, ")");
@@ -3662,21 +4845,28 @@ public:
 		pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
 		result = vkCreateComputePipelines(device.get_logical(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline);
 		if (result == VK_SUCCESS) {
-			Log::info("compute pipeline successfully created (handle: ", pipeline, ")");
+			LOG_INFO("compute pipeline successfully created (handle: ", pipeline, ")");
 		}
 		else {
 			Log::error("failed to create compute pipeline (VkResult=", result, ")");
 		}
+#ifdef PROFILING
+		Profiler::record("pipeline", Profiler::function_name(location.function_name()), "", profile_start, Profiler::now_ns() - profile_start);
+#endif
 	}
 
 	~ComputePipeline() {
+		if (is_cached) {
+			// handles are owned by the pipeline cache
+			return;
+		}
 		if (pipeline != nullptr) {
-			Log::info("destroying compute pipeline");
+			LOG_INFO("destroying compute pipeline");
 			vkDestroyPipeline(logical, pipeline, nullptr);
 			pipeline = nullptr;
 		}
 		if (layout != nullptr) {
-			Log::info("destroying pipeline layout");
+			LOG_INFO("destroying pipeline layout");
 			vkDestroyPipelineLayout(logical, layout, nullptr);
 			layout = nullptr;
 		}
@@ -3695,6 +4885,8 @@ public:
 	uint32_t get_workgroup_size_y() const { return workgroup_size_y; }
 	uint32_t get_workgroup_size_z() const { return workgroup_size_z; }
 
+	bool cached() const { return is_cached; }
+
 private:
 	VkPipeline pipeline = nullptr;
 	VkPipelineLayout layout = nullptr;
@@ -3704,6 +4896,7 @@ private:
 	uint32_t workgroup_size_x = 0;
 	uint32_t workgroup_size_y = 0;
 	uint32_t workgroup_size_z = 0;
+	bool is_cached = false;
 
 };
 
@@ -3804,19 +4997,153 @@ protected:
 	VkImageMemoryBarrier2 image_memory_barrier = {};
 };
 
+// pool of timestamp query pairs for measuring the GPU execution time of recorded commands;
+// the results of completed submissions are passed to the Profiler (see timelog.h) by collect()
+class TimestampQueryPool {
+public:
+	// constructor
+	TimestampQueryPool() = delete;
+	TimestampQueryPool(const Device& device, uint32_t queue_family_index, uint32_t capacity = 256) {
+		this->logical = device.get_logical();
+		this->capacity = capacity;
+		this->period_ns = device.get_properties().limits.timestampPeriod;
+		static std::atomic<uint32_t> pool_count = 0;
+		this->track = pool_count++;
+
+		// timestamps are only supported on queue families with valid timestamp bits
+		uint32_t family_count = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device.get_physical(), &family_count, nullptr);
+		std::vector<VkQueueFamilyProperties> families(family_count);
+		vkGetPhysicalDeviceQueueFamilyProperties(device.get_physical(), &family_count, families.data());
+		uint32_t valid_bits = queue_family_index < family_count ? families[queue_family_index].timestampValidBits : 0;
+		if (valid_bits == 0) {
+			LOG_INFO("timestamp queries are not supported by queue family ", queue_family_index);
+			return;
+		}
+		mask = valid_bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << valid_bits) - 1;
+
+		VkQueryPoolCreateInfo create_info = {};
+		create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		create_info.pNext = NULL;
+		create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		create_info.queryCount = 2 * capacity;
+		VkResult result = vkCreateQueryPool(logical, &create_info, nullptr, &pool);
+		if (result != VK_SUCCESS) {
+			Log::warning("failed to create timestamp query pool (VkResult = ", result, ")");
+			pool = nullptr;
+			return;
+		}
+		slots.resize(capacity);
+		LOG_DEBUG("created timestamp query pool (handle: ", pool, ", ", capacity, " query pairs)");
+	}
+
+	// destructor
+	~TimestampQueryPool() {
+		if (pool != nullptr) {
+			vkDestroyQueryPool(logical, pool, nullptr);
+			pool = nullptr;
+		}
+	}
+
+	// deleted copy constructor and assignment
+	TimestampQueryPool(const TimestampQueryPool&) = delete;
+	TimestampQueryPool& operator=(const TimestampQueryPool&) = delete;
+
+	bool supported() const { return pool != nullptr; }
+
+	// resets a free query pair and records the start timestamp;
+	// returns the index of the pair or -1 if all pairs are waiting for their results
+	int32_t begin(VkCommandBuffer command_buffer, const std::string& name, const std::string& shape, uint64_t bytes) {
+		if (pool == nullptr) { return -1; }
+		for (uint32_t n = 0; n < capacity; n++) {
+			uint32_t i = (next_slot + n) % capacity;
+			if (slots[i].state == SlotState::FREE) {
+				slots[i] = { SlotState::RECORDED, name, shape, bytes };
+				next_slot = i + 1;
+				vkCmdResetQueryPool(command_buffer, pool, 2 * i, 2);
+				vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, 2 * i);
+				return int32_t(i);
+			}
+		}
+		return -1;
+	}
+
+	// records the end timestamp of a query pair
+	void end(VkCommandBuffer command_buffer, int32_t slot) {
+		if (slot < 0) { return; }
+		vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool, 2 * uint32_t(slot) + 1);
+	}
+
+	// marks all recorded query pairs as submitted
+	void submitted() {
+		for (Slot& slot : slots) {
+			if (slot.state == SlotState::RECORDED) { slot.state = SlotState::SUBMITTED; }
+		}
+	}
+
+	// passes the results of all completed query pairs to the Profiler and releases them;
+	// pairs that have been recorded but not submitted are released if discard_unsubmitted == true
+	void collect(bool discard_unsubmitted = false) {
+		for (uint32_t i = 0; i < slots.size(); i++) {
+			Slot& slot = slots[i];
+			if (slot.state == SlotState::RECORDED && discard_unsubmitted) {
+				slot.state = SlotState::FREE;
+			}
+			if (slot.state != SlotState::SUBMITTED) { continue; }
+			uint64_t data[4] = {}; // (value, availability) per query
+			VkResult result = vkGetQueryPoolResults(logical, pool, 2 * i, 2, sizeof(data), data, 2 * sizeof(uint64_t),
+				VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+			if (result != VK_SUCCESS || data[1] == 0 || data[3] == 0) { continue; }
+			uint64_t start = data[0] & mask;
+			uint64_t ticks = ((data[2] & mask) - start) & mask;
+			Profiler::record("gpu", slot.name, slot.shape, double(start) * period_ns, double(ticks) * period_ns, slot.bytes, track);
+			slot.state = SlotState::FREE;
+		}
+	}
+
+private:
+	enum class SlotState { FREE, RECORDED, SUBMITTED };
+	struct Slot {
+		SlotState state = SlotState::FREE;
+		std::string name;
+		std::string shape;
+		uint64_t bytes = 0;
+	};
+
+	VkDevice logical = nullptr;
+	VkQueryPool pool = nullptr;
+	std::vector<Slot> slots;
+	uint32_t capacity = 0;
+	uint32_t next_slot = 0;
+	uint32_t track = 0;      // trace track of the results
+	uint64_t mask = 0;       // valid timestamp bits
+	double period_ns = 1.0;  // nanoseconds per timestamp tick
+};
+
+#ifdef PROFILING
+// label of the next dispatch that is recorded with CommandBuffer::compute() on the calling thread
+struct ProfileLabel {
+	std::string name;
+	std::string shape;
+	bool assigned = false; // if false, CommandBuffer::compute() decides about sampling and uses a generic label
+	bool sampled = false;
+};
+#endif
+
 // command buffer for recording commands;
 // used for graphics, compute and transfer operations
 class CommandBuffer {
 public:
 	// constructor
 	CommandBuffer() = delete;
-	CommandBuffer(Device& device, const CommandPool& pool) {
+	// (queue_index selects one of the queues of the compute queue family, see Device::get_compute_queue_count())
+	CommandBuffer(Device& device, const CommandPool& pool, uint32_t queue_index = 0) {
 		this->device = &device;
 		this->logical = device.get_logical();
 
 		this->usage = pool.get_usage();
 		switch (usage) {
-		case QueueFamily::COMPUTE_QUEUE: queue = this->device->get_compute_queue(); break;
+		case QueueFamily::COMPUTE_QUEUE: queue = this->device->get_compute_queue(queue_index); break;
 		case QueueFamily::GRAPHICS_QUEUE: queue = this->device->get_graphics_queue(); break;
 		case QueueFamily::TRANSFER_QUEUE: queue = this->device->get_transfer_queue(); break;
 		default:
@@ -3829,7 +5156,7 @@ public:
 		if (buffer != nullptr) {
 			vkFreeCommandBuffers(logical, this->pool, 1, &buffer);
 			buffer = nullptr;
-			Log::info("[OLD COMMAND BUFFER DESTROYED]");
+			LOG_INFO("[OLD COMMAND BUFFER DESTROYED]");
 		}
 
 		// setup command buffer
@@ -3839,7 +5166,7 @@ public:
 		allocate_info.commandBufferCount = 1;
 		VkResult result = vkAllocateCommandBuffers(logical, &allocate_info, &buffer);
 		if (result == VK_SUCCESS) {
-			Log::info("successfully allocated command buffer (handle: ", buffer, ")");
+			LOG_INFO("successfully allocated command buffer (handle: ", buffer, ")");
 		}
 		else {
 			Log::warning("in CommandBuffer constructor: memory allocation failed (VkResult=", result, ")!");
@@ -3858,7 +5185,12 @@ public:
 		usage(other.usage),
 		workgroup_size_x(other.workgroup_size_x),
 		workgroup_size_y(other.workgroup_size_y),
-		workgroup_size_z(other.workgroup_size_z) {
+		workgroup_size_z(other.workgroup_size_z),
+		reusable(other.reusable),
+		recording(std::exchange(other.recording, false)) {
+#ifdef PROFILING
+		timestamps = std::move(other.timestamps);
+#endif
 	}
 
 	// move assignment
@@ -3873,6 +5205,11 @@ public:
 			workgroup_size_x = other.workgroup_size_x;
 			workgroup_size_y = other.workgroup_size_y;
 			workgroup_size_z = other.workgroup_size_z;
+			reusable = other.reusable;
+			recording = std::exchange(other.recording, false);
+#ifdef PROFILING
+			timestamps = std::move(other.timestamps);
+#endif
 		}
 		return *this;
 	}
@@ -3885,7 +5222,7 @@ public:
 	~CommandBuffer() {
 		if (buffer != nullptr) {
 			vkFreeCommandBuffers(logical, pool, 1, &buffer);
-			Log::info("[COMMAND BUFFER DESTROYED]");
+			LOG_INFO("[COMMAND BUFFER DESTROYED]");
 			buffer = nullptr;
 		}
 	}
@@ -3935,7 +5272,7 @@ public:
 			Log::error("invalid usage of CommandBuffer::bind_pipeline(): this command buffer doesn't support compute (queue family mismatch)");
 		}
 		if (pipeline.get() != nullptr) {
-			Log::debug("binding pipeline ", pipeline.get(), " to compute bindpoint type at command buffer ", buffer);
+			LOG_DEBUG("binding pipeline ", pipeline.get(), " to compute bindpoint type at command buffer ", buffer);
 			vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.get());
 		}
 		else {
@@ -3947,17 +5284,29 @@ public:
 		pipeline_layout = pipeline.get_layout();
 	}
 
+	// binds a descriptor set to the command buffer; push descriptor sets (DescriptorSet::is_push())
+	// are written directly into the command buffer instead
 	void bind_descriptor_set(const DescriptorSet& set) {
 		if (pipeline_layout == nullptr) {
 			Log::error("invalid usage of CommandBuffer::bind_descriptor_set(): please use CommandBuffer::bind_pipeline() first!");
 		}
 		if (usage == QueueFamily::COMPUTE_QUEUE) {
-			Log::debug("binding descriptor sets to command buffer at compute queue bindpoint ");
-			vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, set.get_ptr(), 0, nullptr);
+			LOG_DEBUG("binding descriptor sets to command buffer at compute queue bindpoint ");
+			if (set.is_push()) {
+				set.push(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout);
+			}
+			else {
+				vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, set.get_ptr(), 0, nullptr);
+			}
 		}
 		else if (usage == QueueFamily::GRAPHICS_QUEUE) {
-			Log::debug("binding descriptor sets to command buffer at graphics queue bindpoint ");
-			vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, set.get_ptr(), 0, nullptr);
+			LOG_DEBUG("binding descriptor sets to command buffer at graphics queue bindpoint ");
+			if (set.is_push()) {
+				set.push(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout);
+			}
+			else {
+				vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, set.get_ptr(), 0, nullptr);
+			}
 		}
 		else {
 			Log::warning("CommandBuffer::bind_descriptor_set() failed. The queue family of the command buffer has to be COMPUTE_QUEUE or GRAPHICS_QUEUE.");
@@ -3995,7 +5344,7 @@ public:
 		copy_region.srcOffset = src_offset_bytes;
 		copy_region.dstOffset = dst_offset_bytes;
 		copy_region.size = size_bytes;
-		vkCmdCopyBuffer(buffer, src_buffer.get(), dst_buffer.get(), 1, copy_region);
+		vkCmdCopyBuffer(buffer, src_buffer.get(), dst_buffer.get(), 1, &copy_region);
 	}
 
 	// add memory barrier
@@ -4202,19 +5551,25 @@ public:
 		vkCmdNextSubpass(buffer, contents);
 	}
 
+	// adds a semaphore that the next submission has to wait for before executing the given stages
+	// (the value is only used for timeline semaphores)
+	void wait_semaphore(const Semaphore& semaphore, uint64_t value = 0, VkPipelineStageFlags stage_mask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT) {
+		wait_semaphores.push_back(semaphore.get());
+		wait_values.push_back(value);
+		wait_stages.push_back(stage_mask);
+	}
+
+	// adds a semaphore that will be signaled once the next submission has completed
+	// (the value is only used for timeline semaphores)
+	void signal_semaphore(const Semaphore& semaphore, uint64_t value = 0) {
+		signal_semaphores.push_back(semaphore.get());
+		signal_values.push_back(value);
+	}
+
 	// end recording and submit command buffer to queue
 	// (overload with fence)
 	void submit(Fence& fence, uint64_t fence_timeout_nanosec = 100000) {
-		// stop command buffer recording state (thus triggering executable state)
-		vkEndCommandBuffer(buffer);
-
-		// submit to queue (triggers command buffer pending state)
-		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submit_info.pCommandBuffers = &buffer;
-		submit_info.commandBufferCount = 1;
-
-		vkQueueSubmit(queue, 1, &submit_info, fence.get());
-
+		queue_submit(fence.get());
 		fence.wait(fence_timeout_nanosec);
 		fence.reset();
 	}
@@ -4222,21 +5577,17 @@ public:
 	// end recording and submit command buffer to queue
 	// (overload without fence)
 	void submit() {
-		// stop command buffer recording state (thus triggering executable state)
-		vkEndCommandBuffer(buffer);
-
-		// submit to queue (triggers command buffer pending state)
-		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submit_info.pCommandBuffers = &buffer;
-		submit_info.commandBufferCount = 1;
-
-		vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+		queue_submit(VK_NULL_HANDLE);
 	}
 
 	void reset(VkCommandBufferResetFlags flags = VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT) {
+#ifdef PROFILING
+		// (a command buffer can only be reset after its submission has completed)
+		if (timestamps != nullptr) { timestamps->collect(true); }
+#endif
 		VkResult result = vkResetCommandBuffer(buffer, flags);
 		if (result == VK_SUCCESS) {
-			Log::debug("successfully reset command buffer");
+			LOG_DEBUG("successfully reset command buffer");
 		}
 		else {
 			Log::warning("failed to reset command buffer (handle: ", buffer, ", VkResult = ", result, ")");
@@ -4251,26 +5602,41 @@ public:
 	// (note: a fence will only be used if fence_timeout_nanosec != 0);
 	// the boolean direct_submit can be set to false in case multiple dispatches need to be added before a final submit
 	void compute(ComputePipeline& pipeline, uint32_t global_size_x, uint32_t global_size_y = 1, uint32_t global_size_z = 1, bool direct_submit = true, uint64_t fence_timeout_nanosec = 100000, bool add_buffer_memory_barriers = true) {
-		Log::debug("executing GPU compute (bind pipeline -> bind descriptor set -> bind push constants -> dispatch -> submit -> wait for fences)");
+		LOG_DEBUG("executing GPU compute (bind pipeline -> bind descriptor set -> bind push constants -> dispatch -> submit -> wait for fences)");
+#ifdef PROFILING
+		// GPU timestamps around the dispatch, tagged with the label of the caller (see set_profile_label())
+		ProfileLabel label = std::move(next_profile_label());
+		next_profile_label() = ProfileLabel();
+		int32_t query = -1;
+		if (label.assigned ? label.sampled : Profiler::sample()) {
+			if (label.name.empty()) { label.name = "compute"; }
+			if (label.shape.empty()) { label.shape = std::to_string(global_size_x) + "x" + std::to_string(global_size_y) + "x" + std::to_string(global_size_z); }
+			uint64_t bytes = 0;
+			for (const auto& binding : pipeline.get_set()->get_buffer_bindings()) {
+				bytes += binding.size;
+			}
+			if (timestamps == nullptr) {
+				timestamps = std::make_unique<TimestampQueryPool>(*device, get_queue_family_index());
+			}
+			query = timestamps->begin(buffer, label.name, label.shape, bytes);
+		}
+#endif
 		bind_pipeline(pipeline);
 		bind_descriptor_set(*pipeline.get_set());
 		bind_constants(*pipeline.get_constants());
 		dispatch(global_size_x, global_size_y, global_size_z);
+#ifdef PROFILING
+		if (query >= 0) { timestamps->end(buffer, query); }
+#endif
 
 		if (add_buffer_memory_barriers) {
-			for (uint32_t i = 0; i < pipeline.get_set()->get_buffer_bindings().size(); i++) {
-				BufferMemoryBarrier barrier(
-					pipeline.get_set()->get_buffer_bindings()[i].buffer,
-					VK_ACCESS_2_SHADER_WRITE_BIT,
-					VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
-					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
-				);
-				this->add_barrier(barrier);
-			}
+			add_binding_barriers(*pipeline.get_set());
 		}
 
 		if (direct_submit) {
+#ifdef PROFILING
+			double submit_start = Profiler::now_ns();
+#endif
 			if (fence_timeout_nanosec != 0) {
 				Fence fence(*device, false);
 				submit(fence, fence_timeout_nanosec);
@@ -4278,27 +5644,150 @@ public:
 			else {
 				submit();
 			}
+#ifdef PROFILING
+			// host time of the submission, including the wait for the fence
+			if (query >= 0) { Profiler::record("submit", label.name, label.shape, submit_start, Profiler::now_ns() - submit_start); }
+#endif
 			reset();
 		}
-		Log::debug("compute execution finished");
+		LOG_DEBUG("compute execution finished");
+	}
+
+	// records a dispatch of a pipeline that is given by its handles (owned by the pipeline cache), with the given
+	// descriptor set, push constant data and number of workgroups; used for re-recording captured sequences
+	// (see NGrid::Graph) after the ComputePipeline objects of the original operations are gone
+	void compute(VkPipeline pipeline, VkPipelineLayout layout, const DescriptorSet& set, const VkPushConstantRange& range, const uint32_t* constants,
+		uint32_t workgroups_x, uint32_t workgroups_y = 1, uint32_t workgroups_z = 1, bool add_buffer_memory_barriers = true) {
+		if (usage != QueueFamily::COMPUTE_QUEUE) {
+			Log::error("invalid usage of CommandBuffer::compute(): this command buffer doesn't support compute (queue family mismatch)");
+		}
+#ifdef PROFILING
+		next_profile_label() = ProfileLabel(); // (the dispatches of a replayed sequence aren't measured individually)
+#endif
+		vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		pipeline_layout = layout;
+		bind_descriptor_set(set);
+		vkCmdPushConstants(buffer, layout, range.stageFlags, range.offset, range.size, constants);
+		vkCmdDispatch(buffer, workgroups_x, workgroups_y, workgroups_z);
+		if (add_buffer_memory_barriers) {
+			add_binding_barriers(set);
+		}
+	}
+
+#ifdef PROFILING
+	// sets the label of the next dispatch recorded with compute() on the calling thread;
+	// sampled == false skips the measurement of that dispatch
+	static void set_profile_label(const std::string& name, const std::string& shape, bool sampled) {
+		ProfileLabel& label = next_profile_label();
+		label.name = name;
+		label.shape = shape;
+		label.assigned = true;
+		label.sampled = sampled;
+	}
+	static const ProfileLabel& get_profile_label() { return next_profile_label(); }
+#endif
+
+	// returns the index of the queue family that the command buffer submits to
+	uint32_t get_queue_family_index() const {
+		switch (usage) {
+		case QueueFamily::GRAPHICS_QUEUE: return device->get_graphics_queue_family_index();
+		case QueueFamily::TRANSFER_QUEUE: return device->get_transfer_queue_family_index();
+		default: return device->get_compute_queue_family_index();
+		}
 	}
 
 	// start command buffer recording state
 	void begin_recording() {
 		begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		begin_info.pNext = NULL;
-		begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; // specifies that each recording of the command buffer will only be submitted once, and the command buffer will be reset and recorded again between each submission
+		// one-time submit: each recording will only be submitted once, and the command buffer will be reset and recorded again between each submission
+		begin_info.flags = reusable ? 0 : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 		begin_info.pInheritanceInfo = nullptr; // pointer to a VkCommandBufferInheritanceInfo struct; only relevant for secondary command buffers
 		VkResult result = vkBeginCommandBuffer(buffer, &begin_info);
 		if (result == VK_SUCCESS) {
-			Log::debug("beginning command buffer recording state");
+			LOG_DEBUG("beginning command buffer recording state");
+			recording = true;
 		}
 		else {
 			Log::warning("failed to begin command buffer recording state (VkResult = ", result, ")");
 		}
 	}
 
+	// ends the recording state (submissions end it automatically);
+	// the recorded commands of a reusable command buffer can be submitted repeatedly afterwards
+	void end_recording() {
+		if (recording) {
+			vkEndCommandBuffer(buffer);
+			recording = false;
+		}
+	}
+
+	// reusable command buffers are recorded without VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	// so that a recording can be submitted more than once (takes effect with the next begin_recording() or reset())
+	void set_reusable(bool reusable) { this->reusable = reusable; }
+
 protected:
+	// stops the recording state and submits the command buffer to the queue,
+	// including the semaphores that have been added since the last submission
+	void queue_submit(VkFence fence) {
+		// stop command buffer recording state (thus triggering executable state)
+		end_recording();
+
+		// submit to queue (triggers command buffer pending state)
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.pCommandBuffers = &buffer;
+		submit_info.commandBufferCount = 1;
+		submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+		submit_info.pWaitSemaphores = wait_semaphores.empty() ? nullptr : wait_semaphores.data();
+		submit_info.pWaitDstStageMask = wait_stages.empty() ? nullptr : wait_stages.data();
+		submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+		submit_info.pSignalSemaphores = signal_semaphores.empty() ? nullptr : signal_semaphores.data();
+
+		// timeline values (ignored for binary semaphores)
+		VkTimelineSemaphoreSubmitInfo timeline_info = {};
+		timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timeline_info.pNext = NULL;
+		timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+		timeline_info.pWaitSemaphoreValues = wait_values.empty() ? nullptr : wait_values.data();
+		timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+		timeline_info.pSignalSemaphoreValues = signal_values.empty() ? nullptr : signal_values.data();
+		submit_info.pNext = (wait_semaphores.empty() && signal_semaphores.empty()) ? NULL : &timeline_info;
+
+		std::unique_lock<std::mutex> queue_lock(device->get_queue_mutex(queue));
+		VkResult result = vkQueueSubmit(queue, 1, &submit_info, fence);
+		queue_lock.unlock();
+		if (result != VK_SUCCESS) {
+			Log::warning("failed to submit command buffer (handle: ", buffer, ", VkResult = ", result, ")");
+		}
+#ifdef PROFILING
+		if (timestamps != nullptr) { timestamps->submitted(); }
+#endif
+
+		// semaphores only apply to a single submission
+		submit_info.pNext = NULL;
+		submit_info.waitSemaphoreCount = 0;
+		submit_info.signalSemaphoreCount = 0;
+		wait_semaphores.clear();
+		wait_values.clear();
+		wait_stages.clear();
+		signal_semaphores.clear();
+		signal_values.clear();
+	}
+
+	// barriers between the shader writes of a dispatch and the accesses of the next dispatch to the bound buffers
+	void add_binding_barriers(const DescriptorSet& set) {
+		for (uint32_t i = 0; i < set.get_buffer_bindings().size(); i++) {
+			BufferMemoryBarrier barrier(
+				set.get_buffer_bindings()[i].buffer,
+				VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+			);
+			this->add_barrier(barrier);
+		}
+	}
+
 	VkCommandBuffer buffer = nullptr;
 	QueueFamily usage = QueueFamily::UNKNOWN_QUEUE;
 	VkPipelineLayout pipeline_layout = nullptr;
@@ -4311,10 +5800,105 @@ protected:
 	VkRenderPassBeginInfo renderpass_begin_info = {};
 	VkSubpassBeginInfo subpass_begin_info = {};
 	VkSubmitInfo submit_info = {};
+	std::vector<VkSemaphore> wait_semaphores;
+	std::vector<uint64_t> wait_values;
+	std::vector<VkPipelineStageFlags> wait_stages;
+	std::vector<VkSemaphore> signal_semaphores;
+	std::vector<uint64_t> signal_values;
 	VkCommandPool pool = nullptr;
 	uint32_t workgroup_size_x = 0; // only used for compute pipelines
 	uint32_t workgroup_size_y = 0; // only used for compute pipelines
 	uint32_t workgroup_size_z = 0; // only used for compute pipelines
+	bool reusable = false;         // recordings may be submitted more than once (see set_reusable())
+	bool recording = false;        // true between begin_recording() and the end of the recording
+#ifdef PROFILING
+	std::unique_ptr<TimestampQueryPool> timestamps; // created by the first sampled dispatch
+
+	static ProfileLabel& next_profile_label() {
+		thread_local ProfileLabel label;
+		return label;
+	}
+#endif
+};
+
+// helper for transfers between the host and (device-local) buffers via temporary host-visible staging buffers;
+// the copy commands are submitted to the queue of the given command pool (usually the transfer queue)
+// and the methods return after the transfer has finished
+class StagingTransfer {
+public:
+	// constructor
+	StagingTransfer() = delete;
+	StagingTransfer(Device& device, const CommandPool& pool, uint64_t fence_timeout_nanosec = 1000000000)
+		: command_buffer(device, pool) {
+		this->device = &device;
+		this->fence_timeout_nanosec = fence_timeout_nanosec;
+	}
+
+	// deleted copy constructor and assignment
+	StagingTransfer(const StagingTransfer&) = delete;
+	StagingTransfer& operator=(const StagingTransfer&) = delete;
+
+	// copies elements from host memory to a buffer
+	template<typename T>
+	void upload(Buffer<T>& target, const T* source, uint32_t copied_elements, uint32_t target_offset_elements = 0, std::source_location location = std::source_location::current()) {
+		if (copied_elements == 0) { return; }
+#ifdef PROFILING
+		double profile_start = Profiler::now_ns();
+#endif
+		if (target.host_visible()) {
+			target.write(source, copied_elements, 0, target_offset_elements);
+		}
+		else {
+			std::lock_guard<std::mutex> lock(mtx);
+			Buffer<T> staging(*device, BufferUsage::TRANSFER_BUFFER, copied_elements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+			staging.write(source, copied_elements);
+			command_buffer.copy_buffer(staging, target, uint64_t(copied_elements) * sizeof(T), 0, uint64_t(target_offset_elements) * sizeof(T));
+			submit();
+		}
+#ifdef PROFILING
+		Profiler::record("upload", Profiler::function_name(location.function_name()), "", profile_start, Profiler::now_ns() - profile_start, uint64_t(copied_elements) * sizeof(T));
+#endif
+	}
+
+	// copies elements from a buffer to host memory
+	template<typename T>
+	void download(const Buffer<T>& source, T* target, uint32_t copied_elements, uint32_t source_offset_elements = 0, std::source_location location = std::source_location::current()) {
+		if (copied_elements == 0) { return; }
+#ifdef PROFILING
+		double profile_start = Profiler::now_ns();
+#endif
+		std::lock_guard<std::mutex> lock(mtx);
+		Buffer<T> staging(*device, BufferUsage::TRANSFER_BUFFER, copied_elements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, {}, MemoryAllocationMode::SCRATCH_ALLOCATION);
+		command_buffer.copy_buffer(source, staging, uint64_t(copied_elements) * sizeof(T), uint64_t(source_offset_elements) * sizeof(T), 0);
+		submit();
+		std::vector<T> data = staging.read();
+		memcpy(target, data.data(), uint64_t(copied_elements) * sizeof(T));
+#ifdef PROFILING
+		Profiler::record("readback", Profiler::function_name(location.function_name()), "", profile_start, Profiler::now_ns() - profile_start, uint64_t(copied_elements) * sizeof(T));
+#endif
+	}
+
+	// device-side copy between two buffers
+	template<typename T>
+	void copy(const Buffer<T>& source, Buffer<T>& target, uint32_t copied_elements, uint32_t source_offset_elements = 0, uint32_t target_offset_elements = 0) {
+		if (copied_elements == 0) { return; }
+		std::lock_guard<std::mutex> lock(mtx);
+		command_buffer.copy_buffer(source, target, uint64_t(copied_elements) * sizeof(T), uint64_t(source_offset_elements) * sizeof(T), uint64_t(target_offset_elements) * sizeof(T));
+		submit();
+	}
+
+private:
+	// submits the recorded copy commands and waits for completion
+	void submit() {
+		Fence fence(*device, false);
+		command_buffer.submit(fence, fence_timeout_nanosec);
+		command_buffer.reset();
+	}
+
+	Device* device = nullptr;
+	CommandBuffer command_buffer;
+	uint64_t fence_timeout_nanosec = 1000000000;
+	std::mutex mtx; // the command buffer is shared by all threads
 };
 
 // shared manager for instance, device and command pools as singleton class
@@ -4328,6 +5912,7 @@ public:
 		uint32_t api_minor_version = 3,
 		uint32_t api_patch_version = 0,
 		uint32_t default_device_id = 0) {
+		std::lock_guard<std::mutex> lock(singleton_mutex);
 		if (singleton == nullptr) {
 			shared_instance_layer_names = instance_layer_names;
 			shared_instance_extension_names = instance_extension_names;
@@ -4353,6 +5938,7 @@ public:
 		uint32_t api_minor_version = 3,
 		uint32_t api_patch_version = 0,
 		uint32_t default_device_id = 0) {
+		std::lock_guard<std::mutex> lock(singleton_mutex);
 		if (singleton == nullptr) {
 			// enable instance layers
 			shared_instance_layer_names = {};
@@ -4404,13 +5990,56 @@ public:
 	}
 
 	static Device& get_device() { return *device; }
+
+	// returns the device for the physical device with the given enumeration index;
+	// devices other than the default device are created on first use, with the same extensions and features
+	// and with their own pipeline cache and memory arena
+	static Device& get_device(uint32_t physical_device_index) {
+		if (physical_device_index == device->get_physical_device_index()) {
+			return *device;
+		}
+		std::lock_guard<std::mutex> lock(singleton_mutex);
+		auto it = additional_devices.find(physical_device_index);
+		if (it == additional_devices.end()) {
+			uint32_t count = get_device_count();
+			if (physical_device_index >= count) {
+				Log::error("in method VulkanManager::get_device(): invalid physical device index ", physical_device_index, " (", count, " devices available)");
+			}
+			LOG_DEBUG("creating additional device for physical device ", physical_device_index);
+			AdditionalDevice resources;
+			resources.device = new Device(*instance, shared_enabled_device_features, shared_device_extension_names, 0, static_cast<int32_t>(physical_device_index));
+			std::string filepath = shared_pipeline_cache_filepath.empty() ? "" : shared_pipeline_cache_filepath + "." + std::to_string(physical_device_index);
+			resources.pipeline_cache = new ComputePipelineCache(*resources.device, filepath);
+			resources.memory_arena = new MemoryArena(*resources.device);
+			it = additional_devices.emplace(physical_device_index, resources).first;
+		}
+		return *it->second.device;
+	}
+
+	// returns the number of physical devices with Vulkan support
+	static uint32_t get_device_count() {
+		uint32_t count = 0;
+		vkEnumeratePhysicalDevices(instance->get(), &count, nullptr);
+		return count;
+	}
+
+	// returns the enumeration index of the default device
+	static uint32_t get_default_device_index() { return device->get_physical_device_index(); }
 	static const Device* get_device_ptr() { return device; }
 	static const Instance& get_instance() { return *instance; }
 	static VulkanManager* get_singleton() { return singleton; }
+	// note: command pools are externally synchronized, i.e. the shared pools must only be used by one thread at a time
 	static CommandPool& get_command_pool_graphics() { return *shared_command_pool_graphics; }
 	static CommandPool& get_command_pool_compute() { return *shared_command_pool_compute; }
 	static CommandPool& get_command_pool_transfer() { return *shared_command_pool_transfer; }
 	static const VkPhysicalDeviceFeatures& get_enabled_device_features() { return shared_enabled_device_features; }
+	static ComputePipelineCache& get_pipeline_cache() { return *shared_pipeline_cache; }
+	static MemoryArena& get_memory_arena() { return *shared_memory_arena; }
+
+	// sets the file used for loading and saving the pipeline cache data;
+	// must be called before the singleton is created in order to take effect on startup;
+	// an empty string disables persistence to disk
+	static void set_pipeline_cache_filepath(const std::string& filepath) { shared_pipeline_cache_filepath = filepath; }
 
 private:
 	// shared members
@@ -4428,6 +6057,18 @@ private:
 	static CommandPool* shared_command_pool_compute;
 	static CommandPool* shared_command_pool_graphics;
 	static CommandPool* shared_command_pool_transfer;
+	static ComputePipelineCache* shared_pipeline_cache;
+	static std::string shared_pipeline_cache_filepath;
+	static MemoryArena* shared_memory_arena;
+	static std::mutex singleton_mutex; // guards the singleton creation (which might be triggered by several threads)
+
+	// devices other than the default device (see get_device(uint32_t)), by physical device index
+	struct AdditionalDevice {
+		Device* device = nullptr;
+		ComputePipelineCache* pipeline_cache = nullptr;
+		MemoryArena* memory_arena = nullptr;
+	};
+	static std::map<uint32_t, AdditionalDevice> additional_devices;
 
 	// private constructor: one-time initialization on first call of get_singleton()
 	VulkanManager() {
@@ -4444,21 +6085,37 @@ private:
 		device = new Device(*instance, shared_enabled_device_features, shared_device_extension_names, shared_default_device_id);
 
 		// setup command pools
-		Log::debug("creating new graphics command pool");
+		LOG_DEBUG("creating new graphics command pool");
 		shared_command_pool_graphics = new CommandPool(*device, QueueFamily::GRAPHICS_QUEUE);
-		Log::debug("creating new compute command pool");
+		LOG_DEBUG("creating new compute command pool");
 		shared_command_pool_compute = new CommandPool(*device, QueueFamily::COMPUTE_QUEUE);
-		Log::debug("creating new transfer command pool");
+		LOG_DEBUG("creating new transfer command pool");
 		shared_command_pool_transfer = new CommandPool(*device, QueueFamily::TRANSFER_QUEUE);
+
+		// setup pipeline cache
+		LOG_DEBUG("creating new compute pipeline cache");
+		shared_pipeline_cache = new ComputePipelineCache(*device, shared_pipeline_cache_filepath);
+
+		// setup memory arena for buffer sub-allocation
+		LOG_DEBUG("creating new device memory arena");
+		shared_memory_arena = new MemoryArena(*device);
 	}
 
 	// private custom destructor method
 	static void destroy_singleton() {
 		if (singleton != nullptr) {
-			Log::debug("singleton manager destructor invoked");
+			LOG_DEBUG("singleton manager destructor invoked");
+			for (auto& [index, resources] : additional_devices) {
+				delete resources.pipeline_cache;
+				delete resources.memory_arena;
+				delete resources.device;
+			}
+			additional_devices.clear();
 			delete shared_command_pool_graphics;    shared_command_pool_graphics = nullptr;
 			delete shared_command_pool_compute;     shared_command_pool_compute = nullptr;
 			delete shared_command_pool_transfer;    shared_command_pool_transfer = nullptr;
+			delete shared_pipeline_cache;           shared_pipeline_cache = nullptr;
+			delete shared_memory_arena;             shared_memory_arena = nullptr;
 			delete device;                          device = nullptr;
 			delete instance;                        instance = nullptr;
 			delete singleton;                       singleton = nullptr;
@@ -4473,6 +6130,11 @@ VulkanManager* VulkanManager::singleton = nullptr;
 CommandPool* VulkanManager::shared_command_pool_compute = nullptr;
 CommandPool* VulkanManager::shared_command_pool_graphics = nullptr;
 CommandPool* VulkanManager::shared_command_pool_transfer = nullptr;
+ComputePipelineCache* VulkanManager::shared_pipeline_cache = nullptr;
+std::string VulkanManager::shared_pipeline_cache_filepath = "pipeline_cache.bin";
+MemoryArena* VulkanManager::shared_memory_arena = nullptr;
+std::mutex VulkanManager::singleton_mutex;
+std::map<uint32_t, VulkanManager::AdditionalDevice> VulkanManager::additional_devices = {};
 std::vector<const char*> VulkanManager::shared_instance_layer_names = {};
 std::vector<const char*> VulkanManager::shared_instance_extension_names = {};
 std::vector<const char*> VulkanManager::shared_device_extension_names = {};
@@ -4482,6 +6144,16 @@ uint32_t VulkanManager::shared_api_major_version = 1;
 uint32_t VulkanManager::shared_api_minor_version = 3;
 uint32_t VulkanManager::shared_api_patch_version = 0;
 
+// initialization of ComputePipelineCache static members
+ComputePipelineCache* ComputePipelineCache::shared = nullptr;
+std::map<VkDevice, ComputePipelineCache*> ComputePipelineCache::registry = {};
+std::mutex ComputePipelineCache::registry_mtx;
+
+// initialization of MemoryArena static members
+MemoryArena* MemoryArena::shared = nullptr;
+std::map<VkDevice, MemoryArena*> MemoryArena::registry = {};
+std::mutex MemoryArena::registry_mtx;
+
 
 #endif // include guard close
 
@@ -30,4 +30,8 @@ int main() {
 	auto result = A.regression(B);
 	result.print();
 
+	// grids and lazy expressions can be mixed (with the grid on either side)
+	NGrid D = (A + C.lazy() * 2).eval();
+	Log::force("max. deviation of the fused expression A + C * 2 from the unfused result: ", (D - (A + C * 2)).maxabs());
+
 }